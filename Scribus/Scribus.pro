@@ -491,6 +491,7 @@ HEADERS += scribus/actionmanager.h \
            scribus/text/frect.h \
            scribus/text/fsize.h \
            scribus/text/nlsconfig.h \
+           scribus/text/paragraphindex.h \
            scribus/text/sctext_shared.h \
            scribus/text/specialchars.h \
            scribus/text/storytext.h \
@@ -1393,6 +1394,7 @@ SOURCES += scribus/actionmanager.cpp \
            scribus/styles/stylecontextproxy.cpp \
            scribus/text/frect.cpp \
            scribus/text/fsize.cpp \
+           scribus/text/paragraphindex.cpp \
            scribus/text/sctext_shared.cpp \
            scribus/text/specialchars.cpp \
            scribus/text/storytext.cpp \
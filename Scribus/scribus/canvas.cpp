@@ -19,7 +19,9 @@
 #include <cmath>
 
 // #include <QDebug>
+#include <QTimer>
 #include <QToolTip>
+#include <QtCore/qmath.h>
 
 #include "canvas.h"
 #include "canvasmode.h"
@@ -31,6 +33,7 @@
 #include "scpainter.h"
 #include "scribusview.h"
 #include "selection.h"
+#include "text/specialchars.h"
 #include "ui/hruler.h"
 #include "ui/vruler.h"
 #include "util.h"
@@ -39,11 +42,36 @@
 
 #define DRAW_DEBUG_LINES 0
 
+// width and height of the tiles of rendered contents in pixels
+static const int TileSize = 256;
+// size of a tile in kB, the cost of a tile in Canvas::m_tiles
+static const int TileCost = TileSize * TileSize * 4 / 1024;
+// maximum size of all tiles in kB
+static const int TileCacheSize = 64 * 1024;
+// idle time in ms after a repaint before tiles around the viewport are rendered ahead
+static const int TilePrefetchDelay = 250;
+
 static QPoint contentsToViewport(QPoint p)
 {
 	return p;
 }
 
+// whether item or one of its members shows the page number or the page count
+static bool showsPageNumber(PageItem* item)
+{
+	QList<PageItem*> items = item->getItemList();
+	items.prepend(item);
+	for (int i = 0; i < items.count(); ++i)
+	{
+		if (!items[i]->asTextFrame() && !items[i]->asPathText())
+			continue;
+		QString text = items[i]->itemText.text(0, items[i]->itemText.length());
+		if (text.contains(SpecialChars::PAGENUMBER) || text.contains(SpecialChars::PAGECOUNT))
+			return true;
+	}
+	return false;
+}
+
 
 void CanvasViewMode::init()
 {	
@@ -112,6 +140,11 @@ Canvas::Canvas(ScribusDoc* doc, ScribusView* parent) : QWidget(parent), m_doc(do
 	m_bufferRect = QRect();
 	m_viewMode.init();
 	m_renderMode = RENDER_NORMAL;
+	m_tiles.setMaxCost(TileCacheSize);
+	m_tileScale = 0.0;
+	m_tilePrefetchTimer = new QTimer(this);
+	m_tilePrefetchTimer->setSingleShot(true);
+	connect(m_tilePrefetchTimer, SIGNAL(timeout()), this, SLOT(prefetchTiles()));
 }
 
 void Canvas::setPreviewVisual(int mode)
@@ -460,14 +493,15 @@ PageItem* Canvas::itemUnderCursor(QPoint globalPos, PageItem* itemAbove, bool al
 		return NULL;
 
 	int currNr = itemAbove? m_doc->Items->indexOf(itemAbove)-1 : m_doc->Items->count()-1;
-	while (currNr >= 0)
+	// only items whose bounds touch the mouse area can be hit, look at them from the top
+	QList<int> candidates = m_doc->itemsInArea(mouseArea);
+	for (int i = candidates.count() - 1; i >= 0; --i)
 	{
-		currItem = m_doc->Items->at(currNr);
+		if (candidates[i] > currNr)
+			continue;
+		currItem = m_doc->Items->at(candidates[i]);
 		if ((m_doc->masterPageMode())  && (!((currItem->OwnPage == -1) || (currItem->OwnPage == static_cast<int>(m_doc->currentPage()->pageNr())))))
-		{
-			--currNr;
 			continue;
-		}
 		if ((currItem->LayerID == m_doc->activeLayer()) && (!m_doc->layerLocked(currItem->LayerID)))
 		{
 			QTransform itemPos = currItem->getTransform();
@@ -491,7 +525,6 @@ PageItem* Canvas::itemUnderCursor(QPoint globalPos, PageItem* itemAbove, bool al
 				return currItem;
 			}
 		}
-		--currNr;
 	}
 	return NULL;
 }
@@ -574,6 +607,13 @@ PageItem * Canvas::itemUnderItem(PageItem * item, int& index) const
  
  local m_bufferRect.topLeft |-> buffer (0,0)
  
+ The buffer is filled from m_tiles, which keeps the rendered contents in tiles
+ of TileSize x TileSize, so that areas scrolled out of the buffer don't have
+ to be rendered again when they come back. Tiles around the viewport are
+ rendered ahead by prefetchTiles() when there was no repaint for a while.
+ Content changes only reach the canvas as paint events with forceRedraw for
+ the visible part. So redrawBuffer() drops all tiles which are not completely
+ inside the buffer, the remaining ones are updated together with the buffer.
  
  */
 
@@ -594,6 +634,129 @@ void Canvas::clearBuffers()
 	m_bufferRect = QRect();
 	m_selectionBuffer = QPixmap();
 	m_selectionRect = QRect();
+	m_tiles.clear();
+}
+
+
+QRect Canvas::tileRect(int column, int row) const
+{
+	QPoint origin = canvasToLocal(QPointF(0.0, 0.0));
+	return QRect(origin.x() + column * TileSize, origin.y() + row * TileSize, TileSize, TileSize);
+}
+
+
+void Canvas::tileRange(QRect rect, int& column1, int& row1, int& column2, int& row2) const
+{
+	QPoint origin = canvasToLocal(QPointF(0.0, 0.0));
+	column1 = qFloor((rect.left() - origin.x()) / static_cast<double>(TileSize));
+	row1 = qFloor((rect.top() - origin.y()) / static_cast<double>(TileSize));
+	column2 = qFloor((rect.right() - origin.x()) / static_cast<double>(TileSize));
+	row2 = qFloor((rect.bottom() - origin.y()) / static_cast<double>(TileSize));
+}
+
+
+quint64 Canvas::tileKey(int column, int row)
+{
+	return (static_cast<quint64>(static_cast<quint32>(column)) << 32) | static_cast<quint32>(row);
+}
+
+
+void Canvas::renderTiles(int column1, int row1, int column2, int row2)
+{
+	if (m_tileScale != m_viewMode.scale)
+	{
+		m_tiles.clear();
+		m_tileScale = m_viewMode.scale;
+	}
+	int missing = 0;
+	for (int row = row1; row <= row2; ++row)
+	{
+		for (int column = column1; column <= column2; ++column)
+		{
+			if (!m_tiles.contains(tileKey(column, row)))
+				++missing;
+		}
+	}
+	if (missing == 0)
+		return;
+	// every call of drawContents() has to go through all pages and layers,
+	// so render the whole range at once if nothing is cached or else runs of missing tiles
+	bool whole = (missing == (column2 - column1 + 1) * (row2 - row1 + 1));
+	for (int row = row1; row <= row2; ++row)
+	{
+		int column = column1;
+		while (column <= column2)
+		{
+			if (!whole && m_tiles.contains(tileKey(column, row)))
+			{
+				++column;
+				continue;
+			}
+			int lastColumn = column;
+			int lastRow = whole ? row2 : row;
+			if (whole)
+				lastColumn = column2;
+			else
+			{
+				while ((lastColumn < column2) && !m_tiles.contains(tileKey(lastColumn + 1, row)))
+					++lastColumn;
+			}
+			QRect area = tileRect(column, row) | tileRect(lastColumn, lastRow);
+			QPixmap contents(area.size());
+			QPainter painter(&contents);
+			painter.translate(-area.x(), -area.y());
+			drawContents(&painter, area.x(), area.y(), area.width(), area.height());
+			painter.end();
+			for (int r = row; r <= lastRow; ++r)
+			{
+				for (int c = column; c <= lastColumn; ++c)
+				{
+					QPixmap* tile = new QPixmap(contents.copy(tileRect(c, r).translated(-area.topLeft())));
+					m_tiles.insert(tileKey(c, r), tile, TileCost);
+				}
+			}
+			column = lastColumn + 1;
+		}
+		if (whole)
+			break;
+	}
+}
+
+
+void Canvas::dropTilesOutside(QRect rect)
+{
+	QList<quint64> keys = m_tiles.keys();
+	for (int i = 0; i < keys.count(); ++i)
+	{
+		int column = static_cast<qint32>(keys[i] >> 32);
+		int row = static_cast<qint32>(keys[i] & 0xffffffff);
+		if (!rect.contains(tileRect(column, row)))
+			m_tiles.remove(keys[i]);
+	}
+}
+
+
+void Canvas::prefetchTiles()
+{
+	if (m_doc->isLoading() || (m_renderMode != RENDER_NORMAL) || m_viewMode.m_MouseButtonPressed || !isVisible())
+		return;
+	QRect viewport(-x(), -y(), m_view->viewport()->width(), m_view->viewport()->height());
+	int column1, row1, column2, row2;
+	tileRange(viewport.adjusted(-TileSize, -TileSize, TileSize, TileSize), column1, row1, column2, row2);
+	// don't push out the tiles of the viewport
+	if ((column2 - column1 + 1) * (row2 - row1 + 1) * TileCost > m_tiles.maxCost() / 2)
+		return;
+	for (int row = row1; row <= row2; ++row)
+	{
+		for (int column = column1; column <= column2; ++column)
+		{
+			if (m_tiles.contains(tileKey(column, row)))
+				continue;
+			renderTiles(column1, row, column2, row);
+			m_tilePrefetchTimer->start(0);
+			return;
+		}
+	}
 }
 
 
@@ -761,10 +924,58 @@ bool Canvas::adjustBuffer()
 void Canvas::fillBuffer(QPaintDevice* buffer, QPoint bufferOrigin, QRect clipRect)
 {
 // 	qDebug()<<"Canvas::fillBuffer"<<clipRect<<m_viewMode.forceRedraw<<m_viewMode.operItemSelecting;
+	int column1, row1, column2, row2;
+	tileRange(clipRect, column1, row1, column2, row2);
+	renderTiles(column1, row1, column2, row2);
 	QPainter painter(buffer);
 	painter.translate(-bufferOrigin.x(), -bufferOrigin.y());
+	for (int row = row1; row <= row2; ++row)
+	{
+		for (int column = column1; column <= column2; ++column)
+		{
+			QRect rect = tileRect(column, row);
+			QRect part = rect & clipRect;
+			QPixmap* tile = m_tiles.object(tileKey(column, row));
+			if (tile)
+				painter.drawPixmap(part.topLeft(), *tile, part.translated(-rect.topLeft()));
+			else // the cache is too small to hold all of clipRect
+				drawContents(&painter, part.x(), part.y(), part.width(), part.height());
+		}
+	}
+	painter.end();
+}
+
+
+void Canvas::redrawBuffer(QRect clipRect)
+{
+	clipRect &= m_bufferRect;
+	if (clipRect.isEmpty())
+		return;
+	dropTilesOutside(m_bufferRect);
+	QPixmap contents(clipRect.size());
+	QPainter painter(&contents);
+	painter.translate(-clipRect.x(), -clipRect.y());
 	drawContents(&painter, clipRect.x(), clipRect.y(), clipRect.width(), clipRect.height());
 	painter.end();
+	painter.begin(&m_buffer);
+	painter.drawPixmap(clipRect.topLeft() - m_bufferRect.topLeft(), contents);
+	painter.end();
+	int column1, row1, column2, row2;
+	tileRange(clipRect, column1, row1, column2, row2);
+	for (int row = row1; row <= row2; ++row)
+	{
+		for (int column = column1; column <= column2; ++column)
+		{
+			QPixmap* tile = m_tiles.object(tileKey(column, row));
+			if (!tile)
+				continue;
+			QRect rect = tileRect(column, row);
+			QRect part = rect & clipRect;
+			painter.begin(tile);
+			painter.drawPixmap(part.topLeft() - rect.topLeft(), contents, part.translated(-clipRect.topLeft()));
+			painter.end();
+		}
+	}
 }
 
 /**
@@ -810,7 +1021,7 @@ void Canvas::paintEvent ( QPaintEvent * p )
 			if ((m_viewMode.forceRedraw || m_viewMode.operTextSelecting) && (!bufferFilled))
 			{
 //				qDebug() << "Canvas::paintEvent: forceRedraw=" << m_viewMode.forceRedraw << "bufferFilled=" << bufferFilled;
-				fillBuffer(&m_buffer, m_bufferRect.topLeft(), p->rect());
+				redrawBuffer(p->rect());
 			}
 #ifdef SHOW_ME_WHAT_YOU_GET_IN_D_CANVA
 			t2 = t.elapsed();
@@ -928,6 +1139,9 @@ void Canvas::paintEvent ( QPaintEvent * p )
 	m_viewMode.forceRedraw = false;
 	m_viewMode.operItemSelecting = false;
 	m_viewMode.operTextSelecting = false;
+	// every repaint postpones rendering ahead, so it doesn't slow down editing or scrolling
+	if (m_renderMode == RENDER_NORMAL)
+		m_tilePrefetchTimer->start(TilePrefetchDelay);
 }
 
 
@@ -1327,6 +1541,13 @@ void Canvas::DrawMasterItems(ScPainter *painter, Page *page, ScLayer& layer, QRe
 	uint layerCount = m_doc->layerCount();
 	if ((layerCount > 1) && ((layer.blendMode != 0) || (layer.transparency != 1.0)) && (!layer.outlineMode))
 		painter->beginLayer(layer.transparency, layer.blendMode);
+	m_masterImages.setMaxCost(qMax(0, PrefsManager::instance()->appPrefs.displayPrefs.itemCacheSize) * 1024);
+	bool useCache = (m_masterImages.maxCost() > 0) && !m_doc->RePos;
+	// Items which look the same on every page are drawn from an image shared by all pages,
+	// consecutive ones from the same image. Items showing the page number get an image per page.
+	enum { DrawDirect, ShareImage, PageImage };
+	QList<PageItem*> items;
+	QList<int> caching;
 	uint pageFromMasterCount=page->FromMaster.count();
 	for (uint a = 0; a < pageFromMasterCount; ++a)
 	{
@@ -1339,41 +1560,33 @@ void Canvas::DrawMasterItems(ScPainter *painter, Page *page, ScLayer& layer, QRe
 			continue;
 		if ((m_viewMode.viewAsPreview) && (!currItem->printEnabled()))
 			continue;
-		double OldX = currItem->xPos();
-		double OldY = currItem->yPos();
-		double OldBX = currItem->BoundingX;
-		double OldBY = currItem->BoundingY;
-		if (!currItem->ChangedMasterItem)
+		items.append(currItem);
+		// blend modes mix the item with what is below it
+		if (!useCache || currItem->ChangedMasterItem || currItem->isSelected() || (currItem->fillBlendmode() != 0) || (currItem->lineBlendmode() != 0))
+			caching.append(DrawDirect);
+		else
 		{
-			//Hack to not check for undo changes, indicate drawing only
-			currItem->moveBy(-Mp->xOffset() + page->xOffset(), -Mp->yOffset() + page->yOffset(), true);
-			currItem->BoundingX = OldBX - Mp->xOffset() + page->xOffset();
-			currItem->BoundingY = OldBY - Mp->yOffset() + page->yOffset();
+			// brings showsPageNumber up to date
+			masterItemGeneration(currItem);
+			caching.append(m_masterItemStates[currItem].showsPageNumber ? PageImage : ShareImage);
 		}
-		currItem->savedOwnPage = currItem->OwnPage;
-		currItem->OwnPage = page->pageNr();
-//FIXME						if (!evSpon || forceRedraw)
-//					currItem->invalid = true;
-		if (cullingArea.intersects(currItem->getBoundingRect().adjusted(0.0, 0.0, 1.0, 1.0)))
+	}
+	int first = 0;
+	while (first < items.count())
+	{
+		int last = first;
+		if (caching[first] == ShareImage)
 		{
-			if (!((m_viewMode.operItemMoving) && (currItem->isSelected())))
-			{
-				if (m_viewMode.forceRedraw)
-					currItem->invalidateLayout();
-				currItem->DrawObj(painter, cullingArea);
-				currItem->DrawObj_Decoration(painter);
-			}
-//							else 
-//								qDebug() << "skip masterpage item (move/resizeEdit/selected)" << m_viewMode.operItemMoving << currItem->isSelected();
+			while ((last + 1 < items.count()) && (caching[last + 1] == ShareImage))
+				++last;
 		}
-		currItem->OwnPage = currItem->savedOwnPage;
-		if (!currItem->ChangedMasterItem)
+		QList<PageItem*> run = items.mid(first, last - first + 1);
+		if ((caching[first] == DrawDirect) || !drawMasterImage(painter, page, Mp, run, caching[first] == PageImage, cullingArea))
 		{
-			//Hack to not check for undo changes, indicate drawing only
-			currItem->setXYPos(OldX, OldY, true);
-			currItem->BoundingX = OldBX;
-			currItem->BoundingY = OldBY;
+			for (int i = 0; i < run.count(); ++i)
+				drawMasterItem(painter, page, Mp, run[i], cullingArea);
 		}
+		first = last + 1;
 	}
 	for (uint a = 0; a < pageFromMasterCount; ++a)
 	{
@@ -1436,6 +1649,136 @@ void Canvas::DrawMasterItems(ScPainter *painter, Page *page, ScLayer& layer, QRe
 }
 
 
+void Canvas::drawMasterItem(ScPainter *painter, Page *page, Page *masterPage, PageItem* currItem, QRectF cullingArea)
+{
+	double OldX = currItem->xPos();
+	double OldY = currItem->yPos();
+	double OldBX = currItem->BoundingX;
+	double OldBY = currItem->BoundingY;
+	if (!currItem->ChangedMasterItem)
+	{
+		//Hack to not check for undo changes, indicate drawing only
+		currItem->moveBy(-masterPage->xOffset() + page->xOffset(), -masterPage->yOffset() + page->yOffset(), true);
+		currItem->BoundingX = OldBX - masterPage->xOffset() + page->xOffset();
+		currItem->BoundingY = OldBY - masterPage->yOffset() + page->yOffset();
+	}
+	currItem->savedOwnPage = currItem->OwnPage;
+	currItem->OwnPage = page->pageNr();
+//FIXME						if (!evSpon || forceRedraw)
+//					currItem->invalid = true;
+	if (cullingArea.intersects(currItem->getBoundingRect().adjusted(0.0, 0.0, 1.0, 1.0)))
+	{
+		if (!((m_viewMode.operItemMoving) && (currItem->isSelected())))
+		{
+			if (m_viewMode.forceRedraw)
+				currItem->invalidateLayout();
+			currItem->DrawObj(painter, cullingArea);
+			currItem->DrawObj_Decoration(painter);
+		}
+//							else 
+//								qDebug() << "skip masterpage item (move/resizeEdit/selected)" << m_viewMode.operItemMoving << currItem->isSelected();
+	}
+	currItem->OwnPage = currItem->savedOwnPage;
+	if (!currItem->ChangedMasterItem)
+	{
+		//Hack to not check for undo changes, indicate drawing only
+		currItem->setXYPos(OldX, OldY, true);
+		currItem->BoundingX = OldBX;
+		currItem->BoundingY = OldBY;
+	}
+}
+
+
+bool Canvas::drawMasterImage(ScPainter *painter, Page *page, Page *masterPage, const QList<PageItem*>& items, bool perPage, QRectF cullingArea)
+{
+	double scale = m_viewMode.scale;
+	QPointF origin(m_doc->minCanvasCoordinate.x(), m_doc->minCanvasCoordinate.y());
+	int state = viewState(items.first());
+	QList<int> generations;
+	for (int i = 0; i < items.count(); ++i)
+		generations.append(masterItemGeneration(items[i]));
+	// A shared image is placed at whole pixels relative to each page, which may
+	// shift it by less than a pixel from where the items would be drawn.
+	QPoint pagePosition(qRound((page->xOffset() - origin.x()) * scale), qRound((page->yOffset() - origin.y()) * scale));
+	QString key = QString("%1 %2").arg(reinterpret_cast<quintptr>(items.first())).arg(perPage ? static_cast<int>(page->pageNr()) : -1);
+	MasterImage* cached = m_masterImages.object(key);
+	if ((cached == NULL) || (cached->scale != scale) || (cached->viewState != state) || (cached->items != items) || (cached->generations != generations))
+	{
+		double dx = page->xOffset() - masterPage->xOffset();
+		double dy = page->yOffset() - masterPage->yOffset();
+		QRectF bounds;
+		for (int i = 0; i < items.count(); ++i)
+			bounds |= items[i]->getVisualBoundingRect().translated(dx, dy);
+		QRectF deviceBounds((bounds.x() - origin.x()) * scale, (bounds.y() - origin.y()) * scale, bounds.width() * scale, bounds.height() * scale);
+		// some room for antialiasing
+		QRect rect = deviceBounds.toAlignedRect().adjusted(-2, -2, 2, 2);
+		QRectF area(origin.x() + rect.x() / scale, origin.y() + rect.y() / scale, rect.width() / scale, rect.height() / scale);
+		// nothing to draw, leave rendering to a page where the items are visible
+		if (!area.intersects(cullingArea))
+			return true;
+		int cost = qMax(1, rect.width() * rect.height() / 256);
+		if (rect.isEmpty() || (static_cast<double>(rect.width()) * rect.height() > 2048.0 * 2048.0) || (cost > m_masterImages.maxCost()))
+			return false;
+		QImage img(rect.size(), QImage::Format_ARGB32_Premultiplied);
+		img.fill(0);
+		ScPainter *p = new ScPainter(&img, img.width(), img.height(), 1.0, 0);
+		p->translate(-rect.x(), -rect.y());
+		p->setZoomFactor(scale);
+		p->translate(-origin.x(), -origin.y());
+		p->setLineWidth(1);
+		p->setFillMode(ScPainter::Solid);
+		for (int i = 0; i < items.count(); ++i)
+		{
+			drawMasterItem(p, page, masterPage, items[i], area);
+			// moving the item around for drawing is no change
+			m_masterItemStates[items[i]].revision = ItemRenderCache::itemRevision(items[i]);
+		}
+		p->end();
+		delete p;
+		cached = new MasterImage;
+		// ScPainter::drawImage() expects the colors not to be premultiplied
+		cached->image = img.convertToFormat(QImage::Format_ARGB32);
+		cached->offset = rect.topLeft() - pagePosition;
+		cached->scale = scale;
+		cached->viewState = state;
+		cached->items = items;
+		cached->generations = generations;
+		m_masterImages.insert(key, cached, cost);
+	}
+	QRect target(pagePosition + cached->offset, cached->image.size());
+	QRectF area(origin.x() + target.x() / scale, origin.y() + target.y() / scale, target.width() / scale, target.height() / scale);
+	if (!area.intersects(cullingArea))
+		return true;
+	painter->save();
+	painter->translate(origin.x(), origin.y());
+	painter->scale(1.0 / scale, 1.0 / scale);
+	painter->translate(target.x(), target.y());
+	painter->setBrushOpacity(1.0);
+	painter->setMaskMode(0);
+	painter->setBlendModeFill(0);
+	painter->drawImage(&cached->image);
+	painter->restore();
+	return true;
+}
+
+
+int Canvas::masterItemGeneration(PageItem* item)
+{
+	// text which still has to be laid out will look different
+	if (item->invalid && (item->asTextFrame() || item->asPathText()))
+		item->increaseRevision();
+	uint revision = ItemRenderCache::itemRevision(item);
+	MasterItemState& state = m_masterItemStates[item];
+	if (state.revision != revision)
+	{
+		state.revision = revision;
+		++state.generation;
+		state.showsPageNumber = showsPageNumber(item);
+	}
+	return state.generation;
+}
+
+
 /**
   draws page items contained in a specific Layer
  */
@@ -1458,11 +1801,14 @@ void Canvas::DrawPageItems(ScPainter *painter, ScLayer& layer, QRect clip)
 	PageItem *currItem;
 	uint layerCount = m_doc->layerCount();
 	int docCurrPageNo=static_cast<int>(m_doc->currentPageNumber());
+	m_itemCache.setMaxSize(PrefsManager::instance()->appPrefs.displayPrefs.itemCacheSize);
+	// the culling test below is done with bounds one point larger
+	QList<int> visibleItems = m_doc->itemsInArea(cullingArea.adjusted(-1.0, -1.0, 0.0, 0.0));
 	if ((layerCount > 1) && ((layer.blendMode != 0) || (layer.transparency != 1.0)) && (!layer.outlineMode))
 		painter->beginLayer(layer.transparency, layer.blendMode);
-	for (int it = 0; it < m_doc->Items->count(); ++it)
+	for (int it = 0; it < visibleItems.count(); ++it)
 	{
-		currItem = m_doc->Items->at(it);
+		currItem = m_doc->Items->at(visibleItems[it]);
 		if (currItem->LayerID != layer.ID)
 			continue;
 		if ((m_viewMode.previewMode) && (!currItem->printEnabled()))
@@ -1488,7 +1834,7 @@ void Canvas::DrawPageItems(ScPainter *painter, ScLayer& layer, QRect clip)
 			else if(m_viewMode.operItemSelecting)
 			{
 				currItem->invalid = false;
-				currItem->DrawObj(painter, cullingArea);
+				drawItem(painter, currItem, cullingArea);
 				currItem->DrawObj_Decoration(painter);
 			}
 			else
@@ -1497,7 +1843,7 @@ void Canvas::DrawPageItems(ScPainter *painter, ScLayer& layer, QRect clip)
 				// alter the "data". And it really prevents optimisation - pm
 // 							if (m_viewMode.forceRedraw)
 // 								currItem->invalidateLayout();
-				currItem->DrawObj(painter, cullingArea);
+				drawItem(painter, currItem, cullingArea);
 				currItem->DrawObj_Decoration(painter);
 			}
 //						currItem->Redrawn = true;
@@ -1524,9 +1870,9 @@ void Canvas::DrawPageItems(ScPainter *painter, ScLayer& layer, QRect clip)
 			}
 		}
 	}
-	for (int it = 0; it < m_doc->Items->count(); ++it)
+	for (int it = 0; it < visibleItems.count(); ++it)
 	{
-		currItem = m_doc->Items->at(it);
+		currItem = m_doc->Items->at(visibleItems[it]);
 		if (currItem->LayerID != layer.ID)
 			continue;
 		if (!currItem->isTableItem)
@@ -1564,6 +1910,56 @@ void Canvas::DrawPageItems(ScPainter *painter, ScLayer& layer, QRect clip)
 		painter->endLayer();
 }
 
+
+void Canvas::drawItem(ScPainter *painter, PageItem* item, QRectF cullingArea)
+{
+	// text being edited shows the cursor and the selection
+	bool editing = (m_doc->appMode == modeEdit) || (m_doc->appMode == modeEditTable);
+	if (!m_doc->RePos && !(editing && (item->asTextFrame() || item->asPathText() || item->isTable() || item->isGroup())))
+	{
+		QPointF origin(m_doc->minCanvasCoordinate.x(), m_doc->minCanvasCoordinate.y());
+		if (m_itemCache.drawItem(painter, item, m_viewMode.scale, origin, viewState(item)))
+			return;
+	}
+	item->DrawObj(painter, cullingArea);
+}
+
+
+int Canvas::viewState(PageItem* item) const
+{
+	int state = 0;
+	if (m_viewMode.previewMode)
+		state |= 1;
+	if (m_viewMode.viewAsPreview || m_doc->viewAsPreview)
+		state |= 2;
+	if (m_doc->drawAsPreview)
+		state |= 4;
+	if (m_doc->layerOutline(item->LayerID))
+		state |= 8;
+	if (m_doc->guidesPrefs().framesShown)
+		state |= 16;
+	if (m_doc->guidesPrefs().colBordersShown)
+		state |= 32;
+	if (m_doc->guidesPrefs().layerMarkersShown)
+		state |= 64;
+	if (m_doc->guidesPrefs().showControls)
+		state |= 128;
+	if ((m_doc->appMode == modeEdit) || (m_doc->appMode == modeEditTable))
+		state |= 256;
+	return state;
+}
+
+
+void Canvas::invalidateItemCache(const QRectF& region)
+{
+	for (int i = 0; i < m_doc->m_Selection->count(); ++i)
+	{
+		PageItem* item = m_doc->m_Selection->itemAt(i);
+		if (!region.isValid() || region.intersects(item->getVisualBoundingRect()))
+			m_itemCache.invalidate(item);
+	}
+}
+
 /**
   Draws the canvas background for masterpages, incl. bleeds
  */
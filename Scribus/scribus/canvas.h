@@ -25,7 +25,11 @@ scribusview.h  -  description
 #define CANVAS_H
 
 #include <QApplication>
+#include <QCache>
 //#include <QDebug>
+#include <QHash>
+#include <QImage>
+#include <QPixmap>
 #include <QPolygon>
 #include <QRect>
 #include <QWidget>
@@ -35,9 +39,12 @@ scribusview.h  -  description
 #include "commonstrings.h"
 #include "fpoint.h"
 #include "fpointarray.h"
+#include "itemrendercache.h"
 #include "pageitempointer.h"
 
 
+class QTimer;
+
 class Page;
 class PageItem;
 class ScLayer;
@@ -138,6 +145,10 @@ public:
 	void setRenderMode(RenderMode m);
 	
 	void clearBuffers();              // very expensive
+	/// drops the rendered images of all items, including those of the master pages
+	void clearItemCache() { m_itemCache.clear(); m_masterImages.clear(); m_masterItemStates.clear(); }
+	/// drops the rendered images of the selected items touching region, of all selected items if region is not valid
+	void invalidateItemCache(const QRectF& region);
 	
 	// deprecated:
 	void resetRenderMode() { m_renderMode = RENDER_NORMAL; clearBuffers(); }
@@ -209,6 +220,20 @@ public:
 	
 private:
 	void DrawPageMarks(ScPainter *p, Page* page, QRect clip);
+	/// draws item from m_itemCache if possible
+	void drawItem(ScPainter *painter, PageItem* item, QRectF cullingArea);
+	/// the view settings which change how item is drawn, as bits
+	int viewState(PageItem* item) const;
+	/// draws item of masterPage moved onto page
+	void drawMasterItem(ScPainter *painter, Page *page, Page *masterPage, PageItem* item, QRectF cullingArea);
+	/**
+		Draws items of masterPage moved onto page from an image in m_masterImages.
+		The image is shared by all pages unless perPage is true.
+		Returns false if the items can not be cached, they are not drawn in that case.
+	 */
+	bool drawMasterImage(ScPainter *painter, Page *page, Page *masterPage, const QList<PageItem*>& items, bool perPage, QRectF cullingArea);
+	/// a number which changes whenever item changed after it was drawn by DrawMasterItems()
+	int masterItemGeneration(PageItem* item);
 	void drawLinkFrameLine(ScPainter* painter, FPoint &start, FPoint &end);
 	void PaintSizeRect(QRect neu);
 	void PaintSizeRect(QPolygon neu);
@@ -226,6 +251,11 @@ private:
 	    bufferOrigin and clipRect are in local coordinates
 	 */
 	void fillBuffer(QPaintDevice* buffer, QPoint bufferOrigin, QRect clipRect);
+	/**
+		Renders clipRect again after the contents changed and updates the buffer
+	    and the cached tiles. clipRect is in local coordinates
+	 */
+	void redrawBuffer(QRect clipRect);
 	void drawContents(QPainter *p, int clipx, int clipy, int clipw, int cliph);
 	void drawBackgroundMasterpage(ScPainter* painter, int clipx, int clipy, int clipw, int cliph);
 	void drawBackgroundPageOutlines(ScPainter* painter, int clipx, int clipy, int clipw, int cliph);
@@ -251,6 +281,45 @@ private:
 	QPixmap m_selectionBuffer;
 	QRect   m_selectionRect;
 	QPoint  m_oldMinCanvasCoordinate;
+	ItemRenderCache m_itemCache;
+	struct MasterImage
+	{
+		QImage image;
+		QPoint offset; // relative to the page origin in device pixels
+		double scale;
+		int viewState;
+		QList<PageItem*> items;
+		QList<int> generations;
+	};
+	/// rendered master page items, keyed by the first item and the page for per page images
+	QCache<QString, MasterImage> m_masterImages;
+	struct MasterItemState
+	{
+		uint revision; // when the item was last drawn or looked at
+		int generation; // counts the changes seen
+		bool showsPageNumber;
+
+		MasterItemState() : revision(0), generation(0), showsPageNumber(false) {}
+	};
+	QHash<PageItem*, MasterItemState> m_masterItemStates;
+	/// rendered contents in tiles of TileSize x TileSize, see tileRect()
+	QCache<quint64, QPixmap> m_tiles;
+	double  m_tileScale;
+	QTimer* m_tilePrefetchTimer;
+
+	/// the tile (column, row) in local coordinates, tile (0, 0) starts at canvas point (0, 0)
+	QRect tileRect(int column, int row) const;
+	/// the range of tiles covering rect
+	void tileRange(QRect rect, int& column1, int& row1, int& column2, int& row2) const;
+	static quint64 tileKey(int column, int row);
+	/// renders the tiles in the given range which are not cached yet
+	void renderTiles(int column1, int row1, int column2, int row2);
+	/// drops the tiles not completely inside rect
+	void dropTilesOutside(QRect rect);
+
+private slots:
+	/// renders one row of missing tiles around the viewport and reschedules itself if there are more
+	void prefetchTiles();
 };
 
 
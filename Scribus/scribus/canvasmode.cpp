@@ -913,6 +913,7 @@ void CanvasMode::commonkeyPressEvent_NormalNodeEdit(QKeyEvent *e)
 			{
 				m_view->Deselect(false);
 				m_doc->Items->removeAt(currItem->ItemNr);
+				m_doc->itemListChanged();
 			}
 			else
 				m_view->Deselect(false);
@@ -91,6 +91,7 @@ void BezierMode::finalizeItem(PageItem* currItem)
 	{
 //		emit DelObj(m_doc->currentPage->pageNr(), currItem->ItemNr);
 		m_doc->Items->removeAt(currItem->ItemNr);
+		m_doc->itemListChanged();
 		m_doc->m_Selection->removeFirst();
 		//emit HaveSel(-1);
 	}
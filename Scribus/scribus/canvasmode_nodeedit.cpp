@@ -912,6 +912,7 @@ void CanvasMode_NodeEdit::handleNodeEditPress(QMouseEvent* m, QRect)
 						bb->ClipEdited = true;
 						PageItem *bx = m_doc->Items->takeAt(bb->ItemNr);
 						m_doc->Items->insert(bb->ItemNr-1, bx);
+						m_doc->itemListChanged();
 					}
 					currItem->PoLine = cli.copy();
 				}
@@ -972,8 +972,12 @@ void CanvasMode_Normal::mouseReleaseEvent(QMouseEvent *m)
 		if (docItemCount != 0)
 		{
 			m_doc->m_Selection->delaySignalsOn();
-			for (int a = 0; a < docItemCount; ++a)
+			// items inside the selection rectangle intersect it, allow for rounding to screen pixels
+			double margin = 2.0 / m_canvas->scale();
+			QList<int> candidates = m_doc->itemsInArea(canvasSele.adjusted(-margin, -margin, margin, margin));
+			for (int i = 0; i < candidates.count(); ++i)
 			{
+				int a = candidates[i];
 				PageItem* docItem = m_doc->Items->at(a);
 				if ((m_doc->masterPageMode()) && (docItem->OnMasterPage != m_doc->currentPage()->pageName()))
 					continue;
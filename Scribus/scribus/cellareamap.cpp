@@ -0,0 +1,59 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+
+#include "cellareamap.h"
+
+CellAreaMap::CellAreaMap() : m_rows(0), m_columns(0)
+{
+}
+
+void CellAreaMap::build(int rows, int columns, const QList<CellArea>& areas)
+{
+	clear();
+	m_rows = qMax(rows, 0);
+	m_columns = qMax(columns, 0);
+	if (areas.isEmpty())
+		return;
+
+	m_areas = areas;
+	m_owners.fill(-1, m_rows * m_columns);
+	for (int i = 0; i < m_areas.count(); ++i)
+	{
+		const CellArea& area = m_areas.at(i);
+		if (!area.isValid())
+			continue;
+		const int lastRow = qMin(area.bottom(), m_rows - 1);
+		const int lastColumn = qMin(area.right(), m_columns - 1);
+		for (int row = qMax(area.row(), 0); row <= lastRow; ++row)
+		{
+			for (int column = qMax(area.column(), 0); column <= lastColumn; ++column)
+			{
+				// Areas should not intersect, if they do the first one wins like in a linear search.
+				int& owner = m_owners[row * m_columns + column];
+				if (owner < 0)
+					owner = i;
+			}
+		}
+	}
+}
+
+void CellAreaMap::clear()
+{
+	m_rows = 0;
+	m_columns = 0;
+	m_areas.clear();
+	m_owners.clear();
+}
+
+CellArea CellAreaMap::areaAt(int row, int column) const
+{
+	if (m_owners.isEmpty() || row < 0 || row >= m_rows || column < 0 || column >= m_columns)
+		return CellArea();
+
+	const int owner = m_owners.at(row * m_columns + column);
+	return owner < 0 ? CellArea() : m_areas.at(owner);
+}
@@ -0,0 +1,56 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#ifndef CELLAREAMAP_H
+#define CELLAREAMAP_H
+
+#include <QList>
+#include <QVector>
+
+#include "cellarea.h"
+
+/**
+ * The CellAreaMap class finds the area of merged cells covering a table cell in constant time.
+ *
+ * The map is built from the dimensions of a table and its list of areas of merged cells, and
+ * stores for every cell the index of the area covering it. It has to be built again whenever
+ * the areas or the dimensions of the table change. A map of a table without merged cells
+ * takes no memory.
+ */
+class CellAreaMap
+{
+public:
+	/// Constructs an empty map.
+	CellAreaMap();
+
+	/// Builds the map for a table with @a rows rows and @a columns columns and merged @a areas.
+	void build(int rows, int columns, const QList<CellArea>& areas);
+	/// Makes this an empty map.
+	void clear();
+
+	/// Returns the number of rows the map was built for.
+	int rows() const { return m_rows; }
+	/// Returns the number of columns the map was built for.
+	int columns() const { return m_columns; }
+
+	/**
+	 * Returns the area of merged cells containing the cell at @a row, @a column, or an invalid
+	 * area if that cell is not merged or outside of the table.
+	 */
+	CellArea areaAt(int row, int column) const;
+
+private:
+	/// Number of rows.
+	int m_rows;
+	/// Number of columns.
+	int m_columns;
+	/// Areas of merged cells.
+	QList<CellArea> m_areas;
+	/// Index into m_areas for each cell in row major order, -1 for cells not merged.
+	QVector<int> m_owners;
+};
+
+#endif // CELLAREAMAP_H
@@ -9,10 +9,13 @@ for which a new license (GPL+exception) is in place.
 #include <QColor>
 #include <QLineF>
 #include <QRectF>
+#include <QtAlgorithms>
 
+#include "commonstrings.h"
 #include "scpainter.h"
 #include "tablecell.h"
 #include "pageitem_table.h"
+#include "pageitem_textframe.h"
 #include "prefsmanager.h"
 #include "scribusdoc.h"
 #include "tableborder.h"
@@ -22,14 +25,46 @@ for which a new license (GPL+exception) is in place.
 
 using namespace TableUtils;
 
-void CollapsedTablePainter::paintTable(ScPainter* p)
+CollapsedTablePainter::~CollapsedTablePainter()
 {
+	delete m_sharedTextFrame;
+}
+
+void CollapsedTablePainter::paintTable(ScPainter* p, const QRectF& area)
+{
+	const QPointF gridOffset = table()->gridOffset();
+
 	p->save();
-	p->translate(table()->gridOffset());
+	p->translate(gridOffset);
 
 	// Paint table fill.
 	paintTableFill(p);
 
+	// Determine the rows and columns to paint.
+	int firstRow = 0;
+	int lastRow = table()->rows() - 1;
+	int firstCol = 0;
+	int lastCol = table()->columns() - 1;
+	if (!area.isNull())
+	{
+		QRectF gridArea = area.translated(-gridOffset);
+		visibleRange(table()->rowPositions(), gridArea.top(), gridArea.bottom(), &firstRow, &lastRow);
+		visibleRange(table()->columnPositions(), gridArea.left(), gridArea.right(), &firstCol, &lastCol);
+	}
+
+	// Collect the cells to paint, each once, including merged cells starting outside the range.
+	QList<TableCell> cells;
+	for (int row = firstRow; row <= lastRow; ++row)
+	{
+		for (int col = firstCol; col <= lastCol; )
+		{
+			TableCell cell = table()->cellAt(row, col);
+			if (row == cell.row() || row == firstRow)
+				cells.append(cell);
+			col = cell.column() + cell.columnSpan();
+		}
+	}
+
 	/*
 	 * We paint the table in five passes:
 	 *
@@ -41,101 +76,71 @@ void CollapsedTablePainter::paintTable(ScPainter* p)
 	 */
 
 	// Pass 1: Paint cell fills.
-	for (int row = 0; row < table()->rows(); ++row)
-	{
-		int colSpan = 0;
-		for (int col = 0; col < table()->columns(); col += colSpan)
-		{
-			TableCell cell = table()->cellAt(row, col);
-			if (row == cell.row())
-				paintCellFill(cell, p);
-			colSpan = cell.columnSpan();
-		}
-	}
+	foreach (const TableCell& cell, cells)
+		paintCellFill(cell, p);
 
 	// Pass 2: Paint vertical borders.
-	for (int row = 0; row < table()->rows(); ++row)
+	foreach (const TableCell& cell, cells)
 	{
-		int colSpan = 0;
-		for (int col = 0; col < table()->columns(); col += colSpan)
-		{
-			TableCell cell = table()->cellAt(row, col);
-			if (row == cell.row())
-			{
-				paintCellRightBorders(cell, p);
-				if (col == 0)
-					paintCellLeftBorders(cell, p);
-			}
-			colSpan = cell.columnSpan();
-		}
+		paintCellBorders(cell, RightSide, p);
+		if (cell.column() == 0)
+			paintCellBorders(cell, LeftSide, p);
 	}
 
 	// Pass 3: Paint horizontal borders.
-	for (int row = 0; row < table()->rows(); ++row)
+	foreach (const TableCell& cell, cells)
 	{
-		int colSpan = 0;
-		for (int col = 0; col < table()->columns(); col += colSpan)
-		{
-			TableCell cell = table()->cellAt(row, col);
-			if (row == cell.row())
-			{
-				paintCellBottomBorders(cell, p);
-				if (row == 0)
-					paintCellTopBorders(cell, p);
-			}
-			colSpan = cell.columnSpan();
-		}
+		paintCellBorders(cell, BottomSide, p);
+		if (cell.row() == 0)
+			paintCellBorders(cell, TopSide, p);
 	}
 
 	// Pass 4: Paint grid lines.
 	if (table()->m_Doc->guidesPrefs().framesShown)
 	{
-		for (int row = 0; row < table()->rows(); ++row)
+		foreach (const TableCell& cell, cells)
 		{
-			int colSpan = 0;
-			for (int col = 0; col < table()->columns(); col += colSpan)
-			{
-				TableCell cell = table()->cellAt(row, col);
-				if (row == cell.row())
-				{
-					int endCol = col + cell.columnSpan() - 1;
-					int endRow = row + cell.rowSpan() - 1;
-					qreal left = table()->columnPosition(col);
-					qreal right = table()->columnPosition(endCol) + table()->columnWidth(endCol);
-					qreal top = table()->rowPosition(row);
-					qreal bottom = table()->rowPosition(endRow) + table()->rowHeight(endRow);
-					// Paint right and bottom grid line.
-					paintGridLine(QPointF(right, top), QPointF(right, bottom), p);
-					paintGridLine(QPointF(left, bottom), QPointF(right, bottom), p);
-					// Paint left and top grid line.
-					if (col == 0)
-						paintGridLine(QPointF(left, top), QPointF(left, bottom), p);
-					if (row == 0)
-						paintGridLine(QPointF(left, top), QPointF(right, top), p);
-				}
-				colSpan = cell.columnSpan();
-			}
+			int row = cell.row();
+			int col = cell.column();
+			int endCol = col + cell.columnSpan() - 1;
+			int endRow = row + cell.rowSpan() - 1;
+			qreal left = table()->columnPosition(col);
+			qreal right = table()->columnPosition(endCol) + table()->columnWidth(endCol);
+			qreal top = table()->rowPosition(row);
+			qreal bottom = table()->rowPosition(endRow) + table()->rowHeight(endRow);
+			// Paint right and bottom grid line.
+			paintGridLine(QPointF(right, top), QPointF(right, bottom), p);
+			paintGridLine(QPointF(left, bottom), QPointF(right, bottom), p);
+			// Paint left and top grid line.
+			if (col == 0)
+				paintGridLine(QPointF(left, top), QPointF(left, bottom), p);
+			if (row == 0)
+				paintGridLine(QPointF(left, top), QPointF(right, top), p);
 		}
 	}
 
 	// Pass 5: Paint cell content.
-	for (int row = 0; row < table()->rows(); ++row)
-	{
-		for (int col = 0; col < table()->columns(); col ++)
-		{
-			TableCell cell = table()->cellAt(row, col);
-			if (cell.row() == row && cell.column() == col)
-			{
-				PageItem* textFrame = cell.textFrame();
-				textFrame->DrawObj(p, QRectF());
-				textFrame->DrawObj_Decoration(p);
-			}
-		}
-	}
+	foreach (const TableCell& cell, cells)
+		paintCellContent(cell, p);
 
 	p->restore();
 }
 
+void CollapsedTablePainter::visibleRange(const QList<qreal>& positions, qreal start, qreal end,
+	int* first, int* last)
+{
+	Q_ASSERT(first);
+	Q_ASSERT(last);
+
+	const int count = positions.count();
+	// Positions are ascending, so an end of the interval lies in the last row/column starting before it.
+	*first = qUpperBound(positions, start) - positions.begin() - 1;
+	*last = qUpperBound(positions, end) - positions.begin() - 1;
+
+	*first = qBound(0, *first - 1, count - 1);
+	*last = qBound(0, *last + 1, count - 1);
+}
+
 void CollapsedTablePainter::paintTableFill(ScPainter* p) const
 {
 	QString colorName = table()->fillColor();
@@ -371,10 +376,10 @@ void CollapsedTablePainter::resolveBordersHorizontal(const TableCell& topLeftCel
 		*bottomRight = TableBorder();
 }
 
-void CollapsedTablePainter::paintCellLeftBorders(const TableCell& cell, ScPainter* p) const
+void CollapsedTablePainter::resolveCellLeftBorders(const TableCell& cell, QList<BorderSegment>* segments) const
 {
 	/*
-	 * We are going to paint the border marked # in the following setup.
+	 * We are going to resolve the border marked # in the following setup.
 	 *
 	 *       +----------------------+----------------------+
 	 *       |                      |                      |
@@ -432,7 +437,7 @@ void CollapsedTablePainter::paintCellLeftBorders(const TableCell& cell, ScPainte
 			&topLeft, &top, &topRight, &border, &bottomLeft, &bottom, &bottomRight);
 
 		if (border.isNull())
-			continue; // Quit early if the border to paint is null.
+			continue; // Skip the segment if the border is null.
 
 		// Set initial coordinates.
 		start.setY(table()->rowPosition(startRow));
@@ -442,15 +447,21 @@ void CollapsedTablePainter::paintCellLeftBorders(const TableCell& cell, ScPainte
 		joinVertical(border, topLeft, top, topRight, bottomLeft, bottom, bottomRight,
 			 &start, &end, &startOffsetFactors, &endOffsetFactors);
 
-		// Paint the border segment.
-		paintBorder(border, start, end, startOffsetFactors, endOffsetFactors, p);
+		// Add the border segment.
+		BorderSegment segment;
+		segment.border = border;
+		segment.start = start;
+		segment.end = end;
+		segment.startOffsetFactors = startOffsetFactors;
+		segment.endOffsetFactors = endOffsetFactors;
+		segments->append(segment);
 	}
 }
 
-void CollapsedTablePainter::paintCellRightBorders(const TableCell& cell, ScPainter* p) const
+void CollapsedTablePainter::resolveCellRightBorders(const TableCell& cell, QList<BorderSegment>* segments) const
 {
 	/*
-	 * We are going to paint the border marked # in the following setup.
+	 * We are going to resolve the border marked # in the following setup.
 	 *
 	 *       +----------------------+----------------------+
 	 *       |                      |                      |
@@ -508,7 +519,7 @@ void CollapsedTablePainter::paintCellRightBorders(const TableCell& cell, ScPaint
 			&topLeft, &top, &topRight, &border, &bottomLeft, &bottom, &bottomRight);
 
 		if (border.isNull())
-			continue; // Quit early if the border to paint is null.
+			continue; // Skip the segment if the border is null.
 
 		// Set initial coordinates.
 		start.setY(table()->rowPosition(startRow));
@@ -518,15 +529,21 @@ void CollapsedTablePainter::paintCellRightBorders(const TableCell& cell, ScPaint
 		joinVertical(border, topLeft, top, topRight, bottomLeft, bottom, bottomRight,
 			 &start, &end, &startOffsetFactors, &endOffsetFactors);
 
-		// Paint the border.
-		paintBorder(border, start, end, startOffsetFactors, endOffsetFactors, p);
+		// Add the border segment.
+		BorderSegment segment;
+		segment.border = border;
+		segment.start = start;
+		segment.end = end;
+		segment.startOffsetFactors = startOffsetFactors;
+		segment.endOffsetFactors = endOffsetFactors;
+		segments->append(segment);
 	}
 }
 
-void CollapsedTablePainter::paintCellTopBorders(const TableCell& cell, ScPainter* p) const
+void CollapsedTablePainter::resolveCellTopBorders(const TableCell& cell, QList<BorderSegment>* segments) const
 {
 	/*
-	 * We are going to paint the border marked # in the following setup.
+	 * We are going to resolve the border marked # in the following setup.
 	 *
 	 *  +--------------------------+--------------------------+--------------------------+
 	 *  |                          |                          |                          |
@@ -577,7 +594,7 @@ void CollapsedTablePainter::paintCellTopBorders(const TableCell& cell, ScPainter
 			bottomRightCell, &topLeft, &left, &bottomLeft, &border, &topRight, &right, &bottomRight);
 
 		if (border.isNull())
-			continue; // Quit early if the border is null.
+			continue; // Skip the segment if the border is null.
 
 		// Set initial coordinates.
 		start.setX(table()->columnPosition(startCol));
@@ -587,15 +604,21 @@ void CollapsedTablePainter::paintCellTopBorders(const TableCell& cell, ScPainter
 		joinHorizontal(border, topLeft, left, bottomLeft, topRight, right, bottomRight,
 			 &start, &end, &startOffsetFactors, &endOffsetFactors);
 
-		// Paint the border segment.
-		paintBorder(border, start, end, startOffsetFactors, endOffsetFactors, p);
+		// Add the border segment.
+		BorderSegment segment;
+		segment.border = border;
+		segment.start = start;
+		segment.end = end;
+		segment.startOffsetFactors = startOffsetFactors;
+		segment.endOffsetFactors = endOffsetFactors;
+		segments->append(segment);
 	}
 }
 
-void CollapsedTablePainter::paintCellBottomBorders(const TableCell& cell, ScPainter* p) const
+void CollapsedTablePainter::resolveCellBottomBorders(const TableCell& cell, QList<BorderSegment>* segments) const
 {
 	/*
-	 * We are going to paint the border marked # in the following setup.
+	 * We are going to resolve the border marked # in the following setup.
 	 *
 	 *  +--------------------------+--------------------------+--------------------------+
 	 *  |                          |                          |                          |
@@ -646,7 +669,7 @@ void CollapsedTablePainter::paintCellBottomBorders(const TableCell& cell, ScPain
 			bottomRightCell, &topLeft, &left, &bottomLeft, &border, &topRight, &right, &bottomRight);
 
 		if (border.isNull())
-			continue; // Quit early if the border is null.
+			continue; // Skip the segment if the border is null.
 
 		// Set initial coordinates.
 		start.setX(table()->columnPosition(startCol));
@@ -656,11 +679,46 @@ void CollapsedTablePainter::paintCellBottomBorders(const TableCell& cell, ScPain
 		joinHorizontal(border, topLeft, left, bottomLeft, topRight, right, bottomRight,
 			 &start, &end, &startOffsetFactors, &endOffsetFactors);
 
-		// Paint the border segment.
-		paintBorder(border, start, end, startOffsetFactors, endOffsetFactors, p);
+		// Add the border segment.
+		BorderSegment segment;
+		segment.border = border;
+		segment.start = start;
+		segment.end = end;
+		segment.startOffsetFactors = startOffsetFactors;
+		segment.endOffsetFactors = endOffsetFactors;
+		segments->append(segment);
 	}
 }
 
+void CollapsedTablePainter::paintCellBorders(const TableCell& cell, CellSide side, ScPainter* p) const
+{
+	const quint64 key = borderKey(cell.row(), cell.column(), side);
+	QHash<quint64, QList<BorderSegment> >::iterator it = m_borderSegments.find(key);
+	if (it == m_borderSegments.end())
+	{
+		QList<BorderSegment> segments;
+		switch (side)
+		{
+			case LeftSide:
+				resolveCellLeftBorders(cell, &segments);
+				break;
+			case RightSide:
+				resolveCellRightBorders(cell, &segments);
+				break;
+			case TopSide:
+				resolveCellTopBorders(cell, &segments);
+				break;
+			case BottomSide:
+				resolveCellBottomBorders(cell, &segments);
+				break;
+		}
+		it = m_borderSegments.insert(key, segments);
+	}
+
+	foreach (const BorderSegment& segment, it.value())
+		paintBorder(segment.border, segment.start, segment.end, segment.startOffsetFactors, segment.endOffsetFactors, p);
+}
+
 void CollapsedTablePainter::paintCellFill(const TableCell& cell, ScPainter* p) const
 {
 	QString colorName = cell.fillColor();
@@ -690,6 +748,32 @@ void CollapsedTablePainter::paintCellFill(const TableCell& cell, ScPainter* p) c
 	p->restore();
 }
 
+void CollapsedTablePainter::paintCellContent(const TableCell& cell, ScPainter* p) const
+{
+	PageItem_TextFrame* textFrame;
+	if (cell.hasTextFrame())
+		textFrame = cell.textFrame();
+	else
+	{
+		// Lay out the plain text of the cell in the shared text frame.
+		if (!m_sharedTextFrame)
+			m_sharedTextFrame = new PageItem_TextFrame(table()->m_Doc,
+				0, 0, 0, 0, 0, CommonStrings::None, CommonStrings::None);
+		textFrame = m_sharedTextFrame;
+
+		const QRectF contentRect = cell.contentRect();
+		textFrame->itemText.clear();
+		textFrame->itemText.insertChars(0, cell.text());
+		textFrame->setXYPos(contentRect.x(), contentRect.y(), true);
+		textFrame->setWidthHeight(contentRect.width(), contentRect.height(), true);
+		textFrame->updateClip();
+		textFrame->invalidateLayout();
+	}
+
+	textFrame->DrawObj(p, QRectF());
+	textFrame->DrawObj_Decoration(p);
+}
+
 void CollapsedTablePainter::paintBorder(const TableBorder& border, const QPointF& start, const QPointF& end,
 										const QPointF& startOffsetFactors, const QPointF& endOffsetFactors,
 										ScPainter *p) const
@@ -726,3 +810,8 @@ void CollapsedTablePainter::paintGridLine(const QPointF& start, const QPointF& e
 	p->drawLine(start, end);
 	p->restore();
 }
+
+quint64 CollapsedTablePainter::borderKey(int row, int column, CellSide side)
+{
+	return (static_cast<quint64>(static_cast<quint32>(row)) << 32) | (static_cast<quint64>(column) << 2) | side;
+}
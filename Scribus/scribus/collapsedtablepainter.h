@@ -9,12 +9,16 @@ for which a new license (GPL+exception) is in place.
 #ifndef COLLAPSEDTABLEPAINTER_H
 #define COLLAPSEDTABLEPAINTER_H
 
+#include <QHash>
+#include <QList>
+#include <QPointF>
 #include <QtGlobal>
 
 #include "tablepainter.h"
 #include "tableborder.h"
 
 class PageItem_Table;
+class PageItem_TextFrame;
 class TableCell;
 class ScPainter;
 
@@ -25,24 +29,60 @@ class CollapsedTablePainter : public TablePainter
 {
 public:
 	/// Creates a new collapsed table painter configured to paint @a table.
-	explicit CollapsedTablePainter(PageItem_Table* table) : TablePainter(table) {}
+	explicit CollapsedTablePainter(PageItem_Table* table) : TablePainter(table), m_sharedTextFrame(0) {}
 
-	/// Paints the table using @a p and returns the table offset.
-	virtual void paintTable(ScPainter* p);
+	/// Destroys the painter.
+	~CollapsedTablePainter();
+
+	/// Paints the part of the table intersecting @a area using @a p.
+	virtual void paintTable(ScPainter* p, const QRectF& area);
+
+	/// Drops the cached collapsed borders.
+	virtual void invalidate() { m_borderSegments.clear(); }
 
 private:
+	/// The sides of a cell.
+	enum CellSide
+	{
+		LeftSide,
+		RightSide,
+		TopSide,
+		BottomSide
+	};
+
+	/// A resolved border segment along one side of a cell, ready to be painted.
+	struct BorderSegment
+	{
+		TableBorder border;
+		QPointF start;
+		QPointF end;
+		QPointF startOffsetFactors;
+		QPointF endOffsetFactors;
+	};
+
+	/**
+	 * Sets @a first and @a last to the range of rows or columns starting at @a positions which
+	 * intersect the interval from @a start to @a end, widened by one on each side to catch borders
+	 * reaching into the interval.
+	 */
+	static void visibleRange(const QList<qreal>& positions, qreal start, qreal end, int* first, int* last);
+
 	/// Paints the fill of the table.
 	void paintTableFill(ScPainter* p) const;
-	/// Paints all of the borders along the left side of @a cell.
-	void paintCellLeftBorders(const TableCell& cell, ScPainter* p) const;
-	/// Paints all of the borders along the right side of @a cell.
-	void paintCellRightBorders(const TableCell& cell, ScPainter* p) const;
-	/// Paints all of the borders along the top side of @a cell.
-	void paintCellTopBorders(const TableCell& cell, ScPainter* p) const;
-	/// Paints all of the borders along the bottom side of @a cell.
-	void paintCellBottomBorders(const TableCell& cell, ScPainter* p) const;
+	/// Paints all of the borders along @a side of @a cell, resolving them first if not cached.
+	void paintCellBorders(const TableCell& cell, CellSide side, ScPainter* p) const;
+	/// Resolves all of the borders along the left side of @a cell and appends them to @a segments.
+	void resolveCellLeftBorders(const TableCell& cell, QList<BorderSegment>* segments) const;
+	/// Resolves all of the borders along the right side of @a cell and appends them to @a segments.
+	void resolveCellRightBorders(const TableCell& cell, QList<BorderSegment>* segments) const;
+	/// Resolves all of the borders along the top side of @a cell and appends them to @a segments.
+	void resolveCellTopBorders(const TableCell& cell, QList<BorderSegment>* segments) const;
+	/// Resolves all of the borders along the bottom side of @a cell and appends them to @a segments.
+	void resolveCellBottomBorders(const TableCell& cell, QList<BorderSegment>* segments) const;
 	/// Paints the fill of @a cell.
 	void paintCellFill(const TableCell& cell, ScPainter* p) const;
+	/// Paints the content of @a cell, using a shared text frame if the cell has none of its own.
+	void paintCellContent(const TableCell& cell, ScPainter* p) const;
 
 	/**
 	 * Paints @a border from @a start to @a end.
@@ -144,6 +184,15 @@ private:
 		const TableCell& topRightCell, const TableCell& bottomLeftCell, const TableCell& bottomCell,
 		const TableCell& bottomRightCell, TableBorder* topLeft, TableBorder* left, TableBorder* bottomLeft,
 		TableBorder* center, TableBorder* topRight, TableBorder* right, TableBorder* bottomRight) const;
+
+	/// Returns the key of the cached border segments along @a side of the cell at @a row, @a column.
+	static quint64 borderKey(int row, int column, CellSide side);
+
+	/// Resolved border segments of the cells painted so far, until the table changes.
+	mutable QHash<quint64, QList<BorderSegment> > m_borderSegments;
+
+	/// Text frame for painting the plain text of cells without a text frame of their own.
+	mutable PageItem_TextFrame* m_sharedTextFrame;
 };
 
 #endif // COLLAPSEDTABLEPAINTER_H
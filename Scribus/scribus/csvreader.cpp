@@ -0,0 +1,106 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+
+#include <QTextStream>
+
+#include "csvreader.h"
+
+namespace {
+
+/// Number of characters read from the stream at once.
+const qint64 BlockSize = 64 * 1024;
+
+} // namespace
+
+CsvReader::CsvReader(QTextStream* stream, const QChar& fieldDelimiter, const QChar& valueDelimiter) :
+	m_stream(stream), m_fieldDelimiter(fieldDelimiter), m_valueDelimiter(valueDelimiter), m_position(0)
+{
+	Q_ASSERT(stream);
+}
+
+bool CsvReader::readRecord(QStringList& fields)
+{
+	fields.clear();
+	QString field;
+	// true while inside of an enclosed value
+	bool enclosed = false;
+	// true as soon as the record has any content, even if only an empty enclosed value
+	bool hasContent = false;
+	QChar c;
+	while (nextChar(c))
+	{
+		if (enclosed)
+		{
+			if (c != m_valueDelimiter)
+				field += c;
+			else if (skipChar(m_valueDelimiter))
+				field += c;
+			else
+				enclosed = false;
+		}
+		else if (c == '\n' || c == '\r')
+		{
+			if (c == '\r')
+				skipChar(QChar('\n'));
+			if (!hasContent)
+				continue;
+			fields.append(field);
+			return true;
+		}
+		else
+		{
+			hasContent = true;
+			if (c == m_fieldDelimiter)
+			{
+				fields.append(field);
+				field.clear();
+			}
+			else if (!m_valueDelimiter.isNull() && c == m_valueDelimiter)
+				enclosed = true;
+			else
+				field += c;
+		}
+	}
+	if (!hasContent)
+		return false;
+	fields.append(field);
+	return true;
+}
+
+QList<QStringList> CsvReader::readAll()
+{
+	QList<QStringList> records;
+	QStringList fields;
+	while (readRecord(fields))
+		records.append(fields);
+	return records;
+}
+
+bool CsvReader::fillBuffer()
+{
+	if (m_position < m_buffer.length())
+		return true;
+	m_buffer = m_stream->read(BlockSize);
+	m_position = 0;
+	return !m_buffer.isEmpty();
+}
+
+bool CsvReader::nextChar(QChar& c)
+{
+	if (!fillBuffer())
+		return false;
+	c = m_buffer.at(m_position++);
+	return true;
+}
+
+bool CsvReader::skipChar(const QChar& c)
+{
+	if (!fillBuffer() || m_buffer.at(m_position) != c)
+		return false;
+	++m_position;
+	return true;
+}
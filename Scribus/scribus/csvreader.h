@@ -0,0 +1,59 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#ifndef CSVREADER_H
+#define CSVREADER_H
+
+#include <QChar>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "scribusapi.h"
+
+class QTextStream;
+
+/**
+ * The CsvReader class reads records of comma separated values from a text stream.
+ *
+ * Values are separated by the field delimiter and records by line breaks. A value may be
+ * enclosed in value delimiters, in which case it may contain field delimiters and line breaks,
+ * and two value delimiters in a row stand for one. Values are returned as they are, without
+ * trimming. Empty lines are skipped. The stream is read in blocks, so records can be processed
+ * one at a time without loading the whole input first.
+ */
+class SCRIBUS_API CsvReader
+{
+public:
+	/**
+	 * Constructs a reader for @a stream. If @a valueDelimiter is null, values can not be
+	 * enclosed and value delimiters are read like any other character.
+	 */
+	explicit CsvReader(QTextStream* stream, const QChar& fieldDelimiter = QChar(','),
+		const QChar& valueDelimiter = QChar('"'));
+
+	/// Reads the next record into @a fields. Returns <code>false</code> if there are no more records.
+	bool readRecord(QStringList& fields);
+
+	/// Reads all remaining records.
+	QList<QStringList> readAll();
+
+private:
+	/// Makes sure there are unread characters in the buffer. Returns <code>false</code> at the end of the stream.
+	bool fillBuffer();
+	/// Reads the next character into @a c. Returns <code>false</code> at the end of the stream.
+	bool nextChar(QChar& c);
+	/// Returns <code>true</code> and skips the next character if it is @a c.
+	bool skipChar(const QChar& c);
+
+	QTextStream* m_stream;
+	QChar m_fieldDelimiter;
+	QChar m_valueDelimiter;
+	QString m_buffer;
+	int m_position;
+};
+
+#endif // CSVREADER_H
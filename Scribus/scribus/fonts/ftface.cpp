@@ -128,6 +128,7 @@ void FtFace::load() const
 	
 	while ( gindex != 0 )
 	{
+		setCMap(charcode, gindex);
 		error = FT_Load_Glyph( m_face, gindex, FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP );
 		if (error)
 		{
@@ -164,7 +165,14 @@ void FtFace::unload() const
 
 uint FtFace::char2CMap(QChar ch) const
 {
-	// FIXME use cMap cache
+	// m_cMap is filled by load() from the same charmap
+	if (!m_cMap.isEmpty())
+	{
+		++m_cacheStats.cMapHits;
+		const QVector<uint>& page(m_cMap.at(ch.unicode() >> 8));
+		return page.isEmpty() ? 0 : page.at(ch.unicode() & 0xFF);
+	}
+	++m_cacheStats.cMapMisses;
 	FT_Face face = ftFace();
 	uint gl = FT_Get_Char_Index(face, ch.unicode());
 	return gl;
@@ -173,7 +181,7 @@ uint FtFace::char2CMap(QChar ch) const
 
 void FtFace::loadGlyph(uint gl) const
 {
-	if (m_glyphWidth.contains(gl))
+	if (hasGlyphWidth(gl))
 		return;
 	
 	ScFace::GlyphData GRec;
@@ -181,7 +189,7 @@ void FtFace::loadGlyph(uint gl) const
 	if (FT_Load_Glyph( face, gl, FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP ))
 	{
 		sDebug(QObject::tr("Font %1 has broken glyph %2").arg(fontFile).arg(gl));
-		m_glyphWidth[gl] = 1;
+		setGlyphWidth(gl, 1);
 	}
 	else {
 		qreal ww = qreal(face->glyph->metrics.horiAdvance) / m_uniEM;
@@ -199,18 +207,18 @@ void FtFace::loadGlyph(uint gl) const
 		bool error = false;
 		error = FT_Set_Char_Size( face, 0, 10, 72, 72 );
 		if (error)
-			m_glyphWidth[gl] = 1;
+			setGlyphWidth(gl, 1);
 		FPointArray outlines = traceGlyph(face, gl, 10, &x, &y, &error);
 		if (!error)
 		{
-			m_glyphWidth[gl] = ww;
+			setGlyphWidth(gl, ww);
 			GRec.Outlines = outlines;
 			GRec.x = x;
 			GRec.y = y;
 			GRec.broken = false;
 		}
 		else {
-			m_glyphWidth[gl] = 1;
+			setGlyphWidth(gl, 1);
 		}
 	}
 	m_glyphOutline[gl] = GRec;
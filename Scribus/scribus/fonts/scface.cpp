@@ -36,6 +36,65 @@ qreal ScFace::ScFaceData::glyphKerning(uint /*gl1*/, uint /*gl2*/, qreal /*sz*/)
 }
 
 
+void ScFace::ScFaceData::setGlyphWidth(uint gl, qreal width) const
+{
+	if (gl >= uint(m_glyphWidth.size()))
+	{
+		int oldSize = m_glyphWidth.size();
+		m_glyphWidth.resize(qMax(gl, maxGlyph) + 1);
+		for (int i = oldSize; i < m_glyphWidth.size(); ++i)
+			m_glyphWidth[i] = qQNaN();
+	}
+	m_glyphWidth[gl] = width;
+}
+
+
+void ScFace::ScFaceData::removeGlyph(uint gl) const
+{
+	if (gl < uint(m_glyphWidth.size()))
+		m_glyphWidth[gl] = qQNaN();
+	m_glyphOutline.remove(gl);
+}
+
+
+void ScFace::ScFaceData::setCMap(uint ch, uint gl) const
+{
+	if (ch > 0xFFFF)
+		return;
+	if (m_cMap.isEmpty())
+		m_cMap.resize(256);
+	QVector<uint>& page(m_cMap[ch >> 8]);
+	if (page.isEmpty())
+		page.fill(0, 256);
+	page[ch & 0xFF] = gl;
+}
+
+
+qreal ScFace::ScFaceData::cachedKerning(uint gl1, uint gl2) const
+{
+	quint64 key = (quint64(gl1) << 32) | gl2;
+	QHash<quint64,qreal>::const_iterator it = m_glyphKerning.constFind(key);
+	if (it != m_glyphKerning.constEnd())
+	{
+		++m_cacheStats.kerningHits;
+		return it.value();
+	}
+	++m_cacheStats.kerningMisses;
+	qreal result = glyphKerning(gl1, gl2, 1.0);
+	m_glyphKerning.insert(key, result);
+	return result;
+}
+
+
+void ScFace::ScFaceData::clearCaches() const
+{
+	m_glyphWidth.clear();
+	m_glyphOutline.clear();
+	m_glyphKerning.clear();
+	m_cMap.clear();
+}
+
+
 bool ScFace::ScFaceData::glyphNames(QMap<uint, std::pair<QChar, QString> >& /*gList*/) const 
 { 
 	return false; 
@@ -57,7 +116,7 @@ GlyphMetrics ScFace::ScFaceData::glyphBBox(uint gl, qreal sz) const
 		res.descent = 0;
 		return res;
 	}
-	else if (! m_glyphWidth.contains(gl)) {
+	else if (! hasGlyphWidth(gl)) {
 		loadGlyph(gl);
 	}			
 	const struct GlyphData & data(m_glyphOutline[gl]);
@@ -74,9 +133,15 @@ qreal ScFace::ScFaceData::glyphWidth(uint gl, qreal size) const
 		return 0.0;
 	else if (gl == 0)
 		return size;
-	else if (! m_glyphWidth.contains(gl)) {
+	else if (hasGlyphWidth(gl)) {
+		++m_cacheStats.widthHits;
+	}
+	else {
+		++m_cacheStats.widthMisses;
 		loadGlyph(gl);
-	}		
+		if (! hasGlyphWidth(gl))
+			return 0.0;
+	}
 	return m_glyphWidth[gl] * size;
 }
 
@@ -94,7 +159,7 @@ FPointArray ScFace::ScFaceData::glyphOutline(uint gl, qreal sz) const
 		sq.addQuadPoint(0,sz,0,sz,0,0,0,0);
 		return sq;
 	}
-	else if (! m_glyphWidth.contains(gl)) {
+	else if (! hasGlyphWidth(gl)) {
 		loadGlyph(gl);
 	}			
 	FPointArray res = m_glyphOutline[gl].Outlines.copy();
@@ -108,7 +173,7 @@ FPoint ScFace::ScFaceData::glyphOrigin(uint gl, qreal sz) const
 {
 	if (gl == 0 || gl >= CONTROL_GLYPHS)
 		return FPoint(0,0);
-	else if (! m_glyphWidth.contains(gl)) {
+	else if (! hasGlyphWidth(gl)) {
 		loadGlyph(gl);
 	}			
 	const struct GlyphData & res(m_glyphOutline[gl]);
@@ -331,9 +396,7 @@ void ScFace::unload() const
 		m->unload();
 	}
 	// clear caches
-	m->m_glyphWidth.clear();
-	m->m_glyphOutline.clear();
-	m->m_cMap.clear();
+	m->clearCaches();
 	m->status = ScFace::UNKNOWN;
 }
 
@@ -391,6 +454,14 @@ bool ScFace::canRender(QChar ch) const
 }
 
 
+qreal ScFace::glyphKerning(uint gl1, uint gl2, qreal size) const
+{
+	if (qMax(gl1, gl2) >= CONTROL_GLYPHS)
+		return 0;
+	return m->cachedKerning(gl1, gl2) * size;
+}
+
+
 qreal ScFace::charWidth(QChar ch, qreal size, QChar ch2) const
 {
 	if (!canRender(ch)) // calls loadGlyph()
@@ -444,10 +515,9 @@ void ScFace::checkAllGlyphs()
 		return;
 	}
 	for (uint gl=0; gl <= m->maxGlyph; ++gl) {
-		if (! m->m_glyphWidth.contains(gl)) {
+		if (! m->hasGlyphWidth(gl)) {
 			m->loadGlyph(gl);
-			m->m_glyphWidth.remove(gl);
-			m->m_glyphOutline.remove(gl);
+			m->removeGlyph(gl);
 		}
 	}
 }
@@ -21,8 +21,10 @@ virtual:      dispatch to constituents, handle embedding (-)
 */
 
 #include <QString>
-//#include <QVector>
+#include <QVector>
+#include <QHash>
 #include <QMap>
+#include <qnumeric.h>
 //#include <QArray>
 #include <utility>
 
@@ -93,6 +95,17 @@ public:
 		GlyphData() : Outlines(), x(0), y(0), bbox_width(1), bbox_ascent(1), bbox_descent(0), broken(true) {}
 	};
 	
+	/// hit and miss counters for the glyph width, kerning and char map caches
+	struct CacheStats {
+		uint widthHits;
+		uint widthMisses;
+		uint kerningHits;
+		uint kerningMisses;
+		uint cMapHits;
+		uint cMapMisses;
+		CacheStats() : widthHits(0), widthMisses(0), kerningHits(0), kerningMisses(0), cMapHits(0), cMapMisses(0) {}
+	};
+	
 	
 	/// see accessors for ScFace for docs
 	class ScFaceData {
@@ -133,26 +146,38 @@ public:
 		Status cachedStatus;
 		
 		// caches
-		mutable QMap<uint,qreal>    m_glyphWidth;
+		/// advance width at size 1.0 by glyph index, NaN for glyphs which are not loaded yet
+		mutable QVector<qreal>       m_glyphWidth;
 		mutable QMap<uint,GlyphData> m_glyphOutline;
-		mutable QMap<uint, uint>     m_cMap;
+		/// kerning at size 1.0 by glyph pair (gl1 << 32 | gl2), pairs without kerning included
+		mutable QHash<quint64,qreal> m_glyphKerning;
+		/// unicode -> glyph index for the BMP in 256 pages of 256 chars. Pages without
+		/// any glyph stay empty. The whole vector is empty until load() fills it.
+		mutable QVector<QVector<uint> > m_cMap;
+		mutable ScFace::CacheStats   m_cacheStats;
+		
+		bool hasGlyphWidth(uint gl) const { return gl < uint(m_glyphWidth.size()) && !qIsNaN(m_glyphWidth[gl]); }
+		void setGlyphWidth(uint gl, qreal width) const;
+		/// forget the cached data for glyph gl
+		void removeGlyph(uint gl) const;
+		/// record the glyph index for unicode ch in m_cMap
+		void setCMap(uint ch, uint gl) const;
+		/// returns the kerning at size 1.0, asks glyphKerning() only once per pair
+		qreal cachedKerning(uint gl1, uint gl2) const;
+		void clearCaches() const;
 		
 		// fill caches & members
 		
 		virtual void load()             const 
 		{ 
-			m_glyphWidth.clear();
-			m_glyphOutline.clear();
-			m_cMap.clear();
+			clearCaches();
 
 			status = qMax(cachedStatus, ScFace::LOADED);
 		}
 		
 		virtual void unload()           const 
 		{
-			m_glyphWidth.clear();
-			m_glyphOutline.clear();
-			m_cMap.clear();
+			clearCaches();
 
 			status = ScFace::UNKNOWN;
 		}
@@ -340,7 +365,7 @@ public:
 	qreal glyphWidth(uint gl, qreal sz=1.0) const { return m->glyphWidth(gl, sz); }
 
 	/// returns the glyph kerning between 'gl1' and 'gl2' at size 'sz'
-	qreal glyphKerning(uint gl1, uint gl2, qreal sz=1.0) const { return qMax(gl1,gl2) < CONTROL_GLYPHS ? m->glyphKerning(gl1, gl2, sz) : 0; } 
+	qreal glyphKerning(uint gl1, uint gl2, qreal sz=1.0) const;
 
 	/// returns the glyphs bounding box at size 'sz', ie. the area where this glyph will produce marks
 	GlyphMetrics glyphBBox(uint gl, qreal sz=1.0) const { return m->glyphBBox(gl, sz); }
@@ -374,6 +399,12 @@ public:
 	/// deprecated, see glyphBBox()
 	qreal realCharDescent(QChar ch, qreal sz=1.0) const { return glyphBBox(char2CMap(ch),sz).descent; }
 	
+	/// returns the hit and miss counts of the metric caches since the last resetCacheStats()
+	CacheStats cacheStats() const { return m->m_cacheStats; }
+	
+	/// sets all cache counters to zero
+	void resetCacheStats() const { m->m_cacheStats = CacheStats(); }
+	
 private:
 		
 	friend class SCFonts;
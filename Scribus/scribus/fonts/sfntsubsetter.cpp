@@ -0,0 +1,279 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QList>
+#include <QVector>
+#include <cstring>
+
+#include "sfntsubsetter.h"
+
+namespace {
+
+// the tables a PDF viewer may need to render an embedded TrueType font
+const char* const KeptTables[] = { "cmap", "cvt ", "fpgm", "glyf", "head", "hhea", "hmtx",
+                                   "loca", "maxp", "name", "OS/2", "post", "prep" };
+
+// flags of composite glyph components
+const uint ArgsAreWords = 0x0001;
+const uint HaveScale = 0x0008;
+const uint MoreComponents = 0x0020;
+const uint HaveXYScale = 0x0040;
+const uint HaveTwoByTwo = 0x0080;
+
+quint32 tagValue(const char* tag)
+{
+	return static_cast<quint32>(static_cast<uchar>(tag[0])) << 24 | static_cast<uchar>(tag[1]) << 16
+		| static_cast<uchar>(tag[2]) << 8 | static_cast<uchar>(tag[3]);
+}
+
+uint readU16(const QByteArray& data, int pos)
+{
+	const uchar* p = reinterpret_cast<const uchar*>(data.constData()) + pos;
+	return p[0] << 8 | p[1];
+}
+
+quint32 readU32(const QByteArray& data, int pos)
+{
+	const uchar* p = reinterpret_cast<const uchar*>(data.constData()) + pos;
+	return static_cast<quint32>(p[0]) << 24 | p[1] << 16 | p[2] << 8 | p[3];
+}
+
+void writeU16(QByteArray& data, int pos, uint value)
+{
+	data[pos] = static_cast<char>(value >> 8);
+	data[pos + 1] = static_cast<char>(value);
+}
+
+void writeU32(QByteArray& data, int pos, quint32 value)
+{
+	writeU16(data, pos, value >> 16);
+	writeU16(data, pos + 2, value & 0xFFFF);
+}
+
+} // namespace
+
+QByteArray SfntSubsetter::subset(const QByteArray& font, const QSet<uint>& glyphs)
+{
+	QList<Table> tables;
+	if (!readTables(font, tables))
+		return font;
+	int head = tableIndex(tables, "head");
+	int maxp = tableIndex(tables, "maxp");
+	int loca = tableIndex(tables, "loca");
+	int glyf = tableIndex(tables, "glyf");
+	if ((head < 0) || (maxp < 0) || (loca < 0) || (glyf < 0))
+		return font;
+	if ((tables[head].data.size() < 54) || (tables[maxp].data.size() < 6))
+		return font;
+	bool longLoca = readU16(tables[head].data, 50) != 0;
+	uint numGlyphs = readU16(tables[maxp].data, 4);
+	const QByteArray& locaData(tables[loca].data);
+	const QByteArray& glyfData(tables[glyf].data);
+	if (static_cast<uint>(locaData.size()) < (numGlyphs + 1) * (longLoca ? 4 : 2))
+		return font;
+
+	QVector<quint32> offsets(numGlyphs + 1);
+	for (uint gid = 0; gid <= numGlyphs; ++gid)
+		offsets[gid] = longLoca ? readU32(locaData, 4 * gid) : 2 * readU16(locaData, 2 * gid);
+	for (uint gid = 0; gid < numGlyphs; ++gid)
+	{
+		if ((offsets[gid] > offsets[gid + 1]) || (offsets[gid + 1] > static_cast<quint32>(glyfData.size())))
+			return font;
+	}
+
+	QVector<bool> keep(numGlyphs, false);
+	QList<uint> pending = glyphs.toList();
+	pending.append(0);
+	while (!pending.isEmpty())
+	{
+		uint gid = pending.takeLast();
+		if ((gid >= numGlyphs) || keep[gid])
+			continue;
+		keep[gid] = true;
+		if (!addComponents(glyfData.mid(offsets[gid], offsets[gid + 1] - offsets[gid]), pending))
+			return font;
+	}
+
+	// glyph data has to start at even offsets for short and at multiples of 4 for long offsets
+	int alignment = longLoca ? 4 : 2;
+	QByteArray newGlyf;
+	newGlyf.reserve(glyfData.size());
+	QByteArray newLoca(locaData.size(), '\0');
+	for (uint gid = 0; gid <= numGlyphs; ++gid)
+	{
+		if (longLoca)
+			writeU32(newLoca, 4 * gid, newGlyf.size());
+		else
+			writeU16(newLoca, 2 * gid, newGlyf.size() / 2);
+		if ((gid == numGlyphs) || !keep[gid])
+			continue;
+		newGlyf.append(glyfData.mid(offsets[gid], offsets[gid + 1] - offsets[gid]));
+		while (newGlyf.size() % alignment != 0)
+			newGlyf.append('\0');
+	}
+	if (!longLoca && (newGlyf.size() / 2 > 0xFFFF))
+		return font;
+	tables[loca].data = newLoca;
+	tables[glyf].data = newGlyf;
+
+	QList<Table> kept;
+	for (int i = 0; i < tables.count(); ++i)
+	{
+		for (uint k = 0; k < sizeof(KeptTables) / sizeof(*KeptTables); ++k)
+		{
+			if (tables[i].tag == tagValue(KeptTables[k]))
+			{
+				kept.append(tables[i]);
+				break;
+			}
+		}
+	}
+	return writeFont(readU32(font, 0), kept);
+}
+
+
+bool SfntSubsetter::canSubset(const QByteArray& font)
+{
+	QList<Table> tables;
+	if (!readTables(font, tables))
+		return false;
+	return (tableIndex(tables, "head") >= 0) && (tableIndex(tables, "maxp") >= 0)
+		&& (tableIndex(tables, "loca") >= 0) && (tableIndex(tables, "glyf") >= 0);
+}
+
+
+bool SfntSubsetter::readTables(const QByteArray& font, QList<Table>& tables)
+{
+	if (font.size() < 12)
+		return false;
+	int numTables = readU16(font, 4);
+	if (font.size() < 12 + 16 * numTables)
+		return false;
+	for (int i = 0; i < numTables; ++i)
+	{
+		int entry = 12 + 16 * i;
+		quint32 offset = readU32(font, entry + 8);
+		quint32 length = readU32(font, entry + 12);
+		if ((offset > static_cast<quint32>(font.size())) || (length > font.size() - offset))
+			return false;
+		Table table;
+		table.tag = readU32(font, entry);
+		table.data = font.mid(offset, length);
+		tables.append(table);
+	}
+	return true;
+}
+
+
+int SfntSubsetter::tableIndex(const QList<Table>& tables, const char* tag)
+{
+	quint32 value = tagValue(tag);
+	for (int i = 0; i < tables.count(); ++i)
+	{
+		if (tables[i].tag == value)
+			return i;
+	}
+	return -1;
+}
+
+
+bool SfntSubsetter::addComponents(const QByteArray& glyph, QList<uint>& pending)
+{
+	if (glyph.isEmpty())
+		return true;
+	if (glyph.size() < 10)
+		return false;
+	// simple glyphs have a non-negative number of contours
+	if (static_cast<qint16>(readU16(glyph, 0)) >= 0)
+		return true;
+	int pos = 10;
+	uint flags;
+	do
+	{
+		if (pos + 4 > glyph.size())
+			return false;
+		flags = readU16(glyph, pos);
+		pending.append(readU16(glyph, pos + 2));
+		pos += 4;
+		pos += (flags & ArgsAreWords) ? 4 : 2;
+		if (flags & HaveScale)
+			pos += 2;
+		else if (flags & HaveXYScale)
+			pos += 4;
+		else if (flags & HaveTwoByTwo)
+			pos += 8;
+	}
+	while (flags & MoreComponents);
+	return true;
+}
+
+
+quint32 SfntSubsetter::checkSum(const QByteArray& data, int pos, int length)
+{
+	// tables are zero padded to a multiple of 4 bytes
+	quint32 sum = 0;
+	for (int i = 0; i < length; i += 4)
+	{
+		quint32 value = 0;
+		for (int k = 0; k < 4; ++k)
+		{
+			value <<= 8;
+			if (i + k < length)
+				value |= static_cast<uchar>(data[pos + i + k]);
+		}
+		sum += value;
+	}
+	return sum;
+}
+
+
+QByteArray SfntSubsetter::writeFont(quint32 version, const QList<Table>& tables)
+{
+	int numTables = tables.count();
+	int searchRange = 1;
+	int entrySelector = 0;
+	while (searchRange * 2 <= numTables)
+	{
+		searchRange *= 2;
+		++entrySelector;
+	}
+	searchRange *= 16;
+	int headerLength = 12 + 16 * numTables;
+	int length = headerLength;
+	for (int i = 0; i < numTables; ++i)
+		length += (tables[i].data.size() + 3) & ~3;
+
+	QByteArray result(length, '\0');
+	writeU32(result, 0, version);
+	writeU16(result, 4, numTables);
+	writeU16(result, 6, searchRange);
+	writeU16(result, 8, entrySelector);
+	writeU16(result, 10, numTables * 16 - searchRange);
+	int pos = headerLength;
+	int headPos = -1;
+	for (int i = 0; i < numTables; ++i)
+	{
+		const Table& table(tables[i]);
+		int size = table.data.size();
+		memcpy(result.data() + pos, table.data.constData(), size);
+		if (table.tag == tagValue("head"))
+		{
+			// checkSumAdjustment, counted as 0 in all checksums
+			headPos = pos;
+			writeU32(result, pos + 8, 0);
+		}
+		int entry = 12 + 16 * i;
+		writeU32(result, entry, table.tag);
+		writeU32(result, entry + 4, checkSum(result, pos, size));
+		writeU32(result, entry + 8, pos);
+		writeU32(result, entry + 12, size);
+		pos += (size + 3) & ~3;
+	}
+	if (headPos >= 0)
+		writeU32(result, headPos + 8, 0xB1B0AFBA - checkSum(result, 0, length));
+	return result;
+}
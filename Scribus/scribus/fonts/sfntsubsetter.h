@@ -0,0 +1,49 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef SFNTSUBSETTER_H
+#define SFNTSUBSETTER_H
+
+#include <QByteArray>
+#include <QSet>
+
+/**
+	Strips the outlines of unused glyphs from TrueType fonts for embedding.
+
+	The glyph ids are not changed: the outlines of all glyphs which are not
+	kept are emptied in the 'glyf' table, so 'cmap', 'hmtx' and 'post' stay
+	valid and a PDF can keep addressing the glyphs by their ids (e.g. with an
+	Identity CIDToGIDMap). Glyph 0 and the components of kept composite glyphs
+	are always kept. Only the tables needed to render the font are written.
+ */
+class SfntSubsetter
+{
+public:
+	/**
+		Returns the sfnt font with only the outlines of the given glyphs.
+		Fonts without 'glyf' outlines (e.g. CFF based OpenType fonts) and
+		damaged fonts are returned unchanged.
+	 */
+	static QByteArray subset(const QByteArray& font, const QSet<uint>& glyphs);
+
+	/// returns true if font is a TrueType font subset() can work on
+	static bool canSubset(const QByteArray& font);
+
+private:
+	struct Table
+	{
+		quint32 tag;
+		QByteArray data;
+	};
+
+	static bool readTables(const QByteArray& font, QList<Table>& tables);
+	static int tableIndex(const QList<Table>& tables, const char* tag);
+	static bool addComponents(const QByteArray& glyph, QList<uint>& pending);
+	static quint32 checkSum(const QByteArray& data, int pos, int length);
+	static QByteArray writeFont(quint32 version, const QList<Table>& tables);
+};
+
+#endif
@@ -106,6 +106,27 @@ void gtAction::clearFrame()
 	textFrame->itemText.clear();
 }
 
+/**
+    Drops NUL and CR and turns LF and ch 5 into paragraph separators, so
+    that the text can be inserted into the story in one go.
+ */
+QString gtAction::convertText(const QString& text)
+{
+	QChar ch0(0), ch5(5), ch10(10), ch13(13); 
+	QString result;
+	result.reserve(text.length());
+	for (int a = 0; a < text.length(); ++a)
+	{
+		if ((text.at(a) == ch0) || (text.at(a) == ch13))
+			continue;
+		QChar ch = text.at(a);
+		if ((ch == ch10) || (ch == ch5))
+			ch = ch13;
+		result += ch;
+	}
+	return result;
+}
+
 void gtAction::writeUnstyled(const QString& text)
 {
 	if (isFirstWrite)
@@ -125,18 +146,7 @@ void gtAction::writeUnstyled(const QString& text)
 		}
 	}
 
-	QChar ch0(0), ch5(5), ch10(10), ch13(13); 
-	for (int a = 0; a < text.length(); ++a)
-	{
-		if ((text.at(a) == ch0) || (text.at(a) == ch13))
-			continue;
-		QChar ch = text.at(a);
-		if ((ch == ch10) || (ch == ch5))
-			ch = ch13;
-		
-		int pos = it->itemText.length();
-		it->itemText.insertChars(pos, QString(ch));
-	}
+	it->itemText.insertChars(it->itemText.length(), convertText(text));
 	
 	lastCharWasLineChange = text.right(1) == "\n";
 	isFirstWrite = false;
@@ -208,19 +218,14 @@ void gtAction::write(const QString& text, gtStyle *style)
 	lastStyle = newStyle;
 	lastStyleStart = it->itemText.length();
 
-	QChar ch0(0), ch5(5), ch10(10), ch13(13); 
-	for (int a = 0; a < text.length(); ++a)
+	QString converted(convertText(text));
+	int start = it->itemText.length();
+	it->itemText.insertChars(start, converted);
+	for (int a = 0; a < converted.length(); ++a)
 	{
-		if ((text.at(a) == ch0) || (text.at(a) == ch13))
-			continue;
-		QChar ch = text.at(a);
-		if ((ch == ch10) || (ch == ch5))
-			ch = ch13;
-		
-		int pos = it->itemText.length();
-		it->itemText.insertChars(pos, QString(ch));
-		if (ch == SpecialChars::PARSEP) 
+		if (converted.at(a) == SpecialChars::PARSEP) 
 		{
+			int pos = start + a;
 			if (paraStyle.hasName())
 			{
 				ParagraphStyle pstyle;
@@ -71,6 +71,7 @@ private:
 	int findParagraphStyle(const QString& name);
 	int findParagraphStyle(gtParagraphStyle* pstyle);
 	int applyParagraphStyle(gtParagraphStyle* pstyle);
+	QString convertText(const QString& text);
 
 	ScFace  validateFont(gtFont* font);
 	QString findFontName(gtFont* font);
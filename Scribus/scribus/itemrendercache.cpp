@@ -0,0 +1,136 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include "itemrendercache.h"
+
+#include "pageitem.h"
+#include "pageitem_table.h"
+#include "scpainter.h"
+
+// Larger items are drawn directly, an image of them would rarely be reused
+// before it gets dropped again.
+static const int MaxPixels = 2048 * 2048;
+
+ItemRenderCache::ItemRenderCache()
+{
+	m_images.setMaxCost(0);
+}
+
+
+void ItemRenderCache::setMaxSize(int megaBytes)
+{
+	// cost is counted in kB
+	m_images.setMaxCost(qMax(0, megaBytes) * 1024);
+}
+
+
+void ItemRenderCache::clear()
+{
+	m_images.clear();
+}
+
+
+void ItemRenderCache::invalidate(PageItem* item)
+{
+	m_images.remove(item);
+}
+
+
+bool ItemRenderCache::drawItem(ScPainter* painter, PageItem* item, double scale, const QPointF& origin, int viewState)
+{
+	if (!isEnabled())
+		return false;
+	// blend modes mix the item with what is below it
+	if ((item->fillBlendmode() != 0) || (item->lineBlendmode() != 0))
+		return false;
+	QRect rect(deviceRect(item, scale, origin));
+	if (rect.isEmpty() || (static_cast<double>(rect.width()) * rect.height() > MaxPixels))
+		return false;
+	int cost = qMax(1, rect.width() * rect.height() / 256);
+	if (cost > m_images.maxCost())
+		return false;
+
+	// text which still has to be laid out will look different
+	if (item->invalid && (item->asTextFrame() || item->asPathText()))
+		item->increaseRevision();
+	ItemImage* cached = m_images.object(item);
+	if ((cached == NULL) || (cached->revision != itemRevision(item)) || (cached->scale != scale) || (cached->origin != origin)
+		|| (cached->viewState != viewState) || (cached->position != rect.topLeft()) || (cached->image.size() != rect.size()))
+	{
+		QImage img(rect.size(), QImage::Format_ARGB32_Premultiplied);
+		img.fill(0);
+		ScPainter *p = new ScPainter(&img, img.width(), img.height(), 1.0, 0);
+		p->translate(-rect.x(), -rect.y());
+		p->setZoomFactor(scale);
+		p->translate(-origin.x(), -origin.y());
+		p->setLineWidth(1);
+		p->setFillMode(ScPainter::Solid);
+		QRectF cullingArea(origin.x() + rect.x() / scale, origin.y() + rect.y() / scale, rect.width() / scale, rect.height() / scale);
+		item->DrawObj(p, cullingArea);
+		p->end();
+		delete p;
+		cached = new ItemImage;
+		// ScPainter::drawImage() expects the colors not to be premultiplied
+		cached->image = img.convertToFormat(QImage::Format_ARGB32);
+		cached->position = rect.topLeft();
+		cached->scale = scale;
+		cached->origin = origin;
+		cached->viewState = viewState;
+		cached->revision = itemRevision(item);
+		m_images.insert(item, cached, cost);
+	}
+
+	painter->save();
+	painter->translate(origin.x(), origin.y());
+	painter->scale(1.0 / scale, 1.0 / scale);
+	painter->translate(cached->position.x(), cached->position.y());
+	painter->setBrushOpacity(1.0);
+	painter->setMaskMode(0);
+	painter->setBlendModeFill(0);
+	painter->drawImage(&cached->image);
+	painter->restore();
+	return true;
+}
+
+
+// Revisions only increase, so the image of a group is outdated as soon as
+// one of its members got a revision newer than the group's. The same holds
+// for a table and the text frames of its cells, which are edited directly
+// in modeEditTable.
+uint ItemRenderCache::itemRevision(PageItem* item)
+{
+	uint revision = item->revision();
+	if (item->isGroup())
+	{
+		QList<PageItem*> members = item->getItemList();
+		for (int i = 0; i < members.count(); ++i)
+			revision = qMax(revision, members.at(i)->revision());
+	}
+	else if (item->isTable())
+	{
+		PageItem_Table* table = item->asTable();
+		for (int row = 0; row < table->rows(); ++row)
+		{
+			for (int col = 0; col < table->columns(); ++col)
+			{
+				TableCell cell = table->cellAt(row, col);
+				if (cell.hasTextFrame())
+					revision = qMax(revision, cell.textFrame()->revision());
+			}
+		}
+	}
+	return revision;
+}
+
+
+QRect ItemRenderCache::deviceRect(PageItem* item, double scale, const QPointF& origin)
+{
+	QRectF bounds(item->getVisualBoundingRect());
+	QRectF rect((bounds.x() - origin.x()) * scale, (bounds.y() - origin.y()) * scale, bounds.width() * scale, bounds.height() * scale);
+	// some room for antialiasing
+	return rect.toAlignedRect().adjusted(-2, -2, 2, 2);
+}
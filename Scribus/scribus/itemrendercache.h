@@ -0,0 +1,73 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#ifndef ITEMRENDERCACHE_H
+#define ITEMRENDERCACHE_H
+
+#include <QCache>
+#include <QImage>
+#include <QPoint>
+#include <QPointF>
+#include <QRectF>
+
+class PageItem;
+class ScPainter;
+
+/**
+  Keeps rendered images of page items for the canvas.
+
+  An image is reused as long as the zoom, the canvas origin, the given view
+  state and the PageItem::revision() of the item are the same as when it was
+  rendered. The least recently used images are dropped when the cache exceeds
+  its size.
+
+  PageItem::update(), the geometry, fill, line, gradient, pattern and mask
+  setters and a text layout invalidation bump the revision. Code that writes
+  other item members directly, e.g. the image effects, has to call
+  PageItem::increaseRevision() or invalidate() itself, or the canvas keeps
+  showing the old image until ScribusView::DrawNew() clears the cache.
+ */
+class ItemRenderCache
+{
+public:
+	ItemRenderCache();
+
+	/// sets the maximum size of all images in MB, 0 disables the cache
+	void setMaxSize(int megaBytes);
+	bool isEnabled() const { return m_images.maxCost() > 0; }
+
+	void clear();
+	void invalidate(PageItem* item);
+
+	/**
+	  Draws item with painter, whose current matrix has to be the canvas matrix
+	  (zoomed by scale and translated by -origin, like in Canvas::drawContents()).
+	  Returns false if the item can not be cached, it is not drawn in that case.
+	 */
+	bool drawItem(ScPainter* painter, PageItem* item, double scale, const QPointF& origin, int viewState);
+
+	/// the newest PageItem::revision() of item and, for groups, of its members
+	static uint itemRevision(PageItem* item);
+
+private:
+	struct ItemImage
+	{
+		QImage image;
+		QPoint position;
+		double scale;
+		QPointF origin;
+		int viewState;
+		uint revision;
+	};
+
+	/// the device rect covered by item, rounded outwards to whole pixels
+	static QRect deviceRect(PageItem* item, double scale, const QPointF& origin);
+
+	QCache<PageItem*, ItemImage> m_images;
+};
+
+#endif
@@ -241,6 +241,7 @@ void Page::restorePageItemCreation(ItemState<PageItem*> *state, bool isUndo)
 			m_Doc->view()->Deselect(true);
 		m_Doc->Items->append(ite);
 		ite->ItemNr = m_Doc->Items->count()-1;
+		m_Doc->itemListChanged();
 		if ((stateCode == 0) || (stateCode == 2))
 			update();
 	}
@@ -304,12 +305,14 @@ void Page::restorePageItemConversion(ItemState<std::pair<PageItem*, PageItem*> >
 	if (isUndo)
 	{
 		m_Doc->Items->replace(newItem->ItemNr, oldItem);
+		m_Doc->itemListChanged();
 		oldItem->updatePolyClip();
 		m_Doc->AdjustItemSize(oldItem);
 	}
 	else
 	{
 		m_Doc->Items->replace(oldItem->ItemNr, newItem);
+		m_Doc->itemListChanged();
 	}
 	m_Doc->setMasterPageMode(oldMPMode);
 }
@@ -349,6 +349,7 @@ PageItem::PageItem(const PageItem & other)
 		tempImageFile = NULL;
 		isInlineImage = false;
 	}
+	increaseRevision();
 }
 
 
@@ -844,11 +845,27 @@ PageItem::PageItem(ScribusDoc *pa, ItemType newType, double x, double y, double
 	}
 	tempImageFile = NULL;
 	isInlineImage = false;
+	increaseRevision();
+}
+
+void PageItem::increaseRevision()
+{
+	// Revisions are unique across all items, so an item created at the address
+	// of a deleted one never matches what was cached for the deleted one.
+	static uint revisionCounter = 0;
+	m_revision = ++revisionCounter;
+}
+
+void PageItem::geometryChanged()
+{
+	increaseRevision();
+	m_Doc->itemGeometryChanged(this);
 }
 
 void PageItem::setXPos(const double newXPos, bool drawingOnly)
 {
 	Xpos = newXPos;
+	geometryChanged();
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -857,6 +874,7 @@ void PageItem::setXPos(const double newXPos, bool drawingOnly)
 void PageItem::setYPos(const double newYPos, bool drawingOnly)
 {
 	Ypos = newYPos;
+	geometryChanged();
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -866,6 +884,7 @@ void PageItem::setXYPos(const double newXPos, const double newYPos, bool drawing
 {
 	Xpos = newXPos;
 	Ypos = newYPos;
+	geometryChanged();
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -886,6 +905,7 @@ void PageItem::moveBy(const double dX, const double dY, bool drawingOnly)
 		Ypos+=dY;
 		gYpos+=dY;
 	}
+	geometryChanged();
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -895,6 +915,7 @@ void PageItem::setWidth(const double newWidth)
 {
 	Width = newWidth;
 	updateConstants();
+	geometryChanged();
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -904,6 +925,7 @@ void PageItem::setHeight(const double newHeight)
 {
 	Height = newHeight;
 	updateConstants();
+	geometryChanged();
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -914,6 +936,7 @@ void PageItem::setWidthHeight(const double newWidth, const double newHeight, boo
 	Width = newWidth;
 	Height = newHeight;
 	updateConstants();
+	geometryChanged();
 	if (drawingOnly)
 		return;
 	checkChanges();
@@ -924,6 +947,7 @@ void PageItem::setWidthHeight(const double newWidth, const double newHeight)
 	Width = newWidth;
 	Height = newHeight;
 	updateConstants();
+	geometryChanged();
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -938,6 +962,7 @@ void PageItem::resizeBy(const double dH, const double dW)
 	if (dW!=0.0)
 		Height+=dW;
 	updateConstants();
+	geometryChanged();
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -946,6 +971,7 @@ void PageItem::resizeBy(const double dH, const double dW)
 void PageItem::setRotation(const double newRotation, bool drawingOnly)
 {
 	Rot=newRotation;
+	geometryChanged();
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -956,6 +982,7 @@ void PageItem::rotateBy(const double dR)
 	if (dR==0.0)
 		return;
 	Rot+=dR;
+	geometryChanged();
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -2276,7 +2303,7 @@ double PageItem::layoutGlyphs(const CharStyle& style, const QString& chars, Glyp
 void PageItem::drawGlyphs(ScPainter *p, const CharStyle& style, GlyphLayout& glyphs)
 {
 	uint glyph = glyphs.glyph;
-	if ((m_Doc->guidesPrefs().showControls) &&
+	if ((m_Doc->guidesPrefs().showControls) && (p->showGuides()) &&
 		(glyph == style.font().char2CMap(QChar(' ')) || glyph >=  ScFace::CONTROL_GLYPHS))
 	{
 		bool stroke = false;
@@ -2585,12 +2612,14 @@ void PageItem::setGradient(const QString &newGradient)
 {
 	if (gradientVal != newGradient)
 		gradientVal = newGradient;
+	increaseRevision();
 }
 
 void PageItem::setPattern(const QString &newPattern)
 {
 	if (patternVal != newPattern)
 		patternVal = newPattern;
+	increaseRevision();
 }
 
 void PageItem::set4ColorGeometry(FPoint c1, FPoint c2, FPoint c3, FPoint c4)
@@ -3023,12 +3052,14 @@ void PageItem::setGradientVector(double startX, double startY, double endX, doub
 	GrFocalY = focalY;
 	GrScale  = scale;
 	GrSkew   = skew;
+	increaseRevision();
 }
 
 void PageItem::setStrokeGradient(const QString &newGradient)
 {
 	if (gradientStrokeVal != newGradient)
 		gradientStrokeVal = newGradient;
+	increaseRevision();
 }
 
 void PageItem::strokeGradientVector(double& startX, double& startY, double& endX, double& endY, double &focalX, double &focalY, double &scale, double &skew) const
@@ -3053,6 +3084,7 @@ void PageItem::setStrokeGradientVector(double startX, double startY, double endX
 	GrStrokeFocalY = focalY;
 	GrStrokeScale  = scale;
 	GrStrokeSkew   = skew;
+	increaseRevision();
 }
 
 void PageItem::setPatternTransform(double scaleX, double scaleY, double offsetX, double offsetY, double rotation, double skewX, double skewY)
@@ -3064,6 +3096,7 @@ void PageItem::setPatternTransform(double scaleX, double scaleY, double offsetX,
 	patternRotation = rotation;
 	patternSkewX = skewX;
 	patternSkewY = skewY;
+	increaseRevision();
 }
 
 void PageItem::patternTransform(double &scaleX, double &scaleY, double &offsetX, double &offsetY, double &rotation, double &skewX, double &skewY) const
@@ -3081,6 +3114,7 @@ void PageItem::setPatternFlip(bool flipX, bool flipY)
 {
 	patternMirrorX = flipX;
 	patternMirrorY = flipY;
+	increaseRevision();
 }
 
 void PageItem::patternFlip(bool &flipX, bool &flipY)
@@ -3093,12 +3127,14 @@ void PageItem::setGradientMask(const QString &newMask)
 {
 	if (gradientMaskVal != newMask)
 		gradientMaskVal = newMask;
+	increaseRevision();
 }
 
 void PageItem::setPatternMask(const QString &newMask)
 {
 	if (patternMaskVal != newMask)
 		patternMaskVal = newMask;
+	increaseRevision();
 }
 
 void PageItem::maskVector(double& startX, double& startY, double& endX, double& endY, double &focalX, double &focalY, double &scale, double &skew) const
@@ -3123,6 +3159,7 @@ void PageItem::setMaskVector(double startX, double startY, double endX, double e
 	GrMaskFocalY = focalY;
 	GrMaskScale  = scale;
 	GrMaskSkew   = skew;
+	increaseRevision();
 }
 
 void PageItem::maskTransform(double &scaleX, double &scaleY, double &offsetX, double &offsetY, double &rotation, double &skewX, double &skewY) const
@@ -3145,12 +3182,14 @@ void PageItem::setMaskTransform(double scaleX, double scaleY, double offsetX, do
 	patternMaskRotation = rotation;
 	patternMaskSkewX = skewX;
 	patternMaskSkewY = skewY;
+	increaseRevision();
 }
 
 void PageItem::setMaskFlip(bool flipX, bool flipY)
 {
 	patternMaskMirrorX = flipX;
 	patternMaskMirrorY = flipY;
+	increaseRevision();
 }
 
 void PageItem::maskFlip(bool &flipX, bool &flipY)
@@ -3244,6 +3283,7 @@ void PageItem::setFillTransparency(double newTransparency)
 		undoManager->action(this, ss);
 	}
 	fillTransparencyVal = newTransparency;
+	increaseRevision();
 }
 
 void PageItem::setFillBlendmode(int newBlendmode)
@@ -3251,6 +3291,7 @@ void PageItem::setFillBlendmode(int newBlendmode)
 	if (fillBlendmodeVal == newBlendmode)
 		return; // nothing to do -> return
 	fillBlendmodeVal = newBlendmode;
+	increaseRevision();
 }
 
 void PageItem::setLineColor(const QString &newColor)
@@ -3328,11 +3369,13 @@ void PageItem::setStrokePattern(const QString &newPattern)
 {
 	if (patternStrokeVal != newPattern)
 		patternStrokeVal = newPattern;
+	increaseRevision();
 }
 
 void PageItem::setStrokePatternToPath(bool enable)
 {
 	patternStrokePath = enable;
+	increaseRevision();
 }
 
 bool PageItem::isStrokePatternToPath()
@@ -3350,12 +3393,14 @@ void PageItem::setStrokePatternTransform(double scaleX, double scaleY, double of
 	patternStrokeSkewX = skewX;
 	patternStrokeSkewY = skewY;
 	patternStrokeSpace = space;
+	increaseRevision();
 }
 
 void PageItem::setStrokePatternFlip(bool flipX, bool flipY)
 {
 	patternStrokeMirrorX = flipX;
 	patternStrokeMirrorY = flipY;
+	increaseRevision();
 }
 
 void PageItem::strokePatternFlip(bool &flipX, bool &flipY)
@@ -3415,6 +3460,7 @@ void PageItem::setLineQColor()
 		VisionDefectColor defect;
 		strokeQColor = defect.convertDefect(strokeQColor, m_Doc->previewVisual);
 	}
+	increaseRevision();
 }
 
 void PageItem::setFillQColor()
@@ -3453,6 +3499,7 @@ void PageItem::setFillQColor()
 		VisionDefectColor defect;
 		fillQColor = defect.convertDefect(fillQColor, m_Doc->previewVisual);
 	}
+	increaseRevision();
 }
 
 void PageItem::setLineTransparency(double newTransparency)
@@ -3470,6 +3517,7 @@ void PageItem::setLineTransparency(double newTransparency)
 		undoManager->action(this, ss);
 	}
 	lineTransparencyVal = newTransparency;
+	increaseRevision();
 }
 
 void PageItem::setLineBlendmode(int newBlendmode)
@@ -3477,6 +3525,7 @@ void PageItem::setLineBlendmode(int newBlendmode)
 	if (lineBlendmodeVal == newBlendmode)
 		return; // nothing to do -> return
 	lineBlendmodeVal = newBlendmode;
+	increaseRevision();
 }
 
 void PageItem::setLineStyle(Qt::PenStyle newStyle)
@@ -3492,6 +3541,7 @@ void PageItem::setLineStyle(Qt::PenStyle newStyle)
 		undoManager->action(this, ss);
 	}
 	PLineArt = newStyle;
+	increaseRevision();
 }
 
 void PageItem::setLineWidth(double newWidth)
@@ -3509,6 +3559,7 @@ void PageItem::setLineWidth(double newWidth)
 	}
 	Oldm_lineWidth=m_lineWidth;
 	m_lineWidth = newWidth;
+	geometryChanged();
 }
 
 void PageItem::setLineEnd(Qt::PenCapStyle newStyle)
@@ -3524,6 +3575,7 @@ void PageItem::setLineEnd(Qt::PenCapStyle newStyle)
 		undoManager->action(this, ss);
 	}
 	PLineEnd = newStyle;
+	increaseRevision();
 }
 
 void PageItem::setLineJoin(Qt::PenJoinStyle newStyle)
@@ -3539,6 +3591,7 @@ void PageItem::setLineJoin(Qt::PenJoinStyle newStyle)
 		undoManager->action(this, ss);
 	}
 	PLineJoin = newStyle;
+	increaseRevision();
 }
 
 void PageItem::setCustomLineStyle(const QString& newStyle)
@@ -3558,6 +3611,7 @@ void PageItem::setCustomLineStyle(const QString& newStyle)
 		undoManager->action(this, ss);
 	}
 	NamedLStyle = newStyle;
+	increaseRevision();
 }
 
 void PageItem::setStartArrowIndex(int newIndex)
@@ -3573,6 +3627,7 @@ void PageItem::setStartArrowIndex(int newIndex)
 		undoManager->action(this, ss);
 	}
 	m_startArrowIndex = newIndex;
+	geometryChanged();
 }
 
 void PageItem::setEndArrowIndex(int newIndex)
@@ -3588,6 +3643,7 @@ void PageItem::setEndArrowIndex(int newIndex)
 		undoManager->action(this, ss);
 	}
 	m_endArrowIndex = newIndex;
+	geometryChanged();
 }
 
 void PageItem::setStartArrowScale(int newScale)
@@ -3595,6 +3651,7 @@ void PageItem::setStartArrowScale(int newScale)
 	if (m_startArrowScale == newScale)
 		return; // nothing to do -> return
 	m_startArrowScale = newScale;
+	geometryChanged();
 }
 
 void PageItem::setEndArrowScale(int newScale)
@@ -3602,6 +3659,7 @@ void PageItem::setEndArrowScale(int newScale)
 	if (m_endArrowScale == newScale)
 		return; // nothing to do -> return
 	m_endArrowScale = newScale;
+	geometryChanged();
 }
 
 void PageItem::setImageFlippedH(bool flipped)
@@ -6170,6 +6228,7 @@ QRect PageItem::getRedrawBounding(const double viewScale)
 
 void PageItem::setRedrawBounding()
 {
+	geometryChanged();
 	double bw, bh;
 	getBoundingRect(&BoundingX, &BoundingY, &bw, &bh);
 	BoundingW = bw - BoundingX;
@@ -6448,6 +6507,7 @@ void PageItem::convertClip()
 
 void PageItem::updateClip()
 {
+	geometryChanged();
 	if (m_Doc->appMode == modeDrawBezierLine)
 		return;
 	if (ContourLine.size() == 0)
@@ -343,7 +343,10 @@ public:
 	virtual void handleModeEditKey(QKeyEvent *k, bool &keyRepeat);
 	
 	/// invalidates current layout information
-	virtual void invalidateLayout() { invalid = true; }
+	virtual void invalidateLayout() { invalid = true; increaseRevision(); }
+	/// changes whenever the appearance of the item may have changed, used to validate cached renderings
+	uint revision() const { return m_revision; }
+	void increaseRevision();
 	/// creates valid layout information
 	virtual void layout() {}
 	/// returns frame where is text end
@@ -1179,6 +1182,10 @@ private:
 	 * @sa loadImage()
 	 */
 	QString getImageEffectsModifier() const;
+	/// called whenever position, size or shape change
+	void geometryChanged();
+
+	uint m_revision;
 
 protected:
 
@@ -194,7 +194,7 @@ void PageItem_Group::DrawObj_Item(ScPainter *p, QRectF /*e*/)
 			}
 			p->endLayer();
 			p->restore();
-			if (m_Doc->guidesPrefs().framesShown)
+			if ((m_Doc->guidesPrefs().framesShown) && (p->showGuides()))
 			{
 				for (int em = 0; em < groupItemList.count(); ++em)
 				{
@@ -209,7 +209,7 @@ void PageItem_Group::DrawObj_Item(ScPainter *p, QRectF /*e*/)
 		}
 		else
 		{
-			if (m_Doc->guidesPrefs().framesShown)
+			if ((m_Doc->guidesPrefs().framesShown) && (p->showGuides()))
 			{
 				p->save();
 				p->setPen(Qt::black, 1, Qt::SolidLine, Qt::FlatCap, Qt::MiterJoin);
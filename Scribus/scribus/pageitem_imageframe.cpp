@@ -88,7 +88,7 @@ void PageItem_ImageFrame::DrawObj_Item(ScPainter *p, QRectF /*e*/)
 			p->setClipPath();
 			if (Pfile.isEmpty())
 			{
-				if ((Frame) && (m_Doc->guidesPrefs().framesShown))
+				if ((Frame) && (m_Doc->guidesPrefs().framesShown) && (p->showGuides()))
 				{
 					p->setPen(Qt::black, 1, Qt::SolidLine, Qt::FlatCap, Qt::MiterJoin);
 					p->drawLine(FPoint(0, 0), FPoint(Width, Height));
@@ -100,7 +100,7 @@ void PageItem_ImageFrame::DrawObj_Item(ScPainter *p, QRectF /*e*/)
 				//If we are missing our image, draw a red cross in the frame
 				if ((!PicArt) || (!PictureIsAvailable))
 				{
-					if ((Frame) && (m_Doc->guidesPrefs().framesShown))
+					if ((Frame) && (m_Doc->guidesPrefs().framesShown) && (p->showGuides()))
 					{
 						p->setBrush(Qt::white);
 						QString htmlText = "";
@@ -196,7 +196,7 @@ void PageItem_ImageFrame::DrawObj_Item(ScPainter *p, QRectF /*e*/)
 					}
 					else
 						p->setMaskMode(0);
-					p->drawImage(pixm.qImagePtr());
+					p->drawImage(&pixm);
 				}
 			}
 			p->restore();
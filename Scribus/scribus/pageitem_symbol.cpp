@@ -150,7 +150,7 @@ void PageItem_Symbol::DrawObj_Item(ScPainter *p, QRectF /*e*/)
 		}
 		else
 		{
-			if (m_Doc->guidesPrefs().framesShown)
+			if ((m_Doc->guidesPrefs().framesShown) && (p->showGuides()))
 			{
 				p->save();
 				p->setPen(Qt::black, 1, Qt::SolidLine, Qt::FlatCap, Qt::MiterJoin);
@@ -46,7 +46,7 @@ const qreal PageItem_Table::MinimumColumnWidth = 3.0;
 PageItem_Table::PageItem_Table(ScribusDoc *pa, double x, double y, double w, double h,
 	double w2, QString fill, QString outline, int numRows, int numColumns) :
 	PageItem(pa, PageItem::Table, x, y, w, h, w2, fill, outline),
-	m_rows(0), m_columns(0), m_tablePainter(new CollapsedTablePainter(this))
+	m_rows(0), m_columns(0), m_cellAreaMapValid(false), m_tablePainter(new CollapsedTablePainter(this))
 {
 	initialize(numRows, numColumns);
 
@@ -431,7 +431,7 @@ void PageItem_Table::mergeCells(int row, int column, int numRows, int numCols)
 			newArea = newArea.united(oldArea);
 
 			// Reset row/column span of old spanning cell, then remove old area.
-			TableCell oldSpanningCell = cellAt(oldArea.row(), oldArea.column());
+			TableCell oldSpanningCell = m_cellRows[oldArea.row()][oldArea.column()];
 			oldSpanningCell.setRowSpan(1);
 			oldSpanningCell.setColumnSpan(1);
 			areaIt.remove();
@@ -439,10 +439,11 @@ void PageItem_Table::mergeCells(int row, int column, int numRows, int numCols)
 	}
 
 	// Set row/column span of new spanning cell, and add new area.
-	TableCell newSpanningCell = cellAt(newArea.row(), newArea.column());
+	TableCell newSpanningCell = m_cellRows[newArea.row()][newArea.column()];
 	newSpanningCell.setRowSpan(newArea.height());
 	newSpanningCell.setColumnSpan(newArea.width());
 	m_cellAreas.append(newArea);
+	m_cellAreaMapValid = false;
 
 	// Update cells. TODO: Not for entire table.
 	updateCells();
@@ -472,6 +473,41 @@ void PageItem_Table::splitCell(int row, int column, int numRows, int numCols)
 	emit changed();
 }
 
+void PageItem_Table::setCellTexts(const QList<QStringList>& texts)
+{
+	ASSERT_VALID();
+
+	int numRows = qMax(texts.count(), 1);
+	int numColumns = 1;
+	foreach (const QStringList& rowTexts, texts)
+		numColumns = qMax(numColumns, rowTexts.count());
+
+	// Resize the table in one step per dimension.
+	if (numRows > rows())
+		insertRows(rows(), numRows - rows());
+	else if (numRows < rows())
+		removeRows(numRows, rows() - numRows);
+	if (numColumns > columns())
+		insertColumns(columns(), numColumns - columns());
+	else if (numColumns < columns())
+		removeColumns(numColumns, columns() - numColumns);
+
+	// Set the texts, cells without text frame just keep them.
+	for (int row = 0; row < rows(); ++row)
+	{
+		const QStringList rowTexts = row < texts.count() ? texts.at(row) : QStringList();
+		for (int col = 0; col < columns(); ++col)
+			m_cellRows[row][col].setText(col < rowTexts.count() ? rowTexts.at(col) : QString());
+	}
+
+	// Update cells once for all texts.
+	updateCells();
+
+	emit changed();
+
+	ASSERT_VALID();
+}
+
 QSet<int> PageItem_Table::selectedRows() const
 {
 	QSet<int> rows;
@@ -540,21 +576,20 @@ TableCell PageItem_Table::cellAt(int row, int column) const
 	if (!validCell(row, column))
 		return TableCell();
 
-	TableCell cell = m_cellRows[row][column];
+	if (!m_cellAreaMapValid)
+	{
+		m_cellAreaMap.build(m_rows, m_columns, m_cellAreas);
+		m_cellAreaMapValid = true;
+	}
 
-	QList<CellArea>::const_iterator areaIt;
-	for (areaIt = m_cellAreas.begin(); areaIt != m_cellAreas.end(); ++areaIt)
+	CellArea area = m_cellAreaMap.areaAt(row, column);
+	if (area.isValid())
 	{
-		CellArea area = (*areaIt);
-		if (area.contains(row, column))
-		{
-			// Cell was contained in merged area, so use spanning cell.
-			cell = m_cellRows[area.row()][area.column()];
-			break;
-		}
+		// Cell was contained in merged area, so use spanning cell.
+		return m_cellRows[area.row()][area.column()];
 	}
 
-	return cell;
+	return m_cellRows[row][column];
 }
 
 TableCell PageItem_Table::cellAt(const QPointF& point) const
@@ -834,7 +869,7 @@ void PageItem_Table::applicableActions(QStringList& actionList)
 	actionList << "tableAdjustTableToFrame";
 }
 
-void PageItem_Table::DrawObj_Item(ScPainter *p, QRectF /*e*/)
+void PageItem_Table::DrawObj_Item(ScPainter *p, QRectF cullingArea)
 {
 	if (m_Doc->RePos)
 		return;
@@ -845,8 +880,11 @@ void PageItem_Table::DrawObj_Item(ScPainter *p, QRectF /*e*/)
 	p->setupPolygon(&PoLine);
 	p->setClipPath();
 
-	// Paint the table.
-	m_tablePainter->paintTable(p);
+	// Paint the table, only the part in the culling area unless we are embedded or grouped.
+	QRectF area;
+	if (!isEmbedded && !cullingArea.isNull())
+		area = getTransform().inverted().mapRect(cullingArea);
+	m_tablePainter->paintTable(p, area);
 
 	p->restore();
 
@@ -1051,6 +1089,9 @@ qreal PageItem_Table::resizeColumnResizeFollowing(int column, qreal width)
 
 void PageItem_Table::updateCells(int startRow, int startColumn, int endRow, int endColumn)
 {
+	// Cells, styles or borders changed, so any collapsed borders resolved before are outdated.
+	m_tablePainter->invalidate();
+
 	if (startRow > endRow || startColumn > endColumn)
 		return; // Invalid area.
 
@@ -1064,6 +1105,9 @@ void PageItem_Table::updateCells(int startRow, int startColumn, int endRow, int
 
 void PageItem_Table::updateSpans(int index, int number, ChangeType changeType)
 {
+	// The table dimensions change, and maybe the areas, so the cell area map must be rebuilt.
+	m_cellAreaMapValid = false;
+
 	// Loop through areas of merged cells.
 	QMutableListIterator<CellArea> areaIt(m_cellAreas);
 	while (areaIt.hasNext())
@@ -1104,7 +1148,7 @@ void PageItem_Table::updateSpans(int index, int number, ChangeType changeType)
 				areaIt.remove();
 
 				// And reset row/column span of spanning cell to 1.
-				TableCell oldSpanningCell = cellAt(oldArea.row(), oldArea.column());
+				TableCell oldSpanningCell = m_cellRows[newArea.row()][newArea.column()];
 				oldSpanningCell.setRowSpan(1);
 				oldSpanningCell.setColumnSpan(1);
 			}
@@ -1114,7 +1158,7 @@ void PageItem_Table::updateSpans(int index, int number, ChangeType changeType)
 				areaIt.setValue(newArea);
 
 				// And set row/column spanning of spanning cell.
-				TableCell newSpanningCell = cellAt(newArea.row(), newArea.column());
+				TableCell newSpanningCell = m_cellRows[newArea.row()][newArea.column()];
 				newSpanningCell.setRowSpan(newArea.height());
 				newSpanningCell.setColumnSpan(newArea.width());
 			}
@@ -14,8 +14,10 @@ for which a new license (GPL+exception) is in place.
 #include <QRectF>
 #include <QSet>
 #include <QString>
+#include <QStringList>
 
 #include "cellarea.h"
+#include "cellareamap.h"
 #include "pageitem.h"
 #include "scribusapi.h"
 #include "styles/tablestyle.h"
@@ -268,6 +270,16 @@ public:
 	 */
 	void splitCell(int row, int column, int numRows, int numCols);
 
+	/**
+	 * Fills the table with @a texts, given as one list of cell texts per row.
+	 *
+	 * The table is resized once to as many rows as there are lists and as many columns as
+	 * the longest list has entries, at least one of each. Cells without text in @a texts are
+	 * emptied. The cells are updated once after all texts have been set, so this is much
+	 * faster than setting the text of each cell on its own for large amounts of data.
+	 */
+	void setCellTexts(const QList<QStringList>& texts);
+
 	/**
 	 * Returns the set of selected cells.
 	 */
@@ -556,6 +568,11 @@ private:
 	/// List of areas of merged cells.
 	QList<CellArea> m_cellAreas;
 
+	/// Map from cells to the areas of merged cells covering them, built on demand by cellAt().
+	mutable CellAreaMap m_cellAreaMap;
+	/// <code>true</code> if m_cellAreaMap is up to date with m_cellAreas and the table dimensions.
+	mutable bool m_cellAreaMapValid;
+
 	/// Set of selected cells.
 	QSet<TableCell> m_selection;
 
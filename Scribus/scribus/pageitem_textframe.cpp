@@ -27,7 +27,6 @@ for which a new license (GPL+exception) is in place.
 #include <QPalette>
 #include <QPoint>
 #include <QPolygon>
-#include <QRegion>
 #include <cassert>
 
 
@@ -47,6 +46,7 @@ for which a new license (GPL+exception) is in place.
 #include "scribusdoc.h"
 #include "scribusstructs.h"
 #include "selection.h"
+#include "textwrapshape.h"
 #include "text/nlsconfig.h"
 #include "undomanager.h"
 #include "undostate.h"
@@ -61,6 +61,11 @@ PageItem_TextFrame::PageItem_TextFrame(ScribusDoc *pa, double x, double y, doubl
 {
 	invalid = true;
 	firstChar = 0;
+	m_layoutCached = false;
+	m_cachedHasObjects = false;
+	m_cachedUsesGrid = false;
+	m_cachedFirstChar = 0;
+	m_cachedMaxChars = 0;
 	cursorBiasBackward = false;
 	unicodeTextEditMode = false;
 	unicodeInputCount = 0;
@@ -72,6 +77,11 @@ PageItem_TextFrame::PageItem_TextFrame(ScribusDoc *pa, double x, double y, doubl
 PageItem_TextFrame::PageItem_TextFrame(const PageItem & p) : PageItem(p)
 {
 	invalid = true;
+	m_layoutCached = false;
+	m_cachedHasObjects = false;
+	m_cachedUsesGrid = false;
+	m_cachedFirstChar = 0;
+	m_cachedMaxChars = 0;
 	cursorBiasBackward = false;
 	unicodeTextEditMode = false;
 	unicodeInputCount = 0;
@@ -80,47 +90,69 @@ PageItem_TextFrame::PageItem_TextFrame(const PageItem & p) : PageItem(p)
 	connect(&itemText,SIGNAL(changed()), this, SLOT(slotInvalidateLayout()));
 }
 
-static QRegion itemShape(PageItem* docItem, double xOffset, double yOffset)
+bool PageItem_TextFrame::WrapSource::operator==(const WrapSource& other) const
+{
+	return item == other.item && xPos == other.xPos && yPos == other.yPos
+		&& rotation == other.rotation && width == other.width && height == other.height
+		&& flow == other.flow && flippedH == other.flippedH && flippedV == other.flippedV
+		&& clip == other.clip && outline == other.outline;
+}
+
+PageItem_TextFrame::WrapSource PageItem_TextFrame::wrapSource(PageItem* docItem, double xOffset, double yOffset, PageItem::TextFlowMode flow)
+{
+	WrapSource source;
+	source.item = docItem;
+	source.xPos = docItem->xPos() - xOffset;
+	source.yPos = docItem->yPos() - yOffset;
+	source.rotation = docItem->rotation();
+	source.width = docItem->width();
+	source.height = docItem->height();
+	source.flow = flow;
+	source.flippedH = docItem->imageFlippedH();
+	source.flippedV = docItem->imageFlippedV();
+	source.clip = docItem->Clip;
+	if (flow == TextFlowUsesImageClipping)
+		source.outline = docItem->imageClip;
+	else if (flow == TextFlowUsesContourLine)
+		source.outline = docItem->ContourLine;
+	return source;
+}
+
+void PageItem_TextFrame::itemShape(const WrapSource& source, QList<QPolygonF>& shape, QList<QPolygonF>& clip)
 {
-	QRegion res;
 	QTransform pp;
-//	pp.begin(view->viewport());
-	pp.translate(docItem->xPos() - xOffset, docItem->yPos() - yOffset);
-	pp.rotate(docItem->rotation());
-	if (docItem->textFlowUsesBoundingBox())
-	{
-		QPolygon tcli(4);
-		tcli.setPoint(0, QPoint(0,0));
-		tcli.setPoint(1, QPoint(qRound(docItem->width()), 0));
-		tcli.setPoint(2, QPoint(qRound(docItem->width()), qRound(docItem->height())));
-		tcli.setPoint(3, QPoint(0, qRound(docItem->height())));
-//		res = QRegion(pp.xForm(tcli));
-		res = QRegion(pp.map(tcli));
-	}
-	else if ((docItem->textFlowUsesImageClipping()) && (docItem->imageClip.size() != 0))
+	pp.translate(source.xPos, source.yPos);
+	pp.rotate(source.rotation);
+	FPointArray outline(source.outline);
+	if (source.flow == TextFlowUsesBoundingBox)
+		shape.append(pp.map(QPolygonF(QRectF(0, 0, source.width, source.height))));
+	else if ((source.flow == TextFlowUsesImageClipping) && (outline.size() != 0))
 	{
-		QList<uint> Segs;
-		QPolygon Clip2 = FlattenPath(docItem->imageClip, Segs);
-//		res = QRegion(pp.xForm(Clip2));
-		res = QRegion(pp.map(Clip2)).intersect(QRegion(pp.map(docItem->Clip)));
-	}
-	else if ((docItem->textFlowUsesContourLine()) && (docItem->ContourLine.size() != 0))
-	{
-		QList<uint> Segs;
-		QPolygon Clip2 = FlattenPath(docItem->ContourLine, Segs);
-//		res = QRegion(pp.xForm(Clip2));
-		res = QRegion(pp.map(Clip2));
+		shape = outline.toQPainterPath(true).toSubpathPolygons(pp);
+		clip.append(pp.map(QPolygonF(source.clip)));
 	}
+	else if ((source.flow == TextFlowUsesContourLine) && (outline.size() != 0))
+		shape = outline.toQPainterPath(true).toSubpathPolygons(pp);
 	else
-//		res = QRegion(pp.xForm(docItem->Clip));
-		res = QRegion(pp.map(docItem->Clip));
-//	pp.end();
-	return  res;
+		shape.append(pp.map(QPolygonF(source.clip)));
 }
 
-QRegion PageItem_TextFrame::availableRegion(QRegion clip)
+void PageItem_TextFrame::addObstacle(TextWrapShape& wrap, const QTransform& toFrame, const WrapSource& source)
 {
-	QRegion result(clip);
+	QList<QPolygonF> shape, clip;
+	itemShape(source, shape, clip);
+	for (int i = 0; i < shape.count(); ++i)
+		shape[i] = toFrame.map(shape[i]);
+	for (int i = 0; i < clip.count(); ++i)
+		clip[i] = toFrame.map(clip[i]);
+	wrap.addObstacle(shape, clip);
+}
+
+QList<PageItem_TextFrame::WrapSource> PageItem_TextFrame::wrapSources()
+{
+	QList<WrapSource> result;
+	// the frame itself always counts with its frame shape
+	result.append(wrapSource(this, 0, 0, TextFlowUsesFrameShape));
 	if (!isEmbedded)
 	{
 		int LayerLev = m_Doc->layerLevelFromID(LayerID);
@@ -143,7 +175,7 @@ QRegion PageItem_TextFrame::availableRegion(QRegion clip)
 				{
 					if (docItem->textFlowAroundObject())
 					{
-						result = result.subtract(itemShape(docItem, Mp->xOffset() - Dp->xOffset(), Mp->yOffset() - Dp->yOffset()));
+						result.append(wrapSource(docItem, Mp->xOffset() - Dp->xOffset(), Mp->yOffset() - Dp->yOffset(), docItem->textFlowMode()));
 					}
 				}
 			} // for all masterItems
@@ -158,7 +190,7 @@ QRegion PageItem_TextFrame::availableRegion(QRegion clip)
 					Dp = m_Doc->Pages->at(OwnPage);
 					if ((docItem->textFlowAroundObject()) && (docItem->OwnPage == OwnPage))
 					{
-						result = result.subtract(itemShape(docItem, m_Doc->view(), Mp->xOffset() - Dp->xOffset(), Mp->yOffset() - Dp->yOffset()));
+						result.append(wrapSource(docItem, Mp->xOffset() - Dp->xOffset(), Mp->yOffset() - Dp->yOffset(), docItem->textFlowMode()));
 					}
 				} // for all docItems
 			} // if (! masterPageMode) */
@@ -172,7 +204,7 @@ QRegion PageItem_TextFrame::availableRegion(QRegion clip)
 				if (((docItem->ItemNr > ItemNr) && (docItem->LayerID == LayerID)) || (LayerLevItem > LayerLev && m_Doc->layerFlow(docItem->LayerID)))
 				{
 					if (docItem->textFlowAroundObject())
-						result = result.subtract(itemShape(docItem, 0, 0));
+						result.append(wrapSource(docItem, 0, 0, docItem->textFlowMode()));
 				}
 			} // for all docItems
 		} // if(OnMasterPage.isEmpty()		
@@ -180,6 +212,52 @@ QRegion PageItem_TextFrame::availableRegion(QRegion clip)
 	return result;
 }
 
+TextWrapShape PageItem_TextFrame::availableShape(const QList<WrapSource>& sources)
+{
+	TextWrapShape result;
+	if (sources.isEmpty())
+		return result;
+	const WrapSource& frame(sources.first());
+	// the layout works in frame coordinates, which are mirrored for flipped frames
+	QTransform flip;
+	if (frame.flippedH)
+	{
+		flip.translate(frame.width, 0);
+		flip.scale(-1, 1);
+	}
+	if (frame.flippedV)
+	{
+		flip.translate(0, frame.height);
+		flip.scale(1, -1);
+	}
+	QTransform toPage;
+	toPage.translate(frame.xPos, frame.yPos);
+	toPage.rotate(frame.rotation);
+	QTransform toFrame = (flip * toPage).inverted();
+	result.setFrame(flip.inverted().map(QPolygonF(frame.clip)));
+	for (int i = 1; i < sources.count(); ++i)
+		addObstacle(result, toFrame, sources[i]);
+	return result;
+}
+
+bool PageItem_TextFrame::updateWrapShape()
+{
+	QList<WrapSource> sources;
+	if (itemText.length() != 0)
+		sources = wrapSources();
+	// the polygons are only rebuilt if the frame or an item text flows around changed
+	if (sources == m_wrapSources)
+		return false;
+	m_wrapSources = sources;
+	TextWrapShape shape = availableShape(sources);
+	// keep the old shape if the change did not reach into the frame, its span cache is still valid
+	if (shape == m_wrapShape)
+		return false;
+	m_wrapShape = shape;
+	m_layoutCached = false;
+	return true;
+}
+
 
 void PageItem_TextFrame::setShadow()
 {
@@ -284,6 +362,83 @@ static void fillInTabLeaders(StoryText & itemText, LineSpec & curLine)
 }
 
 
+static GlyphLayout* copyGlyphChain(const GlyphLayout* layout)
+{
+	if (!layout)
+		return NULL;
+	GlyphLayout* result;
+	const TabLayout* tabLayout = dynamic_cast<const TabLayout*>(layout);
+	if (tabLayout)
+		result = new TabLayout(*tabLayout);
+	else
+		result = new GlyphLayout(*layout);
+	result->more = copyGlyphChain(layout->more);
+	return result;
+}
+
+/**
+ Remembers the glyphs of all chars touched by a layout run. When the run
+ stops in front of text whose lines are reused by the next frame, the
+ chars of the line which did not fit any more are put back.
+ */
+class GlyphBackup
+{
+public:
+	GlyphBackup() : m_enabled(false), m_last(-1) {}
+	~GlyphBackup() { clear(); }
+
+	void setEnabled(bool enabled) { m_enabled = enabled; }
+
+	void save(int index, ScText* hl)
+	{
+		if (!m_enabled || index <= m_last)
+			return;
+		Entry entry;
+		entry.index = index;
+		entry.effects = hl->effects();
+		entry.glyph = hl->glyph;
+		entry.glyph.more = copyGlyphChain(hl->glyph.more);
+		m_entries.append(entry);
+		m_last = index;
+	}
+
+	void restore(StoryText& itemText, int from)
+	{
+		for (int i = 0; i < m_entries.count(); ++i)
+		{
+			Entry& entry(m_entries[i]);
+			if (entry.index < from)
+				continue;
+			ScText* hl = itemText.item(entry.index);
+			hl->setEffects(entry.effects);
+			hl->glyph.shrink();
+			hl->glyph = entry.glyph;
+			entry.glyph.more = NULL;
+		}
+		clear();
+	}
+
+	void clear()
+	{
+		for (int i = 0; i < m_entries.count(); ++i)
+			m_entries[i].glyph.shrink();
+		m_entries.clear();
+		m_last = -1;
+	}
+
+private:
+	struct Entry
+	{
+		int index;
+		StyleFlag effects;
+		GlyphLayout glyph;
+	};
+	QList<Entry> m_entries;
+	bool m_enabled;
+	int m_last;
+};
+
+
 
 enum TabStatus {
 	TabNONE    = 0,
@@ -460,28 +615,16 @@ struct LineControl {
 	}
 	
 	/// find x position to start current line
-	double startOfLine(const QRegion& shape, const QTransform& pf2, double ascent, double descent, double morespace)
+	double startOfLine(const TextWrapShape& shape, double ascent, double descent, double morespace)
 	{
-		QPoint pt1, pt2;
-		double tmpX = xPos;
-		pt1 = QPoint(static_cast<int>(ceil(tmpX)), static_cast<int>(yPos + descent));
-		pt2 = QPoint(static_cast<int>(ceil(tmpX)), static_cast<int>(ceil(yPos - ascent)));
-		// increase pt1/pt2 until i-beam reaches end of line
-		while ((!shape.contains(pf2.map(pt1))) || (!shape.contains(pf2.map(pt2))))
-		{
-			tmpX++;
-			if (xPos + (legacy? lineCorr + insets.Right : 0) + lineCorr + morespace >= colRight)
-			{
-				return tmpX;
-			}
-			pt1 = QPoint(static_cast<int>(ceil(tmpX)), static_cast<int>(yPos + descent));
-			pt2 = QPoint(static_cast<int>(ceil(tmpX)), static_cast<int>(ceil(yPos - ascent)));
-		}
-		return tmpX;
+		// the first position where the whole i-beam is free, at most the end of the column
+		double maxX = colRight - morespace - lineCorr;
+		if (legacy) maxX -= (lineCorr + insets.Right);
+		return qMin(shape.nextFit(xPos, yPos - ascent, yPos + descent), qMax(xPos, maxX));
 	}
 	
 	/// find x position where this line must end
-	double endOfLine(const QRegion& shape, const QTransform& pf2, double morespace = 0)
+	double endOfLine(const TextWrapShape& shape, double morespace = 0)
 	{
 		// Keep old code for reference
 		/*double EndX = floor(qMax(line.x, qMin(colRight,breakXPos) - 1));
@@ -501,47 +644,10 @@ struct LineControl {
 		if (legacy) maxX -= (lineCorr + insets.Right);
 
 		double StartX = floor(qMax(line.x, qMin(colRight,breakXPos) - 1));
-		int xPos  = static_cast<int>(ceil(maxX + insets.Right));
-		int yDesc = static_cast<int>(yPos+line.descent);
-		int yAsc  = static_cast<int>(ceil(yPos-line.ascent));
-
-		QPoint pt12 (xPos, yDesc);
-		QPoint pt22 (xPos, yAsc);
-
-		// simple and fast case: transformed line completely falls within range
-		// this will happen if we don't wrap around anything - ie. very often
-		QPolygon p;
-		p.append (pf2.map (QPoint (StartX, yAsc)));
-		p.append (pf2.map (QPoint (StartX, yDesc)));
-		p.append (pf2.map (pt12));
-		p.append (pf2.map (pt22));
-		// check if something gets in the way
-		QRegion lineI = shape.intersected (p.boundingRect());
-		// if the intersection only has 1 rectangle, then nothing gets in the way
-		if (lineI.numRects() == 1)
-		{
-			int xPos = qRound(ceil(StartX + 0.125 + insets.Right));
-			pt12.setX(xPos);
-			pt22.setX(xPos);
-			if (shape.contains(pf2.map(pt12)) && shape.contains(pf2.map(pt22)))
-			{
-				QRect rect = lineI.rects().at(0);
-				double  mx = qMax(rect.left(), rect.right()) - pf2.dx(); 
-				int steps = static_cast<int>((mx - StartX - insets.Right - 2)/0.125);
-				if (steps > 0)
-					StartX += steps * 0.125;
-			}
-		}
-
-		// qDebug()<<"endOfLine: going for the hard case";
-		double EndX2 = StartX;
-		double Interval = 0.125;
-		do {
-			EndX2 += Interval;
-			int xPos = qRound(ceil(EndX2 + insets.Right));
-			pt12.setX (xPos);
-			pt22.setX (xPos);
-		} while ((EndX2 < maxX) && shape.contains(pf2.map(pt12)) && shape.contains(pf2.map(pt22)));
+
+		// the line ends where the i-beam behind StartX leaves the free band of the line
+		double limit = shape.freeUntil(StartX + insets.Right, yPos - line.ascent, yPos + line.descent) - insets.Right;
+		double EndX2 = qMin(maxX, qMax(StartX + 0.125, limit));
 
 		/*if (EndX!=EndX2) 
 		{
@@ -928,8 +1034,6 @@ void PageItem_TextFrame::layout()
 	
 //	qDebug() << QString("textframe(%1,%2): len=%3, start relayout at %4").arg(Xpos).arg(Ypos).arg(itemText.length()).arg(firstInFrame());
 //	ScribusView* view = m_Doc->view();
-	QTransform pf2;
-	QPoint pt1, pt2;
 	/*QRegion cm;*/
 	double chs, chsd = 0;
 	double oldCurY, EndX, OFs, wide, kernVal;
@@ -958,9 +1062,6 @@ void PageItem_TextFrame::layout()
 	int    DropLines = 0;
 	int    DropLinesCount = 0;
 	
-	
-	itemText.clearLines();
-
 	double lineCorr = 0;
 	if (lineColor() != CommonStrings::None)
 		lineCorr = m_lineWidth / 2.0;
@@ -988,30 +1089,49 @@ void PageItem_TextFrame::layout()
 	dumpIt(itemText.defaultStyle());
 */	
 	
-//	pf2.begin(view->viewport());
-	pf2.translate(Xpos, Ypos);
-	pf2.rotate(Rot);
-	
 	setShadow();
-	if ((itemText.length() != 0)) // || (NextBox != 0))
+
+	// determine layout area
+	updateWrapShape();
+	const TextWrapShape& wrap(m_wrapShape);
+
+	// The lines of the last run can be kept if the frame did not change and
+	// all edits happened in paragraphs behind it. Otherwise we relayout and
+	// check whether the following frames can keep their (shifted) lines.
+	LayoutGeometry geometry = layoutGeometry(lineCorr);
+	LayoutDamage damage = itemText.layoutDamage();
+	bool cacheUsable = m_layoutCached && OnMasterPage.isEmpty() && !m_cachedHasObjects
+		&& !damage.full && geometry == m_cachedGeometry;
+	uint oldMaxChars = m_cachedMaxChars;
+	bool hasInlineObjects = false;
+	bool usesBaselineGrid = false;
+	GlyphBackup glyphBackup;
+	glyphBackup.setEnabled(cacheUsable && damage.changed && NextBox != NULL);
+	if (cacheUsable && firstChar == m_cachedFirstChar)
 	{
-		// determine layout area
-		QRegion cl = availableRegion(QRegion(pf2.map(Clip)));
-		if (cl.isEmpty())
+		bool keepLines = !damage.changed;
+		if (!keepLines)
 		{
-			MaxChars = firstInFrame();
-			goto NoRoom;
+			int restart = itemText.startOfParagraph(itemText.nrOfParagraph(damage.first));
+			keepLines = signed(m_cachedMaxChars) < restart;
 		}
-		
-		if (imageFlippedH())
+		if (keepLines)
 		{
-			pf2.translate(Width, 0);
-			pf2.scale(-1, 1);
+			usesBaselineGrid = m_cachedUsesGrid;
+			MaxChars = m_cachedMaxChars;
+			if (signed(MaxChars) < itemText.length())
+				goto NoRoom;
+			goto EndOfText;
 		}
-		if (imageFlippedV())
+	}
+
+	itemText.clearLines();
+	if ((itemText.length() != 0)) // || (NextBox != 0))
+	{
+		if (wrap.isEmpty())
 		{
-			pf2.translate(0, Height);
-			pf2.scale(1, -1);
+			MaxChars = firstInFrame();
+			goto NoRoom;
 		}
 		
 		current.nextColumn(0);
@@ -1056,6 +1176,9 @@ void PageItem_TextFrame::layout()
 		for (int a = firstInFrame(); a < itemText.length(); ++a)
 		{
 			hl = itemText.item(a);
+			glyphBackup.save(a, hl);
+			if (hl->ch == SpecialChars::OBJECT)
+				hasInlineObjects = true;
 			if (a > 0 && itemText.text(a-1) == SpecialChars::PARSEP)
 				style = itemText.paragraphStyle(a);
 			if (current.itemsInLine == 0)
@@ -1344,6 +1467,7 @@ void PageItem_TextFrame::layout()
 					if (style.lineSpacingMode() == ParagraphStyle::BaselineGridLineSpacing)
 					{
 						double by = Ypos;
+						usesBaselineGrid = true;
 						if (OwnPage != -1)
 							by = Ypos - m_Doc->Pages->at(OwnPage)->yOffset();
 						int ol1 = qRound((by + current.yPos - m_Doc->guidesPrefs().offsetBaselineGrid) * 10000.0);
@@ -1379,6 +1503,7 @@ void PageItem_TextFrame::layout()
 				if (style.lineSpacingMode() == ParagraphStyle::BaselineGridLineSpacing)
 				{
 					double by = Ypos;
+					usesBaselineGrid = true;
 					if (OwnPage != -1)
 						by = Ypos - m_Doc->Pages->at(OwnPage)->yOffset();
 					int ol1 = qRound((by + current.yPos - m_Doc->guidesPrefs().offsetBaselineGrid) * 10000.0);
@@ -1395,16 +1520,14 @@ void PageItem_TextFrame::layout()
 				}
 				 */
 				// find linelength:
-				pt1 = QPoint(static_cast<int>(ceil(current.xPos)), static_cast<int>(current.yPos+BotOffset));
-				pt2 = QPoint(static_cast<int>(ceil(current.xPos)), static_cast<int>(ceil(current.yPos-TopOffset)));
-				// increase pt1/pt2 until i-beam reaches end of line
+				// move right until the i-beam fits into the free band of the line
 //				qDebug() << QString("linestart: %1 + %2 + %3 < %4").arg(current.xPos).arg(wide).arg(style.rightMargin()).arg(current.colRight);
 				double leftIndent = 0;
 				double xStep = legacy? 1 : 0.125;
-				while (!cl.contains(pf2.map(pt1)) || !cl.contains(pf2.map(pt2)) || current.isEndOfLine(wide + leftIndent + style.rightMargin()))
+				while (!wrap.fits(current.xPos, current.yPos - TopOffset, current.yPos + BotOffset) || current.isEndOfLine(wide + leftIndent + style.rightMargin()))
 				{
 					fBorder = true;
-					current.xPos += xStep;
+					current.xPos = qMax(current.xPos + xStep, wrap.nextFit(current.xPos, current.yPos - TopOffset, current.yPos + BotOffset));
 					if (current.isEndOfLine(wide + leftIndent + style.rightMargin()))
 					{
 //						qDebug() << QString("eocol %5? %1 + %2 + %3 + %4").arg(current.yPos).arg(current.startOfCol).arg(style.lineSpacingMode() == ParagraphStyle::BaselineGridLineSpacing).arg(style.lineSpacing()).arg(current.column);
@@ -1424,6 +1547,7 @@ void PageItem_TextFrame::layout()
 						if (style.lineSpacingMode() == ParagraphStyle::BaselineGridLineSpacing)
 						{
 							double by = Ypos;
+							usesBaselineGrid = true;
 							if (OwnPage != -1)
 								by = Ypos - m_Doc->Pages->at(OwnPage)->yOffset();
 							int ol1 = qRound((by + current.yPos - m_Doc->guidesPrefs().offsetBaselineGrid) * 10000.0);
@@ -1458,6 +1582,7 @@ void PageItem_TextFrame::layout()
 								if (style.lineSpacingMode() == ParagraphStyle::BaselineGridLineSpacing)
 								{
 									double by = Ypos;
+									usesBaselineGrid = true;
 									if (OwnPage != -1)
 										by = Ypos - m_Doc->Pages->at(OwnPage)->yOffset();
 									int ol1 = qRound((by + current.yPos - m_Doc->guidesPrefs().offsetBaselineGrid) * 10000.0);
@@ -1474,8 +1599,6 @@ void PageItem_TextFrame::layout()
 							}
 						}
 					}
-					pt1 = QPoint(static_cast<int>(ceil(current.xPos)), static_cast<int>(current.yPos+BotOffset));
-					pt2 = QPoint(static_cast<int>(ceil(current.xPos)), static_cast<int>(ceil(current.yPos-TopOffset)));
 				}
 
 				if (((fBorder)) && (!current.hasDropCap))
@@ -1603,34 +1726,31 @@ void PageItem_TextFrame::layout()
 			}		
 			
 			//FIXME: asce / desc set correctly?
+			double endX;
 			if (legacy && 
 				(((hl->ch == '-' || (hl->effects() & ScStyle_HyphenationPossible)) && (current.hyphenCount < m_Doc->hyphConsecutiveLines() || m_Doc->hyphConsecutiveLines() == 0))
 				|| hl->ch == SpecialChars::SHYPHEN))
 			{
 				if (hl->effects() & ScStyle_HyphenationPossible || hl->ch == SpecialChars::SHYPHEN)
 				{
-					pt1 = QPoint(qRound(ceil(current.xPos+extra.Right - current.maxShrink + charStyle.font().charWidth('-', charStyle.fontSize() / 10.0) * (charStyle.scaleH() / 1000.0))), qRound(current.yPos+desc));
-					pt2 = QPoint(qRound(ceil(current.xPos+extra.Right - current.maxShrink + charStyle.font().charWidth('-', charStyle.fontSize() / 10.0) * (charStyle.scaleH() / 1000.0))), qRound(ceil(current.yPos-asce)));
+					endX = current.xPos+extra.Right - current.maxShrink + charStyle.font().charWidth('-', charStyle.fontSize() / 10.0) * (charStyle.scaleH() / 1000.0);
 				}
 				else
 				{
-					pt1 = QPoint(qRound(ceil(current.xPos+extra.Right - current.maxShrink )), qRound(current.yPos+desc));
-					pt2 = QPoint(qRound(ceil(current.xPos+extra.Right - current.maxShrink )), qRound(ceil(current.yPos-asce)));
+					endX = current.xPos+extra.Right - current.maxShrink;
 				}
 			}
 			else if (!legacy && SpecialChars::isBreakingSpace(hl->ch))
 			{
-				pt1 = QPoint(qRound(ceil(breakPos + extra.Right - current.maxShrink )), qRound(current.yPos+desc));
-				pt2 = QPoint(qRound(ceil(breakPos + extra.Right - current.maxShrink )), qRound(ceil(current.yPos-asce)));
+				endX = breakPos + extra.Right - current.maxShrink;
 			}
 			else
 			{
-				pt1 = QPoint(qRound(ceil(current.xPos+extra.Right - current.maxShrink)), qRound(current.yPos+desc));
-				pt2 = QPoint(qRound(ceil(current.xPos+extra.Right - current.maxShrink)), qRound(ceil(current.yPos-asce)));
+				endX = current.xPos+extra.Right - current.maxShrink;
 			}
 			
 			// test if end of line reached
-			if ((!cl.contains(pf2.map(pt1))) || (!cl.contains(pf2.map(pt2))) || (legacy && current.isEndOfLine(style.rightMargin())))
+			if (!wrap.fits(endX, current.yPos - asce, current.yPos + desc) || (legacy && current.isEndOfLine(style.rightMargin())))
 				outs = true;
 			if (current.isEndOfCol())
 				outs = true;
@@ -1711,6 +1831,7 @@ void PageItem_TextFrame::layout()
 				{
 					current.yPos -= m_Doc->guidesPrefs().valueBaselineGrid * (DropLines-1);
 					double by = Ypos;
+					usesBaselineGrid = true;
 					if (OwnPage != -1)
 						by = Ypos - m_Doc->Pages->at(OwnPage)->yOffset();
 					int ol1 = qRound((by + current.yPos - m_Doc->guidesPrefs().offsetBaselineGrid) * 10000.0);
@@ -1756,7 +1877,7 @@ void PageItem_TextFrame::layout()
 				{
 					// find end of line
 					current.breakLine(itemText, style, firstLineOffset(), a);
-					EndX = current.endOfLine(cl, pf2, style.rightMargin());
+					EndX = current.endOfLine(wrap, style.rightMargin());
 					current.finishLine(EndX);
 					
 //					if (style.alignment() != 0)
@@ -1825,7 +1946,7 @@ void PageItem_TextFrame::layout()
 						
 						current.updateHeightMetrics(itemText);
 						current.updateLineOffset(itemText, style, firstLineOffset());
-						EndX = current.endOfLine(cl, pf2, style.rightMargin());
+						EndX = current.endOfLine(wrap, style.rightMargin());
 						current.finishLine(EndX);
 
 //???						current.breakXPos = current.line.x;
@@ -1908,7 +2029,7 @@ void PageItem_TextFrame::layout()
 //						qDebug() << QString("style nb @%6: %1 -- %2, %4/%5 char: %3").arg(style.leftMargin()).arg(style.rightMargin())
 //							   .arg(style.charStyle().asString()).arg(style.name()).arg(style.parent())
 //							   .arg(a);
-						EndX = current.endOfLine(cl, pf2, style.rightMargin());
+						EndX = current.endOfLine(wrap, style.rightMargin());
 						current.finishLine(EndX);
 //						qDebug() << QString("no break pos: %1-%2 @ %3 wid %4 nat %5 endX %6")
 //							   .arg(current.line.firstItem).arg(current.line.firstItem)
@@ -1974,13 +2095,9 @@ void PageItem_TextFrame::layout()
 								}
 								break;
 							}
-							// #7944 : Do not use static_cast<int> here, this is not consistent with computations
-							// performed at lines 1488-1512 and can trigger hang due to changing region detection
-							//pt1 = QPoint(qRound(current.xPos+extra.Right), static_cast<int>(current.yPos+BotOffset));
-							//pt2 = QPoint(qRound(current.xPos+extra.Right), static_cast<int>(ceil(current.yPos-asce)));
-							pt1 = QPoint(qRound(current.xPos+extra.Right), qRound(current.yPos+BotOffset));
-							pt2 = QPoint(qRound(current.xPos+extra.Right), qRound(ceil(current.yPos-asce)));
-							if (cl.contains(pf2.map(pt1)) && cl.contains(pf2.map(pt2)))
+							// #7944 : the fit test must be the same as the one at the start of the line,
+							// otherwise a changing region detection can trigger a hang
+							if (wrap.fits(current.xPos+extra.Right, current.yPos - asce, current.yPos + BotOffset))
 								break;
 //							else
 //								qDebug() << QString("looking for start of line at %1,%2").arg(current.xPos).arg(current.yPos);
@@ -2148,7 +2265,7 @@ void PageItem_TextFrame::layout()
 		int a = itemText.length()-1;
 		hl = a >=0 ? itemText.item(a) : NULL;
 		current.breakLine(itemText, style, firstLineOffset(), a);
-		EndX = current.endOfLine(cl, pf2, style.rightMargin());
+		EndX = current.endOfLine(wrap, style.rightMargin());
 		current.finishLine(EndX);
 
 //		if (style.alignment() != 0)
@@ -2203,7 +2320,9 @@ void PageItem_TextFrame::layout()
 		}
 	}
 	MaxChars = itemText.length();
+EndOfText:
 	invalid = false;
+	rememberLayout(geometry, hasInlineObjects, usesBaselineGrid);
 //	pf2.end();
 	if (NextBox != NULL) 
 	{
@@ -2220,9 +2339,35 @@ void PageItem_TextFrame::layout()
 NoRoom:     
 //	pf2.end();
 	invalid = false;
+	rememberLayout(geometry, hasInlineObjects, usesBaselineGrid);
 	PageItem_TextFrame * next = dynamic_cast<PageItem_TextFrame*>(NextBox);
 	if (next != NULL)
 	{
+		// all edits were in this frame and it still ends at the same text:
+		// the following frames only need to move their lines
+		if (cacheUsable && damage.changed && damage.end < signed(MaxChars)
+			&& signed(MaxChars) == signed(oldMaxChars) + damage.delta)
+		{
+			glyphBackup.restore(itemText, qMax(signed(MaxChars), itemText.lastInFrame() + 1));
+			PageItem_TextFrame* frame = next;
+			uint nextFirst = MaxChars;
+			while (frame != NULL && frame->reuseShiftedLayout(nextFirst))
+			{
+				nextFirst = frame->MaxChars;
+				frame = dynamic_cast<PageItem_TextFrame*>(frame->NextBox);
+			}
+			if (frame != next)
+			{
+				if (frame != NULL)
+				{
+					frame->invalid = true;
+					frame->firstChar = nextFirst;
+					if (signed(nextFirst) < itemText.length())
+						frame->layout();
+				}
+				return;
+			}
+		}
 		next->invalid = true;
 		next->firstChar = MaxChars;
 		if (itemText.cursorPosition() > signed(MaxChars))
@@ -2246,22 +2391,99 @@ NoRoom:
 //	qDebug("textframe: len=%d, done relayout (no room %d)", itemText.length(), MaxChars);
 }
 
+bool PageItem_TextFrame::LayoutGeometry::operator==(const LayoutGeometry& other) const
+{
+	return width == other.width && height == other.height
+		&& extraLeft == other.extraLeft && extraTop == other.extraTop
+		&& extraRight == other.extraRight && extraBottom == other.extraBottom
+		&& columnGap == other.columnGap && lineCorr == other.lineCorr
+		&& pageOffset == other.pageOffset && gridTop == other.gridTop
+		&& gridDistance == other.gridDistance && gridOffset == other.gridOffset && columns == other.columns
+		&& ownPage == other.ownPage && firstLineOffset == other.firstLineOffset
+		&& flippedH == other.flippedH && flippedV == other.flippedV;
+}
+
+PageItem_TextFrame::LayoutGeometry PageItem_TextFrame::layoutGeometry(double lineCorr) const
+{
+	LayoutGeometry geometry;
+	geometry.width       = Width;
+	geometry.height      = Height;
+	geometry.extraLeft   = Extra;
+	geometry.extraTop    = TExtra;
+	geometry.extraRight  = RExtra;
+	geometry.extraBottom = BExtra;
+	geometry.columnGap   = ColGap;
+	geometry.lineCorr    = lineCorr;
+	geometry.pageOffset  = (OwnPage != -1) ? m_Doc->Pages->at(OwnPage)->yOffset() : 0.0;
+	// lines on the baseline grid depend on where the frame is on the page
+	geometry.gridTop      = m_cachedUsesGrid ? Ypos - geometry.pageOffset : 0.0;
+	geometry.gridDistance = m_cachedUsesGrid ? m_Doc->guidesPrefs().valueBaselineGrid : 0.0;
+	geometry.gridOffset   = m_cachedUsesGrid ? m_Doc->guidesPrefs().offsetBaselineGrid : 0.0;
+	geometry.columns     = Cols;
+	geometry.ownPage     = OwnPage;
+	geometry.firstLineOffset = firstLineOffset();
+	geometry.flippedH    = imageFlippedH();
+	geometry.flippedV    = imageFlippedV();
+	return geometry;
+}
+
+void PageItem_TextFrame::rememberLayout(const LayoutGeometry& geometry, bool hasInlineObjects, bool usesBaselineGrid)
+{
+	m_layoutCached     = true;
+	m_cachedHasObjects = hasInlineObjects;
+	m_cachedFirstChar  = firstChar;
+	m_cachedMaxChars   = MaxChars;
+	m_cachedUsesGrid   = usesBaselineGrid;
+	// the grid position only counts if the lines just laid out used the grid
+	m_cachedGeometry   = layoutGeometry(geometry.lineCorr);
+	itemText.markLayoutValid();
+}
+
+bool PageItem_TextFrame::reuseShiftedLayout(uint newFirstChar)
+{
+	if (!m_layoutCached || !OnMasterPage.isEmpty() || m_cachedHasObjects)
+		return false;
+	LayoutDamage damage = itemText.layoutDamage();
+	if (damage.full || signed(m_cachedFirstChar) + damage.delta != signed(newFirstChar))
+		return false;
+	if (damage.changed && damage.end >= signed(newFirstChar))
+		return false;
+	double lineCorr = 0;
+	if (lineColor() != CommonStrings::None)
+		lineCorr = m_lineWidth / 2.0;
+	if (layoutGeometry(lineCorr) != m_cachedGeometry)
+		return false;
+	if (updateWrapShape())
+		return false;
+	itemText.shiftLines(damage.delta);
+	firstChar = newFirstChar;
+	MaxChars  = m_cachedMaxChars + damage.delta;
+	m_cachedFirstChar = firstChar;
+	m_cachedMaxChars  = MaxChars;
+	itemText.markLayoutValid();
+	invalid = false;
+	return true;
+}
+
 void PageItem_TextFrame::invalidateLayout()
 {
 	const bool wholeChain = true;
 	this->invalid = true;
+	increaseRevision();
 	if (wholeChain)
 	{
 		PageItem *prevFrame = this->prevInChain();
 		while (prevFrame != 0)
 		{
 			prevFrame->invalid = true;
+			prevFrame->increaseRevision();
 			prevFrame = prevFrame->prevInChain();
 		}
 		PageItem *nextFrame = this->nextInChain();
 		while (nextFrame != 0)
 		{
 			nextFrame->invalid = true;
+			nextFrame->increaseRevision();
 			nextFrame = nextFrame->nextInChain();
 		}
 	}
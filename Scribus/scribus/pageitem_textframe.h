@@ -24,11 +24,13 @@ for which a new license (GPL+exception) is in place.
 
 #include <QMap>
 #include <QRectF>
+#include <QTransform>
 #include <QString>
 #include <QKeyEvent>
 
 #include "scribusapi.h"
 #include "pageitem.h"
+#include "textwrapshape.h"
 
 class ScPainter;
 class ScribusDoc;
@@ -82,7 +84,6 @@ protected:
 	virtual void DrawObj_Post(ScPainter *p);
 	virtual void DrawObj_Decoration(ScPainter *p);
 	void drawColumnBorders(ScPainter *p);
-	QRegion availableRegion(QRegion clip);
 
 #ifdef NLS_PROTO
 	void DrawLineItem(ScPainter *p, double width,
@@ -100,6 +101,76 @@ protected:
 private:
 	bool cursorBiasBackward;
 
+	/// frame properties which influence the line layout besides the available region
+	struct LayoutGeometry
+	{
+		double width;
+		double height;
+		double extraLeft;
+		double extraTop;
+		double extraRight;
+		double extraBottom;
+		double columnGap;
+		double lineCorr;
+		double pageOffset;
+		/// top of the frame on its page and the grid, if the lines were snapped to the baseline grid
+		double gridTop;
+		double gridDistance;
+		double gridOffset;
+		int    columns;
+		int    ownPage;
+		int    firstLineOffset;
+		bool   flippedH;
+		bool   flippedV;
+		bool operator==(const LayoutGeometry& other) const;
+		bool operator!=(const LayoutGeometry& other) const { return !(*this == other); }
+	};
+	LayoutGeometry layoutGeometry(double lineCorr) const;
+
+	/// the geometry of an item which the wrap shape depends on, cheap to copy and compare
+	struct WrapSource
+	{
+		PageItem* item;
+		double xPos;
+		double yPos;
+		double rotation;
+		double width;
+		double height;
+		TextFlowMode flow;
+		bool   flippedH;
+		bool   flippedV;
+		QPolygon clip;
+		/// image clip or contour line, if the flow mode uses one
+		FPointArray outline;
+		bool operator==(const WrapSource& other) const;
+	};
+	/// the frame followed by the items text flows around
+	QList<WrapSource> wrapSources();
+	static WrapSource wrapSource(PageItem* docItem, double xOffset, double yOffset, TextFlowMode flow);
+	/// the outline text has to flow around in page coordinates, only the part inside of clip if that is set
+	static void itemShape(const WrapSource& source, QList<QPolygonF>& shape, QList<QPolygonF>& clip);
+	/// the frame area minus the objects text flows around, in frame coordinates
+	TextWrapShape availableShape(const QList<WrapSource>& sources);
+	void addObstacle(TextWrapShape& wrap, const QTransform& toFrame, const WrapSource& source);
+	/// stores the state of the finished layout run so that its lines can be reused
+	void rememberLayout(const LayoutGeometry& geometry, bool hasInlineObjects, bool usesBaselineGrid);
+	/// rebuilds m_wrapShape if the frame or an item text flows around changed, and drops the cached layout
+	/// if the shape changed. Returns true if it changed.
+	bool updateWrapShape();
+	/// moves the cached lines to start at newFirstChar if only text in front of the frame changed
+	bool reuseShiftedLayout(uint newFirstChar);
+
+	bool m_layoutCached;
+	bool m_cachedHasObjects;
+	bool m_cachedUsesGrid;
+	uint m_cachedFirstChar;
+	uint m_cachedMaxChars;
+	/// available area of the last layout, kept to reuse its span cache
+	TextWrapShape m_wrapShape;
+	/// what m_wrapShape was built from
+	QList<WrapSource> m_wrapSources;
+	LayoutGeometry m_cachedGeometry;
+
 	void setShadow();
 	QString currentShadow;
 	QMap<QString,StoryText> shadows;
@@ -0,0 +1,283 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+
+#include "pagerenderer.h"
+
+#include "commonstrings.h"
+#include "page.h"
+#include "pageitem.h"
+#include "scpainter.h"
+#include "scribusdoc.h"
+#include "sclayer.h"
+#include "text/specialchars.h"
+
+namespace {
+
+/// Returns true if @a item is drawn on @a layer within @a area.
+bool isDrawn(PageItem* item, const ScLayer& layer, const QRectF& area)
+{
+	if ((item->LayerID != layer.ID) || (!item->printEnabled()))
+		return false;
+	return area.intersects(item->getBoundingRect().adjusted(0.0, 0.0, 1.0, 1.0));
+}
+
+/// Returns true if the text of @a item contains the page number or the page count.
+bool showsPageNumber(PageItem* item)
+{
+	if (!item->asTextFrame() && !item->asPathText())
+		return false;
+	QString text = item->itemText.text(0, item->itemText.length());
+	return text.contains(SpecialChars::PAGENUMBER) || text.contains(SpecialChars::PAGECOUNT);
+}
+
+/// Draws the cell borders of the old style table cell @a item, like the canvas does.
+void drawTableBorder(ScPainter* painter, PageItem* item)
+{
+	if ((item->lineColor() == CommonStrings::None) || (item->lineWidth() == 0.0))
+		return;
+	if (!item->TopLine && !item->RightLine && !item->BottomLine && !item->LeftLine)
+		return;
+	painter->save();
+	painter->translate(item->xPos(), item->yPos());
+	painter->rotate(item->rotation());
+	QColor color;
+	item->SetQColor(&color, item->lineColor(), item->lineShade());
+	painter->setPen(color, item->lineWidth(), item->PLineArt, Qt::SquareCap, item->PLineJoin);
+	if (item->TopLine)
+		painter->drawLine(FPoint(0.0, 0.0), FPoint(item->width(), 0.0));
+	if (item->RightLine)
+		painter->drawLine(FPoint(item->width(), 0.0), FPoint(item->width(), item->height()));
+	if (item->BottomLine)
+		painter->drawLine(FPoint(item->width(), item->height()), FPoint(0.0, item->height()));
+	if (item->LeftLine)
+		painter->drawLine(FPoint(0.0, item->height()), FPoint(0.0, 0.0));
+	painter->restore();
+}
+
+} // namespace
+
+PageRenderer::PageRenderer(ScribusDoc* doc) : m_doc(doc)
+{
+	Q_ASSERT(doc);
+}
+
+QImage PageRenderer::render(Page* page, double scale, bool drawFrame) const
+{
+	int width = qRound(page->width() * scale);
+	int height = qRound(page->height() * scale);
+	if ((width <= 0) || (height <= 0))
+		return QImage();
+	QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+	if (image.isNull())
+		return image;
+	render(&image, page, scale);
+	if (drawFrame)
+	{
+		ScPainter *painter = new ScPainter(&image, width, height, 1.0, 0);
+		painter->setPen(Qt::black, 1, Qt::SolidLine, Qt::FlatCap, Qt::MiterJoin);
+		painter->setFillMode(ScPainter::None);
+		painter->drawRect(0, 0, width, height);
+		painter->end();
+		delete painter;
+	}
+	return image;
+}
+
+void PageRenderer::render(QImage* image, Page* page, double scale, const QPoint& offset) const
+{
+	ScPainter *painter = new ScPainter(image, image->width(), image->height(), 1.0, 0);
+	painter->setShowGuides(false);
+	painter->clear(m_doc->paperColor());
+	QRectF pageRect(page->xOffset(), page->yOffset(), page->width(), page->height());
+	QRectF area(page->xOffset() + offset.x() / scale, page->yOffset() + offset.y() / scale, image->width() / scale, image->height() / scale);
+	area &= pageRect;
+	if (!area.isEmpty())
+	{
+		painter->setZoomFactor(scale);
+		painter->translate(-page->xOffset() - offset.x() / scale, -page->yOffset() - offset.y() / scale);
+		painter->setLineWidth(1);
+		painter->setFillMode(ScPainter::Solid);
+		painter->beginLayer(1.0, 0);
+		render(painter, page, area);
+		painter->endLayer();
+	}
+	painter->end();
+	delete painter;
+}
+
+QImage PageRenderer::renderToSize(Page* page, int maxSize, bool drawFrame) const
+{
+	if ((page->width() <= 0.0) || (page->height() <= 0.0))
+		return QImage();
+	double scale = qMin(maxSize / page->width(), maxSize / page->height());
+	return render(page, scale, drawFrame);
+}
+
+void PageRenderer::render(ScPainter* painter, Page* page, const QRectF& area) const
+{
+	QRectF cullingArea(area);
+	if (cullingArea.isNull())
+		cullingArea = QRectF(page->xOffset(), page->yOffset(), page->width(), page->height());
+	bool isMasterPage = m_doc->MasterPages.contains(page);
+	Page* masterPage = NULL;
+	if (!isMasterPage && !page->MPageNam.isEmpty() && m_doc->MasterNames.contains(page->MPageNam))
+		masterPage = m_doc->MasterPages.at(m_doc->MasterNames[page->MPageNam]);
+
+	ScLayer layer;
+	int layerCount = m_doc->layerCount();
+	for (int layerLevel = 0; layerLevel < layerCount; ++layerLevel)
+	{
+		m_doc->Layers.levelToLayer(layer, layerLevel);
+		if ((!layer.isViewable) || (!layer.isPrintable))
+			continue;
+		if (masterPage)
+			drawMasterItems(painter, page, masterPage, layer, cullingArea);
+		if (isMasterPage)
+			drawItems(painter, m_doc->MasterItems, page, layer, cullingArea);
+		else
+			drawItems(painter, m_doc->DocItems, NULL, layer, cullingArea);
+	}
+}
+
+PageRenderer::ImageResolutions PageRenderer::loadFullResolutionImages(Page* page) const
+{
+	ImageResolutions resolutions;
+	bool isMasterPage = m_doc->MasterPages.contains(page);
+	QList<PageItem*> items = isMasterPage ? QList<PageItem*>() : page->FromMaster;
+	const QList<PageItem*>& pageItems = isMasterPage ? m_doc->MasterItems : m_doc->DocItems;
+	QRectF pageRect(page->xOffset(), page->yOffset(), page->width(), page->height());
+	for (int i = 0; i < pageItems.count(); ++i)
+	{
+		PageItem* currItem = pageItems.at(i);
+		if (pageRect.intersects(currItem->getBoundingRect().adjusted(0.0, 0.0, 1.0, 1.0)))
+			items.append(currItem);
+	}
+	ImageResolutions previous;
+	for (int i = 0; i < items.count(); ++i)
+	{
+		PageItem* currItem = items.at(i);
+		if ((!currItem->asImageFrame()) || (!currItem->PictureIsAvailable) || (currItem->pixm.imgInfo.lowResType == 0))
+			continue;
+		previous.append(qMakePair(currItem, currItem->pixm.imgInfo.lowResType));
+		resolutions.append(qMakePair(currItem, 0));
+	}
+	restoreImageResolutions(resolutions);
+	return previous;
+}
+
+void PageRenderer::restoreImageResolutions(const ImageResolutions& resolutions) const
+{
+	if (resolutions.isEmpty())
+		return;
+	bool wasLoading = m_doc->isLoading();
+	m_doc->setLoading(true);
+	for (int i = 0; i < resolutions.count(); ++i)
+	{
+		PageItem* currItem = resolutions.at(i).first;
+		currItem->pixm.imgInfo.lowResType = resolutions.at(i).second;
+		int fho = currItem->imageFlippedH();
+		int fvo = currItem->imageFlippedV();
+		m_doc->loadPict(currItem->Pfile, currItem, true);
+		currItem->setImageFlippedH(fho);
+		currItem->setImageFlippedV(fvo);
+	}
+	m_doc->setLoading(wasLoading);
+}
+
+void PageRenderer::drawMasterItems(ScPainter* painter, Page* page, Page* masterPage, const ScLayer& layer, const QRectF& area) const
+{
+	if (page->FromMaster.isEmpty())
+		return;
+	// Master items are drawn by moving the painter instead of the items. Items changed
+	// on the page already are where they are drawn.
+	double dx = page->xOffset() - masterPage->xOffset();
+	double dy = page->yOffset() - masterPage->yOffset();
+	QRectF masterArea(area.translated(-dx, -dy));
+	bool blend = blendsLayer(layer);
+	if (blend)
+		painter->beginLayer(layer.transparency, layer.blendMode);
+	for (int i = 0; i < page->FromMaster.count(); ++i)
+	{
+		PageItem* currItem = page->FromMaster.at(i);
+		if ((currItem->OwnPage != -1) && (currItem->OwnPage != masterPage->pageNr()))
+			continue;
+		bool moved = !currItem->ChangedMasterItem;
+		if (!isDrawn(currItem, layer, moved ? masterArea : area))
+			continue;
+		// Master items are laid out for the page in OwnPage, so it is switched to the
+		// rendered page like Canvas::drawMasterItem() does. The page number is part of
+		// the layout, which has to be redone for this page and again for the canvas.
+		// Only the layout is marked invalid, the revision of the item stays the same.
+		bool relayout = showsPageNumber(currItem);
+		int savedOwnPage = currItem->savedOwnPage;
+		currItem->savedOwnPage = currItem->OwnPage;
+		currItem->OwnPage = page->pageNr();
+		if (relayout)
+			currItem->invalid = true;
+		painter->save();
+		if (moved)
+			painter->translate(dx, dy);
+		currItem->DrawObj(painter, moved ? masterArea : area);
+		painter->restore();
+		currItem->OwnPage = currItem->savedOwnPage;
+		currItem->savedOwnPage = savedOwnPage;
+		if (relayout)
+			currItem->invalid = true;
+	}
+	for (int i = 0; i < page->FromMaster.count(); ++i)
+	{
+		PageItem* currItem = page->FromMaster.at(i);
+		if (!currItem->isTableItem)
+			continue;
+		if ((currItem->OwnPage != -1) && (currItem->OwnPage != masterPage->pageNr()))
+			continue;
+		bool moved = !currItem->ChangedMasterItem;
+		if (!isDrawn(currItem, layer, moved ? masterArea : area))
+			continue;
+		painter->save();
+		if (moved)
+			painter->translate(dx, dy);
+		drawTableBorder(painter, currItem);
+		painter->restore();
+	}
+	if (blend)
+		painter->endLayer();
+}
+
+void PageRenderer::drawItems(ScPainter* painter, const QList<PageItem*>& items, Page* masterPage, const ScLayer& layer, const QRectF& area) const
+{
+	if (items.isEmpty())
+		return;
+	bool blend = blendsLayer(layer);
+	if (blend)
+		painter->beginLayer(layer.transparency, layer.blendMode);
+	for (int i = 0; i < items.count(); ++i)
+	{
+		PageItem* currItem = items.at(i);
+		if (masterPage && (currItem->OnMasterPage != masterPage->pageName()))
+			continue;
+		if (isDrawn(currItem, layer, area))
+			currItem->DrawObj(painter, area);
+	}
+	for (int i = 0; i < items.count(); ++i)
+	{
+		PageItem* currItem = items.at(i);
+		if (!currItem->isTableItem)
+			continue;
+		if (masterPage && (currItem->OnMasterPage != masterPage->pageName()))
+			continue;
+		if (isDrawn(currItem, layer, area))
+			drawTableBorder(painter, currItem);
+	}
+	if (blend)
+		painter->endLayer();
+}
+
+bool PageRenderer::blendsLayer(const ScLayer& layer) const
+{
+	return (m_doc->layerCount() > 1) && ((layer.blendMode != 0) || (layer.transparency != 1.0)) && (!layer.outlineMode);
+}
@@ -0,0 +1,83 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#ifndef PAGERENDERER_H
+#define PAGERENDERER_H
+
+#include <QImage>
+#include <QList>
+#include <QPair>
+#include <QPoint>
+#include <QRectF>
+
+#include "scribusapi.h"
+
+class Page;
+class PageItem;
+class ScLayer;
+class ScPainter;
+class ScribusDoc;
+
+/**
+ * The PageRenderer class draws document and master pages without a view.
+ *
+ * Unlike ScribusView::PageToPixmap() used to, it does not change the zoom or the current page
+ * of the view, the canvas origin, the current page or mode of the document or its guide
+ * settings. Pages are drawn as in the preview mode of the canvas: only printable layers and
+ * items, and no frame outlines, placeholders or control characters. Items are still laid out
+ * when they are drawn, so the pages of one document must not be drawn from several threads at
+ * the same time.
+ *
+ * Master items are the exception to leaving the document alone: like on the canvas, their
+ * OwnPage is set to the rendered page while they are drawn, since text frames lay out page
+ * numbers, shadows and text wrap for that page. It is restored afterwards, and frames showing
+ * a page number are marked for relayout, without changing their revision.
+ */
+class SCRIBUS_API PageRenderer
+{
+public:
+	explicit PageRenderer(ScribusDoc* doc);
+
+	/// Renders @a page at @a scale, 1.0 being 72 dpi, on the paper color of the document.
+	QImage render(Page* page, double scale, bool drawFrame = false) const;
+	/// Renders @a page as large as possible within @a maxSize x @a maxSize pixels.
+	QImage renderToSize(Page* page, int maxSize, bool drawFrame = false) const;
+	/**
+	 * Renders the part of @a page at @a scale which starts @a offset pixels from the top left
+	 * corner of the page into @a image, so that large pages can be rendered piece by piece.
+	 */
+	void render(QImage* image, Page* page, double scale, const QPoint& offset = QPoint()) const;
+
+	/**
+	 * Draws the items of @a page within @a area, given in document coordinates, with @a painter.
+	 * The matrix of @a painter has to map document coordinates to the device. A null area
+	 * stands for the whole page.
+	 */
+	void render(ScPainter* painter, Page* page, const QRectF& area = QRectF()) const;
+
+	/// Image frames with the resolution their image was loaded in.
+	typedef QList<QPair<PageItem*, int> > ImageResolutions;
+	/**
+	 * Reloads the images on @a page, which the canvas shows in a lower resolution, in full
+	 * resolution. Unlike drawing, this changes the items. Returns the previous resolutions
+	 * for restoreImageResolutions().
+	 */
+	ImageResolutions loadFullResolutionImages(Page* page) const;
+	/// Reloads the images of @a resolutions in the resolution given there.
+	void restoreImageResolutions(const ImageResolutions& resolutions) const;
+
+private:
+	/// Draws the items of the master page of @a page on @a layer.
+	void drawMasterItems(ScPainter* painter, Page* page, Page* masterPage, const ScLayer& layer, const QRectF& area) const;
+	/// Draws @a items on @a layer, only those placed on @a masterPage if it is not null.
+	void drawItems(ScPainter* painter, const QList<PageItem*>& items, Page* masterPage, const ScLayer& layer, const QRectF& area) const;
+	/// Returns true if @a layer has to be drawn on its own layer of the painter.
+	bool blendsLayer(const ScLayer& layer) const;
+
+	ScribusDoc* m_doc;
+};
+
+#endif // PAGERENDERER_H
@@ -0,0 +1,115 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+
+#include <cmath>
+
+#include "pdfcontentstream.h"
+
+namespace {
+
+// Larger numbers are clipped, PDF viewers can not handle them anyway
+// and their fixed point value still fits into 64 bits.
+const double MaxValue = 1e12;
+
+} // namespace
+
+PdfContentStream& PdfContentStream::operator<<(const char* text)
+{
+	m_data.append(text);
+	return *this;
+}
+
+PdfContentStream& PdfContentStream::operator<<(const QByteArray& text)
+{
+	m_data.append(text);
+	return *this;
+}
+
+PdfContentStream& PdfContentStream::operator<<(const QString& text)
+{
+	m_data.append(text.toLatin1());
+	return *this;
+}
+
+PdfContentStream& PdfContentStream::operator<<(double value)
+{
+	char buffer[MaxNumberLength];
+	m_data.append(buffer, formatNumber(value, buffer));
+	return *this;
+}
+
+PdfContentStream& PdfContentStream::operator<<(int value)
+{
+	m_data.append(QByteArray::number(value));
+	return *this;
+}
+
+PdfContentStream& PdfContentStream::operator<<(uint value)
+{
+	m_data.append(QByteArray::number(value));
+	return *this;
+}
+
+PdfContentStream& PdfContentStream::operator<<(const PdfContentStream& stream)
+{
+	m_data.append(stream.m_data);
+	return *this;
+}
+
+QByteArray PdfContentStream::number(double value)
+{
+	char buffer[MaxNumberLength];
+	return QByteArray(buffer, formatNumber(value, buffer));
+}
+
+QString PdfContentStream::numberString(double value)
+{
+	char buffer[MaxNumberLength];
+	return QString::fromLatin1(buffer, formatNumber(value, buffer));
+}
+
+int PdfContentStream::formatNumber(double value, char* buffer)
+{
+	if (value != value)
+	{
+		buffer[0] = '0';
+		return 1;
+	}
+	if (std::fabs(value) > MaxValue)
+		value = (value > 0) ? MaxValue : -MaxValue;
+
+	// the digits are produced from the last one on
+	char digits[MaxNumberLength];
+	int count = 0;
+	qint64 fixed = qRound64(value * 100000.0);
+	bool negative = fixed < 0;
+	quint64 rest = negative ? -fixed : fixed;
+	bool hasFraction = false;
+	for (int i = 0; i < 5; ++i)
+	{
+		int digit = rest % 10;
+		rest /= 10;
+		if ((digit != 0) || hasFraction)
+		{
+			digits[count++] = '0' + digit;
+			hasFraction = true;
+		}
+	}
+	if (hasFraction)
+		digits[count++] = '.';
+	do
+	{
+		digits[count++] = '0' + rest % 10;
+		rest /= 10;
+	}
+	while (rest != 0);
+	if (negative)
+		digits[count++] = '-';
+	for (int i = 0; i < count; ++i)
+		buffer[i] = digits[count - 1 - i];
+	return count;
+}
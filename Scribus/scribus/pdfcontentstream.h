@@ -0,0 +1,53 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#ifndef PDFCONTENTSTREAM_H
+#define PDFCONTENTSTREAM_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * The PdfContentStream class collects the operators of a PDF content stream as 8 bit characters.
+ *
+ * Content streams only consist of Latin-1 characters, so keeping them in a QByteArray takes half
+ * the memory of a QString and they can be compressed and written without another conversion.
+ * Numbers are formatted directly into the stream, with at most five decimals and without
+ * trailing zeros.
+ */
+class PdfContentStream
+{
+public:
+	PdfContentStream() {}
+
+	PdfContentStream& operator<<(const char* text);
+	PdfContentStream& operator<<(const QByteArray& text);
+	/// Appends @a text, which has to consist of Latin-1 characters.
+	PdfContentStream& operator<<(const QString& text);
+	PdfContentStream& operator<<(double value);
+	PdfContentStream& operator<<(int value);
+	PdfContentStream& operator<<(uint value);
+	PdfContentStream& operator<<(const PdfContentStream& stream);
+
+	void clear() { m_data.clear(); }
+	bool isEmpty() const { return m_data.isEmpty(); }
+	int size() const { return m_data.size(); }
+	const QByteArray& data() const { return m_data; }
+
+	/// Returns @a value formatted like operator<<(double) does.
+	static QByteArray number(double value);
+	/// Returns @a value formatted like operator<<(double) does, for text that is still built as a QString.
+	static QString numberString(double value);
+
+private:
+	/// Writes @a value to @a buffer, which has room for MaxNumberLength characters, and returns the length.
+	static int formatNumber(double value, char* buffer);
+	static const int MaxNumberLength = 32;
+
+	QByteArray m_data;
+};
+
+#endif // PDFCONTENTSTREAM_H
@@ -38,6 +38,7 @@ for which a new license (GPL+exception) is in place.
 #include "rc4.h"
 
 #include <QByteArray>
+#include <QCryptographicHash>
 #include <QDateTime>
 #include <QDataStream>
 #include <QDebug>
@@ -53,6 +54,7 @@ for which a new license (GPL+exception) is in place.
 #include <QString>
 #include <QTemporaryFile>
 #include <QTextCodec>
+#include <QtConcurrentRun>
 #include <QtXml>
 #include <QUuid>
 
@@ -61,6 +63,7 @@ for which a new license (GPL+exception) is in place.
 #include "ui/bookmarkpalette.h"
 #include "cmsettings.h"
 #include "commonstrings.h"
+#include "fonts/sfntsubsetter.h"
 #include "ui/multiprogressdialog.h"
 #include "page.h"
 #include "pageitem.h"
@@ -136,6 +139,7 @@ PDFLibCore::PDFLibCore(ScribusDoc & docu)
 	Outlines.Count = 0;
 	Seite.ObjNum = 0;
 	Seite.Thumb = 0;
+	PendingStreamBytes = 0;
 	int kg_array[] = {0x28, 0xbf, 0x4e, 0x5e, 0x4e, 0x75, 0x8a, 0x41, 0x64, 0x00, 0x4e, 0x56, 0xff, 0xfa,
 			  0x01, 0x08, 0x2e, 0x2e, 0x00, 0xb6, 0xd0, 0x68, 0x3e, 0x80, 0x2f, 0x0c, 0xa9, 0xfe,
 			  0x64, 0x53, 0x69, 0x7a};
@@ -160,12 +164,12 @@ PDFLibCore::~PDFLibCore()
 	delete progressDialog;
 }
 
+// Contents of at most this many bytes wait for being compressed and written.
+static const qint64 MaxPendingStreamBytes = 256 * 1024 * 1024;
+
 static inline QString FToStr(double c)
 {
-	double v = c;
-	if (fabs(c) < 0.0000001)
-		v = 0.0;
-	return QString::number(v, 'f', 5);
+	return PdfContentStream::numberString(c);
 };
 
 bool PDFLibCore::doExport(const QString& fn, const QString& nam, int Components,
@@ -295,6 +299,20 @@ static QString PDFEncode(const QString & in)
 	return tmp;
 }
 
+// Six upper case letters which tell a font subset apart from the full font
+// and from other subsets of it.
+static QString subsetTag(const QString& seed)
+{
+	uint hash = qHash(seed);
+	QString tag;
+	for (int i = 0; i < 6; ++i)
+	{
+		tag += QChar('A' + hash % 26);
+		hash /= 26;
+	}
+	return tag;
+}
+
 static QString blendMode(int code)
 {
 	switch (code)
@@ -952,6 +970,8 @@ bool PDFLibCore::PDF_Begin_Doc(const QString& fn, SCFonts &AllFonts, QMap<QStrin
 				bool mustEmbed = ((annotType >= 2) && (annotType <= 6) && (annotType != 4));
 				if (pgit->annotation().Type() == 4)
 					StdFonts.insert("/ZapfDingbats", "");
+				if (mustEmbed)
+					FormFonts.insert(pgit->itemText.defaultStyle().charStyle().font().replacementName());
 				if (pgit->itemText.length() > 0 || mustEmbed)
 				{
 					if (Options.Version < PDFOptions::PDFVersion_14)
@@ -976,6 +996,8 @@ bool PDFLibCore::PDF_Begin_Doc(const QString& fn, SCFonts &AllFonts, QMap<QStrin
 				bool mustEmbed = ((annotType >= 2) && (annotType <= 6) && (annotType != 4));
 				if (pgit->annotation().Type() == 4)
 					StdFonts.insert("/ZapfDingbats", "");
+				if (mustEmbed)
+					FormFonts.insert(pgit->itemText.defaultStyle().charStyle().font().replacementName());
 				if (pgit->itemText.length() > 0 || mustEmbed)
 				{
 					if (Options.Version < PDFOptions::PDFVersion_14)
@@ -1000,6 +1022,8 @@ bool PDFLibCore::PDF_Begin_Doc(const QString& fn, SCFonts &AllFonts, QMap<QStrin
 				bool mustEmbed = ((annotType >= 2) && (annotType <= 6) && (annotType != 4));
 				if (pgit->annotation().Type() == 4)
 					StdFonts.insert("/ZapfDingbats", "");
+				if (mustEmbed)
+					FormFonts.insert(pgit->itemText.defaultStyle().charStyle().font().replacementName());
 				if (pgit->itemText.length() > 0 || mustEmbed)
 				{
 					if (Options.Version < PDFOptions::PDFVersion_14)
@@ -1212,14 +1236,14 @@ bool PDFLibCore::PDF_Begin_Doc(const QString& fn, SCFonts &AllFonts, QMap<QStrin
 			}
 			else
 			{
-				QString fon("");
+				PdfContentStream fon;
 				QMap<uint,FPointArray>& RealGlyphs(it.value());
 				QMap<uint,FPointArray>::Iterator ig;
 				for (ig = RealGlyphs.begin(); ig != RealGlyphs.end(); ++ig)
 				{
 					FPoint np, np1, np2;
 					bool nPath = true;
-					fon = "";
+					fon.clear();
 					if (ig.value().size() > 3)
 					{
 						FPointArray gly = ig.value();
@@ -1230,30 +1254,30 @@ bool PDFLibCore::PDF_Begin_Doc(const QString& fn, SCFonts &AllFonts, QMap<QStrin
 						{
 							if (gly.point(poi).x() > 900000)
 							{
-								fon += "h\n";
+								fon << "h\n";
 								nPath = true;
 								continue;
 							}
 							if (nPath)
 							{
 								np = gly.point(poi);
-								fon += FToStr(np.x())+" "+FToStr(-np.y())+" m\n";
+								fon << np.x() << " " << -np.y() << " m\n";
 								nPath = false;
 							}
 							np = gly.point(poi+1);
 							np1 = gly.point(poi+3);
 							np2 = gly.point(poi+2);
-							fon += FToStr(np.x()) + " " + FToStr(-np.y()) + " " +
-								FToStr(np1.x()) + " " + FToStr(-np1.y()) + " " +
-								FToStr(np2.x()) + " " + FToStr(-np2.y()) + " c\n";
+							fon << np.x() << " " << -np.y() << " " <<
+								np1.x() << " " << -np1.y() << " " <<
+								np2.x() << " " << -np2.y() << " c\n";
 						}
-						fon += "h f*\n";
+						fon << "h f*\n";
 						np = getMinClipF(&gly);
 						np1 = getMaxClipF(&gly);
 					}
 					else
 					{
-						fon = "h";
+						fon << "h";
 						np = FPoint(0, 0);
 						np1 = FPoint(0, 0);
 					}
@@ -1263,12 +1287,7 @@ bool PDFLibCore::PDF_Begin_Doc(const QString& fn, SCFonts &AllFonts, QMap<QStrin
 					PutDoc("/BBox [ "+FToStr(np.x())+" "+FToStr(-np.y())+" "+FToStr(np1.x())+ " "+FToStr(-np1.y())+" ]\n");
 					PutDoc("/Resources << /ProcSet [/PDF /Text /ImageB /ImageC /ImageI]\n");
 					PutDoc(">>\n");
-					if (Options.Compress)
-						fon = CompressStr(&fon);
-					PutDoc("/Length "+QString::number(fon.length()+1));
-					if (Options.Compress)
-						PutDoc("\n/Filter /FlateDecode");
-					PutDoc(" >>\nstream\n"+EncStream(fon, fontGlyphXForm)+"\nendstream\nendobj\n");
+					PutStream(fon.data(), Options.Compress ? CompressArray(fon.data()) : QByteArray(), fontGlyphXForm);
 					Seite.XObjects[AllFonts[it.key()].psName().replace( QRegExp("[\\s\\/\\{\\[\\]\\}\\<\\>\\(\\)\\%]"), "_" )+QString::number(ig.key())] = fontGlyphXForm;
 				}
 			}
@@ -1277,6 +1296,7 @@ bool PDFLibCore::PDF_Begin_Doc(const QString& fn, SCFonts &AllFonts, QMap<QStrin
 		{
 			UsedFontsP.insert(it.key(), "/Fo"+QString::number(a));
 			uint embeddedFontObject = 0;
+			QString fontName = AllFonts[it.key()].psName().replace( QRegExp("[\\s\\/\\{\\[\\]\\}\\<\\>\\(\\)\\%]"), "_" );
 			if ((fformat == ScFace::PFB) && (Options.EmbedList.contains(it.key())))
 			{
 				QString fon("");
@@ -1364,29 +1384,44 @@ bool PDFLibCore::PDF_Begin_Doc(const QString& fn, SCFonts &AllFonts, QMap<QStrin
 			}
 			if ((fformat == ScFace::SFNT || fformat == ScFace::TTCF) && (Options.EmbedList.contains(it.key())))
 			{
-				QString fon("");
 				embeddedFontObject = newObject();
-				StartObj(embeddedFontObject);
 				QByteArray bb;
 				AllFonts[it.key()].RawData(bb);
-				//AV: += and append() dont't work because they stop at '\0' :-(
-				for (int i=0; i < bb.size(); i++)
-					fon += QChar(bb[i]);
-				int len = fon.length();
-				if (Options.Compress)
-					fon = CompressStr(&fon);
-				//qDebug() << QString("sfnt data: size=%1 before=%2 compressed=%3").arg(bb.size()).arg(len).arg(fon.length());
-				PutDoc("<<\n/Length "+QString::number(fon.length()+1)+"\n");
-				PutDoc("/Length1 "+QString::number(len)+"\n");
-				if (Options.Compress)
-					PutDoc("/Filter /FlateDecode\n");
-				PutDoc(">>\nstream\n"+EncStream(fon, embeddedFontObject)+"\nendstream\nendobj\n");
+				// viewers use the fonts of form fields for what is typed in, so these have to be complete
+				if (!FormFonts.contains(it.key()) && SfntSubsetter::canSubset(bb))
+				{
+					// written by PDF_SubsetFonts() when all glyphs used on the pages are known
+					SubsetFont subset;
+					subset.face = AllFonts[it.key()];
+					subset.FontFile = embeddedFontObject;
+					subset.Widths = 0;
+					subset.ToUnicode = 0;
+					SubsetFonts.insert(it.key(), subset);
+					fontName.prepend(subsetTag(fontName + Datum) + "+");
+				}
+				else
+				{
+					QString fon("");
+					StartObj(embeddedFontObject);
+					//AV: += and append() dont't work because they stop at '\0' :-(
+					for (int i=0; i < bb.size(); i++)
+						fon += QChar(bb[i]);
+					int len = fon.length();
+					if (Options.Compress)
+						fon = CompressStr(&fon);
+					//qDebug() << QString("sfnt data: size=%1 before=%2 compressed=%3").arg(bb.size()).arg(len).arg(fon.length());
+					PutDoc("<<\n/Length "+QString::number(fon.length()+1)+"\n");
+					PutDoc("/Length1 "+QString::number(len)+"\n");
+					if (Options.Compress)
+						PutDoc("/Filter /FlateDecode\n");
+					PutDoc(">>\nstream\n"+EncStream(fon, embeddedFontObject)+"\nendstream\nendobj\n");
+				}
 			}
 			uint fontDescriptor = newObject();
 			StartObj(fontDescriptor);
 			// TODO: think about QByteArray ScFace::getFontDescriptor() -- AV
 			PutDoc("<<\n/Type /FontDescriptor\n");
-			PutDoc("/FontName /"+AllFonts[it.key()].psName().replace( QRegExp("[\\s\\/\\{\\[\\]\\}\\<\\>\\(\\)\\%]"), "_" )+"\n");
+			PutDoc("/FontName /"+fontName+"\n");
 			PutDoc("/FontBBox [ "+AllFonts[it.key()].fontBBoxAsString()+" ]\n");
 			PutDoc("/Flags ");
 			//FIXME: isItalic() should be queried from ScFace, not from Qt -- AV
@@ -1466,73 +1501,26 @@ bool PDFLibCore::PDF_Begin_Doc(const QString& fn, SCFonts &AllFonts, QMap<QStrin
 				if (Options.Version == PDFOptions::PDFVersion_X4 && (fformat == ScFace::SFNT || fformat == ScFace::TTCF))
 				{
 					uint fontWidths2 = newObject();
-					StartObj(fontWidths2);
-					QStringList toUnicodeMaps;
-					QList<int> toUnicodeMapsCount;
-					QString toUnicodeMap = "";
-					int toUnicodeMapCounter = 0;
-
-					PutDoc("[ ");
-					QList<uint> keys = gl.uniqueKeys();
-					QList<uint>::iterator git;
-					for (git = keys.begin(); git != keys.end(); ++git)
+					uint fontToUnicode2 = newObject();
+					if (SubsetFonts.contains(it.key()))
 					{
-						PutDoc(QString::number(*git)+" ["+QString::number(static_cast<int>(AllFonts[it.key()].glyphWidth(*git)* 1000))+"] " );
-						QString tmp, tmp2;
-						tmp.sprintf("%02X", *git);
-						tmp2.sprintf("%04X", gl.value(*git).first.unicode());
-						toUnicodeMap += QString("<%1> <%2>\n").arg(tmp).arg((tmp2));
-						toUnicodeMapCounter++;
-						if (toUnicodeMapCounter == 100)
-						{
-							toUnicodeMaps.append(toUnicodeMap);
-							toUnicodeMapsCount.append(toUnicodeMapCounter);
-							toUnicodeMap = "";
-							toUnicodeMapCounter = 0;
-						}
-					}
-					PutDoc("]\nendobj\n");
-					if (toUnicodeMapCounter != 0)
-					{
-						toUnicodeMaps.append(toUnicodeMap);
-						toUnicodeMapsCount.append(toUnicodeMapCounter);
-					}
-					QString toUnicodeMapStream = "";
-					toUnicodeMapStream += "/CIDInit /ProcSet findresource begin\n";
-					toUnicodeMapStream += "12 dict begin\n";
-					toUnicodeMapStream += "begincmap\n";
-					toUnicodeMapStream += "/CIDSystemInfo <<\n";
-					toUnicodeMapStream += "/Registry (Adobe)\n";
-					toUnicodeMapStream += "/Ordering (UCS)\n";
-					toUnicodeMapStream += "/Supplement 0\n";
-					toUnicodeMapStream += ">> def\n";
-					toUnicodeMapStream += "/CMapName /Adobe-Identity-UCS def\n";
-					toUnicodeMapStream += "/CMapType 2 def\n";
-					toUnicodeMapStream += "1 begincodespacerange\n";
-					toUnicodeMapStream += "<0000> <FFFF>\n";
-					toUnicodeMapStream += "endcodespacerange\n";
-					for (int uniC = 0; uniC < toUnicodeMaps.count(); uniC++)
-					{
-						toUnicodeMapStream += QString("%1 beginbfchar\n").arg(toUnicodeMapsCount[uniC]);
-						toUnicodeMapStream += toUnicodeMaps[uniC];
-						toUnicodeMapStream += "endbfchar\n";
+						// only for the glyphs used on the pages, written by PDF_SubsetFonts()
+						SubsetFonts[it.key()].Widths = fontWidths2;
+						SubsetFonts[it.key()].ToUnicode = fontToUnicode2;
 					}
-					toUnicodeMapStream += "endcmap\n";
-					toUnicodeMapStream += "CMapName currentdict /CMap defineresource pop\n";
-					toUnicodeMapStream += "end\n";
-					toUnicodeMapStream += "end\n";
-					uint fontToUnicode2 = WritePDFStream(toUnicodeMapStream);
+					else
+						PDF_CIDFontMetrics(AllFonts[it.key()], gl.uniqueKeys(), fontWidths2, fontToUnicode2);
 					uint fontObject2 = newObject();
 					StartObj(fontObject2);
 					PutDoc("<<\n/Type /Font\n/Subtype /Type0\n");
 					PutDoc("/Name /Fo"+QString::number(a)+"\n");
-					PutDoc("/BaseFont /"+AllFonts[it.key()].psName().replace( QRegExp("[\\s\\/\\{\\[\\]\\}\\<\\>\\(\\)\\%]"), "_" )+"\n");
+					PutDoc("/BaseFont /"+fontName+"\n");
 					PutDoc("/Encoding /Identity-H\n");
 					PutDoc("/ToUnicode "+QString::number(fontToUnicode2)+" 0 R\n");
 					PutDoc("/DescendantFonts [");
 					PutDoc("<</Type /Font");
 					PutDoc("/Subtype /CIDFontType2");
-					PutDoc("/BaseFont /"+AllFonts[it.key()].psName().replace( QRegExp("[\\s\\/\\{\\[\\]\\}\\<\\>\\(\\)\\%]"), "_" ));
+					PutDoc("/BaseFont /"+fontName);
 					PutDoc("/FontDescriptor "+QString::number(FontDes)+" 0 R");
 					PutDoc("/CIDSystemInfo <</Ordering(Identity)/Registry(Adobe)/Supplement 0>>");
 					PutDoc("/DW 1000");
@@ -1651,7 +1639,7 @@ bool PDFLibCore::PDF_Begin_Doc(const QString& fn, SCFonts &AllFonts, QMap<QStrin
 						PutDoc("<<\n/Type /Font\n/Subtype ");
 						PutDoc((fformat == ScFace::SFNT || fformat == ScFace::TTCF) ? "/TrueType\n" : "/Type1\n");
 						PutDoc("/Name /Fo"+QString::number(a)+"S"+QString::number(Fc)+"\n");
-						PutDoc("/BaseFont /"+AllFonts[it.key()].psName().replace( QRegExp("[\\s\\/\\{\\[\\]\\}\\<\\>\\(\\)\\%]"), "_" )+"\n");
+						PutDoc("/BaseFont /"+fontName+"\n");
 						PutDoc("/FirstChar 0\n");
 						PutDoc("/LastChar "+QString::number(chCount-1)+"\n");
 						PutDoc("/Widths "+QString::number(fontWidths2)+" 0 R\n");
@@ -1691,7 +1679,7 @@ bool PDFLibCore::PDF_Begin_Doc(const QString& fn, SCFonts &AllFonts, QMap<QStrin
 						Seite.FObjects[AllFonts[it.key()].psName().replace( QRegExp("[\\s\\/\\{\\[\\]\\}\\<\\>\\(\\)\\%]"), "_" )] = ObjCounter;
 						UsedFontsF.insert(it.key(), "/"+AllFonts[it.key()].psName().replace( QRegExp("[\\s\\/\\{\\[\\]\\}\\<\\>\\(\\)\\%]"), "_" ));
 					} */
-					PutDoc("/BaseFont /"+AllFonts[it.key()].psName().replace( QRegExp("[\\s\\/\\{\\[\\]\\}\\<\\>\\(\\)\\%]"), "_" )+"\n");
+					PutDoc("/BaseFont /"+fontName+"\n");
 					PutDoc("/Encoding << \n");
 					PutDoc("/Differences [ \n");
 					PutDoc("24 /breve /caron /circumflex /dotaccent /hungarumlaut /ogonek /ring /tilde\n");
@@ -1898,7 +1886,7 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 	ScLayer ll;
 	ll.isPrintable = false;
 	ll.ID = 0;
-	Content = "";
+	Content.clear();
 	Seite.AObjects.clear();
 	for (int la = 0; la < doc.Layers.count(); ++la)
 	{
@@ -1907,10 +1895,10 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 		if ((ll.isPrintable) || (((Options.Version == PDFOptions::PDFVersion_15) || (Options.Version == PDFOptions::PDFVersion_X4)) && (Options.useLayers)))
 		{
 			if (((Options.Version == PDFOptions::PDFVersion_15) || (Options.Version == PDFOptions::PDFVersion_X4)) && (Options.useLayers))
-				PutPage("/OC /"+OCGEntries[ll.Name].Name+" BDC\n");
+				Content << "/OC /" << OCGEntries[ll.Name].Name << " BDC\n";
 			for (int a = 0; a < PItems.count(); ++a)
 			{
-				Content = "";
+				Content.clear();
 				ite =PItems.at(a);
 				if (ite->LayerID != ll.ID)
 					continue;
@@ -1939,7 +1927,7 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 					Transpar[ShName] = writeGState("/OP true\n"
 												   "/op true\n"
 												   "/OPM 1\n");
-					PutPage("/"+ShName+" gs\n");
+					Content << "/" << ShName << " gs\n";
 				}
 /* Bookmarks on Master Pages do not make any sense */
 //				if ((ite->isBookmark) && (Options.Bookmarks))
@@ -1953,7 +1941,7 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 					PutPage(putColor(ite->fillColor(), ite->fillShade(), true));
 				if (ite->lineColor() != CommonStrings::None)
 					PutPage(putColor(ite->lineColor(), ite->lineShade(), false));
-				Content += FToStr(fabs(ite->lineWidth()))+" w\n";
+				Content << fabs(ite->lineWidth()) << " w\n";
 				if (ite->DashValues.count() != 0)
 				{
 					PutPage("[ ");
@@ -1964,12 +1952,12 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 						// #8758: Custom dotted lines don't export properly to pdf
 						// Null values have to be exported if line end != flat
 						if ((da != 0) || (ite->lineEnd() != Qt::FlatCap))
-							PutPage(QString::number(da)+" ");
+							Content << da << " ";
 					}
-					PutPage("] "+QString::number(static_cast<int>(ite->DashOffset))+" d\n");
+					Content << "] " << static_cast<int>(ite->DashOffset) << " d\n";
 				}
 				else
-					PutPage("["+getDashString(ite->PLineArt, ite->lineWidth())+"] 0 d\n");
+					Content << "[" << getDashString(ite->PLineArt, ite->lineWidth()) << "] 0 d\n";
 				switch (ite->PLineEnd)
 				{
 					case Qt::FlatCap:
@@ -2000,7 +1988,7 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 						PutPage("0 j\n");
 						break;
 				}
-				PutPage("1 0 0 1 "+FToStr(ite->xPos() - pag->xOffset())+" "+FToStr(pag->height() - (ite->yPos()  - pag->yOffset()))+" cm\n");
+				Content << "1 0 0 1 " << ite->xPos() - pag->xOffset() << " " << pag->height() - (ite->yPos()  - pag->yOffset()) << " cm\n";
 				if (ite->rotation() != 0)
 				{
 					double sr = sin(-ite->rotation()* M_PI / 180.0);
@@ -2009,7 +1997,7 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 						cr = 0;
 					if ((sr * sr) < 0.000001)
 						sr = 0;
-					PutPage(FToStr(cr)+" "+FToStr(sr)+" "+FToStr(-sr)+" "+FToStr(cr)+" 0 0 cm\n");
+					Content << cr << " " << sr << " " << -sr << " " << cr << " 0 0 cm\n";
 				}
 				switch (ite->itemType())
 				{
@@ -2049,9 +2037,9 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 						PutPage(SetClipPath(ite));
 						PutPage("h\nW*\nn\n");
 						if (ite->imageFlippedH())
-							PutPage("-1 0 0 1 "+FToStr(ite->width())+" 0 cm\n");
+							Content << "-1 0 0 1 " << ite->width() << " 0 cm\n";
 						if (ite->imageFlippedV())
-							PutPage("1 0 0 -1 0 "+FToStr(-ite->height())+" cm\n");
+							Content << "1 0 0 -1 0 " << -ite->height() << " cm\n";
 						if ((ite->PictureIsAvailable) && (!ite->Pfile.isEmpty()))
 						{
 							if (!PDF_Image(ite, ite->Pfile, ite->imageXScale(), ite->imageYScale(), ite->imageXOffset(), -ite->imageYOffset(), false, ite->IProfile, ite->UseEmbedded, ite->IRender, &tmpOut))
@@ -2071,7 +2059,7 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 									if (ite->patternStrokePath)
 									{
 										QPainterPath path = ite->PoLine.toQPainterPath(false);
-										PutPage(HandleBrushPattern(ite, path, pag, pag->pageNr()));
+										HandleBrushPattern(Content, ite, path, pag, pag->pageNr());
 									}
 									else
 									{
@@ -2127,7 +2115,7 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 									QPainterPath path;
 									path.moveTo(0, 0);
 									path.lineTo(ite->width(), 0);
-									PutPage(HandleBrushPattern(ite, path, pag, pag->pageNr()));
+									HandleBrushPattern(Content, ite, path, pag, pag->pageNr());
 								}
 								else
 								{
@@ -2135,7 +2123,7 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 										return false;
 									PutPage(tmpOut);
 									PutPage("0 0 m\n");
-									PutPage(FToStr(ite->width())+" 0 l\n");
+									Content << ite->width() << " 0 l\n";
 									PutPage("S\n");
 								}
 							}
@@ -2146,13 +2134,13 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 								PutPage("q\n");
 								PutPage(tmpOut);
 								PutPage("0 0 m\n");
-								PutPage(FToStr(ite->width())+" 0 l\n");
+								Content << ite->width() << " 0 l\n";
 								PutPage("S\nQ\n");
 							}
 							else
 							{
 								PutPage("0 0 m\n");
-								PutPage(FToStr(ite->width())+" 0 l\n");
+								Content << ite->width() << " 0 l\n";
 								PutPage("S\n");
 							}
 						}
@@ -2165,7 +2153,7 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 									{
 										PutPage(setStrokeMulti(&ml[it]));
 										PutPage("0 0 m\n");
-										PutPage(FToStr(ite->width())+" 0 l\n");
+										Content << ite->width() << " 0 l\n";
 										PutPage("S\n");
 									}
 							}
@@ -2175,14 +2163,14 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 							QTransform arrowTrans;
 							arrowTrans.scale(-1,1);
 							arrowTrans.scale(ite->startArrowScale() / 100.0, ite->startArrowScale() / 100.0);
-							PutPage(drawArrow(ite, arrowTrans, ite->startArrowIndex()));
+							drawArrow(Content, ite, arrowTrans, ite->startArrowIndex());
 						}
 						if (ite->endArrowIndex() != 0)
 						{
 							QTransform arrowTrans;
 							arrowTrans.translate(ite->width(), 0);
 							arrowTrans.scale(ite->endArrowScale() / 100.0, ite->endArrowScale() / 100.0);
-							PutPage(drawArrow(ite, arrowTrans, ite->endArrowIndex()));
+							drawArrow(Content, ite, arrowTrans, ite->endArrowIndex());
 						}
 						break;
 					case PageItem::ItemType1:
@@ -2231,7 +2219,7 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 									if (ite->patternStrokePath)
 									{
 										QPainterPath path = ite->PoLine.toQPainterPath(false);
-										PutPage(HandleBrushPattern(ite, path, pag, pag->pageNr()));
+										HandleBrushPattern(Content, ite, path, pag, pag->pageNr());
 									}
 									else
 									{
@@ -2318,7 +2306,7 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 									if (ite->patternStrokePath)
 									{
 										QPainterPath path = ite->PoLine.toQPainterPath(false);
-										PutPage(HandleBrushPattern(ite, path, pag, pag->pageNr()));
+										HandleBrushPattern(Content, ite, path, pag, pag->pageNr());
 									}
 									else
 									{
@@ -2372,7 +2360,7 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 									arrowTrans.translate(Start.x(), Start.y());
 									arrowTrans.rotate(r);
 									arrowTrans.scale(ite->startArrowScale() / 100.0, ite->startArrowScale() / 100.0);
-									PutPage(drawArrow(ite, arrowTrans, ite->startArrowIndex()));
+									drawArrow(Content, ite, arrowTrans, ite->startArrowIndex());
 									break;
 								}
 							}
@@ -2390,7 +2378,7 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 									arrowTrans.translate(End.x(), End.y());
 									arrowTrans.rotate(r);
 									arrowTrans.scale(ite->endArrowScale() / 100.0, ite->endArrowScale() / 100.0);
-									PutPage(drawArrow(ite, arrowTrans, ite->endArrowIndex()));
+									drawArrow(Content, ite, arrowTrans, ite->endArrowIndex());
 									break;
 								}
 							}
@@ -2413,7 +2401,7 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 											if (ite->patternStrokePath)
 											{
 												QPainterPath path = ite->PoLine.toQPainterPath(false);
-												PutPage(HandleBrushPattern(ite, path, pag, pag->pageNr()));
+												HandleBrushPattern(Content, ite, path, pag, pag->pageNr());
 											}
 											else
 											{
@@ -2463,7 +2451,7 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 								PutPage("q\n");
 							PutPage(PDF_TransparenzFill(ite));
 						}
-						PutPage(setTextSt(ite, pag->pageNr(), pag));
+						setTextSt(Content, ite, pag->pageNr(), pag);
 						if (ite->GrMask > 0)
 							PutPage("Q\n");
 						break;
@@ -2472,30 +2460,30 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 					case PageItem::Symbol:
 						if (doc.docPatterns.contains(ite->pattern()))
 						{
-							QString tmpD = "";
+							PdfContentStream tmpD;
 							ScPattern pat = doc.docPatterns[ite->pattern()];
 							PutPage("q\n");
 							PutPage(SetClipPath(ite));
 							PutPage("h W* n\n");
 							if (ite->imageFlippedH())
-								PutPage("-1 0 0 1 "+FToStr(ite->width())+" 0 cm\n");
+								Content << "-1 0 0 1 " << ite->width() << " 0 cm\n";
 							if (ite->imageFlippedV())
-								PutPage("1 0 0 -1 0 "+FToStr(-ite->height())+" cm\n");
+								Content << "1 0 0 -1 0 " << -ite->height() << " cm\n";
 							QTransform trans;
 							trans.scale(ite->width() / pat.width, ite->height() / pat.height);
 							trans.translate(0.0, -ite->height());
 							trans.translate(pat.items.at(0)->gXpos, -pat.items.at(0)->gYpos);
-							PutPage(FToStr(trans.m11())+" "+FToStr(trans.m12())+" "+FToStr(trans.m21())+" "+FToStr(trans.m22())+" "+FToStr(trans.dx())+" "+FToStr(trans.dy())+" cm\n");
+							Content << trans.m11() << " " << trans.m12() << " " << trans.m21() << " " << trans.m22() << " " << trans.dx() << " " << trans.dy() << " cm\n";
 							for (int em = 0; em < pat.items.count(); ++em)
 							{
 								PageItem* embedded = pat.items.at(em);
-								tmpD += "q\n";
-								tmpD +=  "1 0 0 1 "+FToStr(embedded->gXpos)+" "+FToStr(ite->height() - embedded->gYpos)+" cm\n";
-								QString output;
+								tmpD << "q\n";
+								tmpD << "1 0 0 1 " << embedded->gXpos << " " << ite->height() - embedded->gYpos << " cm\n";
+								PdfContentStream output;
 								if (!PDF_ProcessItem(output, embedded, pag, pag->pageNr(), true))
 									return "";
-								tmpD += output;
-								tmpD += "Q\n";
+								tmpD << output;
+								tmpD << "Q\n";
 							}
 							for (int em = 0; em < pat.items.count(); ++em)
 							{
@@ -2504,10 +2492,10 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 									continue;
 								if ((embedded->lineColor() == CommonStrings::None) || (embedded->lineWidth() == 0.0))
 									continue;
-								tmpD += "q\n";
-								tmpD +=  "1 0 0 1 "+FToStr(embedded->gXpos)+" "+FToStr(ite->height() - embedded->gYpos)+" cm\n";
-								tmpD += PDF_ProcessTableItem(embedded, pag);
-								tmpD += "Q\n";
+								tmpD << "q\n";
+								tmpD << "1 0 0 1 " << embedded->gXpos << " " << ite->height() - embedded->gYpos << " cm\n";
+								PDF_ProcessTableItem(tmpD, embedded, pag);
+								tmpD << "Q\n";
 							}
 							if (Options.Version >= PDFOptions::PDFVersion_14 || Options.Version == PDFOptions::PDFVersion_X4)
 								PutPage(Write_TransparencyGroup(ite->fillTransparency(), ite->fillBlendmode(), tmpD, ite));
@@ -2519,29 +2507,29 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 					case PageItem::Group:
 						if (ite->groupItemList.count() > 0)
 						{
-							QString tmpD = "";
+							PdfContentStream tmpD;
 							PutPage("q\n");
 							PutPage(SetClipPath(ite));
 							PutPage("h W* n\n");
 							if (ite->imageFlippedH())
-								PutPage("-1 0 0 1 "+FToStr(ite->width())+" 0 cm\n");
+								Content << "-1 0 0 1 " << ite->width() << " 0 cm\n";
 							if (ite->imageFlippedV())
-								PutPage("1 0 0 -1 0 "+FToStr(-ite->height())+" cm\n");
+								Content << "1 0 0 -1 0 " << -ite->height() << " cm\n";
 							QTransform trans;
 							trans.scale(ite->width() / ite->groupWidth, ite->height() / ite->groupHeight);
 							trans.translate(0.0, -ite->height());
 							trans.translate(ite->groupItemList.at(0)->gXpos, -ite->groupItemList.at(0)->gYpos);
-							PutPage(FToStr(trans.m11())+" "+FToStr(trans.m12())+" "+FToStr(trans.m21())+" "+FToStr(trans.m22())+" "+FToStr(trans.dx())+" "+FToStr(trans.dy())+" cm\n");
+							Content << trans.m11() << " " << trans.m12() << " " << trans.m21() << " " << trans.m22() << " " << trans.dx() << " " << trans.dy() << " cm\n";
 							for (int em = 0; em < ite->groupItemList.count(); ++em)
 							{
 								PageItem* embedded = ite->groupItemList.at(em);
-								tmpD += "q\n";
-								tmpD +=  "1 0 0 1 "+FToStr(embedded->gXpos)+" "+FToStr(ite->height() - embedded->gYpos)+" cm\n";
-								QString output;
+								tmpD << "q\n";
+								tmpD << "1 0 0 1 " << embedded->gXpos << " " << ite->height() - embedded->gYpos << " cm\n";
+								PdfContentStream output;
 								if (!PDF_ProcessItem(output, embedded, pag, pag->pageNr(), true))
 									return "";
-								tmpD += output;
-								tmpD += "Q\n";
+								tmpD << output;
+								tmpD << "Q\n";
 							}
 							for (int em = 0; em < ite->groupItemList.count(); ++em)
 							{
@@ -2550,10 +2538,10 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 									continue;
 								if ((embedded->lineColor() == CommonStrings::None) || (embedded->lineWidth() == 0.0))
 									continue;
-								tmpD += "q\n";
-								tmpD +=  "1 0 0 1 "+FToStr(embedded->gXpos)+" "+FToStr(ite->height() - embedded->gYpos)+" cm\n";
-								tmpD += PDF_ProcessTableItem(embedded, pag);
-								tmpD += "Q\n";
+								tmpD << "q\n";
+								tmpD << "1 0 0 1 " << embedded->gXpos << " " << ite->height() - embedded->gYpos << " cm\n";
+								PDF_ProcessTableItem(tmpD, embedded, pag);
+								tmpD << "Q\n";
 							}
 							if (Options.Version >= PDFOptions::PDFVersion_14 || Options.Version == PDFOptions::PDFVersion_X4)
 								PutPage(Write_TransparencyGroup(ite->fillTransparency(), ite->fillBlendmode(), tmpD, ite));
@@ -2636,12 +2624,7 @@ bool PDFLibCore::PDF_TemplatePage(const Page* pag, bool )
 					PutDoc(">>\n");
 				}
 				PutDoc(">>\n");
-				if (Options.Compress)
-					Content = CompressStr(&Content);
-				PutDoc("/Length "+QString::number(Content.length()+1));
-				if (Options.Compress)
-					PutDoc("\n/Filter /FlateDecode");
-				PutDoc(" >>\nstream\n"+EncStream(Content, templateObject)+"\nendstream\nendobj\n");
+				PutStream(Content.data(), Options.Compress ? CompressArray(Content.data()) : QByteArray(), templateObject);
 				int pIndex   = doc.MasterPages.indexOf((Page* const) pag) + 1;
 				QString name = QString("master_page_obj_%1_%2").arg(pIndex).arg(ite->ItemNr);
 				Seite.XObjects[name] = templateObject;
@@ -2658,7 +2641,7 @@ void PDFLibCore::PDF_Begin_Page(const Page* pag, QPixmap pm)
 {
 	QString tmp;
 	ActPageP = pag;
-	Content = "";
+	Content.clear();
 	Seite.AObjects.clear();
 	if (Options.Thumbnails)
 	{
@@ -2884,7 +2867,7 @@ void PDFLibCore::PDF_End_Page(int physPage)
 			PutPage("Q\n");
 		}
 	}
-	Seite.ObjNum = WritePDFStream(Content);
+	Seite.ObjNum = WritePageStream(Content.data());
 	int Gobj = 0;
 	if ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4))
 	{
@@ -3110,7 +3093,7 @@ bool PDFLibCore::PDF_ProcessPage(const Page* pag, uint PNr, bool clip)
 	ScLayer ll;
 	ll.isPrintable = false;
 	if (Options.UseLPI)
-		PutPage("/"+HTName+" gs\n");
+		Content << "/" << HTName << " gs\n";
 	double bleedRight  = 0.0;
 	double bleedLeft   = 0.0;
 	double bleedBottom = 0.0;
@@ -3125,7 +3108,7 @@ bool PDFLibCore::PDF_ProcessPage(const Page* pag, uint PNr, bool clip)
 	/*if (!pag->MPageNam.isEmpty())
 	{*/
 		getBleeds(ActPageP, bleedLeft, bleedRight, bleedBottom, bleedTop);
-		PutPage("1 0 0 1 "+FToStr(bleedLeft+markOffs)+" "+FToStr(Options.bleeds.Bottom+markOffs)+" cm\n");
+		Content << "1 0 0 1 " << bleedLeft+markOffs << " " << Options.bleeds.Bottom+markOffs << " cm\n";
 		bleedDisplacementX = bleedLeft+markOffs;
 		bleedDisplacementY = Options.bleeds.Bottom+markOffs;
 	/*}*/
@@ -3137,14 +3120,14 @@ bool PDFLibCore::PDF_ProcessPage(const Page* pag, uint PNr, bool clip)
 		PutPage( QString("%1 %2 %3 %4 re W n\n").arg(FToStr(-bleedLeft)).arg(FToStr(-bleedBottom)).arg(FToStr(bbWidth)).arg(FToStr(bbHeight)) );
 	}
 	if ( (Options.MirrorH) && (!pag->MPageNam.isEmpty()) )
-		PutPage("-1 0 0 1 "+FToStr(ActPageP->width())+" 0 cm\n");
+		Content << "-1 0 0 1 " << ActPageP->width() << " 0 cm\n";
 	if ( (Options.MirrorV) && (!pag->MPageNam.isEmpty()) )
-		PutPage("1 0 0 -1 0 "+FToStr(ActPageP->height())+" cm\n");
+		Content << "1 0 0 -1 0 " << ActPageP->height() << " cm\n";
 	if (clip)
 	{
 		double maxBoxX = ActPageP->width() - ActPageP->Margins.Right - ActPageP->Margins.Left;
 		double maxBoxY = ActPageP->height() - ActPageP->Margins.Top - ActPageP->Margins.Bottom;
-		PutPage(FToStr(ActPageP->Margins.Left)+" "+FToStr(ActPageP->Margins.Bottom)+" "+FToStr(maxBoxX)+" "+FToStr(maxBoxY)+" re W n\n");
+		Content << ActPageP->Margins.Left << " " << ActPageP->Margins.Bottom << " " << maxBoxX << " " << maxBoxY << " re W n\n";
 	//	PutPage("0 0 "+FToStr(ActPageP->width())+" "+FToStr(ActPageP->height())+" re W n\n");
 	}
 	//CB *2 because the Pitems count loop runs twice.. y.. dunno.
@@ -3166,7 +3149,7 @@ bool PDFLibCore::PDF_ProcessPage(const Page* pag, uint PNr, bool clip)
 bool PDFLibCore::PDF_ProcessMasterElements(const ScLayer& layer, const Page* pag, uint PNr)
 {
 	PageItem* ite;
-	QString output;
+	PdfContentStream output;
 	QList<PageItem*> PItems;
 
 	if (pag->MPageNam.isEmpty())
@@ -3181,7 +3164,7 @@ bool PDFLibCore::PDF_ProcessMasterElements(const ScLayer& layer, const Page* pag
 	if ((layer.isPrintable) || (((Options.Version == PDFOptions::PDFVersion_15) || (Options.Version == PDFOptions::PDFVersion_X4)) && (Options.useLayers)))
 	{
 		if ((((Options.Version == PDFOptions::PDFVersion_15) || (Options.Version == PDFOptions::PDFVersion_X4))) && (Options.useLayers))
-			PutPage("/OC /"+OCGEntries[layer.Name].Name+" BDC\n");
+			Content << "/OC /" << OCGEntries[layer.Name].Name << " BDC\n";
 		for (int am = 0; am < pag->FromMaster.count() && !abortExport; ++am)
 		{
 			ite = pag->FromMaster.at(am);
@@ -3193,7 +3176,7 @@ bool PDFLibCore::PDF_ProcessMasterElements(const ScLayer& layer, const Page* pag
 				continue;
 			QString name = QString("/master_page_obj_%1_%2").arg(mPageIndex).arg(ite->ItemNr);
 			if (! ite->asTextFrame())
-				PutPage(name+" Do\n");
+				Content << name << " Do\n";
 			else
 			{
 				double oldX = ite->xPos();
@@ -3227,7 +3210,7 @@ bool PDFLibCore::PDF_ProcessMasterElements(const ScLayer& layer, const Page* pag
 			double OldBY = ite->BoundingY;
 			ite->setXPos(ite->xPos() - mPage->xOffset() + pag->xOffset(), true);
 			ite->setYPos(ite->yPos() - mPage->yOffset() + pag->yOffset(), true);
-			PutPage(PDF_ProcessTableItem(ite, pag));
+			PDF_ProcessTableItem(Content, ite, pag);
 			ite->setXYPos(oldX, oldY, true);
 			ite->BoundingX = OldBX;
 			ite->BoundingY = OldBY;
@@ -3241,16 +3224,16 @@ bool PDFLibCore::PDF_ProcessMasterElements(const ScLayer& layer, const Page* pag
 bool PDFLibCore::PDF_ProcessPageElements(const ScLayer& layer, const Page* pag, uint PNr)
 {
 	PageItem* ite;
-	QString output;
+	PdfContentStream output;
 	QList<PageItem*> PItems;
 
 	int pc_exportpagesitems = usingGUI ? progressDialog->progress("ECPI") : 0;
 	PItems = (pag->pageName().isEmpty()) ? doc.DocItems : doc.MasterItems;
 	if ((layer.isPrintable) || (((Options.Version == PDFOptions::PDFVersion_15) || (Options.Version == PDFOptions::PDFVersion_X4)) && (Options.useLayers)))
 	{
-		QString inh = "";
+		PdfContentStream inh;
 		if (((Options.Version == PDFOptions::PDFVersion_15) || (Options.Version == PDFOptions::PDFVersion_X4)) && (Options.useLayers))
-			PutPage("/OC /"+OCGEntries[layer.Name].Name+" BDC\n");
+			Content << "/OC /" << OCGEntries[layer.Name].Name << " BDC\n";
 		for (int a = 0; a < PItems.count() && !abortExport; ++a)
 		{
 			ite = PItems.at(a);
@@ -3264,7 +3247,7 @@ bool PDFLibCore::PDF_ProcessPageElements(const ScLayer& layer, const Page* pag,
 			if (!PDF_ProcessItem(output, ite, pag, PNr))
 				return false;
 			if (((layer.transparency != 1) || (layer.blendMode != 0)) && ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4)))
-				inh += output;
+				inh << output;
 			else
 				PutPage(output);
 		}
@@ -3300,9 +3283,9 @@ bool PDFLibCore::PDF_ProcessPageElements(const ScLayer& layer, const Page* pag,
 			if (!ite->printEnabled())
 				continue;
 			if (((layer.transparency != 1) || (layer.blendMode != 0)) && ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4)))
-				inh += PDF_ProcessTableItem(ite, pag);
+				PDF_ProcessTableItem(inh, ite, pag);
 			else
-				PutPage(PDF_ProcessTableItem(ite, pag));
+				PDF_ProcessTableItem(Content, ite, pag);
 		}
 		if (((layer.transparency != 1) || (layer.blendMode != 0)) && ((Options.Version >= PDFOptions::PDFVersion_14) ||(Options.Version == PDFOptions::PDFVersion_X4)))
 		{
@@ -3329,17 +3312,12 @@ bool PDFLibCore::PDF_ProcessPageElements(const ScLayer& layer, const Page* pag,
 			double maxBoxY = ActPageP->height()+Options.bleeds.Top+Options.bleeds.Bottom;
 			PutDoc("/BBox [ "+FToStr(-bleedLeft)+" "+FToStr(-Options.bleeds.Bottom)+" "+FToStr(maxBoxX)+" "+FToStr(maxBoxY)+" ]\n");
 			PutDoc("/Group "+QString::number(Gobj)+" 0 R\n");
-			if (Options.Compress)
-				inh = CompressStr(&inh);
-			PutDoc("/Length "+QString::number(inh.length()+1));
-			if (Options.Compress)
-				PutDoc("\n/Filter /FlateDecode");
-			PutDoc(" >>\nstream\n"+EncStream(inh, formObject)+"\nendstream\nendobj\n");
+			PutStream(inh.data(), Options.Compress ? CompressArray(inh.data()) : QByteArray(), formObject);
 			QString name = layer.Name.simplified().replace(QRegExp("[\\s\\/\\{\\[\\]\\}\\<\\>\\(\\)\\%]"), "_") + QString::number(layer.ID) + QString::number(PNr);
 			Seite.XObjects[name] = formObject;
 			PutPage("q\n");
-			PutPage("/"+ShName+" gs\n");
-			PutPage("/"+name+" Do\n");
+			Content << "/" << ShName << " gs\n";
+			Content << "/" << name << " Do\n";
 			PutPage("Q\n");
 		}
 		if (((Options.Version == PDFOptions::PDFVersion_15) || (Options.Version == PDFOptions::PDFVersion_X4)) && (Options.useLayers))
@@ -3348,7 +3326,7 @@ bool PDFLibCore::PDF_ProcessPageElements(const ScLayer& layer, const Page* pag,
 	return true;
 }
 
-QString PDFLibCore::Write_TransparencyGroup(double trans, int blend, QString &data, PageItem *controlItem)
+QString PDFLibCore::Write_TransparencyGroup(double trans, int blend, const PdfContentStream& data, PageItem *controlItem)
 {
 	QString ShName = "";
 	QString retString = "";
@@ -3415,12 +3393,7 @@ QString PDFLibCore::Write_TransparencyGroup(double trans, int blend, QString &da
 	else
 		PutDoc("/BBox [ "+FToStr(-bleedLeft)+" "+FToStr(-Options.bleeds.Bottom)+" "+FToStr(maxBoxX)+" "+FToStr(maxBoxY)+" ]\n");
 	PutDoc("/Group "+QString::number(Gobj)+" 0 R\n");
-	if (Options.Compress)
-		data = CompressStr(&data);
-	PutDoc("/Length "+QString::number(data.length()+1));
-	if (Options.Compress)
-		PutDoc("\n/Filter /FlateDecode");
-	PutDoc(" >>\nstream\n"+EncStream(data, formObject)+"\nendstream\nendobj\n");
+	PutStream(data.data(), Options.Compress ? CompressArray(data.data()) : QByteArray(), formObject);
 	QString name = ResNam+QString::number(ResCount);
 	ResCount++;
 	Seite.XObjects[name] = formObject;
@@ -3429,12 +3402,11 @@ QString PDFLibCore::Write_TransparencyGroup(double trans, int blend, QString &da
 	return retString;
 }
 
-QString PDFLibCore::PDF_ProcessTableItem(PageItem* ite, const Page* pag)
+void PDFLibCore::PDF_ProcessTableItem(PdfContentStream& output, PageItem* ite, const Page* pag)
 {
 	if ((ite->lineColor() == CommonStrings::None) || (ite->lineWidth() == 0.0))
-		return "";
-	QString tmp("");
-	tmp += "q\n";
+		return;
+	output << "q\n";
 	if ((ite->doOverprint) && (!Options.UseRGB))
 	{
 		QString ShName = ResNam+QString::number(ResCount);
@@ -3442,20 +3414,20 @@ QString PDFLibCore::PDF_ProcessTableItem(PageItem* ite, const Page* pag)
 		Transpar[ShName] = writeGState("/OP true\n"
 									   "/op true\n"
 									   "/OPM 1\n");
-		tmp += "/"+ShName+" gs\n";
+		output << "/" << ShName << " gs\n";
 	}
 //	if (((ite->fillTransparency() != 0) || (ite->lineTransparency() != 0)) && (Options.Version >= PDFOptions::PDFVersion_14))
 //		tmp += PDF_Transparenz(ite);
 //	if (ite->fillColor() != CommonStrings::None)
 //		tmp += putColor(ite->fillColor(), ite->fillShade(), true);
 	if (((ite->lineTransparency() != 0) || (ite->lineBlendmode() != 0)) && ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4)))
-		tmp += PDF_TransparenzStroke(ite);
+		output << PDF_TransparenzStroke(ite);
 	if (ite->lineColor() != CommonStrings::None)
-		tmp += putColor(ite->lineColor(), ite->lineShade(), false);
-	tmp += FToStr(fabs(ite->lineWidth()))+" w\n";
+		output << putColor(ite->lineColor(), ite->lineShade(), false);
+	output << fabs(ite->lineWidth()) << " w\n";
 	if (ite->DashValues.count() != 0)
 	{
-		tmp += "[ ";
+		output << "[ ";
 		QVector<double>::iterator it;
 		for ( it = ite->DashValues.begin(); it != ite->DashValues.end(); ++it )
 		{
@@ -3463,29 +3435,29 @@ QString PDFLibCore::PDF_ProcessTableItem(PageItem* ite, const Page* pag)
 			// #8758: Custom dotted lines don't export properly to pdf
 			// Null values have to be exported if line end != flat
 			if ((da != 0) || (ite->lineEnd() != Qt::FlatCap))
-				tmp += QString::number(da)+" ";
+				output << da << " ";
 		}
-		tmp += "] "+QString::number(static_cast<int>(ite->DashOffset))+" d\n";
+		output << "] " << static_cast<int>(ite->DashOffset) << " d\n";
 	}
 	else
-		tmp += "["+getDashString(ite->PLineArt, ite->lineWidth())+"] 0 d\n";
-	tmp += "2 J\n";
+		output << "[" << getDashString(ite->PLineArt, ite->lineWidth()) << "] 0 d\n";
+	output << "2 J\n";
 	switch (ite->PLineJoin)
 	{
 		case Qt::MiterJoin:
-			tmp += "0 j\n";
+			output << "0 j\n";
 			break;
 		case Qt::BevelJoin:
-			tmp += "2 j\n";
+			output << "2 j\n";
 			break;
 		case Qt::RoundJoin:
-			tmp += "1 j\n";
+			output << "1 j\n";
 			break;
 		default:
-			tmp += "0 j\n";
+			output << "0 j\n";
 			break;
 	}
-	tmp += "1 0 0 1 "+FToStr(ite->xPos() - pag->xOffset())+" "+FToStr(pag->height() - (ite->yPos()  - pag->yOffset()))+" cm\n";
+	output << "1 0 0 1 " << ite->xPos() - pag->xOffset() << " " << pag->height() - (ite->yPos()  - pag->yOffset()) << " cm\n";
 	if (ite->rotation() != 0)
 	{
 		double sr = sin(-ite->rotation()* M_PI / 180.0);
@@ -3494,39 +3466,39 @@ QString PDFLibCore::PDF_ProcessTableItem(PageItem* ite, const Page* pag)
 			cr = 0;
 		if ((sr * sr) < 0.000001)
 			sr = 0;
-		tmp += FToStr(cr)+" "+FToStr(sr)+" "+FToStr(-sr)+" "+FToStr(cr)+ " 0 0 cm\n";
+		output << cr << " " << sr << " " << -sr << " " << cr << " 0 0 cm\n";
 	}
 	if ((ite->TopLine) || (ite->RightLine) || (ite->BottomLine) || (ite->LeftLine))
 	{
 		if (ite->TopLine)
 		{
-			tmp += "0 0 m\n";
-			tmp += FToStr(ite->width())+" 0 l\n";
+			output << "0 0 m\n";
+			output << ite->width() << " 0 l\n";
 		}
 		if (ite->RightLine)
 		{
-			tmp += FToStr(ite->width())+" 0 m\n";
-			tmp += FToStr(ite->width())+" "+FToStr(-ite->height())+" l\n";
+			output << ite->width() << " 0 m\n";
+			output << ite->width() << " " << -ite->height() << " l\n";
 		}
 		if (ite->BottomLine)
 		{
-			tmp += "0 "+FToStr(-ite->height())+" m\n";
-			tmp += FToStr(ite->width())+" "+FToStr(-ite->height())+" l\n";
+			output << "0 " << -ite->height() << " m\n";
+			output << ite->width() << " " << -ite->height() << " l\n";
 		}
 		if (ite->LeftLine)
 		{
-			tmp += "0 0 m\n";
-			tmp += "0 "+FToStr(-ite->height())+" l\n";
+			output << "0 0 m\n";
+			output << "0 " << -ite->height() << " l\n";
 		}
-		tmp += "S\n";
+		output << "S\n";
 	}
-	tmp += "Q\n";
-	return tmp;
+	output << "Q\n";
 }
 
-bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag, uint PNr, bool embedded, bool pattern)
+bool PDFLibCore::PDF_ProcessItem(PdfContentStream& output, PageItem* ite, const Page* pag, uint PNr, bool embedded, bool pattern)
 {
-	QString tmp(""), tmpOut;
+	PdfContentStream tmp;
+	QString tmpOut;
 	if (ite->isGroup())
 		ite->asGroupFrame()->adjustXYPosition();
 	ite->setRedrawBounding();
@@ -3541,7 +3513,7 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 	double y2 = ite->BoundingY - ilw / 2.0;
 	double w2 = qMax(ite->BoundingW + ilw, 1.0);
 	double h2 = qMax(ite->BoundingH + ilw, 1.0);
-	output.resize(0);
+	output.clear();
 	if (!pattern)
 	{
 //		qDebug() << QString("pdflib process item: pagename=%1 ownpage=%2 pagenr=%3 changedMP=%4").arg(pag->pageName()).arg(ite->OwnPage).arg(pag->pageNr()).arg(ite->ChangedMasterItem);
@@ -3564,7 +3536,7 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 		}
 	}
 
-	tmp += "q\n";
+	tmp << "q\n";
 	if ((ite->doOverprint) && (!Options.UseRGB))
 	{
 		QString ShName = ResNam+QString::number(ResCount);
@@ -3572,7 +3544,7 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 		Transpar[ShName] = writeGState("/OP true\n"
 									   "/op true\n"
 									   "/OPM 1\n");
-		tmp += "/"+ShName+" gs\n";
+		tmp << "/" << ShName << " gs\n";
 	}
 //	if (((ite->fillTransparency() != 0) || (ite->lineTransparency() != 0)) && (Options.Version >= PDFOptions::PDFVersion_14))
 //		tmp += PDF_Transparenz(ite);
@@ -3583,19 +3555,19 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 		if (!ite->printEnabled() || ((ite->itemType() == PageItem::TextFrame) && (!pag->pageName().isEmpty())))
 		{
 //			qDebug() << "Q exit";
-			tmp += "Q\n";
+			tmp << "Q\n";
 			output = tmp;
 			return true;
 		}
 	}
 	if (ite->fillColor() != CommonStrings::None)
-		tmp += putColor(ite->fillColor(), ite->fillShade(), true);
+		tmp << putColor(ite->fillColor(), ite->fillShade(), true);
 	if (ite->lineColor() != CommonStrings::None)
-		tmp += putColor(ite->lineColor(), ite->lineShade(), false);
-	tmp += FToStr(fabs(ite->lineWidth()))+" w\n";
+		tmp << putColor(ite->lineColor(), ite->lineShade(), false);
+	tmp << fabs(ite->lineWidth()) << " w\n";
 	if (ite->DashValues.count() != 0)
 	{
-		tmp += "[ ";
+		tmp << "[ ";
 		QVector<double>::iterator it;
 		for ( it = ite->DashValues.begin(); it != ite->DashValues.end(); ++it )
 		{
@@ -3603,45 +3575,45 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 			// #8758: Custom dotted lines don't export properly to pdf
 			// Null values have to be exported if line end != flat
 			if ((da != 0) || (ite->lineEnd() != Qt::FlatCap))
-				tmp += QString::number(da)+" ";
+				tmp << da << " ";
 		}
-		tmp += "] "+QString::number(static_cast<int>(ite->DashOffset))+" d\n";
+		tmp << "] " << static_cast<int>(ite->DashOffset) << " d\n";
 	}
 	else
-		tmp += "["+getDashString(ite->PLineArt, ite->lineWidth())+"] 0 d\n";
+		tmp << "[" << getDashString(ite->PLineArt, ite->lineWidth()) << "] 0 d\n";
 	switch (ite->PLineEnd)
 	{
 		case Qt::FlatCap:
-			tmp += "0 J\n";
+			tmp << "0 J\n";
 			break;
 		case Qt::SquareCap:
-			tmp += "2 J\n";
+			tmp << "2 J\n";
 			break;
 		case Qt::RoundCap:
-			tmp += "1 J\n";
+			tmp << "1 J\n";
 			break;
 		default:
-			tmp += "0 J\n";
+			tmp << "0 J\n";
 			break;
 	}
 	switch (ite->PLineJoin)
 	{
 		case Qt::MiterJoin:
-			tmp += "0 j\n";
+			tmp << "0 j\n";
 			break;
 		case Qt::BevelJoin:
-			tmp += "2 j\n";
+			tmp << "2 j\n";
 			break;
 		case Qt::RoundJoin:
-			tmp += "1 j\n";
+			tmp << "1 j\n";
 			break;
 		default:
-			tmp += "0 j\n";
+			tmp << "0 j\n";
 			break;
 	}
 	if (!embedded)
 	{
-		tmp += "1 0 0 1 "+FToStr(ite->xPos() - pag->xOffset())+" "+FToStr(pag->height() - (ite->yPos()  - pag->yOffset()))+" cm\n";
+		tmp << "1 0 0 1 " << ite->xPos() - pag->xOffset() << " " << pag->height() - (ite->yPos()  - pag->yOffset()) << " cm\n";
 	}
 	if (ite->rotation() != 0)
 	{
@@ -3651,7 +3623,7 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 			cr = 0;
 		if ((sr * sr) < 0.000001)
 			sr = 0;
-		tmp += FToStr(cr)+" "+FToStr(sr)+" "+FToStr(-sr)+" "+FToStr(cr)+" 0 0 cm\n";
+		tmp << cr << " " << sr << " " << -sr << " " << cr << " 0 0 cm\n";
 	}
 	switch (ite->itemType())
 	{
@@ -3669,11 +3641,11 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 				break;
 			}
 #endif
-			tmp += "q\n";
+			tmp << "q\n";
 			// Same functions as for ImageFrames work for LatexFrames too
 			if (((ite->GrMask > 0) || (ite->fillTransparency() != 0) || (ite->fillBlendmode() != 0)) && ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4) ))
 			{
-				tmp += PDF_TransparenzFill(ite);
+				tmp << PDF_TransparenzFill(ite);
 			}
 			if ((ite->fillColor() != CommonStrings::None) || (ite->GrType != 0))
 			{
@@ -3689,40 +3661,40 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 						if (!PDF_GradientFillStroke(tmpOut, ite))
 							return false;
 					}
-					tmp += tmpOut;
-					tmp += SetClipPath(ite);
-					tmp += (ite->fillRule ? "h\nf*\n" : "h\nf\n");
+					tmp << tmpOut;
+					tmp << SetClipPath(ite);
+					tmp << (ite->fillRule ? "h\nf*\n" : "h\nf\n");
 				}
 				else
 				{
-					tmp += SetClipPath(ite);
-					tmp += (ite->fillRule ? "h\nf*\n" : "h\nf\n");
+					tmp << SetClipPath(ite);
+					tmp << (ite->fillRule ? "h\nf*\n" : "h\nf\n");
 				}
 			}
-			tmp += "q\n";
+			tmp << "q\n";
 			if (ite->imageClip.size() != 0)
 			{
-				tmp += SetClipPathImage(ite);
-				tmp += "h\nW*\nn\n";
+				tmp << SetClipPathImage(ite);
+				tmp << "h\nW*\nn\n";
 			}
-			tmp += SetClipPath(ite);
-			tmp += "h\nW*\nn\n";
+			tmp << SetClipPath(ite);
+			tmp << "h\nW*\nn\n";
 			if (ite->imageFlippedH())
-				tmp += "-1 0 0 1 "+FToStr(ite->width())+" 0 cm\n";
+				tmp << "-1 0 0 1 " << ite->width() << " 0 cm\n";
 			if (ite->imageFlippedV())
-				tmp += "1 0 0 -1 0 "+FToStr(-ite->height())+" cm\n";
+				tmp << "1 0 0 -1 0 " << -ite->height() << " cm\n";
 			if ((ite->PictureIsAvailable) && (!ite->Pfile.isEmpty()))
 			{
 				if (!PDF_Image(ite, ite->Pfile, ite->imageXScale(), ite->imageYScale(), ite->imageXOffset(), -ite->imageYOffset(), false, ite->IProfile, ite->UseEmbedded, ite->IRender, &tmpOut))
 					return false;
-				tmp += tmpOut;
+				tmp << tmpOut;
 			}
-			tmp += "Q\n";
-			tmp += "Q\n";
+			tmp << "Q\n";
+			tmp << "Q\n";
 			if (((ite->lineColor() != CommonStrings::None) || (!ite->NamedLStyle.isEmpty()) || (!ite->strokePattern().isEmpty()) || (ite->GrTypeStroke > 0)) && (!ite->isTableItem))
 			{
 				if (((ite->lineTransparency() != 0) || (ite->lineBlendmode() != 0)) && ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4) ))
-					tmp += PDF_TransparenzStroke(ite);
+					tmp << PDF_TransparenzStroke(ite);
 				if (ite->NamedLStyle.isEmpty()) //&& (ite->lineWidth() != 0.0))
 				{
 					if (!ite->strokePattern().isEmpty())
@@ -3730,31 +3702,31 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 						if (ite->patternStrokePath)
 						{
 							QPainterPath path = ite->PoLine.toQPainterPath(false);
-							tmp += HandleBrushPattern(ite, path, pag, PNr);
+							HandleBrushPattern(tmp, ite, path, pag, PNr);
 						}
 						else
 						{
-							tmp += SetClipPath(ite);
+							tmp << SetClipPath(ite);
 							if (!PDF_PatternFillStroke(tmpOut, ite, 1))
 								return false;
-							tmp += tmpOut;
-							tmp += "h\nS\n";
+							tmp << tmpOut;
+							tmp << "h\nS\n";
 						}
 					}
 					else if (ite->GrTypeStroke > 0)
 					{
 						if (!PDF_GradientFillStroke(tmpOut, ite, true))
 							return false;
-						tmp += "q\n";
-						tmp += tmpOut;
-						tmp += SetClipPath(ite);
-						tmp += "h\nS\n";
-						tmp += "Q\n";
+						tmp << "q\n";
+						tmp << tmpOut;
+						tmp << SetClipPath(ite);
+						tmp << "h\nS\n";
+						tmp << "Q\n";
 					}
 					else if (ite->lineColor() != CommonStrings::None)
 					{
-						tmp += SetClipPath(ite);
-						tmp += "h\nS\n";
+						tmp << SetClipPath(ite);
+						tmp << "h\nS\n";
 					}
 				}
 				else
@@ -3764,9 +3736,9 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 					{
 						if (ml[it].Color != CommonStrings::None) //&& (ml[it].Width != 0))
 						{
-							tmp += setStrokeMulti(&ml[it]);
-							tmp += SetClipPath(ite);
-							tmp += "h\nS\n";
+							tmp << setStrokeMulti(&ml[it]);
+							tmp << SetClipPath(ite);
+							tmp << "h\nS\n";
 						}
 					}
 				}
@@ -3779,10 +3751,10 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 					return false;
 				break;
 			}
-			tmp += "q\n";
+			tmp << "q\n";
 			if (((ite->GrMask > 0) || (ite->fillTransparency() != 0) || (ite->fillBlendmode() != 0)) && ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4) ))
 			{
-				tmp += PDF_TransparenzFill(ite);
+				tmp << PDF_TransparenzFill(ite);
 			}
 			if ((ite->fillColor() != CommonStrings::None) || (ite->GrType != 0))
 			{
@@ -3798,28 +3770,28 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 						if (!PDF_GradientFillStroke(tmpOut, ite))
 							return false;
 					}
-					tmp += tmpOut;
-					tmp += SetClipPath(ite);
-					tmp += (ite->fillRule ? "h\nf*\n" : "h\nf\n");
+					tmp << tmpOut;
+					tmp << SetClipPath(ite);
+					tmp << (ite->fillRule ? "h\nf*\n" : "h\nf\n");
 				}
 				else
 				{
-					tmp += SetClipPath(ite);
-					tmp += (ite->fillRule ? "h\nf*\n" : "h\nf\n");
+					tmp << SetClipPath(ite);
+					tmp << (ite->fillRule ? "h\nf*\n" : "h\nf\n");
 				}
 			}
-			tmp += "q\n";
+			tmp << "q\n";
 			if (ite->imageFlippedH())
-				tmp += "-1 0 0 1 "+FToStr(ite->width())+" 0 cm\n";
+				tmp << "-1 0 0 1 " << ite->width() << " 0 cm\n";
 			if (ite->imageFlippedV())
-				tmp += "1 0 0 -1 0 "+FToStr(-ite->height())+" cm\n";
-			tmp += setTextSt(ite, PNr, pag);
-			tmp += "Q\n";
-			tmp += "Q\n";
+				tmp << "1 0 0 -1 0 " << -ite->height() << " cm\n";
+			setTextSt(tmp, ite, PNr, pag);
+			tmp << "Q\n";
+			tmp << "Q\n";
 			if (((ite->lineColor() != CommonStrings::None) || (!ite->NamedLStyle.isEmpty()) || (!ite->strokePattern().isEmpty()) || (ite->GrTypeStroke > 0)) && (!ite->isTableItem))
 			{
 				if (((ite->lineTransparency() != 0) || (ite->lineBlendmode() != 0)) && ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4) ))
-					tmp += PDF_TransparenzStroke(ite);
+					tmp << PDF_TransparenzStroke(ite);
 				if (ite->NamedLStyle.isEmpty()) //&& (ite->lineWidth() != 0.0))
 				{
 					if (!ite->strokePattern().isEmpty())
@@ -3827,31 +3799,31 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 						if (ite->patternStrokePath)
 						{
 							QPainterPath path = ite->PoLine.toQPainterPath(false);
-							tmp += HandleBrushPattern(ite, path, pag, PNr);
+							HandleBrushPattern(tmp, ite, path, pag, PNr);
 						}
 						else
 						{
-							tmp += SetClipPath(ite);
+							tmp << SetClipPath(ite);
 							if (!PDF_PatternFillStroke(tmpOut, ite, 1))
 								return false;
-							tmp += tmpOut;
-							tmp += "h\nS\n";
+							tmp << tmpOut;
+							tmp << "h\nS\n";
 						}
 					}
 					else if (ite->GrTypeStroke > 0)
 					{
 						if (!PDF_GradientFillStroke(tmpOut, ite, true))
 							return false;
-						tmp += "q\n";
-						tmp += tmpOut;
-						tmp += SetClipPath(ite);
-						tmp += "h\nS\n";
-						tmp += "Q\n";
+						tmp << "q\n";
+						tmp << tmpOut;
+						tmp << SetClipPath(ite);
+						tmp << "h\nS\n";
+						tmp << "Q\n";
 					}
 					else if (ite->lineColor() != CommonStrings::None)
 					{
-						tmp += SetClipPath(ite);
-						tmp += "h\nS\n";
+						tmp << SetClipPath(ite);
+						tmp << "h\nS\n";
 					}
 				}
 				else
@@ -3861,9 +3833,9 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 					{
 						if (ml[it].Color != CommonStrings::None) //&& (ml[it].Width != 0))
 						{
-							tmp += setStrokeMulti(&ml[it]);
-							tmp += SetClipPath(ite);
-							tmp += "h\nS\n";
+							tmp << setStrokeMulti(&ml[it]);
+							tmp << SetClipPath(ite);
+							tmp << "h\nS\n";
 						}
 					}
 				}
@@ -3871,7 +3843,7 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 			break;
 		case PageItem::Line:
 			if (((ite->lineTransparency() != 0) || (ite->lineBlendmode() != 0)) && ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4)))
-				tmp += PDF_TransparenzStroke(ite);
+				tmp << PDF_TransparenzStroke(ite);
 			if (ite->NamedLStyle.isEmpty())
 			{
 				if (!ite->strokePattern().isEmpty())
@@ -3881,34 +3853,34 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 						QPainterPath path;
 						path.moveTo(0, 0);
 						path.lineTo(ite->width(), 0);
-						tmp += HandleBrushPattern(ite, path, pag, PNr);
+						HandleBrushPattern(tmp, ite, path, pag, PNr);
 					}
 					else
 					{
 						if (!PDF_PatternFillStroke(tmpOut, ite, 1))
 							return false;
-						tmp += tmpOut;
-						tmp += "0 0 m\n";
-						tmp += FToStr(ite->width())+" 0 l\n";
-						tmp += "S\n";
+						tmp << tmpOut;
+						tmp << "0 0 m\n";
+						tmp << ite->width() << " 0 l\n";
+						tmp << "S\n";
 					}
 				}
 				else if (ite->GrTypeStroke > 0)
 				{
 					if (!PDF_GradientFillStroke(tmpOut, ite, true))
 						return false;
-					tmp += "q\n";
-					tmp += tmpOut;
-					tmp += "0 0 m\n";
-					tmp += FToStr(ite->width())+" 0 l\n";
-					tmp += "S\n";
-					tmp += "Q\n";
+					tmp << "q\n";
+					tmp << tmpOut;
+					tmp << "0 0 m\n";
+					tmp << ite->width() << " 0 l\n";
+					tmp << "S\n";
+					tmp << "Q\n";
 				}
 				else if (ite->lineColor() != CommonStrings::None)
 				{
-					tmp += "0 0 m\n";
-					tmp += FToStr(ite->width())+" 0 l\n";
-					tmp += "S\n";
+					tmp << "0 0 m\n";
+					tmp << ite->width() << " 0 l\n";
+					tmp << "S\n";
 				}
 			}
 			else
@@ -3918,10 +3890,10 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 				{
 					if (ml[it].Color != CommonStrings::None) //&& (ml[it].Width != 0))
 					{
-						tmp += setStrokeMulti(&ml[it]);
-						tmp += "0 0 m\n";
-						tmp += FToStr(ite->width())+" 0 l\n";
-						tmp += "S\n";
+						tmp << setStrokeMulti(&ml[it]);
+						tmp << "0 0 m\n";
+						tmp << ite->width() << " 0 l\n";
+						tmp << "S\n";
 					}
 				}
 			}
@@ -3930,14 +3902,14 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 				QTransform arrowTrans;
 				arrowTrans.scale(-1,1);
 				arrowTrans.scale(ite->startArrowScale() / 100.0, ite->startArrowScale() / 100.0);
-				tmp += drawArrow(ite, arrowTrans, ite->startArrowIndex());
+				drawArrow(tmp, ite, arrowTrans, ite->startArrowIndex());
 			}
 			if (ite->endArrowIndex() != 0)
 			{
 				QTransform arrowTrans;
 				arrowTrans.translate(ite->width(), 0);
 				arrowTrans.scale(ite->endArrowScale() / 100.0, ite->endArrowScale() / 100.0);
-				tmp += drawArrow(ite, arrowTrans, ite->endArrowIndex());
+				drawArrow(tmp, ite, arrowTrans, ite->endArrowIndex());
 			}
 			break;
 		case PageItem::ItemType1:
@@ -3945,10 +3917,10 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 		case PageItem::Polygon:
 		case PageItem::RegularPolygon:
 		case PageItem::Arc:
-			tmp += "q\n";
+			tmp << "q\n";
 			if (((ite->GrMask > 0) || (ite->fillTransparency() != 0) || (ite->fillBlendmode() != 0)) && ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4)))
 			{
-				tmp += PDF_TransparenzFill(ite);
+				tmp << PDF_TransparenzFill(ite);
 			}
 			if (ite->GrType != 0)
 			{
@@ -3962,23 +3934,23 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 					if (!PDF_GradientFillStroke(tmpOut, ite))
 						return false;
 				}
-				tmp += tmpOut;
-				tmp += SetClipPath(ite);
-				tmp += (ite->fillRule ? "h\nf*\n" : "h\nf\n");
+				tmp << tmpOut;
+				tmp << SetClipPath(ite);
+				tmp << (ite->fillRule ? "h\nf*\n" : "h\nf\n");
 			}
 			else
 			{
 				if (ite->fillColor() != CommonStrings::None)
 				{
-					tmp += SetClipPath(ite);
-					tmp += (ite->fillRule ? "h\nf*\n" : "h\nf\n");
+					tmp << SetClipPath(ite);
+					tmp << (ite->fillRule ? "h\nf*\n" : "h\nf\n");
 				}
 			}
-			tmp += "Q\n";
+			tmp << "Q\n";
 			if ((ite->lineColor() != CommonStrings::None) || (!ite->NamedLStyle.isEmpty()) || (!ite->strokePattern().isEmpty()) || (ite->GrTypeStroke > 0))
 			{
 				if (((ite->lineTransparency() != 0) || (ite->lineBlendmode() != 0)) && ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4)))
-					tmp += PDF_TransparenzStroke(ite);
+					tmp << PDF_TransparenzStroke(ite);
 				if (ite->NamedLStyle.isEmpty()) //&& (ite->lineWidth() != 0.0))
 				{
 					if (!ite->strokePattern().isEmpty())
@@ -3986,31 +3958,31 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 						if (ite->patternStrokePath)
 						{
 							QPainterPath path = ite->PoLine.toQPainterPath(false);
-							tmp += HandleBrushPattern(ite, path, pag, PNr);
+							HandleBrushPattern(tmp, ite, path, pag, PNr);
 						}
 						else
 						{
-							tmp += SetClipPath(ite);
+							tmp << SetClipPath(ite);
 							if (!PDF_PatternFillStroke(tmpOut, ite, 1))
 								return false;
-							tmp += tmpOut;
-							tmp += "h\nS\n";
+							tmp << tmpOut;
+							tmp << "h\nS\n";
 						}
 					}
 					else if (ite->GrTypeStroke > 0)
 					{
 						if (!PDF_GradientFillStroke(tmpOut, ite, true))
 							return false;
-						tmp += "q\n";
-						tmp += tmpOut;
-						tmp += SetClipPath(ite);
-						tmp += "h\nS\n";
-						tmp += "Q\n";
+						tmp << "q\n";
+						tmp << tmpOut;
+						tmp << SetClipPath(ite);
+						tmp << "h\nS\n";
+						tmp << "Q\n";
 					}
 					else if (ite->lineColor() != CommonStrings::None)
 					{
-						tmp += SetClipPath(ite);
-						tmp += "h\nS\n";
+						tmp << SetClipPath(ite);
+						tmp << "h\nS\n";
 					}
 				}
 				else
@@ -4020,9 +3992,9 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 					{
 						if (ml[it].Color != CommonStrings::None) //&& (ml[it].Width != 0))
 						{
-							tmp += setStrokeMulti(&ml[it]);
-							tmp += SetClipPath(ite);
-							tmp += "h\nS\n";
+							tmp << setStrokeMulti(&ml[it]);
+							tmp << SetClipPath(ite);
+							tmp << "h\nS\n";
 						}
 					}
 				}
@@ -4032,10 +4004,10 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 		case PageItem::Spiral:
 			if (ite->PoLine.size() > 4)  // && ((ite->PoLine.point(0) != ite->PoLine.point(1)) || (ite->PoLine.point(2) != ite->PoLine.point(3))))
 			{
-				tmp += "q\n";
+				tmp << "q\n";
 				if (((ite->GrMask > 0) || (ite->fillTransparency() != 0) || (ite->fillBlendmode() != 0)) && ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4)))
 				{
-					tmp += PDF_TransparenzFill(ite);
+					tmp << PDF_TransparenzFill(ite);
 				}
 				if (ite->GrType != 0)
 				{
@@ -4049,24 +4021,24 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 						if (!PDF_GradientFillStroke(tmpOut, ite))
 							return false;
 					}
-					tmp += tmpOut;
-					tmp += SetClipPath(ite);
-					tmp += (ite->fillRule ? "h\nf*\n" : "h\nf\n");
+					tmp << tmpOut;
+					tmp << SetClipPath(ite);
+					tmp << (ite->fillRule ? "h\nf*\n" : "h\nf\n");
 				}
 				else
 				{
 					if (ite->fillColor() != CommonStrings::None)
 					{
-						tmp += SetClipPath(ite);
-						tmp += (ite->fillRule ? "h\nf*\n" : "h\nf\n");
+						tmp << SetClipPath(ite);
+						tmp << (ite->fillRule ? "h\nf*\n" : "h\nf\n");
 					}
 				}
-				tmp += "Q\n";
+				tmp << "Q\n";
 			}
 			if ((ite->lineColor() != CommonStrings::None) || (!ite->NamedLStyle.isEmpty()) || (!ite->strokePattern().isEmpty()) || (ite->GrTypeStroke > 0))
 			{
 				if (((ite->lineTransparency() != 0) || (ite->lineBlendmode() != 0)) && ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4)))
-					tmp += PDF_TransparenzStroke(ite);
+					tmp << PDF_TransparenzStroke(ite);
 				if (ite->NamedLStyle.isEmpty()) //&& (ite->lineWidth() != 0.0))
 				{
 					if (!ite->strokePattern().isEmpty())
@@ -4074,31 +4046,31 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 						if (ite->patternStrokePath)
 						{
 							QPainterPath path = ite->PoLine.toQPainterPath(false);
-							tmp += HandleBrushPattern(ite, path, pag, PNr);
+							HandleBrushPattern(tmp, ite, path, pag, PNr);
 						}
 						else
 						{
-							tmp += SetClipPath(ite, false);
+							tmp << SetClipPath(ite, false);
 							if (!PDF_PatternFillStroke(tmpOut, ite, 1))
 								return false;
-							tmp += tmpOut;
-							tmp += "S\n";
+							tmp << tmpOut;
+							tmp << "S\n";
 						}
 					}
 					else if (ite->GrTypeStroke > 0)
 					{
 						if (!PDF_GradientFillStroke(tmpOut, ite, true))
 							return false;
-						tmp += "q\n";
-						tmp += tmpOut;
-						tmp += SetClipPath(ite);
-						tmp += "h\nS\n";
-						tmp += "Q\n";
+						tmp << "q\n";
+						tmp << tmpOut;
+						tmp << SetClipPath(ite);
+						tmp << "h\nS\n";
+						tmp << "Q\n";
 					}
 					else if (ite->lineColor() != CommonStrings::None)
 					{
-						tmp += SetClipPath(ite, false);
-						tmp += "S\n";
+						tmp << SetClipPath(ite, false);
+						tmp << "S\n";
 					}
 				}
 				else
@@ -4108,9 +4080,9 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 					{
 						if (ml[it].Color != CommonStrings::None) //&& (ml[it].Width != 0))
 						{
-							tmp += setStrokeMulti(&ml[it]);
-							tmp += SetClipPath(ite, false);
-							tmp += "S\n";
+							tmp << setStrokeMulti(&ml[it]);
+							tmp << SetClipPath(ite, false);
+							tmp << "S\n";
 						}
 					}
 				}
@@ -4128,7 +4100,7 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 						arrowTrans.translate(Start.x(), Start.y());
 						arrowTrans.rotate(r);
 						arrowTrans.scale(ite->startArrowScale() / 100.0, ite->startArrowScale() / 100.0);
-						tmp += drawArrow(ite, arrowTrans, ite->startArrowIndex());
+						drawArrow(tmp, ite, arrowTrans, ite->startArrowIndex());
 						break;
 					}
 				}
@@ -4146,7 +4118,7 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 						arrowTrans.translate(End.x(), End.y());
 						arrowTrans.rotate(r);
 						arrowTrans.scale(ite->endArrowScale() / 100.0, ite->endArrowScale() / 100.0);
-						tmp += drawArrow(ite, arrowTrans, ite->endArrowIndex());
+						drawArrow(tmp, ite, arrowTrans, ite->endArrowIndex());
 						break;
 					}
 				}
@@ -4157,11 +4129,11 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 			{
 				if (ite->PoLine.size() > 3)
 				{
-					tmp += "q\n";
+					tmp << "q\n";
 					if ((ite->lineColor() != CommonStrings::None) || (!ite->NamedLStyle.isEmpty()) || (!ite->strokePattern().isEmpty()) || (ite->GrTypeStroke > 0))
 					{
 						if (((ite->lineTransparency() != 0) || (ite->lineBlendmode() != 0)) && ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4)))
-							tmp += PDF_TransparenzStroke(ite);
+							tmp << PDF_TransparenzStroke(ite);
 						if (ite->NamedLStyle.isEmpty()) //&& (ite->lineWidth() != 0.0))
 						{
 							if (!ite->strokePattern().isEmpty())
@@ -4169,31 +4141,31 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 								if (ite->patternStrokePath)
 								{
 									QPainterPath path = ite->PoLine.toQPainterPath(false);
-									tmp += HandleBrushPattern(ite, path, pag, PNr);
+									HandleBrushPattern(tmp, ite, path, pag, PNr);
 								}
 								else
 								{
-									tmp += SetClipPath(ite, false);
+									tmp << SetClipPath(ite, false);
 									if (!PDF_PatternFillStroke(tmpOut, ite, 1))
 										return false;
-									tmp += tmpOut;
-									tmp += "S\n";
+									tmp << tmpOut;
+									tmp << "S\n";
 								}
 							}
 							else if (ite->GrTypeStroke > 0)
 							{
 								if (!PDF_GradientFillStroke(tmpOut, ite, true))
 									return false;
-								tmp += "q\n";
-								tmp += tmpOut;
-								tmp += SetClipPath(ite, false);
-								tmp += "S\n";
-								tmp += "Q\n";
+								tmp << "q\n";
+								tmp << tmpOut;
+								tmp << SetClipPath(ite, false);
+								tmp << "S\n";
+								tmp << "Q\n";
 							}
 							else if (ite->lineColor() != CommonStrings::None)
 							{
-								tmp += SetClipPath(ite, false);
-								tmp += "S\n";
+								tmp << SetClipPath(ite, false);
+								tmp << "S\n";
 							}
 						}
 						else
@@ -4203,53 +4175,53 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 							{
 								if (ml[it].Color != CommonStrings::None) //&& (ml[it].Width != 0))
 								{
-									tmp += setStrokeMulti(&ml[it]);
-									tmp += SetClipPath(ite, false);
-									tmp += "S\n";
+									tmp << setStrokeMulti(&ml[it]);
+									tmp << SetClipPath(ite, false);
+									tmp << "S\n";
 								}
 							}
 						}
 					}
-					tmp += "Q\n";
+					tmp << "Q\n";
 				}
 			}
 			if (((ite->GrMask > 0) || (ite->fillTransparency() != 0) || (ite->fillBlendmode() != 0)) && ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4)))
 			{
 				if (ite->GrMask > 0)
-					tmp += "q\n";
-				tmp += PDF_TransparenzFill(ite);
+					tmp << "q\n";
+				tmp << PDF_TransparenzFill(ite);
 			}
-			tmp += setTextSt(ite, PNr, pag);
+			setTextSt(tmp, ite, PNr, pag);
 			if (ite->GrMask > 0)
-				tmp += "Q\n";
+				tmp << "Q\n";
 			break;
 		case PageItem::Symbol:
 			if (doc.docPatterns.contains(ite->pattern()))
 			{
-				QString tmpD = "";
+				PdfContentStream tmpD;
 				ScPattern pat = doc.docPatterns[ite->pattern()];
-				tmp += "q\n";
-				tmp += SetClipPath(ite);
-				tmp += "h W* n\n";
+				tmp << "q\n";
+				tmp << SetClipPath(ite);
+				tmp << "h W* n\n";
 				if (ite->imageFlippedH())
-					tmp += "-1 0 0 1 "+FToStr(ite->width())+" 0 cm\n";
+					tmp << "-1 0 0 1 " << ite->width() << " 0 cm\n";
 				if (ite->imageFlippedV())
-					tmp += "1 0 0 -1 0 "+FToStr(-ite->height())+" cm\n";
+					tmp << "1 0 0 -1 0 " << -ite->height() << " cm\n";
 				QTransform trans;
 				trans.scale(ite->width() / pat.width, ite->height() / pat.height);
 				trans.translate(0.0, -ite->height());
 			//	trans.translate(pat.items.at(0)->gXpos, -pat.items.at(0)->gYpos);
-				tmp += FToStr(trans.m11())+" "+FToStr(trans.m12())+" "+FToStr(trans.m21())+" "+FToStr(trans.m22())+" "+FToStr(trans.dx())+" "+FToStr(trans.dy())+" cm\n";
+				tmp << trans.m11() << " " << trans.m12() << " " << trans.m21() << " " << trans.m22() << " " << trans.dx() << " " << trans.dy() << " cm\n";
 				for (int em = 0; em < pat.items.count(); ++em)
 				{
 					PageItem* embedded = pat.items.at(em);
-					tmpD += "q\n";
-					tmpD +=  "1 0 0 1 "+FToStr(embedded->gXpos)+" "+FToStr(ite->height() - embedded->gYpos)+" cm\n";
-					QString output;
+					tmpD << "q\n";
+					tmpD << "1 0 0 1 " << embedded->gXpos << " " << ite->height() - embedded->gYpos << " cm\n";
+					PdfContentStream output;
 					if (!PDF_ProcessItem(output, embedded, pag, PNr, true))
 						return "";
-					tmpD += output;
-					tmpD += "Q\n";
+					tmpD << output;
+					tmpD << "Q\n";
 				}
 				for (int em = 0; em < pat.items.count(); ++em)
 				{
@@ -4258,44 +4230,44 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 						continue;
 					if ((embedded->lineColor() == CommonStrings::None) || (embedded->lineWidth() == 0.0))
 						continue;
-					tmpD += "q\n";
-					tmpD +=  "1 0 0 1 "+FToStr(embedded->gXpos)+" "+FToStr(ite->height() - embedded->gYpos)+" cm\n";
-					tmpD += PDF_ProcessTableItem(embedded, pag);
-					tmpD += "Q\n";
+					tmpD << "q\n";
+					tmpD << "1 0 0 1 " << embedded->gXpos << " " << ite->height() - embedded->gYpos << " cm\n";
+					PDF_ProcessTableItem(tmpD, embedded, pag);
+					tmpD << "Q\n";
 				}
 				if (Options.Version >= PDFOptions::PDFVersion_14 || Options.Version == PDFOptions::PDFVersion_X4)
-					tmp += Write_TransparencyGroup(ite->fillTransparency(), ite->fillBlendmode(), tmpD, ite);
+					tmp << Write_TransparencyGroup(ite->fillTransparency(), ite->fillBlendmode(), tmpD, ite);
 				else
-					tmp += tmpD;
-				tmp += "Q\n";
+					tmp << tmpD;
+				tmp << "Q\n";
 			}
 			break;
 		case PageItem::Group:
 			if (ite->groupItemList.count() > 0)
 			{
-				QString tmpD = "";
-				tmp += "q\n";
-				tmp += SetClipPath(ite);
-				tmp += "h W* n\n";
+				PdfContentStream tmpD;
+				tmp << "q\n";
+				tmp << SetClipPath(ite);
+				tmp << "h W* n\n";
 				if (ite->imageFlippedH())
-					tmp += "-1 0 0 1 "+FToStr(ite->width())+" 0 cm\n";
+					tmp << "-1 0 0 1 " << ite->width() << " 0 cm\n";
 				if (ite->imageFlippedV())
-					tmp += "1 0 0 -1 0 "+FToStr(-ite->height())+" cm\n";
+					tmp << "1 0 0 -1 0 " << -ite->height() << " cm\n";
 				QTransform trans;
 				trans.scale(ite->width() / ite->groupWidth, ite->height() / ite->groupHeight);
 				trans.translate(0.0, -ite->height());
-				tmp += FToStr(trans.m11())+" "+FToStr(trans.m12())+" "+FToStr(trans.m21())+" "+FToStr(trans.m22())+" "+FToStr(trans.dx())+" "+FToStr(trans.dy())+" cm\n";
+				tmp << trans.m11() << " " << trans.m12() << " " << trans.m21() << " " << trans.m22() << " " << trans.dx() << " " << trans.dy() << " cm\n";
 				groupStackPos.push(QPointF(ite->xPos(), ite->height()));
 				for (int em = 0; em < ite->groupItemList.count(); ++em)
 				{
 					PageItem* embedded = ite->groupItemList.at(em);
-					tmpD += "q\n";
-					tmpD +=  "1 0 0 1 "+FToStr(embedded->gXpos)+" "+FToStr(ite->height() - embedded->gYpos)+" cm\n";
-					QString output;
+					tmpD << "q\n";
+					tmpD << "1 0 0 1 " << embedded->gXpos << " " << ite->height() - embedded->gYpos << " cm\n";
+					PdfContentStream output;
 					if (!PDF_ProcessItem(output, embedded, pag, PNr, true))
 						return "";
-					tmpD += output;
-					tmpD += "Q\n";
+					tmpD << output;
+					tmpD << "Q\n";
 				}
 				for (int em = 0; em < ite->groupItemList.count(); ++em)
 				{
@@ -4304,32 +4276,31 @@ bool PDFLibCore::PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag
 						continue;
 					if ((embedded->lineColor() == CommonStrings::None) || (embedded->lineWidth() == 0.0))
 						continue;
-					tmpD += "q\n";
-					tmpD +=  "1 0 0 1 "+FToStr(embedded->gXpos)+" "+FToStr(ite->height() - embedded->gYpos)+" cm\n";
-					tmpD += PDF_ProcessTableItem(embedded, pag);
-					tmpD += "Q\n";
+					tmpD << "q\n";
+					tmpD << "1 0 0 1 " << embedded->gXpos << " " << ite->height() - embedded->gYpos << " cm\n";
+					PDF_ProcessTableItem(tmpD, embedded, pag);
+					tmpD << "Q\n";
 				}
 				groupStackPos.pop();
 				if (Options.Version >= PDFOptions::PDFVersion_14 || Options.Version == PDFOptions::PDFVersion_X4)
-					tmp += Write_TransparencyGroup(ite->fillTransparency(), ite->fillBlendmode(), tmpD, ite);
+					tmp << Write_TransparencyGroup(ite->fillTransparency(), ite->fillBlendmode(), tmpD, ite);
 				else
-					tmp += tmpD;
-				tmp += "Q\n";
+					tmp << tmpD;
+				tmp << "Q\n";
 			}
 			break;
 		case PageItem::Multiple:
 			Q_ASSERT(false);
 			break;
 	}
-	tmp += "Q\n";
+	tmp << "Q\n";
 	output = tmp;
 	return true;
 }
 
-QString PDFLibCore::HandleBrushPattern(PageItem* ite, QPainterPath &path, const Page* pag, uint PNr)
+void PDFLibCore::HandleBrushPattern(PdfContentStream& output, PageItem* ite, QPainterPath &path, const Page* pag, uint PNr)
 {
-	QString tmp;
-	tmp = "";
+	PdfContentStream tmp;
 	ScPattern pat = doc.docPatterns[ite->strokePattern()];
 	double pLen = path.length() - ((pat.width / 2.0) * (ite->patternStrokeScaleX / 100.0));
 	double adv = pat.width * ite->patternStrokeScaleX / 100.0 * ite->patternStrokeSpace;
@@ -4345,11 +4316,11 @@ QString PDFLibCore::HandleBrushPattern(PageItem* ite, QPainterPath &path, const
 			currAngle = 360.0 - currAngle;
 #endif
 		QPointF currPoint = path.pointAtPercent(currPerc);
-		tmp += "q\n";
+		tmp << "q\n";
 		QTransform base;
 		base.translate(currPoint.x(), -currPoint.y());
 		base.rotate(-currAngle);
-		tmp += FToStr(base.m11())+" "+FToStr(base.m12())+" "+FToStr(base.m21())+" "+FToStr(base.m22())+" "+FToStr(base.dx())+" "+FToStr(base.dy())+" cm\n";
+		tmp << base.m11() << " " << base.m12() << " " << base.m21() << " " << base.m22() << " " << base.dx() << " " << base.dy() << " cm\n";
 		QTransform trans;
 		trans.translate(0.0, -ite->patternStrokeOffsetY);
 		trans.rotate(-ite->patternStrokeRotation);
@@ -4366,17 +4337,17 @@ QString PDFLibCore::HandleBrushPattern(PageItem* ite, QPainterPath &path, const
 			trans.translate(0, pat.height);
 			trans.scale(1, -1);
 		}
-		tmp += FToStr(trans.m11())+" "+FToStr(trans.m12())+" "+FToStr(trans.m21())+" "+FToStr(trans.m22())+" "+FToStr(trans.dx())+" "+FToStr(trans.dy())+" cm\n";
+		tmp << trans.m11() << " " << trans.m12() << " " << trans.m21() << " " << trans.m22() << " " << trans.dx() << " " << trans.dy() << " cm\n";
 		for (int em = 0; em < pat.items.count(); ++em)
 		{
 			PageItem* embedded = pat.items.at(em);
-			tmp += "q\n";
-			tmp +=  "1 0 0 1 "+FToStr(embedded->gXpos)+" "+FToStr(embedded->gHeight - embedded->gYpos)+" cm\n";
-			QString output;
-			if (!PDF_ProcessItem(output, embedded, pag, PNr, true))
-				return "";
-			tmp += output;
-			tmp += "Q\n";
+			tmp << "q\n";
+			tmp << "1 0 0 1 " << embedded->gXpos << " " << embedded->gHeight - embedded->gYpos << " cm\n";
+			PdfContentStream itemOutput;
+			if (!PDF_ProcessItem(itemOutput, embedded, pag, PNr, true))
+				return;
+			tmp << itemOutput;
+			tmp << "Q\n";
 		}
 		for (int em = 0; em < pat.items.count(); ++em)
 		{
@@ -4385,20 +4356,19 @@ QString PDFLibCore::HandleBrushPattern(PageItem* ite, QPainterPath &path, const
 				continue;
 			if ((embedded->lineColor() == CommonStrings::None) || (embedded->lineWidth() == 0.0))
 				continue;
-			tmp += "q\n";
-			tmp +=  "1 0 0 1 "+FToStr(embedded->gXpos)+" "+FToStr(embedded->gHeight - embedded->gYpos)+" cm\n";
-			tmp += PDF_ProcessTableItem(embedded, pag);
-			tmp += "Q\n";
+			tmp << "q\n";
+			tmp << "1 0 0 1 " << embedded->gXpos << " " << embedded->gHeight - embedded->gYpos << " cm\n";
+			PDF_ProcessTableItem(tmp, embedded, pag);
+			tmp << "Q\n";
 		}
-		tmp += "Q\n";
+		tmp << "Q\n";
 		xpos += adv;
 	}
-	return tmp;
+	output << tmp;
 }
 
-QString PDFLibCore::drawArrow(PageItem *ite, QTransform &arrowTrans, int arrowIndex)
+void PDFLibCore::drawArrow(PdfContentStream& output, PageItem *ite, QTransform &arrowTrans, int arrowIndex)
 {
-	QString tmp = "";
 	FPointArray arrow = doc.arrowStyles().at(arrowIndex-1).points.copy();
 	if (ite->NamedLStyle.isEmpty())
 	{
@@ -4420,32 +4390,32 @@ QString PDFLibCore::drawArrow(PageItem *ite, QTransform &arrowTrans, int arrowIn
 									   + "/ca "+FToStr(1.0 - ite->lineTransparency())+"\n"
 									   + "/SMask /None\n/AIS false\n/OPM 1\n"
 									   + "/BM /Normal\n");
-		tmp += "/"+ShName+" gs\n";
+		output << "/" << ShName << " gs\n";
 	}
 	if (ite->NamedLStyle.isEmpty())
 	{
 		if (!ite->strokePattern().isEmpty())
 		{
-			tmp += SetClipPathArray(&arrow);
+			output << SetClipPathArray(&arrow);
 			QString tmpOut;
 			PDF_PatternFillStroke(tmpOut, ite, 1, true);
-			tmp += tmpOut;
-			tmp += "h\nf*\n";
+			output << tmpOut;
+			output << "h\nf*\n";
 		}
 		else if (ite->GrTypeStroke > 0)
 		{
-			tmp += SetClipPathArray(&arrow);
+			output << SetClipPathArray(&arrow);
 			QString tmpOut;
 			PDF_GradientFillStroke(tmpOut, ite, true, true);
-			tmp += "q\n";
-			tmp += tmpOut;
-			tmp += "h\nf*\nQ\n";
+			output << "q\n";
+			output << tmpOut;
+			output << "h\nf*\nQ\n";
 		}
 		else if (ite->lineColor() != CommonStrings::None)
 		{
-			tmp += putColor(ite->lineColor(), ite->lineShade(), true);
-			tmp += SetClipPathArray(&arrow);
-			tmp += "h\nf*\n";
+			output << putColor(ite->lineColor(), ite->lineShade(), true);
+			output << SetClipPathArray(&arrow);
+			output << "h\nf*\n";
 		}
 	}
 	else
@@ -4453,21 +4423,20 @@ QString PDFLibCore::drawArrow(PageItem *ite, QTransform &arrowTrans, int arrowIn
 		multiLine ml = doc.MLineStyles[ite->NamedLStyle];
 		if (ml[0].Color != CommonStrings::None)
 		{
-			tmp += putColor(ml[0].Color, ml[0].Shade, true);
-			tmp += SetClipPathArray(&arrow);
-			tmp += "h\nf*\n";
+			output << putColor(ml[0].Color, ml[0].Shade, true);
+			output << SetClipPathArray(&arrow);
+			output << "h\nf*\n";
 		}
 		for (int it = ml.size()-1; it > 0; it--)
 		{
 			if (ml[it].Color != CommonStrings::None)
 			{
-				tmp += setStrokeMulti(&ml[it]);
-				tmp += SetClipPathArray(&arrow);
-				tmp += "h\nS\n";
+				output << setStrokeMulti(&ml[it]);
+				output << SetClipPathArray(&arrow);
+				output << "h\nS\n";
 			}
 		}
 	}
-	return tmp;
 }
 
 QString PDFLibCore::putColor(const QString& color, double shade, bool fill)
@@ -4726,13 +4695,13 @@ QString PDFLibCore::setStrokeMulti(struct SingleLine *sl)
 }
 
 // Return a PDF substring representing a PageItem's text
-QString PDFLibCore::setTextSt(PageItem *ite, uint PNr, const Page* pag)
+void PDFLibCore::setTextSt(PdfContentStream& output, PageItem *ite, uint PNr, const Page* pag)
 {
 	int tabCc = 0;
 	int savedOwnPage = ite->OwnPage;
 	double tabDist = ite->textToFrameDistLeft();
 	double colLeft = 0.0;
-	QString tmp(""), tmp2("");
+	PdfContentStream tmp2;
 	QList<ParagraphStyle::TabRecord> tTabValues;
 	ite->OwnPage = PNr;
 	ite->layout();
@@ -4743,7 +4712,7 @@ QString PDFLibCore::setTextSt(PageItem *ite, uint PNr, const Page* pag)
 	// Loop over each character (!) in the pageItem...
 	if (ite->itemType() == PageItem::TextFrame)
 	{
-		tmp += "BT\n";
+		output << "BT\n";
 		for (uint ll=0; ll < ite->itemText.lines(); ++ll)
 		{
 			LineSpec ls = ite->itemText.line(ll);
@@ -4802,9 +4771,9 @@ QString PDFLibCore::setTextSt(PageItem *ite, uint PNr, const Page* pag)
 								hl3.setFillShade(hl2.strokeShade());
 								hl3.glyph.yoffset = hl2.glyph.yoffset - (chstyle.fontSize() * chstyle.shadowYOffset() / 10000.0);
 								hl3.glyph.xoffset = hl2.glyph.xoffset + (chstyle.fontSize() * chstyle.shadowXOffset() / 10000.0);
-								setTextCh(ite, PNr, CurX, ls.y, d, tmp, tmp2, &hl3, pstyle, pag);
+								setTextCh(ite, PNr, CurX, ls.y, d, output, tmp2, &hl3, pstyle, pag);
 							}
-							setTextCh(ite, PNr, CurX, ls.y, d, tmp, tmp2, &hl2, pstyle, pag);
+							setTextCh(ite, PNr, CurX, ls.y, d, output, tmp2, &hl2, pstyle, pag);
 						}
 					}
 					tabCc++;
@@ -4842,9 +4811,9 @@ QString PDFLibCore::setTextSt(PageItem *ite, uint PNr, const Page* pag)
 					hl2.glyph.xoffset = hl->glyph.xoffset + (chstyle.fontSize() * chstyle.shadowXOffset() / 10000.0);
 					hl2.glyph.scaleH = hl->glyph.scaleH;
 					hl2.glyph.scaleV = hl->glyph.scaleV;
-					setTextCh(ite, PNr, CurX, ls.y, d, tmp, tmp2, &hl2, pstyle, pag);
+					setTextCh(ite, PNr, CurX, ls.y, d, output, tmp2, &hl2, pstyle, pag);
 				}
-				setTextCh(ite, PNr, CurX, ls.y, d, tmp, tmp2, hl, pstyle, pag);
+				setTextCh(ite, PNr, CurX, ls.y, d, output, tmp2, hl, pstyle, pag);
 				// Unneeded now that glyph xadvance is set appropriately for inline objects by PageItem_TextFrame::layout() - JG
 				/*if (hl->ch == SpecialChars::OBJECT)
 				{
@@ -4904,9 +4873,9 @@ QString PDFLibCore::setTextSt(PageItem *ite, uint PNr, const Page* pag)
 							hl3.setFillShade(hl2.strokeShade());
 							hl3.glyph.yoffset = hl2.glyph.yoffset - (chstyle.fontSize() * chstyle.shadowYOffset() / 10000.0);
 							hl3.glyph.xoffset = hl2.glyph.xoffset + (chstyle.fontSize() * chstyle.shadowXOffset() / 10000.0);
-							setTextCh(ite, PNr, 0, 0, d, tmp, tmp2, &hl3, pstyle, pag);
+							setTextCh(ite, PNr, 0, 0, d, output, tmp2, &hl3, pstyle, pag);
 						}
-						setTextCh(ite, PNr, 0, 0, d, tmp, tmp2, &hl2, pstyle, pag);
+						setTextCh(ite, PNr, 0, 0, d, output, tmp2, &hl2, pstyle, pag);
 					}
 					tabCc++;
 				}
@@ -4939,28 +4908,28 @@ QString PDFLibCore::setTextSt(PageItem *ite, uint PNr, const Page* pag)
 				hl2.PtransY = hl->PtransY;
 				hl2.PRot = hl->PRot;
 				hl2.PDx = hl->PDx;
-				setTextCh(ite, PNr, 0, 0, d, tmp, tmp2, &hl2, pstyle, pag);
+				setTextCh(ite, PNr, 0, 0, d, output, tmp2, &hl2, pstyle, pag);
 			}
-			setTextCh(ite, PNr, 0, 0, d, tmp, tmp2, hl, pstyle, pag);
+			setTextCh(ite, PNr, 0, 0, d, output, tmp2, hl, pstyle, pag);
 			CurX += hl->glyph.wide();
 			tabDist = CurX;
 		}
 	}
 #endif
+	flushTextRun(output);
 	if (ite->itemType() == PageItem::TextFrame)
-		tmp += "ET\n"+tmp2;
-	return tmp;
+		output << "ET\n" << tmp2;
 }
 
-bool PDFLibCore::setTextCh(PageItem *ite, uint PNr, double x,  double y, uint d, QString &tmp, QString &tmp2, const ScText *hl, const ParagraphStyle& pstyle, const Page* pag)
+bool PDFLibCore::setTextCh(PageItem *ite, uint PNr, double x,  double y, uint d, PdfContentStream &tmp, PdfContentStream &tmp2, const ScText *hl, const ParagraphStyle& pstyle, const Page* pag)
 {
 #ifndef NLS_PROTO
-	QString output;
+	PdfContentStream output;
 	QString FillColor = "";
 	QString StrokeColor = "";
 	if (ite->asPathText())
 	{
-		tmp += "q\n";
+		tmp << "q\n";
 		QPointF tangt = QPointF( cos(hl->PRot), sin(hl->PRot) );
 		QTransform trafo = QTransform( 1, 0, 0, -1, -hl->PDx, 0 );
 		if (ite->textPathFlipped)
@@ -4983,13 +4952,13 @@ bool PDFLibCore::setTextCh(PageItem *ite, uint PNr, double x,  double y, uint d,
 			else
 				trafo *= QTransform( a, 6 * b, 0, -1, hl->PtransX, -hl->PtransY );
 		}
-		tmp += FToStr(trafo.m11())+" "+FToStr(trafo.m12())+" "+FToStr(trafo.m21())+" "+FToStr(trafo.m22())+" "+FToStr(trafo.dx())+" "+FToStr(trafo.dy())+" cm\n";
+		tmp << trafo.m11() << " " << trafo.m12() << " " << trafo.m21() << " " << trafo.m22() << " " << trafo.dx() << " " << trafo.dy() << " cm\n";
 		if (ite->BaseOffs != 0)
-			tmp += "1 0 0 1 0 "+ FToStr( -ite->BaseOffs)+" cm\n";
+			tmp << "1 0 0 1 0 " << -ite->BaseOffs << " cm\n";
 		if (hl->glyph.xoffset != 0.0 || hl->glyph.yoffset != 0.0)
-			tmp += "1 0 0 1 " + FToStr( hl->glyph.xoffset)+ " " + FToStr( -hl->glyph.yoffset)+" cm\n";
+			tmp << "1 0 0 1 " << hl->glyph.xoffset << " " << -hl->glyph.yoffset << " cm\n";
 		if (hl->ch != SpecialChars::OBJECT)
-			tmp += "BT\n";
+			tmp << "BT\n";
 	}
 	double tsz = hl->fontSize();
 	QChar chstr = hl->ch;
@@ -5014,24 +4983,25 @@ bool PDFLibCore::setTextCh(PageItem *ite, uint PNr, double x,  double y, uint d,
 	InlineFrame& embedded(const_cast<InlineFrame&>(hl->embedded));
 	if (hl->hasObject())
 	{
+		flushTextRun(tmp);
 		if (!ite->asPathText())
 		{
-			tmp += "ET\n"+tmp2;
-			tmp2 = "";
+			tmp << "ET\n" << tmp2;
+			tmp2.clear();
 		}
 		QList<PageItem*> emG = embedded.getGroupedItems();
 		for (int em = 0; em < emG.count(); ++em)
 		{
 			PageItem* embedded = emG.at(em);
-			tmp2 += "q\n";
+			tmp2 << "q\n";
 			if (ite->asPathText())
-				tmp2 +=  FToStr(style.scaleH() / 1000.0)+" 0 0 "+FToStr(style.scaleV() / 1000.0)+" "+FToStr(embedded->gXpos * (style.scaleH() / 1000.0))+" "+FToStr((embedded->gHeight * (style.scaleV() / 1000.0)) - embedded->gYpos * (style.scaleV() / 1000.0)+embedded->gHeight * (style.baselineOffset() / 1000.0))+" cm\n";
+				tmp2 << style.scaleH() / 1000.0 << " 0 0 " << style.scaleV() / 1000.0 << " " << embedded->gXpos * (style.scaleH() / 1000.0) << " " << (embedded->gHeight * (style.scaleV() / 1000.0)) - embedded->gYpos * (style.scaleV() / 1000.0)+embedded->gHeight * (style.baselineOffset() / 1000.0) << " cm\n";
 			else
-				tmp2 +=  FToStr(style.scaleH() / 1000.0)+" 0 0 "+FToStr(style.scaleV() / 1000.0)+" "+FToStr(x+hl->glyph.xoffset + embedded->gXpos * (style.scaleH() / 1000.0))+" "+FToStr(-y-hl->glyph.yoffset + (embedded->gHeight * (style.scaleV() / 1000.0)) - embedded->gYpos * (style.scaleV() / 1000.0)+embedded->gHeight * (style.baselineOffset() / 1000.0))+" cm\n";
+				tmp2 << style.scaleH() / 1000.0 << " 0 0 " << style.scaleV() / 1000.0 << " " << x+hl->glyph.xoffset + embedded->gXpos * (style.scaleH() / 1000.0) << " " << -y-hl->glyph.yoffset + (embedded->gHeight * (style.scaleV() / 1000.0)) - embedded->gYpos * (style.scaleV() / 1000.0)+embedded->gHeight * (style.baselineOffset() / 1000.0) << " cm\n";
 			if (!PDF_ProcessItem(output, embedded, pag, PNr, true))
 				return false;
-			tmp2 +=output;
-			tmp2 += "Q\n";
+			tmp2 << output;
+			tmp2 << "Q\n";
 		}
 		for (int em = 0; em < emG.count(); ++em)
 		{
@@ -5040,11 +5010,11 @@ bool PDFLibCore::setTextCh(PageItem *ite, uint PNr, double x,  double y, uint d,
 				continue;
 			if ((embedded->lineColor() == CommonStrings::None) || (embedded->lineWidth() == 0.0))
 				continue;
-			tmp2 += "q\n";
+			tmp2 << "q\n";
 			if (ite->asPathText())
-				tmp2 +=  FToStr(style.scaleH() / 1000.0)+" 0 0 "+FToStr(style.scaleV() / 1000.0)+" "+FToStr(embedded->gXpos * (style.scaleH() / 1000.0))+" "+FToStr((embedded->gHeight * (style.scaleV() / 1000.0)) - embedded->gYpos * (style.scaleV() / 1000.0)+embedded->gHeight * (style.baselineOffset() / 1000.0))+" cm\n";
+				tmp2 << style.scaleH() / 1000.0 << " 0 0 " << style.scaleV() / 1000.0 << " " << embedded->gXpos * (style.scaleH() / 1000.0) << " " << (embedded->gHeight * (style.scaleV() / 1000.0)) - embedded->gYpos * (style.scaleV() / 1000.0)+embedded->gHeight * (style.baselineOffset() / 1000.0) << " cm\n";
 			else
-				tmp2 +=  FToStr(style.scaleH() / 1000.0)+" 0 0 "+FToStr(style.scaleV() / 1000.0)+" "+FToStr(x+hl->glyph.xoffset + embedded->gXpos * (style.scaleH() / 1000.0))+" "+FToStr(-y-hl->glyph.yoffset + (embedded->gHeight * (style.scaleV() / 1000.0)) - embedded->gYpos * (style.scaleV() / 1000.0)+embedded->gHeight * (style.baselineOffset() / 1000.0))+" cm\n";
+				tmp2 << style.scaleH() / 1000.0 << " 0 0 " << style.scaleV() / 1000.0 << " " << x+hl->glyph.xoffset + embedded->gXpos * (style.scaleH() / 1000.0) << " " << -y-hl->glyph.yoffset + (embedded->gHeight * (style.scaleV() / 1000.0)) - embedded->gYpos * (style.scaleV() / 1000.0)+embedded->gHeight * (style.baselineOffset() / 1000.0) << " cm\n";
 
 			if ((embedded->doOverprint) && (!Options.UseRGB))
 			{
@@ -5053,16 +5023,16 @@ bool PDFLibCore::setTextCh(PageItem *ite, uint PNr, double x,  double y, uint d,
 				Transpar[ShName] = writeGState("/OP true\n"
 											"/op true\n"
 											"/OPM 1\n");
-				tmp2 += "/"+ShName+" gs\n";
+				tmp2 << "/" << ShName << " gs\n";
 			}
 			if (((embedded->lineTransparency() != 0) || (embedded->lineBlendmode() != 0)) && ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4)))
-				tmp2 += PDF_TransparenzStroke(embedded);
+				tmp2 << PDF_TransparenzStroke(embedded);
 			if (embedded->lineColor() != CommonStrings::None)
-				tmp2 += putColor(embedded->lineColor(), embedded->lineShade(), false);
-			tmp2 += FToStr(fabs(embedded->lineWidth()))+" w\n";
+				tmp2 << putColor(embedded->lineColor(), embedded->lineShade(), false);
+			tmp2 << fabs(embedded->lineWidth()) << " w\n";
 			if (embedded->DashValues.count() != 0)
 			{
-				tmp2 += "[ ";
+				tmp2 << "[ ";
 				QVector<double>::iterator it;
 				for ( it = embedded->DashValues.begin(); it != embedded->DashValues.end(); ++it )
 				{
@@ -5070,60 +5040,60 @@ bool PDFLibCore::setTextCh(PageItem *ite, uint PNr, double x,  double y, uint d,
 					// #8758: Custom dotted lines don't export properly to pdf
 					// Null values have to be exported if line end != flat
 					if ((da != 0) || (embedded->lineEnd() != Qt::FlatCap))
-						tmp2 += QString::number(da)+" ";
+						tmp2 << da << " ";
 				}
-				tmp2 += "] "+QString::number(static_cast<int>(embedded->DashOffset))+" d\n";
+				tmp2 << "] " << static_cast<int>(embedded->DashOffset) << " d\n";
 			}
 			else
-				tmp2 += "["+getDashString(embedded->PLineArt, embedded->lineWidth())+"] 0 d\n";
-			tmp2 += "2 J\n";
+				tmp2 << "[" << getDashString(embedded->PLineArt, embedded->lineWidth()) << "] 0 d\n";
+			tmp2 << "2 J\n";
 			switch (embedded->PLineJoin)
 			{
 				case Qt::MiterJoin:
-					tmp2 += "0 j\n";
+					tmp2 << "0 j\n";
 					break;
 				case Qt::BevelJoin:
-					tmp2 += "2 j\n";
+					tmp2 << "2 j\n";
 					break;
 				case Qt::RoundJoin:
-					tmp2 += "1 j\n";
+					tmp2 << "1 j\n";
 					break;
 				default:
-					tmp2 += "0 j\n";
+					tmp2 << "0 j\n";
 					break;
 			}
 			if ((embedded->TopLine) || (embedded->RightLine) || (embedded->BottomLine) || (embedded->LeftLine))
 			{
 				if (embedded->TopLine)
 				{
-					tmp2 += "0 0 m\n";
-					tmp2 += FToStr(embedded->width())+" 0 l\n";
+					tmp2 << "0 0 m\n";
+					tmp2 << embedded->width() << " 0 l\n";
 				}
 				if (embedded->RightLine)
 				{
-					tmp2 += FToStr(embedded->width())+" 0 m\n";
-					tmp2 += FToStr(embedded->width())+" "+FToStr(-embedded->height())+" l\n";
+					tmp2 << embedded->width() << " 0 m\n";
+					tmp2 << embedded->width() << " " << -embedded->height() << " l\n";
 				}
 				if (embedded->BottomLine)
 				{
-					tmp2 += "0 "+FToStr(-embedded->height())+" m\n";
-					tmp2 += FToStr(embedded->width())+" "+FToStr(-embedded->height())+" l\n";
+					tmp2 << "0 " << -embedded->height() << " m\n";
+					tmp2 << embedded->width() << " " << -embedded->height() << " l\n";
 				}
 				if (embedded->LeftLine)
 				{
-					tmp2 += "0 0 m\n";
-					tmp2 += "0 "+FToStr(-embedded->height())+" l\n";
+					tmp2 << "0 0 m\n";
+					tmp2 << "0 " << -embedded->height() << " l\n";
 				}
-				tmp2 += "S\n";
+				tmp2 << "S\n";
 			}
-			tmp2 += "Q\n";
+			tmp2 << "Q\n";
 		}
-		tmp += tmp2+"\n";
-		tmp2 = "";
+		tmp << tmp2 << "\n";
+		tmp2.clear();
 		if (ite->asPathText())
-			tmp += "Q\n";
+			tmp << "Q\n";
 		else
-			tmp += "BT\n";
+			tmp << "BT\n";
 		return true;
 	}
 
@@ -5181,35 +5151,35 @@ bool PDFLibCore::setTextCh(PageItem *ite, uint PNr, double x,  double y, uint d,
 			if (style.baselineOffset() != 0)
 				Upos += (style.fontSize() / 10.0) * hl->glyph.scaleV * (style.baselineOffset() / 1000.0);
 			if (style.fillColor() != CommonStrings::None)
-				tmp2 += putColor(style.fillColor(), style.fillShade(), false);
-			tmp2 += FToStr(Uwid)+" w\n";
+				tmp2 << putColor(style.fillColor(), style.fillShade(), false);
+			tmp2 << Uwid << " w\n";
 			if (ite->itemType() == PageItem::PathText)
 			{
 				if (style.effects() & ScStyle_Subscript)
 				{
-					tmp2 += FToStr(x+hl->glyph.xoffset)     +" "+FToStr(-y+Upos)+" m\n";
-					tmp2 += FToStr(x+hl->glyph.xoffset+Ulen)+" "+FToStr(-y+Upos)+" l\n";
+					tmp2 << x+hl->glyph.xoffset << " " << -y+Upos << " m\n";
+					tmp2 << x+hl->glyph.xoffset+Ulen << " " << -y+Upos << " l\n";
 				}
 				else
 				{
-					tmp2 += FToStr(x+hl->glyph.xoffset)     +" "+FToStr(-y+hl->glyph.yoffset+Upos)+" m\n";
-					tmp2 += FToStr(x+hl->glyph.xoffset+Ulen)+" "+FToStr(-y+hl->glyph.yoffset+Upos)+" l\n";
+					tmp2 << x+hl->glyph.xoffset << " " << -y+hl->glyph.yoffset+Upos << " m\n";
+					tmp2 << x+hl->glyph.xoffset+Ulen << " " << -y+hl->glyph.yoffset+Upos << " l\n";
 				}
 			}
 			else
 			{
 				if (style.effects() & ScStyle_Subscript)
 				{
-					tmp2 += FToStr(x+hl->glyph.xoffset)     +" "+FToStr(-y-hl->glyph.yoffset+Upos)+" m\n";
-					tmp2 += FToStr(x+hl->glyph.xoffset+Ulen)+" "+FToStr(-y-hl->glyph.yoffset+Upos)+" l\n";
+					tmp2 << x+hl->glyph.xoffset << " " << -y-hl->glyph.yoffset+Upos << " m\n";
+					tmp2 << x+hl->glyph.xoffset+Ulen << " " << -y-hl->glyph.yoffset+Upos << " l\n";
 				}
 				else
 				{
-					tmp2 += FToStr(x+hl->glyph.xoffset)     +" "+FToStr(-y+Upos)+" m\n";
-					tmp2 += FToStr(x+hl->glyph.xoffset+Ulen)+" "+FToStr(-y+Upos)+" l\n";
+					tmp2 << x+hl->glyph.xoffset << " " << -y+Upos << " m\n";
+					tmp2 << x+hl->glyph.xoffset+Ulen << " " << -y+Upos << " l\n";
 				}
 			}
-			tmp2 += "S\n";
+			tmp2 << "S\n";
 		}
 		if (!style.font().hasNames())
 		{
@@ -5217,12 +5187,12 @@ bool PDFLibCore::setTextCh(PageItem *ite, uint PNr, double x,  double y, uint d,
 			{
 				if ((style.strokeColor() != CommonStrings::None) && (style.effects() & ScStyle_Outline))
 				{
-					tmp2 += FToStr((tsz * style.outlineWidth() / 1000.0) / tsz)+" w\n[] 0 d\n0 J\n0 j\n";
-					tmp2 += StrokeColor;
+					tmp2 << (tsz * style.outlineWidth() / 1000.0) / tsz << " w\n[] 0 d\n0 J\n0 j\n";
+					tmp2 << StrokeColor;
 				}
 				if (style.fillColor() != CommonStrings::None)
-					tmp2 += FillColor;
-				tmp2 += "q\n";
+					tmp2 << FillColor;
+				tmp2 << "q\n";
 				// #see 8257 : transform is already computed at beginning of the function
 				/*if (ite->itemType() == PageItem::PathText)
 				{
@@ -5241,27 +5211,27 @@ bool PDFLibCore::setTextCh(PageItem *ite, uint PNr, double x,  double y, uint d,
 					if (ite->reversed())
 					{
 						double wid = style.font().charWidth(chstr, style.fontSize()) * (hl->glyph.scaleH);
-						tmp2 += "1 0 0 1 "+FToStr(x+hl->glyph.xoffset)+" "+FToStr((y+hl->glyph.yoffset - (tsz / 10.0)) * -1 + ((tsz / 10.0) * (style.baselineOffset() / 1000.0)))+" cm\n";
-						tmp2 += "-1 0 0 1 0 0 cm\n";
-						tmp2 += "1 0 0 1 "+FToStr(-wid)+" 0 cm\n";
-						tmp2 += FToStr(tsz / 10.0)+" 0 0 "+FToStr(tsz / 10.0)+" 0 0 cm\n";
+						tmp2 << "1 0 0 1 " << x+hl->glyph.xoffset << " " << (y+hl->glyph.yoffset - (tsz / 10.0)) * -1 + ((tsz / 10.0) * (style.baselineOffset() / 1000.0)) << " cm\n";
+						tmp2 << "-1 0 0 1 0 0 cm\n";
+						tmp2 << "1 0 0 1 " << -wid << " 0 cm\n";
+						tmp2 << tsz / 10.0 << " 0 0 " << tsz / 10.0 << " 0 0 cm\n";
 					}
 					else
 					{
-						tmp2 += FToStr(tsz / 10.0)+" 0 0 "+FToStr(tsz / 10.0)+" "+FToStr(x+hl->glyph.xoffset)+" "+FToStr((y+hl->glyph.yoffset - (tsz / 10.0)) * -1 + ((tsz / 10.0) * (style.baselineOffset() / 1000.0)))+" cm\n";
+						tmp2 << tsz / 10.0 << " 0 0 " << tsz / 10.0 << " " << x+hl->glyph.xoffset << " " << (y+hl->glyph.yoffset - (tsz / 10.0)) * -1 + ((tsz / 10.0) * (style.baselineOffset() / 1000.0)) << " cm\n";
 					}
 				}
 				else
 				{
 					if (ite->BaseOffs != 0)
-						tmp2 += "1 0 0 1 0 "+FToStr( -ite->BaseOffs)+" cm\n";
-					tmp2 += FToStr(tsz / 10.0)+" 0 0 "+FToStr(tsz / 10.0)+" 0 "+FToStr(tsz / 10.0)+" cm\n";
+						tmp2 << "1 0 0 1 0 " << -ite->BaseOffs << " cm\n";
+					tmp2 << tsz / 10.0 << " 0 0 " << tsz / 10.0 << " 0 " << tsz / 10.0 << " cm\n";
 				}
 				if (hl->glyph.scaleV != 1.0)
-					tmp2 += "1 0 0 1 0 "+FToStr( (((tsz / 10.0) - (tsz / 10.0) * (hl->glyph.scaleV)) / (tsz / 10.0)) * -1)+" cm\n";
-				tmp2 += FToStr(qMax(hl->glyph.scaleH, 0.1))+" 0 0 "+FToStr(qMax(hl->glyph.scaleV, 0.1))+" 0 0 cm\n";
+					tmp2 << "1 0 0 1 0 " << (((tsz / 10.0) - (tsz / 10.0) * (hl->glyph.scaleV)) / (tsz / 10.0)) * -1 << " cm\n";
+				tmp2 << qMax(hl->glyph.scaleH, 0.1) << " 0 0 " << qMax(hl->glyph.scaleV, 0.1) << " 0 0 cm\n";
 				if (style.fillColor() != CommonStrings::None)
-					tmp2 += "/"+style.font().psName().replace( QRegExp("[\\s\\/\\{\\[\\]\\}\\<\\>\\(\\)\\%]"), "_" )+QString::number(glyph)+" Do\n";
+					tmp2 << "/" << style.font().psName().replace( QRegExp("[\\s\\/\\{\\[\\]\\}\\<\\>\\(\\)\\%]"), "_" ) << glyph << " Do\n";
 				if (style.effects() & ScStyle_Outline)
 				{
 					FPointArray gly = style.font().glyphOutline(glyph);
@@ -5276,27 +5246,27 @@ bool PDFLibCore::setTextCh(PageItem *ite, uint PNr, double x,  double y, uint d,
 						{
 							if (gly.point(poi).x() > 900000)
 							{
-								tmp2 += "h\n";
+								tmp2 << "h\n";
 								nPath = true;
 								continue;
 							}
 							if (nPath)
 							{
 								np = gly.point(poi);
-								tmp2 += FToStr(np.x())+" "+FToStr(-np.y())+" m\n";
+								tmp2 << np.x() << " " << -np.y() << " m\n";
 								nPath = false;
 							}
 							np = gly.point(poi+1);
-							tmp2 += FToStr(np.x())+" "+FToStr(-np.y())+" ";
+							tmp2 << np.x() << " " << -np.y() << " ";
 							np = gly.point(poi+3);
-							tmp2 += FToStr(np.x())+" "+FToStr(-np.y())+" ";
+							tmp2 << np.x() << " " << -np.y() << " ";
 							np = gly.point(poi+2);
-							tmp2 += FToStr(np.x())+" "+FToStr(-np.y())+" c\n";
+							tmp2 << np.x() << " " << -np.y() << " c\n";
 						}
 					}
-					tmp2 += "h s\n";
+					tmp2 << "h s\n";
 				}
-				tmp2 += "Q\n";
+				tmp2 << "Q\n";
 			}
 		}
 		else
@@ -5304,36 +5274,39 @@ bool PDFLibCore::setTextCh(PageItem *ite, uint PNr, double x,  double y, uint d,
 			if (style.strokeColor() != CommonStrings::None)
 			{
 				if ((style.effects() & ScStyle_Underline) || (style.effects() & ScStyle_Strikethrough) || (style.effects() & ScStyle_Outline))
-					tmp2 += StrokeColor;
+					tmp2 << StrokeColor;
 			}
 			if (style.fillColor() != CommonStrings::None)
 			{
 				if ((style.effects() & ScStyle_Underline) || (style.effects() & ScStyle_Strikethrough))
-					tmp2 += FillColor;
+					tmp2 << FillColor;
 			}
 			if (glyph != style.font().char2CMap(QChar(' ')))
 			{
 				uint idx = hl->glyph.glyph;
 				uint idx1;
+				if (SubsetFonts.contains(style.font().replacementName()) && (idx < ScFace::CONTROL_GLYPHS))
+					UsedGlyphs[style.font().replacementName()].insert(idx);
 				if (Options.SubsetList.contains(style.font().replacementName()))
 					idx1 = Type3Fonts[UsedFontsP[style.font().replacementName()]][idx] / 256;
 				else
 					idx1 = idx / 224;
 				ScFace currentFace = style.font();
+				PdfContentStream textState;
 				if (Options.Version == PDFOptions::PDFVersion_X4
 					&& (currentFace.format() == ScFace::SFNT || currentFace.format() == ScFace::TTCF)
 					&& ( !Options.SubsetList.contains(style.font().replacementName()) ) )
-					tmp+= UsedFontsP[currentFace.replacementName()]+" "+FToStr(tsz / 10.0)+" Tf\n";
+					textState << UsedFontsP[currentFace.replacementName()] << " " << tsz / 10.0 << " Tf\n";
 				else
-					tmp += UsedFontsP[style.font().replacementName()]+"S"+QString::number(idx1)+" "+FToStr(tsz / 10.0)+" Tf\n";
+					textState << UsedFontsP[style.font().replacementName()] << "S" << idx1 << " " << tsz / 10.0 << " Tf\n";
 				if (style.strokeColor() != CommonStrings::None)
-					tmp += StrokeColor;
+					textState << StrokeColor;
 				if (style.fillColor() != CommonStrings::None)
-					tmp += FillColor;
+					textState << FillColor;
 				if ((Options.SubsetList.contains(style.font().replacementName())) && (style.effects() & ScStyle_Outline) && (style.strokeColor() != CommonStrings::None))
 				{
-					tmp2 += "q\n";
-					tmp2 += FToStr((tsz * style.outlineWidth() / 1000.0) / tsz)+" w\n[] 0 d\n0 J\n0 j\n";
+					tmp2 << "q\n";
+					tmp2 << (tsz * style.outlineWidth() / 1000.0) / tsz << " w\n[] 0 d\n0 J\n0 j\n";
 					// #see 8257 : transform is already computed at beginning of the function
 					/*if (ite->itemType() == PageItem::PathText)
 					{
@@ -5352,25 +5325,25 @@ bool PDFLibCore::setTextCh(PageItem *ite, uint PNr, double x,  double y, uint d,
 						if (ite->reversed())
 						{
 							double wid = style.font().charWidth(chstr, style.fontSize()) * (hl->glyph.scaleH);
-							tmp2 += "1 0 0 1 "+FToStr(x+hl->glyph.xoffset)+" "+FToStr((y+hl->glyph.yoffset - (tsz / 10.0)) * -1 + ((tsz / 10.0) * (style.baselineOffset() / 1000.0)))+" cm\n";
-							tmp2 += "-1 0 0 1 0 0 cm\n";
-							tmp2 += "1 0 0 1 "+FToStr(-wid)+" 0 cm\n";
-							tmp2 += FToStr(tsz / 10.0)+" 0 0 "+FToStr(tsz / 10.0)+" 0 0 cm\n";
+							tmp2 << "1 0 0 1 " << x+hl->glyph.xoffset << " " << (y+hl->glyph.yoffset - (tsz / 10.0)) * -1 + ((tsz / 10.0) * (style.baselineOffset() / 1000.0)) << " cm\n";
+							tmp2 << "-1 0 0 1 0 0 cm\n";
+							tmp2 << "1 0 0 1 " << -wid << " 0 cm\n";
+							tmp2 << tsz / 10.0 << " 0 0 " << tsz / 10.0 << " 0 0 cm\n";
 						}
 						else
 						{
-							tmp2 += FToStr(tsz / 10.0)+" 0 0 "+FToStr(tsz / 10.0)+" "+FToStr(x+hl->glyph.xoffset)+" "+FToStr((y+hl->glyph.yoffset - (tsz / 10.0)) * -1 + ((tsz / 10.0) * (style.baselineOffset() / 1000.0)))+" cm\n";
+							tmp2 << tsz / 10.0 << " 0 0 " << tsz / 10.0 << " " << x+hl->glyph.xoffset << " " << (y+hl->glyph.yoffset - (tsz / 10.0)) * -1 + ((tsz / 10.0) * (style.baselineOffset() / 1000.0)) << " cm\n";
 						}
 					}
 					else
 					{
 						if (ite->BaseOffs != 0)
-							tmp2 += "1 0 0 1 0 "+FToStr( -ite->BaseOffs)+" cm\n";
-						tmp2 += FToStr(tsz / 10.0)+" 0 0 "+FToStr(tsz / 10.0)+" 0 "+FToStr(tsz / 10.0)+" cm\n";
+							tmp2 << "1 0 0 1 0 " << -ite->BaseOffs << " cm\n";
+						tmp2 << tsz / 10.0 << " 0 0 " << tsz / 10.0 << " 0 " << tsz / 10.0 << " cm\n";
 					}
 					if (hl->glyph.scaleV != 1.0)
-						tmp2 += "1 0 0 1 0 "+FToStr( (((tsz / 10.0) - (tsz / 10.0) * (hl->glyph.scaleV)) / (tsz / 10.0)) * -1)+" cm\n";
-					tmp2 += FToStr(qMax(hl->glyph.scaleH, 0.1))+" 0 0 "+FToStr(qMax(hl->glyph.scaleV, 0.1))+" 0 0 cm\n";
+						tmp2 << "1 0 0 1 0 " << (((tsz / 10.0) - (tsz / 10.0) * (hl->glyph.scaleV)) / (tsz / 10.0)) * -1 << " cm\n";
+					tmp2 << qMax(hl->glyph.scaleH, 0.1) << " 0 0 " << qMax(hl->glyph.scaleV, 0.1) << " 0 0 cm\n";
 					FPointArray gly = style.font().glyphOutline(glyph);
 					QTransform mat;
 					mat.scale(0.1, 0.1);
@@ -5383,68 +5356,74 @@ bool PDFLibCore::setTextCh(PageItem *ite, uint PNr, double x,  double y, uint d,
 						{
 							if (gly.point(poi).x() > 900000)
 							{
-								tmp2 += "h\n";
+								tmp2 << "h\n";
 								nPath = true;
 								continue;
 							}
 							if (nPath)
 							{
 								np = gly.point(poi);
-								tmp2 += FToStr(np.x())+" "+FToStr(-np.y())+" m\n";
+								tmp2 << np.x() << " " << -np.y() << " m\n";
 								nPath = false;
 							}
 							np = gly.point(poi+1);
-							tmp2 += FToStr(np.x())+" "+FToStr(-np.y())+" ";
+							tmp2 << np.x() << " " << -np.y() << " ";
 							np = gly.point(poi+3);
-							tmp2 += FToStr(np.x())+" "+FToStr(-np.y())+" ";
+							tmp2 << np.x() << " " << -np.y() << " ";
 							np = gly.point(poi+2);
-							tmp2 += FToStr(np.x())+" "+FToStr(-np.y())+" c\n";
+							tmp2 << np.x() << " " << -np.y() << " c\n";
 						}
 					}
-					tmp2 += "h s\n";
-					tmp2 += "Q\n";
+					tmp2 << "h s\n";
+					tmp2 << "Q\n";
 				}
 				else
 				{
 					if (style.effects() & ScStyle_Outline)
-						tmp += FToStr(tsz * style.outlineWidth() / 10000.0) + (style.fillColor() != CommonStrings::None ? " w 2 Tr\n" : " w 1 Tr\n");
+						textState << tsz * style.outlineWidth() / 10000.0 << (style.fillColor() != CommonStrings::None ? " w 2 Tr\n" : " w 1 Tr\n");
 					else
-						tmp += "0 Tr\n";
+						textState << "0 Tr\n";
 				}
-				if (!ite->asPathText())
-				{
-					if (ite->reversed())
-					{
-						double wtr = hl->glyph.xadvance;
-						tmp +=  FToStr(-qMax(hl->glyph.scaleH, 0.1))+" 0 0 "+FToStr(qMax(hl->glyph.scaleV, 0.1)) +" "+FToStr(x+hl->glyph.xoffset+wtr)+" "+FToStr(-y-hl->glyph.yoffset+(style.fontSize() / 10.0) * (style.baselineOffset() / 1000.0))+" Tm\n";
-					}
-					else
-						tmp +=  FToStr(qMax(hl->glyph.scaleH, 0.1))+" 0 0 "+FToStr(qMax(hl->glyph.scaleV, 0.1))+" "+FToStr(x+hl->glyph.xoffset)+" "+FToStr(-y-hl->glyph.yoffset+(style.fontSize() / 10.0) * (style.baselineOffset() / 1000.0))+" Tm\n";
-				}
-				else
-					tmp += FToStr(qMax(hl->glyph.scaleH, 0.1))+" 0 0 "+FToStr(qMax(hl->glyph.scaleV, 0.1))+" 0 0 Tm\n";
-				uchar idx2;
+				QByteArray glyphCode;
 				if (Options.SubsetList.contains(style.font().replacementName()))
 				{
 					if (style.fillColor() != CommonStrings::None)
-					{
-						idx2 = Type3Fonts[UsedFontsP[style.font().replacementName()]][idx] % 256;
-						tmp += "<"+QString(toHex(idx2))+"> Tj\n";
-					}
+						glyphCode = QByteArray(toHex(static_cast<uchar>(Type3Fonts[UsedFontsP[style.font().replacementName()]][idx] % 256)));
 				}
 				else if (Options.Version == PDFOptions::PDFVersion_X4 && (currentFace.format() == ScFace::SFNT || currentFace.format() == ScFace::TTCF))
 				{
-					QString val;
-					val.setNum(idx,16);
-					int numberOfZero = 4-val.size();
+					glyphCode.setNum(idx,16);
+					int numberOfZero = 4-glyphCode.size();
 					for (int i=0; i<numberOfZero; ++i)
-						val.prepend("0");
-					tmp += "<"+val+"> Tj\n";
+						glyphCode.prepend("0");
 				}
+				else
+					glyphCode = QByteArray(toHex(static_cast<uchar>(idx % 224 + 32)));
+				double scaleH = qMax(hl->glyph.scaleH, 0.1);
+				double scaleV = qMax(hl->glyph.scaleV, 0.1);
+				double baseY = -y-hl->glyph.yoffset+(style.fontSize() / 10.0) * (style.baselineOffset() / 1000.0);
+				// Glyphs drawn by the text operators can be collected into runs as long as the
+				// font declares the same widths Scribus uses, Type3 glyphs are drawn one by one.
+				if (!ite->asPathText() && !ite->reversed() && !Options.SubsetList.contains(style.font().replacementName()) && (idx < ScFace::CONTROL_GLYPHS))
+					putTextGlyph(tmp, textState.data(), scaleH, scaleV, tsz / 10.0, x+hl->glyph.xoffset, baseY, glyphCode, static_cast<int>(currentFace.glyphWidth(idx) * 1000));
 				else
 				{
-					idx2 = idx % 224 + 32;
-					tmp += "<"+QString(toHex(idx2))+"> Tj\n";
+					flushTextRun(tmp);
+					tmp << textState;
+					if (!ite->asPathText())
+					{
+						if (ite->reversed())
+						{
+							double wtr = hl->glyph.xadvance;
+							tmp << -scaleH << " 0 0 " << scaleV << " " << x+hl->glyph.xoffset+wtr << " " << baseY << " Tm\n";
+						}
+						else
+							tmp << scaleH << " 0 0 " << scaleV << " " << x+hl->glyph.xoffset << " " << baseY << " Tm\n";
+					}
+					else
+						tmp << scaleH << " 0 0 " << scaleV << " 0 0 Tm\n";
+					if (!glyphCode.isEmpty())
+						tmp << "<" << glyphCode << "> Tj\n";
 				}
 			}
 		}
@@ -5476,24 +5455,24 @@ bool PDFLibCore::setTextCh(PageItem *ite, uint PNr, double x,  double y, uint d,
 			if (style.baselineOffset() != 0)
 				Upos += (style.fontSize() / 10.0) * hl->glyph.scaleV * (style.baselineOffset() / 1000.0);
 			if (style.fillColor() != CommonStrings::None)
-				tmp2 += putColor(style.fillColor(), style.fillShade(), false);
-			tmp2 += FToStr(Uwid)+" w\n";
+				tmp2 << putColor(style.fillColor(), style.fillShade(), false);
+			tmp2 << Uwid << " w\n";
 			if (ite->itemType() == PageItem::PathText)
 			{
-				tmp2 += FToStr(x+hl->glyph.xoffset)     +" "+FToStr(-y+Upos)+" m\n";
-				tmp2 += FToStr(x+hl->glyph.xoffset+Ulen)+" "+FToStr(-y+Upos)+" l\n";
+				tmp2 << x+hl->glyph.xoffset << " " << -y+Upos << " m\n";
+				tmp2 << x+hl->glyph.xoffset+Ulen << " " << -y+Upos << " l\n";
 			}
 			else
 			{
-				tmp2 += FToStr(x+hl->glyph.xoffset)     +" "+FToStr(-y-hl->glyph.yoffset+Upos)+" m\n";
-				tmp2 += FToStr(x+hl->glyph.xoffset+Ulen)+" "+FToStr(-y-hl->glyph.yoffset+Upos)+" l\n";
+				tmp2 << x+hl->glyph.xoffset << " " << -y-hl->glyph.yoffset+Upos << " m\n";
+				tmp2 << x+hl->glyph.xoffset+Ulen << " " << -y-hl->glyph.yoffset+Upos << " l\n";
 			}
-			tmp2 += "S\n";
+			tmp2 << "S\n";
 		}
 		if (ite->asPathText())
 		{
-			tmp += "ET\n"+tmp2+"Q\n";
-			tmp2 = "";
+			tmp << "ET\n" << tmp2 << "Q\n";
+			tmp2.clear();
 		}
 	}
 	if (hl->glyph.more) {
@@ -5509,6 +5488,48 @@ bool PDFLibCore::setTextCh(PageItem *ite, uint PNr, double x,  double y, uint d,
 #endif
 }
 
+void PDFLibCore::putTextGlyph(PdfContentStream &tmp, const QByteArray& state, double scaleH, double scaleV, double fontSize, double x, double y, const QByteArray& code, int width)
+{
+	TextRun& run(CurrentTextRun);
+	if (!run.Glyphs.isEmpty() && ((run.State != state) || (run.ScaleH != scaleH) || (run.ScaleV != scaleV)
+		|| (run.FontSize != fontSize) || (fabs(run.PosY - y) > 0.00001)))
+		flushTextRun(tmp);
+	// the viewer advances by the glyph widths, the differences to the positions
+	// computed by the layout are given in thousandths of the scaled font size
+	double unit = fontSize * scaleH / 1000.0;
+	if (run.Glyphs.isEmpty())
+	{
+		tmp << state;
+		tmp << scaleH << " 0 0 " << scaleV << " " << x << " " << y << " Tm\n";
+		run.State = state;
+		run.ScaleH = scaleH;
+		run.ScaleV = scaleV;
+		run.FontSize = fontSize;
+		run.PosX = x;
+		run.PosY = y;
+		run.Glyphs << "[";
+	}
+	else if (unit > 0.0)
+	{
+		double adjust = (run.PosX - x) / unit;
+		if (fabs(adjust) >= 0.01)
+		{
+			run.Glyphs << adjust;
+			run.PosX = x;
+		}
+	}
+	run.Glyphs << "<" << code << ">";
+	run.PosX += width * unit;
+}
+
+void PDFLibCore::flushTextRun(PdfContentStream &tmp)
+{
+	if (CurrentTextRun.Glyphs.isEmpty())
+		return;
+	tmp << CurrentTextRun.Glyphs << "] TJ\n";
+	CurrentTextRun.Glyphs.clear();
+}
+
 QString PDFLibCore::SetColor(const QString& farbe, double Shade)
 {
 	const ScColor& col = doc.PageColors[farbe];
@@ -5974,32 +5995,28 @@ QString PDFLibCore::PDF_TransparenzFill(PageItem *currItem)
 			PutDoc(">>\n");
 		}
 		PutDoc(">>\n");
-		QString stre = "q\n";
+		PdfContentStream stre;
+		stre << "q\n";
 		if (currItem->isGroup())
 		{
 			QTransform mpa;
 			mpa.translate(currItem->xPos() - ActPageP->xOffset(), ActPageP->height() - (currItem->yPos() - ActPageP->yOffset()));
 			mpa.rotate(-currItem->rotation());
-			stre += FToStr(mpa.m11())+" "+FToStr(mpa.m12())+" "+FToStr(mpa.m21())+" "+FToStr(mpa.m22())+" "+FToStr(mpa.dx())+" "+FToStr(mpa.dy())+" cm\n";
+			stre << mpa.m11() << " " << mpa.m12() << " " << mpa.m21() << " " << mpa.m22() << " " << mpa.dx() << " " << mpa.dy() << " cm\n";
 		}
 		else if (currItem->itemType() == PageItem::Symbol)
 		{
 			QTransform mpa;
 			mpa.translate(0, currItem->height() * scaleY);
 			mpa.scale(scaleX, scaleY);
-			stre += FToStr(mpa.m11())+" "+FToStr(mpa.m12())+" "+FToStr(mpa.m21())+" "+FToStr(mpa.m22())+" "+FToStr(mpa.dx())+" "+FToStr(mpa.dy())+" cm\n";
-		}
-		stre += SetClipPath(currItem)+"h\n";
-		stre += FToStr(fabs(currItem->lineWidth()))+" w\n";
-		stre += "/Pattern cs\n";
-		stre += "/Pattern"+QString::number(patObject)+" scn\nf*\n";
-		stre += "Q\n";
-		if (Options.Compress)
-			stre = CompressStr(&stre);
-		PutDoc("/Length "+QString::number(stre.length())+"\n");
-		if (Options.Compress)
-			PutDoc("/Filter /FlateDecode\n");
-		PutDoc(">>\nstream\n"+EncStream(stre, formObject)+"\nendstream\nendobj\n");
+			stre << mpa.m11() << " " << mpa.m12() << " " << mpa.m21() << " " << mpa.m22() << " " << mpa.dx() << " " << mpa.dy() << " cm\n";
+		}
+		stre << SetClipPath(currItem) << "h\n";
+		stre << fabs(currItem->lineWidth()) << " w\n";
+		stre << "/Pattern cs\n";
+		stre << "/Pattern" << patObject << " scn\nf*\n";
+		stre << "Q\n";
+		PutStream(stre.data(), Options.Compress ? CompressArray(stre.data()) : QByteArray(), formObject);
 		Seite.XObjects[ResNam+QString::number(ResCount)] = formObject;
 		ResCount++;
 		GXName = ResNam+QString::number(ResCount);
@@ -6045,31 +6062,27 @@ QString PDFLibCore::PDF_TransparenzFill(PageItem *currItem)
 			PutDoc(">>\n");
 		}
 		PutDoc(">>\n");
-		QString stre = "q\n";
+		PdfContentStream stre;
+		stre << "q\n";
 		if (currItem->isGroup())
 		{
 			QTransform mpa;
 			mpa.translate(currItem->xPos() - ActPageP->xOffset(), ActPageP->height() - (currItem->yPos() - ActPageP->yOffset()));
 			mpa.rotate(-currItem->rotation());
-			stre += FToStr(mpa.m11())+" "+FToStr(mpa.m12())+" "+FToStr(mpa.m21())+" "+FToStr(mpa.m22())+" "+FToStr(mpa.dx())+" "+FToStr(mpa.dy())+" cm\n";
+			stre << mpa.m11() << " " << mpa.m12() << " " << mpa.m21() << " " << mpa.m22() << " " << mpa.dx() << " " << mpa.dy() << " cm\n";
 		}
 		else if (currItem->itemType() == PageItem::Symbol)
 		{
 			QTransform mpa;
 			mpa.translate(0, currItem->height() * scaleY);
 			mpa.scale(scaleX, scaleY);
-			stre += FToStr(mpa.m11())+" "+FToStr(mpa.m12())+" "+FToStr(mpa.m21())+" "+FToStr(mpa.m22())+" "+FToStr(mpa.dx())+" "+FToStr(mpa.dy())+" cm\n";
+			stre << mpa.m11() << " " << mpa.m12() << " " << mpa.m21() << " " << mpa.m22() << " " << mpa.dx() << " " << mpa.dy() << " cm\n";
 		}
-		stre += SetClipPath(currItem)+"h\n";
-		stre += FToStr(fabs(currItem->lineWidth()))+" w\n";
-		stre += tmpOut+" f*\n";
-		stre += "Q\n";
-		if (Options.Compress)
-			stre = CompressStr(&stre);
-		PutDoc("/Length "+QString::number(stre.length())+"\n");
-		if (Options.Compress)
-			PutDoc("/Filter /FlateDecode\n");
-		PutDoc(">>\nstream\n"+EncStream(stre, formObject)+"\nendstream\nendobj\n");
+		stre << SetClipPath(currItem) << "h\n";
+		stre << fabs(currItem->lineWidth()) << " w\n";
+		stre << tmpOut << " f*\n";
+		stre << "Q\n";
+		PutStream(stre.data(), Options.Compress ? CompressArray(stre.data()) : QByteArray(), formObject);
 		Seite.XObjects[ResNam+QString::number(ResCount)] = formObject;
 		ResCount++;
 		GXName = ResNam+QString::number(ResCount);
@@ -6101,7 +6114,7 @@ QString PDFLibCore::PDF_TransparenzStroke(PageItem *currItem)
 
 bool PDFLibCore::PDF_PatternFillStroke(QString& output, PageItem *currItem, int kind, bool forArrow)
 {
-	QString tmp2 = "", tmpOut;
+	PdfContentStream tmp2, tmpOut;
 	ScPattern *pat = NULL;
 	if (kind == 0)
 		pat = &doc.docPatterns[currItem->pattern()];
@@ -6114,16 +6127,16 @@ bool PDFLibCore::PDF_PatternFillStroke(QString& output, PageItem *currItem, int
 	for (int em = 0; em < pat->items.count(); ++em)
 	{
 		PageItem* item = pat->items.at(em);
-		tmp2 += "q\n";
-		tmp2 +=  "1 0 0 1 "+FToStr(item->gXpos)+" "+FToStr(-(item->gYpos - pat->height))+" cm\n";
+		tmp2 << "q\n";
+		tmp2 << "1 0 0 1 " << item->gXpos << " " << -(item->gYpos - pat->height) << " cm\n";
 		item->setXYPos(item->xPos() + ActPageP->xOffset(), item->yPos() + ActPageP->yOffset(), true);
 		inPattern++;
 		if (!PDF_ProcessItem(tmpOut, item, doc.DocPages.at(0), 0, true, true))
 			return false;
-		tmp2 += tmpOut;
+		tmp2 << tmpOut;
 		item->setXYPos(item->xPos() - ActPageP->xOffset(), item->yPos() - ActPageP->yOffset(), true);
 		inPattern--;
-		tmp2 += "Q\n";
+		tmp2 << "Q\n";
 	}
 	for (int em = 0; em < pat->items.count(); ++em)
 	{
@@ -6132,7 +6145,7 @@ bool PDFLibCore::PDF_PatternFillStroke(QString& output, PageItem *currItem, int
 			continue;
 		if ((item->lineColor() == CommonStrings::None) || (item->lineWidth() == 0.0))
 			continue;
-		tmp2 += "q\n";
+		tmp2 << "q\n";
 		if ((item->doOverprint) && (!Options.UseRGB))
 		{
 			QString ShName = ResNam+QString::number(ResCount);
@@ -6140,16 +6153,16 @@ bool PDFLibCore::PDF_PatternFillStroke(QString& output, PageItem *currItem, int
 			Transpar[ShName] = writeGState("/OP true\n"
 										"/op true\n"
 										"/OPM 1\n");
-			tmp2 += "/"+ShName+" gs\n";
+			tmp2 << "/" << ShName << " gs\n";
 		}
 		if (((item->lineTransparency() != 0) || (item->lineBlendmode() != 0)) && ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4)))
-			tmp2 += PDF_TransparenzStroke(item);
+			tmp2 << PDF_TransparenzStroke(item);
 		if (item->lineColor() != CommonStrings::None)
-			tmp2 += putColor(item->lineColor(), item->lineShade(), false);
-		tmp2 += FToStr(fabs(item->lineWidth()))+" w\n";
+			tmp2 << putColor(item->lineColor(), item->lineShade(), false);
+		tmp2 << fabs(item->lineWidth()) << " w\n";
 		if (item->DashValues.count() != 0)
 		{
-			tmp2 += "[ ";
+			tmp2 << "[ ";
 			QVector<double>::iterator it;
 			for ( it = item->DashValues.begin(); it != item->DashValues.end(); ++it )
 			{
@@ -6157,29 +6170,29 @@ bool PDFLibCore::PDF_PatternFillStroke(QString& output, PageItem *currItem, int
 				// #8758: Custom dotted lines don't export properly to pdf
 				// Null values have to be exported if line end != flat
 				if ((da != 0) || (item->lineEnd() != Qt::FlatCap))
-					tmp2 += QString::number(da)+" ";
+					tmp2 << da << " ";
 			}
-			tmp2 += "] "+QString::number(static_cast<int>(item->DashOffset))+" d\n";
+			tmp2 << "] " << static_cast<int>(item->DashOffset) << " d\n";
 		}
 		else
-			tmp2 += "["+getDashString(item->PLineArt, item->lineWidth())+"] 0 d\n";
-		tmp2 += "2 J\n";
+			tmp2 << "[" << getDashString(item->PLineArt, item->lineWidth()) << "] 0 d\n";
+		tmp2 << "2 J\n";
 		switch (item->PLineJoin)
 		{
 			case Qt::MiterJoin:
-				tmp2 += "0 j\n";
+				tmp2 << "0 j\n";
 				break;
 			case Qt::BevelJoin:
-				tmp2 += "2 j\n";
+				tmp2 << "2 j\n";
 				break;
 			case Qt::RoundJoin:
-				tmp2 += "1 j\n";
+				tmp2 << "1 j\n";
 				break;
 			default:
-				tmp2 += "0 j\n";
+				tmp2 << "0 j\n";
 				break;
 		}
-		tmp2 +=  "1 0 0 1 "+FToStr(item->gXpos)+" "+FToStr(-(item->gYpos - pat->height))+" cm\n";
+		tmp2 << "1 0 0 1 " << item->gXpos << " " << -(item->gYpos - pat->height) << " cm\n";
 		if (item->rotation() != 0)
 		{
 			double sr = sin(-item->rotation()* M_PI / 180.0);
@@ -6188,36 +6201,34 @@ bool PDFLibCore::PDF_PatternFillStroke(QString& output, PageItem *currItem, int
 				cr = 0;
 			if ((sr * sr) < 0.000001)
 				sr = 0;
-			tmp2 += FToStr(cr)+" "+FToStr(sr)+" "+FToStr(-sr)+" "+FToStr(cr)+ " 0 0 cm\n";
+			tmp2 << cr << " " << sr << " " << -sr << " " << cr << " 0 0 cm\n";
 		}
 		if ((item->TopLine) || (item->RightLine) || (item->BottomLine) || (item->LeftLine))
 		{
 			if (item->TopLine)
 			{
-				tmp2 += "0 0 m\n";
-				tmp2 += FToStr(item->width())+" 0 l\n";
+				tmp2 << "0 0 m\n";
+				tmp2 << item->width() << " 0 l\n";
 			}
 			if (item->RightLine)
 			{
-				tmp2 += FToStr(item->width())+" 0 m\n";
-				tmp2 += FToStr(item->width())+" "+FToStr(-item->height())+" l\n";
+				tmp2 << item->width() << " 0 m\n";
+				tmp2 << item->width() << " " << -item->height() << " l\n";
 			}
 			if (item->BottomLine)
 			{
-				tmp2 += "0 "+FToStr(-item->height())+" m\n";
-				tmp2 += FToStr(item->width())+" "+FToStr(-item->height())+" l\n";
+				tmp2 << "0 " << -item->height() << " m\n";
+				tmp2 << item->width() << " " << -item->height() << " l\n";
 			}
 			if (item->LeftLine)
 			{
-				tmp2 += "0 0 m\n";
-				tmp2 += "0 "+FToStr(-item->height())+" l\n";
+				tmp2 << "0 0 m\n";
+				tmp2 << "0 " << -item->height() << " l\n";
 			}
-			tmp2 += "S\n";
+			tmp2 << "S\n";
 		}
-		tmp2 += "Q\n";
+		tmp2 << "Q\n";
 	}
-	if (Options.Compress)
-		tmp2 = CompressStr(&tmp2);
 	uint patObject = newObject();
 	StartObj(patObject);
 	PutDoc("<< /Type /Pattern\n");
@@ -6350,10 +6361,7 @@ bool PDFLibCore::PDF_PatternFillStroke(QString& output, PageItem *currItem, int
 		PutDoc(">>\n");
 	}
 	PutDoc(">>\n");
-	PutDoc("/Length "+QString::number(tmp2.length()));
-	if (Options.Compress)
-		PutDoc("\n/Filter /FlateDecode");
-	PutDoc(" >>\nstream\n"+EncStream(tmp2, patObject)+"\nendstream\nendobj\n");
+	PutStream(tmp2.data(), Options.Compress ? CompressArray(tmp2.data()) : QByteArray(), patObject);
 	Patterns.insert("Pattern"+QString::number(patObject), patObject);
 	QString tmp;
 	if ((forArrow) || (kind != 1))
@@ -6528,17 +6536,13 @@ bool PDFLibCore::PDF_MeshGradientFill(QString& output, PageItem *c)
 			PutDoc(">>\n");
 		}
 		PutDoc(">>\n");
-		QString stre = "q\n"+SetClipPath(c)+"h\n";
-		stre += FToStr(fabs(c->lineWidth()))+" w\n";
-		stre += "/Pattern cs\n";
-		stre += "/Pattern"+QString::number(patObject)+" scn\nf*\n";
-		stre += "Q\n";
-		if (Options.Compress)
-			stre = CompressStr(&stre);
-		PutDoc("/Length "+QString::number(stre.length())+"\n");
-		if (Options.Compress)
-			PutDoc("/Filter /FlateDecode\n");
-		PutDoc(">>\nstream\n"+EncStream(stre, formObject)+"\nendstream\nendobj\n");
+		PdfContentStream stre;
+		stre << "q\n" << SetClipPath(c) << "h\n";
+		stre << fabs(c->lineWidth()) << " w\n";
+		stre << "/Pattern cs\n";
+		stre << "/Pattern" << patObject << " scn\nf*\n";
+		stre << "Q\n";
+		PutStream(stre.data(), Options.Compress ? CompressArray(stre.data()) : QByteArray(), formObject);
 		Seite.XObjects[ResNam+QString::number(ResCount)] = formObject;
 		ResCount++;
 		QString GXName = ResNam+QString::number(ResCount);
@@ -6863,17 +6867,13 @@ bool PDFLibCore::PDF_DiamondGradientFill(QString& output, PageItem *c)
 			PutDoc(">>\n");
 		}
 		PutDoc(">>\n");
-		QString stre = "q\n"+SetClipPath(c)+"h\n";
-		stre += FToStr(fabs(c->lineWidth()))+" w\n";
-		stre += "/Pattern cs\n";
-		stre += "/Pattern"+QString::number(patObject)+" scn\nf*\n";
-		stre += "Q\n";
-		if (Options.Compress)
-			stre = CompressStr(&stre);
-		PutDoc("/Length "+QString::number(stre.length())+"\n");
-		if (Options.Compress)
-			PutDoc("/Filter /FlateDecode\n");
-		PutDoc(">>\nstream\n"+EncStream(stre, formObject)+"\nendstream\nendobj\n");
+		PdfContentStream stre;
+		stre << "q\n" << SetClipPath(c) << "h\n";
+		stre << fabs(c->lineWidth()) << " w\n";
+		stre << "/Pattern cs\n";
+		stre << "/Pattern" << patObject << " scn\nf*\n";
+		stre << "Q\n";
+		PutStream(stre.data(), Options.Compress ? CompressArray(stre.data()) : QByteArray(), formObject);
 		Seite.XObjects[ResNam+QString::number(ResCount)] = formObject;
 		ResCount++;
 		QString GXName = ResNam+QString::number(ResCount);
@@ -7236,17 +7236,13 @@ bool PDFLibCore::PDF_TensorGradientFill(QString& output, PageItem *c)
 			PutDoc(">>\n");
 		}
 		PutDoc(">>\n");
-		QString stre = "q\n"+SetClipPath(c)+"h\n";
-		stre += FToStr(fabs(c->lineWidth()))+" w\n";
-		stre += "/Pattern cs\n";
-		stre += "/Pattern"+QString::number(patObject)+" scn\nf*\n";
-		stre += "Q\n";
-		if (Options.Compress)
-			stre = CompressStr(&stre);
-		PutDoc("/Length "+QString::number(stre.length())+"\n");
-		if (Options.Compress)
-			PutDoc("/Filter /FlateDecode\n");
-		PutDoc(">>\nstream\n"+EncStream(stre, formObject)+"\nendstream\nendobj\n");
+		PdfContentStream stre;
+		stre << "q\n" << SetClipPath(c) << "h\n";
+		stre << fabs(c->lineWidth()) << " w\n";
+		stre << "/Pattern cs\n";
+		stre << "/Pattern" << patObject << " scn\nf*\n";
+		stre << "Q\n";
+		PutStream(stre.data(), Options.Compress ? CompressArray(stre.data()) : QByteArray(), formObject);
 		Seite.XObjects[ResNam+QString::number(ResCount)] = formObject;
 		ResCount++;
 		QString GXName = ResNam+QString::number(ResCount);
@@ -7660,25 +7656,21 @@ bool PDFLibCore::PDF_GradientFillStroke(QString& output, PageItem *currItem, boo
 			PutDoc(">>\n");
 		}
 		PutDoc(">>\n");
-		QString stre = "q\n"+SetClipPath(currItem)+"h\n";
-		stre += FToStr(fabs(currItem->lineWidth()))+" w\n";
+		PdfContentStream stre;
+		stre << "q\n" << SetClipPath(currItem) << "h\n";
+		stre << fabs(currItem->lineWidth()) << " w\n";
 		if ((forArrow) || (!stroke))
 		{
-			stre += "/Pattern cs\n";
-			stre += "/Pattern"+QString::number(patObject)+" scn\nf*\n";
+			stre << "/Pattern cs\n";
+			stre << "/Pattern" << patObject << " scn\nf*\n";
 		}
 		else
 		{
-			stre += "/Pattern CS\n";
-			stre += "/Pattern"+QString::number(patObject)+" SCN\nS\n";
+			stre << "/Pattern CS\n";
+			stre << "/Pattern" << patObject << " SCN\nS\n";
 		}
-		stre += "Q\n";
-		if (Options.Compress)
-			stre = CompressStr(&stre);
-		PutDoc("/Length "+QString::number(stre.length())+"\n");
-		if (Options.Compress)
-			PutDoc("/Filter /FlateDecode\n");
-		PutDoc(">>\nstream\n"+EncStream(stre, formObject)+"\nendstream\nendobj\n");
+		stre << "Q\n";
+		PutStream(stre.data(), Options.Compress ? CompressArray(stre.data()) : QByteArray(), formObject);
 		Seite.XObjects[ResNam+QString::number(ResCount)] = formObject;
 		ResCount++;
 		QString GXName = ResNam+QString::number(ResCount);
@@ -8513,15 +8505,72 @@ uint PDFLibCore::writeActions(const Annotation&	annot, uint annotationObj)
 uint PDFLibCore::WritePDFStream(const QString& cc)
 {
 	uint result = newObject();
+	WritePDFStream(cc, result);
+	return result;
+}
+
+void PDFLibCore::WritePDFStream(const QString& cc, uint objNr)
+{
 	QString tmp(cc);
 	if (Options.Compress)
 		tmp = CompressStr(&tmp);
-	StartObj(result);
+	StartObj(objNr);
 	PutDoc("<< /Length "+QString::number(tmp.length()));  // moeglicherweise +1
 	if (Options.Compress)
 		PutDoc("\n/Filter /FlateDecode");
-	PutDoc(" >>\nstream\n"+EncStream(tmp, result)+"\nendstream\nendobj\n");
-	return result;
+	PutDoc(" >>\nstream\n"+EncStream(tmp, objNr)+"\nendstream\nendobj\n");
+}
+
+uint PDFLibCore::WritePageStream(const QByteArray& cc)
+{
+	if (!Options.Compress)
+	{
+		uint objNr = newObject();
+		StartObj(objNr);
+		PutDoc("<<");
+		PutStream(cc, QByteArray(), objNr);
+		return objNr;
+	}
+	// Compressing takes much longer than writing, so the page contents are compressed
+	// by worker threads while the next pages are processed. The object is numbered
+	// now and written later, the xref table does not care about the order.
+	PendingStream stream;
+	stream.ObjNum = newObject();
+	stream.Content = cc;
+	stream.Compressed = QtConcurrent::run(CompressArray, stream.Content);
+	PendingStreams.append(stream);
+	PendingStreamBytes += stream.Content.size();
+	WritePendingStreams(false);
+	return stream.ObjNum;
+}
+
+void PDFLibCore::WritePendingStreams(bool wait)
+{
+	// streams are written in the order of their pages, so the output does not depend on timing
+	while (!PendingStreams.isEmpty())
+	{
+		PendingStream stream(PendingStreams.first());
+		if (!wait && !stream.Compressed.isFinished() && (PendingStreamBytes <= MaxPendingStreamBytes))
+			break;
+		PendingStreams.removeFirst();
+		PendingStreamBytes -= stream.Content.size();
+		StartObj(stream.ObjNum);
+		PutDoc("<<");
+		PutStream(stream.Content, stream.Compressed.result(), stream.ObjNum);
+	}
+}
+
+// Writes the end of a stream object whose dictionary is still open. The content
+// is written uncompressed if compressed is empty, e.g. because compressing failed.
+void PDFLibCore::PutStream(const QByteArray& content, const QByteArray& compressed, uint objNr)
+{
+	const QByteArray& data(compressed.isEmpty() ? content : compressed);
+	PutDoc(" /Length "+QString::number(data.size()));
+	if (!compressed.isEmpty())
+		PutDoc("\n/Filter /FlateDecode");
+	PutDoc(" >>\nstream\n");
+	EncodeArrayToStream(data, objNr);
+	PutDoc("\nendstream\nendobj\n");
 }
 
 uint PDFLibCore::WritePDFString(const QString& cc)
@@ -8570,6 +8619,102 @@ void PDFLibCore::PDF_xForm(uint objNr, double w, double h, QString im)
 	ResCount++;
 }
 
+void PDFLibCore::PDF_CIDFontMetrics(ScFace& face, const QList<uint>& glyphs, uint widthsObj, uint toUnicodeObj)
+{
+	QMap<uint,std::pair<QChar,QString> > gl;
+	face.glyphNames(gl);
+	QStringList toUnicodeMaps;
+	QList<int> toUnicodeMapsCount;
+	QString toUnicodeMap = "";
+	int toUnicodeMapCounter = 0;
+	StartObj(widthsObj);
+	PutDoc("[ ");
+	for (int i = 0; i < glyphs.count(); ++i)
+	{
+		uint glyph = glyphs[i];
+		PutDoc(QString::number(glyph)+" ["+QString::number(static_cast<int>(face.glyphWidth(glyph)* 1000))+"] " );
+		QMap<uint,std::pair<QChar,QString> >::Iterator glIt = gl.find(glyph);
+		if (glIt == gl.end())
+			continue;
+		// Identity-H uses two byte codes
+		QString tmp, tmp2;
+		tmp.sprintf("%04X", glyph);
+		tmp2.sprintf("%04X", glIt.value().first.unicode());
+		toUnicodeMap += QString("<%1> <%2>\n").arg(tmp).arg((tmp2));
+		toUnicodeMapCounter++;
+		if (toUnicodeMapCounter == 100)
+		{
+			toUnicodeMaps.append(toUnicodeMap);
+			toUnicodeMapsCount.append(toUnicodeMapCounter);
+			toUnicodeMap = "";
+			toUnicodeMapCounter = 0;
+		}
+	}
+	PutDoc("]\nendobj\n");
+	if (toUnicodeMapCounter != 0)
+	{
+		toUnicodeMaps.append(toUnicodeMap);
+		toUnicodeMapsCount.append(toUnicodeMapCounter);
+	}
+	QString toUnicodeMapStream = "";
+	toUnicodeMapStream += "/CIDInit /ProcSet findresource begin\n";
+	toUnicodeMapStream += "12 dict begin\n";
+	toUnicodeMapStream += "begincmap\n";
+	toUnicodeMapStream += "/CIDSystemInfo <<\n";
+	toUnicodeMapStream += "/Registry (Adobe)\n";
+	toUnicodeMapStream += "/Ordering (UCS)\n";
+	toUnicodeMapStream += "/Supplement 0\n";
+	toUnicodeMapStream += ">> def\n";
+	toUnicodeMapStream += "/CMapName /Adobe-Identity-UCS def\n";
+	toUnicodeMapStream += "/CMapType 2 def\n";
+	toUnicodeMapStream += "1 begincodespacerange\n";
+	toUnicodeMapStream += "<0000> <FFFF>\n";
+	toUnicodeMapStream += "endcodespacerange\n";
+	for (int uniC = 0; uniC < toUnicodeMaps.count(); uniC++)
+	{
+		toUnicodeMapStream += QString("%1 beginbfchar\n").arg(toUnicodeMapsCount[uniC]);
+		toUnicodeMapStream += toUnicodeMaps[uniC];
+		toUnicodeMapStream += "endbfchar\n";
+	}
+	toUnicodeMapStream += "endcmap\n";
+	toUnicodeMapStream += "CMapName currentdict /CMap defineresource pop\n";
+	toUnicodeMapStream += "end\n";
+	toUnicodeMapStream += "end\n";
+	WritePDFStream(toUnicodeMapStream, toUnicodeObj);
+}
+
+void PDFLibCore::PDF_SubsetFonts()
+{
+	QMap<QString, SubsetFont>::Iterator it;
+	for (it = SubsetFonts.begin(); it != SubsetFonts.end(); ++it)
+	{
+		SubsetFont& subset(it.value());
+		QSet<uint> glyphs(UsedGlyphs.value(it.key()));
+		QByteArray bb;
+		subset.face.RawData(bb);
+		bb = SfntSubsetter::subset(bb, glyphs);
+		QString fon("");
+		//AV: += and append() dont't work because they stop at '\0' :-(
+		for (int i=0; i < bb.size(); i++)
+			fon += QChar(bb[i]);
+		int len = fon.length();
+		if (Options.Compress)
+			fon = CompressStr(&fon);
+		StartObj(subset.FontFile);
+		PutDoc("<<\n/Length "+QString::number(fon.length()+1)+"\n");
+		PutDoc("/Length1 "+QString::number(len)+"\n");
+		if (Options.Compress)
+			PutDoc("/Filter /FlateDecode\n");
+		PutDoc(">>\nstream\n"+EncStream(fon, subset.FontFile)+"\nendstream\nendobj\n");
+		if (subset.Widths != 0)
+		{
+			QList<uint> usedGlyphs = glyphs.toList();
+			qSort(usedGlyphs);
+			PDF_CIDFontMetrics(subset.face, usedGlyphs, subset.Widths, subset.ToUnicode);
+		}
+	}
+}
+
 void PDFLibCore::PDF_Form(const QString& im) // unused? - av
 {
 	uint form = newObject();
@@ -9399,72 +9544,6 @@ bool PDFLibCore::PDF_Image(PageItem* c, const QString& fn, double sx, double sy,
 				ImInfo.sxa = sx * (1.0 / ImInfo.reso);
 				ImInfo.sya = sy * (1.0 / ImInfo.reso);
 			}
-			uint maskObj = 0;
-			if (alphaM)
-			{
-				bool compAlphaAvail = false;
-				maskObj = newObject();
-				StartObj(maskObj);
-				PutDoc("<<\n/Type /XObject\n/Subtype /Image\n");
-				if (Options.CompressMethod != PDFOptions::Compression_None)
-				{
-					QByteArray compAlpha = CompressArray(im2);
-					if (compAlpha.size() > 0)
-					{
-						im2 = compAlpha;
-						compAlphaAvail = true;
-					}
-				}
-				if ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4))
-				{
-					PutDoc("/Width "+QString::number(origWidth)+"\n");
-					PutDoc("/Height "+QString::number(origHeight)+"\n");
-					PutDoc("/ColorSpace /DeviceGray\n");
-					PutDoc("/BitsPerComponent 8\n");
-					PutDoc("/Length "+QString::number(im2.size())+"\n");
-				}
-				else
-				{
-					PutDoc("/Width "+QString::number(origWidth)+"\n");
-					PutDoc("/Height "+QString::number(origHeight)+"\n");
-					PutDoc("/ImageMask true\n/BitsPerComponent 1\n");
-					PutDoc("/Length "+QString::number(im2.size())+"\n");
-				}
-				if ((Options.CompressMethod != PDFOptions::Compression_None) && compAlphaAvail)
-					PutDoc("/Filter /FlateDecode\n");
-				PutDoc(">>\nstream\n");
-				EncodeArrayToStream(im2, maskObj);
-				PutDoc("\nendstream\nendobj\n");
-				Seite.ImgObjects[ResNam+"I"+QString::number(ResCount)] = maskObj;
-				ResCount++;
-			}
-			uint imageObj = newObject();
-			StartObj(imageObj);
-			PutDoc("<<\n/Type /XObject\n/Subtype /Image\n");
-			PutDoc("/Width "+QString::number(img.width())+"\n");
-			PutDoc("/Height "+QString::number(img.height())+"\n");
-			if ((doc.HasCMS) && (Options.UseProfiles2))
-			{
-				PutDoc("/ColorSpace "+ICCProfiles[profInUse].ICCArray+"\n");
-				PutDoc("/Intent /");
-				int inte2 = Intent;
-				if (Options.EmbeddedI)
-					inte2 = Options.Intent2;
-				static const QString cmsmode[] = {"Perceptual", "RelativeColorimetric", "Saturation", "AbsoluteColorimetric"};
-				PutDoc(cmsmode[inte2] + "\n");
-			}
-			else
-			{
-				if (Options.UseRGB)
-					PutDoc("/ColorSpace /DeviceRGB\n");
-				else
-				{
-					if (Options.isGrayscale)
-						PutDoc("/ColorSpace /DeviceGray\n");
-					else
-						PutDoc("/ColorSpace /DeviceCMYK\n");
-				}
-			}
 			enum PDFOptions::PDFCompression compress_method = Options.CompressMethod;
  			enum PDFOptions::PDFCompression cm = Options.CompressMethod;
 			bool exportToCMYK = false, exportToGrayscale = false, jpegUseOriginal = false;
@@ -9540,46 +9619,135 @@ bool PDFLibCore::PDF_Image(PageItem* c, const QString& fn, double sx, double sy,
 					}*/
 				}
 			}
-			int bytesWritten = 0;
-			PutDoc("/BitsPerComponent 8\n");
-			uint lengthObj = newObject();
-			PutDoc("/Length "+QString::number(lengthObj)+" 0 R\n");
-			if (cm == PDFOptions::Compression_JPEG)
-				PutDoc("/Filter /DCTDecode\n");
-			else if (cm != PDFOptions::Compression_None)
-				PutDoc("/Filter /FlateDecode\n");
-//			if (exportToCMYK && (cm == PDFOptions::Compression_JPEG))
-//				PutDoc("/Decode [1 0 1 0 1 0 1 0]\n");
-			if (alphaM)
-			{
-				if ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4))
-					PutDoc("/SMask "+QString::number(maskObj)+" 0 R\n");
-				else
-					PutDoc("/Mask "+QString::number(maskObj)+" 0 R\n");
-			}
-			PutDoc(">>\nstream\n");
+			int quality = c->OverrideCompressionQuality ? c->CompressionQualityIndex : Options.Quality;
+			if (c->OverrideCompressionQuality)
+				jpegUseOriginal = false;
 			if ((hasGrayProfile) && (doc.HasCMS) && (Options.UseProfiles2) && (!hasColorEffect))
 				exportToGrayscale = true;
-			if (cm == PDFOptions::Compression_JPEG)
-			{
-				int quality = c->OverrideCompressionQuality ? c->CompressionQualityIndex : Options.Quality;
-				if (c->OverrideCompressionQuality)
-					jpegUseOriginal = false;
-				bytesWritten = WriteJPEGImageToStream(img, fn, imageObj, quality, exportToCMYK, exportToGrayscale, jpegUseOriginal, (!hasColorEffect && hasGrayProfile));
-			}
-			else if (cm == PDFOptions::Compression_ZIP)
-				bytesWritten = WriteFlateImageToStream(img, imageObj, exportToCMYK, exportToGrayscale, (!hasColorEffect && hasGrayProfile));
+			// Identical images, e.g. copies of a file or items sharing the same effects, are written
+			// only once. The same pixels written with the same parameters give the same streams,
+			// so the hash is taken before encoding them.
+			QCryptographicHash imageHash(QCryptographicHash::Md5);
+			const QImage& imgData(img.qImage());
+			int lineBytes = (imgData.width() * imgData.depth() + 7) / 8;
+			for (int yi = 0; yi < imgData.height(); ++yi)
+				imageHash.addData(reinterpret_cast<const char*>(imgData.scanLine(yi)), lineBytes);
+			if (alphaM)
+				imageHash.addData(im2);
+			QStringList imageParams;
+			imageParams << QString::number(imgData.width()) << QString::number(imgData.height()) << QString::number(imgData.depth())
+				<< QString::number(origWidth) << QString::number(origHeight) << QString::number(img.imgInfo.colorspace)
+				<< profInUse << QString::number(Intent) << QString::number(cm) << QString::number(quality)
+				<< QString::number(exportToCMYK) << QString::number(exportToGrayscale) << QString::number(hasColorEffect && hasGrayProfile)
+				<< (jpegUseOriginal ? fn : QString());
+			imageHash.addData(imageParams.join("\n").toUtf8());
+			QByteArray imageKey = imageHash.result();
+			uint imageObj;
+			if (WrittenImages.contains(imageKey))
+				imageObj = WrittenImages[imageKey];
 			else
-				bytesWritten = WriteImageToStream(img, imageObj, exportToCMYK, exportToGrayscale, (!hasColorEffect && hasGrayProfile));
-			PutDoc("\nendstream\nendobj\n");
-			if (bytesWritten <= 0)
 			{
-				PDF_Error_ImageWriteFailure(fn);
-				return false;
+				uint maskObj = 0;
+				if (alphaM)
+				{
+					bool compAlphaAvail = false;
+					maskObj = newObject();
+					StartObj(maskObj);
+					PutDoc("<<\n/Type /XObject\n/Subtype /Image\n");
+					if (Options.CompressMethod != PDFOptions::Compression_None)
+					{
+						QByteArray compAlpha = CompressArray(im2);
+						if (compAlpha.size() > 0)
+						{
+							im2 = compAlpha;
+							compAlphaAvail = true;
+						}
+					}
+					if ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4))
+					{
+						PutDoc("/Width "+QString::number(origWidth)+"\n");
+						PutDoc("/Height "+QString::number(origHeight)+"\n");
+						PutDoc("/ColorSpace /DeviceGray\n");
+						PutDoc("/BitsPerComponent 8\n");
+						PutDoc("/Length "+QString::number(im2.size())+"\n");
+					}
+					else
+					{
+						PutDoc("/Width "+QString::number(origWidth)+"\n");
+						PutDoc("/Height "+QString::number(origHeight)+"\n");
+						PutDoc("/ImageMask true\n/BitsPerComponent 1\n");
+						PutDoc("/Length "+QString::number(im2.size())+"\n");
+					}
+					if ((Options.CompressMethod != PDFOptions::Compression_None) && compAlphaAvail)
+						PutDoc("/Filter /FlateDecode\n");
+					PutDoc(">>\nstream\n");
+					EncodeArrayToStream(im2, maskObj);
+					PutDoc("\nendstream\nendobj\n");
+					Seite.ImgObjects[ResNam+"I"+QString::number(ResCount)] = maskObj;
+					ResCount++;
+				}
+				imageObj = newObject();
+				StartObj(imageObj);
+				PutDoc("<<\n/Type /XObject\n/Subtype /Image\n");
+				PutDoc("/Width "+QString::number(img.width())+"\n");
+				PutDoc("/Height "+QString::number(img.height())+"\n");
+				if ((doc.HasCMS) && (Options.UseProfiles2))
+				{
+					PutDoc("/ColorSpace "+ICCProfiles[profInUse].ICCArray+"\n");
+					PutDoc("/Intent /");
+					int inte2 = Intent;
+					if (Options.EmbeddedI)
+						inte2 = Options.Intent2;
+					static const QString cmsmode[] = {"Perceptual", "RelativeColorimetric", "Saturation", "AbsoluteColorimetric"};
+					PutDoc(cmsmode[inte2] + "\n");
+				}
+				else
+				{
+					if (Options.UseRGB)
+						PutDoc("/ColorSpace /DeviceRGB\n");
+					else
+					{
+						if (Options.isGrayscale)
+							PutDoc("/ColorSpace /DeviceGray\n");
+						else
+							PutDoc("/ColorSpace /DeviceCMYK\n");
+					}
+				}
+				int bytesWritten = 0;
+				PutDoc("/BitsPerComponent 8\n");
+				uint lengthObj = newObject();
+				PutDoc("/Length "+QString::number(lengthObj)+" 0 R\n");
+				if (cm == PDFOptions::Compression_JPEG)
+					PutDoc("/Filter /DCTDecode\n");
+				else if (cm != PDFOptions::Compression_None)
+					PutDoc("/Filter /FlateDecode\n");
+//				if (exportToCMYK && (cm == PDFOptions::Compression_JPEG))
+//					PutDoc("/Decode [1 0 1 0 1 0 1 0]\n");
+				if (alphaM)
+				{
+					if ((Options.Version >= PDFOptions::PDFVersion_14) || (Options.Version == PDFOptions::PDFVersion_X4))
+						PutDoc("/SMask "+QString::number(maskObj)+" 0 R\n");
+					else
+						PutDoc("/Mask "+QString::number(maskObj)+" 0 R\n");
+				}
+				PutDoc(">>\nstream\n");
+				if (cm == PDFOptions::Compression_JPEG)
+					bytesWritten = WriteJPEGImageToStream(img, fn, imageObj, quality, exportToCMYK, exportToGrayscale, jpegUseOriginal, (!hasColorEffect && hasGrayProfile));
+				else if (cm == PDFOptions::Compression_ZIP)
+					bytesWritten = WriteFlateImageToStream(img, imageObj, exportToCMYK, exportToGrayscale, (!hasColorEffect && hasGrayProfile));
+				else
+					bytesWritten = WriteImageToStream(img, imageObj, exportToCMYK, exportToGrayscale, (!hasColorEffect && hasGrayProfile));
+				PutDoc("\nendstream\nendobj\n");
+				if (bytesWritten <= 0)
+				{
+					PDF_Error_ImageWriteFailure(fn);
+					return false;
+				}
+				StartObj(lengthObj);
+				PutDoc(QString("    %1\n").arg(bytesWritten));
+				PutDoc("endobj\n");
+				WrittenImages.insert(imageKey, imageObj);
 			}
-			StartObj(lengthObj);
-			PutDoc(QString("    %1\n").arg(bytesWritten));
-			PutDoc("endobj\n");
 			Seite.ImgObjects[ResNam+"I"+QString::number(ResCount)] = imageObj;
 			ImInfo.ResNum = ResCount;
 			ImInfo.Width = img.width();
@@ -9662,6 +9830,8 @@ bool PDFLibCore::PDF_End_Doc(const QString& PrintPr, const QString& Name, int Co
 	QTreeWidgetItem* pp;
 	QString Inhal = "";
 	QMap<int,QString> Inha;
+	WritePendingStreams(true);
+	PDF_SubsetFonts();
 	if ((Bvie->topLevelItemCount() != 0) && (Options.Bookmarks) && (BookMinUse))
 	{
 		int Basis = ObjCounter - 1;
@@ -10265,6 +10435,11 @@ bool PDFLibCore::closeAndCleanup()
 	Seite.FObjects.clear();
 	Seite.AObjects.clear();
 	Seite.FormObjects.clear();
+	// still running compressions only work on their own copies of the contents
+	PendingStreams.clear();
+	PendingStreamBytes = 0;
+	WrittenImages.clear();
+	CurrentTextRun.Glyphs.clear();
 	CalcFields.clear();
 	Shadings.clear();
 	Transpar.clear();
@@ -10,8 +10,10 @@ for which a new license (GPL+exception) is in place.
 
 #include <QFile>
 #include <QDataStream>
+#include <QFuture>
 #include <QPixmap>
 #include <QList>
+#include <QSet>
 #include <QStack>
 #include <string>
 #include <vector>
@@ -31,6 +33,7 @@ class MultiProgressDialog;
 class ScLayer;
 class ScText;
 
+#include "pdfcontentstream.h"
 #include "scribusstructs.h"
 #include "scimagestructs.h"
 
@@ -122,9 +125,11 @@ private:
 	QString SetGradientColor(const QString& farbe, double Shade);
 	QString putColor(const QString& color, double Shade, bool fill);
 	QString putColorUncached(const QString& color, int Shade, bool fill);
-	QString Write_TransparencyGroup(double trans, int blend, QString &data, PageItem *controlItem = 0);
-	QString setTextSt(PageItem *ite, uint PNr, const Page* pag);
-	bool    setTextCh(PageItem *ite, uint PNr, double x, double y, uint d,  QString &tmp, QString &tmp2, const ScText * hl, const ParagraphStyle& pstyle, const Page* pag);
+	QString Write_TransparencyGroup(double trans, int blend, const PdfContentStream& data, PageItem *controlItem = 0);
+	void    setTextSt(PdfContentStream& output, PageItem *ite, uint PNr, const Page* pag);
+	bool    setTextCh(PageItem *ite, uint PNr, double x, double y, uint d,  PdfContentStream &tmp, PdfContentStream &tmp2, const ScText * hl, const ParagraphStyle& pstyle, const Page* pag);
+	void    putTextGlyph(PdfContentStream &tmp, const QByteArray& state, double scaleH, double scaleV, double fontSize, double x, double y, const QByteArray& code, int width);
+	void    flushTextRun(PdfContentStream &tmp);
 	void    getBleeds(const Page* page, double &left, double &right);
 	void    getBleeds(const Page* page, double &left, double &right, double &bottom, double& top);
 
@@ -135,10 +140,17 @@ private:
 	void PutDoc(const char* in) { outStream.writeRawData(in, strlen(in)); }
 	void PutDoc(const std::string & in) { outStream.writeRawData(in.c_str(), in.length()); }
 
-	void       PutPage(const QString & in) { Content += in; }
+	void       PutPage(const QString & in) { Content << in; }
+	void       PutPage(const QByteArray & in) { Content << in; }
+	void       PutPage(const char* in) { Content << in; }
+	void       PutPage(const PdfContentStream & in) { Content << in; }
 	void       StartObj(int nr);
 	uint       newObject() { return ObjCounter++; }
 	uint       WritePDFStream(const QString& cc);
+	void       WritePDFStream(const QString& cc, uint objNr);
+	uint       WritePageStream(const QByteArray& cc);
+	void       WritePendingStreams(bool wait);
+	void       PutStream(const QByteArray& content, const QByteArray& compressed, uint objNr);
 	uint       WritePDFString(const QString& cc);
 	void       writeXObject(uint objNr, QString dictionary, QByteArray stream);
 	uint       writeObject(QString type, QString dictionary);
@@ -148,10 +160,10 @@ private:
 	QByteArray ComputeMD5(const QString& in);
 	QByteArray ComputeRC4Key(int ObjNum);
 
-	bool    PDF_ProcessItem(QString& output, PageItem* ite, const Page* pag, uint PNr, bool embedded = false, bool pattern = false);
-	QString PDF_ProcessTableItem(PageItem* ite, const Page* pag);
-	QString HandleBrushPattern(PageItem* ite, QPainterPath &path, const Page* pag, uint PNr);
-	QString drawArrow(PageItem *ite, QTransform &arrowTrans, int arrowIndex);
+	bool    PDF_ProcessItem(PdfContentStream& output, PageItem* ite, const Page* pag, uint PNr, bool embedded = false, bool pattern = false);
+	void    PDF_ProcessTableItem(PdfContentStream& output, PageItem* ite, const Page* pag);
+	void    HandleBrushPattern(PdfContentStream& output, PageItem* ite, QPainterPath &path, const Page* pag, uint PNr);
+	void    drawArrow(PdfContentStream& output, PageItem *ite, QTransform &arrowTrans, int arrowIndex);
 	void    PDF_Bookmark(PageItem *currItem, double ypos);
 	bool    PDF_PatternFillStroke(QString& output, PageItem *currItem, int kind = 0, bool forArrow = false);
 	quint32 encode32dVal(double val);
@@ -167,6 +179,8 @@ private:
 #ifdef HAVE_OSG
 	bool    PDF_3DAnnotation(PageItem *ite, uint PNr);
 #endif
+	void    PDF_CIDFontMetrics(ScFace& face, const QList<uint>& glyphs, uint widthsObj, uint toUnicodeObj);
+	void    PDF_SubsetFonts();
 	void    PDF_Form(const QString& im);
 	void    PDF_xForm(uint objNr, double w, double h, QString im);
 	bool    PDF_Image(PageItem* c, const QString& fn, double sx, double sy, double x, double y, bool fromAN = false, const QString& Profil = "", bool Embedded = false, eRenderIntent Intent = Intent_Relative_Colorimetric, QString* output = NULL);
@@ -180,7 +194,7 @@ private:
 	int bytesWritten() { return Spool.pos(); }
 
 
-	QString Content;
+	PdfContentStream Content;
 	QString ErrorMessage;
 	ScribusDoc & doc;
 	const Page * ActPageP;
@@ -259,7 +273,32 @@ private:
 		QString ResNamX;
 		QString data;
 	};
+	struct PendingStream
+	{
+		uint ObjNum;
+		QByteArray Content;
+		QFuture<QByteArray> Compressed;
+	};
+	struct SubsetFont
+	{
+		ScFace face;
+		uint FontFile;
+		uint Widths;
+		uint ToUnicode;
+	};
+	// glyphs written with one TJ operator, they share the text state and the baseline
+	struct TextRun
+	{
+		QByteArray State;
+		double ScaleH;
+		double ScaleV;
+		double FontSize;
+		double PosX;
+		double PosY;
+		PdfContentStream Glyphs;
+	};
 	QMap<QString,ShIm> SharedImages;
+	QMap<QByteArray, uint> WrittenImages;
 	QList<uint> XRef;
 	QList<Dest> NamedDest;
 	QList<int> Threads;
@@ -279,6 +318,12 @@ private:
 	int NDnum;
 	QMap<QString, QString> UsedFontsP;
 	QMap<QString, QString> UsedFontsF;
+	QMap<QString, SubsetFont> SubsetFonts;
+	QList<PendingStream> PendingStreams;
+	TextRun CurrentTextRun;
+	qint64 PendingStreamBytes;
+	QMap<QString, QSet<uint> > UsedGlyphs;
+	QSet<QString> FormFonts;
 	QByteArray KeyGen;
 	QByteArray OwnerKey;
 	QByteArray UserKey;
@@ -1589,6 +1589,7 @@ void XfigPlug::resortItems()
 				ite->LayerID = currentLayer;
 		}
 	}
+	m_Doc->itemListChanged();
 }
 
 
@@ -10,7 +10,11 @@ for which a new license (GPL+exception) is in place.
 #include <QString>
 #include <QDir>
 #include <QCursor>
+#include <QEventLoop>
 #include <QSharedPointer>
+#include <QTimer>
+#include <QtConcurrentRun>
+#include <tiffio.h>
 
 #include "ui/scmessagebox.h"
 #include "scribus.h"
@@ -18,8 +22,22 @@ for which a new license (GPL+exception) is in place.
 #include "ui/scmwmenumanager.h"
 #include "util.h"
 #include "commonstrings.h"
+#include "page.h"
+#include "pagerenderer.h"
 #include "scpaths.h"
 
+// Images rendered but not saved yet may take this many bytes.
+static const qint64 MaxPendingImageBytes = Q_INT64_C(512) * 1024 * 1024;
+
+// Pages written in bands are rendered into an image of at most this many bytes.
+static const qint64 MaxBandBytes = 32 * 1024 * 1024;
+
+// Runs in a worker thread, so it gets its own copies of everything.
+static bool saveImage(QImage image, QString fileName, QByteArray format, int quality)
+{
+	return image.save(fileName, format.constData(), quality);
+}
+
 int scribusexportpixmap_getPluginAPIVersion()
 {
 	return PLUGIN_API_VERSION;
@@ -168,14 +186,102 @@ ExportBitmap::~ExportBitmap()
 {
 }
 
-bool ExportBitmap::exportPage(ScribusDoc* doc, uint pageNr, bool single = true)
+bool ExportBitmap::confirmOverwrite(ScribusDoc* doc, const QString& fileName, bool single)
 {
-	uint over   = 0;
-	bool saved = false, doFileSave = true;
-	QString fileName(getFileName(doc, pageNr));
+	if (!QFile::exists(fileName) || overwrite)
+		return true;
+	QString fn = QDir::toNativeSeparators(fileName);
+//	QApplication::restoreOverrideCursor();
+	QApplication::changeOverrideCursor(Qt::ArrowCursor);
+	uint over = QMessageBox::question(doc->scMW(), tr("File exists. Overwrite?"),
+			fn +"\n"+ tr("exists already. Overwrite?"),
+			// hack for multiple overwriting (petr) 
+			(single == true) ? QMessageBox::Yes | QMessageBox::No : QMessageBox::Yes | QMessageBox::No | QMessageBox::YesToAll);
+	QApplication::changeOverrideCursor(QCursor(Qt::WaitCursor));
+	if (over == QMessageBox::YesToAll)
+		overwrite = true;
+	return (over == QMessageBox::Yes || over == QMessageBox::YesToAll);
+}
 
-	if (!doc->Pages->at(pageNr))
+double ExportBitmap::pageScale(Page* page) const
+{
+	// the larger side of the page gets the requested resolution, rounded to whole pixels
+	double pixmapSize = qMax(page->width(), page->height());
+	return qRound(pixmapSize * enlargement * (pageDPI / 72.0) / 100.0) / pixmapSize;
+}
+
+bool ExportBitmap::writesBands() const
+{
+	QString type(bitmapType.toLower());
+	return (type == "tif") || (type == "tiff");
+}
+
+bool ExportBitmap::exportPageInBands(ScribusDoc* doc, uint pageNr, const QString& fileName)
+{
+	Page* page = doc->Pages->at(pageNr);
+	double scale = pageScale(page);
+	int width = qRound(page->width() * scale);
+	int height = qRound(page->height() * scale);
+	if ((width <= 0) || (height <= 0))
 		return false;
+	int bandHeight = static_cast<int>(qBound(Q_INT64_C(1), MaxBandBytes / (4 * static_cast<qint64>(width)), static_cast<qint64>(height)));
+	QImage band(width, bandHeight, QImage::Format_ARGB32_Premultiplied);
+	if (band.isNull())
+	{
+		QMessageBox::warning(doc->scMW(), tr("Save as Image"), tr("Insufficient memory for this image size."));
+		doc->scMW()->setStatusBarInfoText( tr("Insufficient memory for this image size."));
+		return false;
+	}
+	QByteArray row(3 * width, 0);
+	TIFF* tif = TIFFOpen(fileName.toLocal8Bit().data(), "w");
+	bool written = (tif != NULL);
+	if (tif)
+	{
+		TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, width);
+		TIFFSetField(tif, TIFFTAG_IMAGELENGTH, height);
+		TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, 8);
+		TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, 3);
+		TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+		TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_RGB);
+		TIFFSetField(tif, TIFFTAG_COMPRESSION, COMPRESSION_LZW);
+		TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, TIFFDefaultStripSize(tif, 0));
+		TIFFSetField(tif, TIFFTAG_XRESOLUTION, static_cast<float>(pageDPI));
+		TIFFSetField(tif, TIFFTAG_YRESOLUTION, static_cast<float>(pageDPI));
+		TIFFSetField(tif, TIFFTAG_RESOLUTIONUNIT, RESUNIT_INCH);
+		PageRenderer renderer(doc);
+		// images are drawn in full resolution, whatever is used on the canvas
+		PageRenderer::ImageResolutions resolutions = renderer.loadFullResolutionImages(page);
+		for (int top = 0; (top < height) && written; top += bandHeight)
+		{
+			renderer.render(&band, page, scale, QPoint(0, top));
+			int rows = qMin(bandHeight, height - top);
+			for (int y = 0; (y < rows) && written; ++y)
+			{
+				// the paper is opaque, so the colors are not premultiplied
+				const QRgb* src = reinterpret_cast<const QRgb*>(band.scanLine(y));
+				uchar* dst = reinterpret_cast<uchar*>(row.data());
+				for (int x = 0; x < width; ++x)
+				{
+					*dst++ = qRed(src[x]);
+					*dst++ = qGreen(src[x]);
+					*dst++ = qBlue(src[x]);
+				}
+				written = (TIFFWriteScanline(tif, row.data(), top + y) >= 0);
+			}
+		}
+		renderer.restoreImageResolutions(resolutions);
+		TIFFClose(tif);
+	}
+	if (!written)
+	{
+		QMessageBox::warning(doc->scMW(), tr("Save as Image"), tr("Error writing the output file(s)."));
+		doc->scMW()->setStatusBarInfoText( tr("Error writing the output file(s)."));
+	}
+	return written;
+}
+
+QImage ExportBitmap::renderPage(ScribusDoc* doc, uint pageNr)
+{
 	Page* page = doc->Pages->at(pageNr);
 
 	/* a little magic here - I need to compute the "maxGr" value...
@@ -188,30 +294,29 @@ bool ExportBitmap::exportPage(ScribusDoc* doc, uint pageNr, bool single = true)
 	{
 		QMessageBox::warning(doc->scMW(), tr("Save as Image"), tr("Insufficient memory for this image size."));
 		doc->scMW()->setStatusBarInfoText( tr("Insufficient memory for this image size."));
-		return false;
+		return im;
 	}
 	int dpm = qRound(100.0 / 2.54 * pageDPI);
 	im.setDotsPerMeterY(dpm);
 	im.setDotsPerMeterX(dpm);
-	if (QFile::exists(fileName) && !overwrite)
-	{
-		doFileSave = false;
-		QString fn = QDir::toNativeSeparators(fileName);
-//		QApplication::restoreOverrideCursor();
-		QApplication::changeOverrideCursor(Qt::ArrowCursor);
-		over = QMessageBox::question(doc->scMW(), tr("File exists. Overwrite?"),
-				fn +"\n"+ tr("exists already. Overwrite?"),
-				// hack for multiple overwriting (petr) 
-				(single == true) ? QMessageBox::Yes | QMessageBox::No : QMessageBox::Yes | QMessageBox::No | QMessageBox::YesToAll);
-		QApplication::changeOverrideCursor(QCursor(Qt::WaitCursor));
-		if (over == QMessageBox::Yes || over == QMessageBox::YesToAll)
-			doFileSave = true;
-		if (over == QMessageBox::YesToAll)
-			overwrite = true;
-	}
-	if (doFileSave)
-		saved = im.save(fileName, bitmapType.toLocal8Bit().constData(), quality);
-	if (!saved && doFileSave)
+	return im;
+}
+
+bool ExportBitmap::exportPage(ScribusDoc* doc, uint pageNr, bool single = true)
+{
+	QString fileName(getFileName(doc, pageNr));
+
+	if (!doc->Pages->at(pageNr))
+		return false;
+	if (!confirmOverwrite(doc, fileName, single))
+		return false;
+	if (writesBands())
+		return exportPageInBands(doc, pageNr, fileName);
+	QImage im(renderPage(doc, pageNr));
+	if (im.isNull())
+		return false;
+	bool saved = im.save(fileName, bitmapType.toLocal8Bit().constData(), quality);
+	if (!saved)
 	{
 		QMessageBox::warning(doc->scMW(), tr("Save as Image"), tr("Error writing the output file(s)."));
 		doc->scMW()->setStatusBarInfoText( tr("Error writing the output file(s)."));
@@ -226,12 +331,75 @@ bool ExportBitmap::exportCurrent(ScribusDoc* doc)
 
 bool ExportBitmap::exportInterval(ScribusDoc* doc, std::vector<int> &pageNs)
 {
+	// Rendering lays out text and loads images, which is not thread safe, so the pages
+	// are rendered one after the other here. Compressing and writing the images is left
+	// to a pool of worker threads meanwhile, as long as they fit into MaxPendingImageBytes.
+	QList<PendingImage> pending;
+	bool rendered = true;
+	bool written = true;
 	doc->scMW()->mainWindowProgressBar->setMaximum(pageNs.size());
-	for (uint a = 0; a < pageNs.size(); ++a)
+	for (uint a = 0; a < pageNs.size() && rendered && written; ++a)
 	{
 		doc->scMW()->mainWindowProgressBar->setValue(a);
-		if (!exportPage(doc, pageNs[a]-1, false))
-			return false;
+		uint pageNr = pageNs[a] - 1;
+		QString fileName(getFileName(doc, pageNr));
+		if (!doc->Pages->at(pageNr) || !confirmOverwrite(doc, fileName, false))
+		{
+			rendered = false;
+			break;
+		}
+		if (writesBands())
+		{
+			rendered = exportPageInBands(doc, pageNr, fileName);
+			continue;
+		}
+		QImage im(renderPage(doc, pageNr));
+		if (im.isNull())
+		{
+			rendered = false;
+			break;
+		}
+		PendingImage image;
+		image.bytes = im.byteCount();
+		image.saved = QtConcurrent::run(saveImage, im, fileName, bitmapType.toLocal8Bit(), quality);
+		pending.append(image);
+		written = waitForImages(pending, MaxPendingImageBytes);
 	}
-	return true;
+	if (!waitForImages(pending, 0))
+		written = false;
+	if (!written)
+	{
+		QMessageBox::warning(doc->scMW(), tr("Save as Image"), tr("Error writing the output file(s)."));
+		doc->scMW()->setStatusBarInfoText( tr("Error writing the output file(s)."));
+	}
+	return rendered && written;
+}
+
+bool ExportBitmap::waitForImages(QList<PendingImage>& pending, qint64 maxBytes)
+{
+	bool written = true;
+	QEventLoop loop;
+	QTimer timer;
+	connect(&timer, SIGNAL(timeout()), &loop, SLOT(quit()));
+	timer.start(50);
+	while (true)
+	{
+		qint64 bytes = 0;
+		for (int i = 0; i < pending.count(); )
+		{
+			if (pending[i].saved.isFinished())
+			{
+				written = written && pending[i].saved.result();
+				pending.removeAt(i);
+			}
+			else
+				bytes += pending[i++].bytes;
+		}
+		if (pending.isEmpty() || (bytes <= maxBytes))
+			break;
+		// keeps the progress bar painted while waiting
+		loop.exec(QEventLoop::ExcludeUserInputEvents);
+	}
+	timer.stop();
+	return written;
 }
@@ -9,10 +9,14 @@ for which a new license (GPL+exception) is in place.
 
 #include <QString>
 #include <QFileDialog>
+#include <QFuture>
+#include <QImage>
+#include <QList>
 #include <pluginapi.h>
 #include <loadsaveplugin.h>
 #include <vector>
 
+class Page;
 class ScrAction;
 
 class PLUGIN_API PixmapExportPlugin : public ScActionPlugin
@@ -78,6 +82,32 @@ private:
 	\retval bool true on success
 	*/
 	bool exportPage(ScribusDoc* doc, uint pageNr, bool single);
+	/*! \brief ask whether an existing file may be overwritten
+	\param fileName name of the file
+	\param single bool TRUE if only the one page is exported
+	\retval bool true if the file may be written */
+	bool confirmOverwrite(ScribusDoc* doc, const QString& fileName, bool single);
+	/*! \brief the scale the page is rendered in, 1.0 being 72 dpi */
+	double pageScale(Page* page) const;
+	/*! \brief true if pages are rendered and written in bands instead of as a whole */
+	bool writesBands() const;
+	/*! \brief render one page band by band and write it to a TIFF file
+	Only one band is kept in memory, whatever the resolution.
+	\retval bool true on success */
+	bool exportPageInBands(ScribusDoc* doc, uint pageNr, const QString& fileName);
+	/*! \brief render one page in the export resolution
+	\retval QImage a null image if there is not enough memory */
+	QImage renderPage(ScribusDoc* doc, uint pageNr);
+
+	/*! \brief an image which is saved by a worker thread */
+	struct PendingImage
+	{
+		QFuture<bool> saved;
+		qint64 bytes;
+	};
+	/*! \brief wait until the images not saved yet take at most maxBytes
+	\retval bool false if an image could not be written */
+	bool waitForImages(QList<PendingImage>& pending, qint64 maxBytes);
 };
 
 #endif
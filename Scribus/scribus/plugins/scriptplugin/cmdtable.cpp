@@ -7,8 +7,12 @@
  * for which a new license (GPL+exception) is in place.
  */
 
+#include <QFile>
+#include <QTextStream>
+
 #include "cmdtable.h"
 #include "cmdutil.h"
+#include "csvreader.h"
 #include "pageitem_table.h"
 
 PyObject *scribus_gettablerows(PyObject* /* self */, PyObject* args)
@@ -322,6 +326,44 @@ PyObject *scribus_mergetablecells(PyObject* /* self */, PyObject* args)
 	Py_RETURN_NONE;
 }
 
+PyObject *scribus_importtablecsv(PyObject* /* self */, PyObject* args)
+{
+	char *fileName;
+	char *fieldDelimiter = const_cast<char*>(",");
+	char *valueDelimiter = const_cast<char*>("\"");
+	char *Name = const_cast<char*>("");
+	if (!PyArg_ParseTuple(args, "es|eseses", "utf-8", &fileName, "utf-8", &fieldDelimiter, "utf-8", &valueDelimiter, "utf-8", &Name))
+		return NULL;
+	if(!checkHaveDocument())
+		return NULL;
+	PageItem *i = GetUniqueItem(QString::fromUtf8(Name));
+	if (i == NULL)
+		return NULL;
+	PageItem_Table *table = i->asTable();
+	if (!table)
+	{
+		PyErr_SetString(WrongFrameTypeError, QObject::tr("Cannot import data into a non-table item.","python error").toLocal8Bit().constData());
+		return NULL;
+	}
+	QString fieldDelim = QString::fromUtf8(fieldDelimiter);
+	QString valueDelim = QString::fromUtf8(valueDelimiter);
+	if (fieldDelim.length() != 1 || valueDelim.length() > 1)
+	{
+		PyErr_SetString(PyExc_ValueError, QObject::tr("The field delimiter must be one character and the value delimiter at most one.", "python error").toLocal8Bit().constData());
+		return NULL;
+	}
+	QFile file(QString::fromUtf8(fileName));
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		PyErr_SetString(ScribusException, QObject::tr("Failed to open file.","python error").toLocal8Bit().constData());
+		return NULL;
+	}
+	QTextStream stream(&file);
+	CsvReader reader(&stream, fieldDelim.at(0), valueDelim.isEmpty() ? QChar() : valueDelim.at(0));
+	table->setCellTexts(reader.readAll());
+	Py_RETURN_NONE;
+}
+
 PyObject *scribus_gettablestyle(PyObject* /* self */, PyObject* args)
 {
 	char *Name = const_cast<char*>("");
@@ -529,5 +571,5 @@ void cmdtabledocwarnings()
 	  << scribus_gettablestyle__doc__ << scribus_settablefillcolor__doc__
 	  << scribus_gettablefillcolor__doc__ << scribus_settableleftborder__doc__
 	  << scribus_settablerightborder__doc__ << scribus_settabletopborder__doc__
-	  << scribus_settablebottomborder__doc__;
+	  << scribus_settablebottomborder__doc__ << scribus_importtablecsv__doc__;
 }
@@ -140,6 +140,22 @@ May throw ValueError if number if numRows or numColumns is less than 1 or the sp
 /*! Merge table cells */
 PyObject *scribus_mergetablecells(PyObject * /*self*/, PyObject* args);
 
+/*! docstring */
+PyDoc_STRVAR(scribus_importtablecsv__doc__,
+QT_TR_NOOP("importTableCSV(filename, [fieldDelimiter, valueDelimiter, \"name\"])\n\
+\n\
+Fills the table \"name\" with the comma separated values in the file \"filename\".\n\
+The table is resized to the number of records and values in the file. \"fieldDelimiter\"\n\
+separates the values and defaults to \",\". Values may be enclosed in \"valueDelimiter\",\n\
+which defaults to '\"'. Pass an empty string to read value delimiters as normal characters.\n\
+If \"name\" is not given the currently selected item is used.\n\
+\n\
+May throw ValueError if a delimiter is longer than one character.\n\
+May throw ScribusError if the file can not be read.\n\
+"));
+/*! Import CSV data into a table */
+PyObject *scribus_importtablecsv(PyObject * /*self*/, PyObject* args);
+
 /*! docstring */
 PyDoc_STRVAR(scribus_gettablestyle__doc__,
 QT_TR_NOOP("getTableStyle([\"name\"]) -> string\n\
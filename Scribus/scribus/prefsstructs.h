@@ -327,6 +327,7 @@ struct DisplayPrefs
 	double pageGapVertical; //! Vertical gap between pages
 	double displayScale; //! Display scale, typically used to set the scale of the display to 100% of real values.
 	bool showVerifierWarningsOnCanvas; //! Show preflight verifier warnings on canvas
+	int itemCacheSize; //! Size in MB of the rendered item images kept by each view, 0 to not keep any
 };
 
 struct ExternalToolsPrefs
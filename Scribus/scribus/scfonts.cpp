@@ -16,8 +16,10 @@ for which a new license (GPL+exception) is in place.
 */
 
 #include <QApplication>
+#include <QDataStream>
 #include <QDir>
 #include <QDomDocument>
+#include <QEventLoop>
 #include <QFile>
 #include <QFileInfo>
 #include <QFont>
@@ -25,6 +27,9 @@ for which a new license (GPL+exception) is in place.
 #include <QMap>
 #include <QRegExp>
 #include <QString>
+#include <QThreadStorage>
+#include <QTimer>
+#include <QtConcurrentMap>
 
 
 #include <cstdlib>
@@ -111,15 +116,19 @@ void SCFonts::AddPath(QString p)
 }
 
 void SCFonts::AddScalableFonts(const QString &path, QString DocName)
+{
+	QList<FontFile> files;
+	collectFontFiles(path, DocName, files);
+	addFontFiles(files);
+}
+
+void SCFonts::collectFontFiles(const QString &path, const QString& DocName, QList<FontFile>& files)
 {
 	//Make sure this is not empty or we will scan the whole drive on *nix
 	//QString::null+/ is / of course.
 	if (path.isEmpty())
 		return;
-	FT_Library library = NULL;
 	QString pathfile, fullpath;
-	bool error;
-	error = FT_Init_FreeType( &library );
 	QString pathname(path);
 	if ( !pathname.endsWith("/") )
 		pathname += "/";
@@ -169,7 +178,7 @@ void SCFonts::AddScalableFonts(const QString &path, QString DocName)
 						continue;
 				}
 				if (DocName.isEmpty())
-					AddScalableFonts(pathfile);
+					collectFontFiles(pathfile, DocName, files);
 				continue;
 			}
 			QString ext = fi.suffix().toLower();
@@ -178,19 +187,16 @@ void SCFonts::AddScalableFonts(const QString &path, QString DocName)
 				ext = ext2;
 			if ((ext == "ttc") || (ext == "dfont") || (ext == "pfa") || (ext == "pfb") || (ext == "ttf") || (ext == "otf"))
 			{
-				error = AddScalableFont(pathfile, library, DocName);
+				files.append(FontFile(pathfile, DocName, false));
 			}
 #ifdef Q_OS_MAC
 			else if (ext.isEmpty() && DocName.isEmpty())
 			{
-				error = AddScalableFont(pathfile, library, DocName);
-				if (error)
-					error = AddScalableFont(pathfile + "/..namedfork/rsrc",library, DocName);
+				files.append(FontFile(pathfile, DocName, true));
 			}
 #endif				
 		}
 	}
-	FT_Done_FreeType( library );
 }
 
 
@@ -298,17 +304,148 @@ void getSFontType(FT_Face face, ScFace::FontType & type)
 	}
 } 
 
-// Load a single font into the library from the passed filename. Returns true on error.
-bool SCFonts::AddScalableFont(QString filename, FT_Library &library, QString DocName)
+void SCFonts::readFace(FT_Face face, int faceIndex, ScFace::FontFormat format, bool hasNames, bool subset, CachedFace& info)
+{
+	QString sty(face->style_name);
+	if (sty == "Regular")
+	{
+		switch (face->style_flags)
+		{
+			case 0:
+				break;
+			case 1:
+				sty = "Italic";
+				break;
+			case 2:
+				sty = "Bold";
+				break;
+			case 3:
+				sty = "Bold Italic";
+				break;
+			default:
+				break;
+		}
+	}
+	info.faceIndex = faceIndex;
+	info.family = QString(face->family_name);
+	info.style = sty;
+	const char* psName = FT_Get_Postscript_Name(face);
+	if (psName)
+		info.psName = QString(psName);
+	else
+		info.psName = info.family + " " + sty;
+	info.format = format;
+	info.type = ScFace::UNKNOWN_TYPE;
+	info.hasNames = hasNames;
+	info.subset = subset;
+	switch (format)
+	{
+		case ScFace::PFA:
+		case ScFace::PFB:
+			info.type = ScFace::TYPE1;
+			break;
+		case ScFace::SFNT:
+		case ScFace::TYPE42:
+			getSFontType(face, info.type);
+			if (info.type == ScFace::OTF)
+				info.subset = true;
+			break;
+		case ScFace::TTCF:
+			info.type = ScFace::TTF;
+			//getSFontType(face, info.type);
+			break;
+		default:
+			break;
+	}
+	if (face->num_glyphs > 2048)
+		info.subset = true;
+}
+
+bool SCFonts::addFace(const QString& filename, const CachedFace& info, const QString& DocName)
+{
+	QString sty(info.style);
+	QString ts(info.family + " " + sty);
+	QString alt("");
+	ScFace t;
+	if (contains(ts))
+	{
+		t = (*this)[ts];
+		if (t.psName() != info.psName)
+		{
+			alt = " ("+info.psName+")";
+			ts += alt;
+			sty += alt;
+		}
+	}
+	t = (*this)[ts];
+	if (!t.isNone())
+	{
+		if (showFontInformation)
+			sDebug(QObject::tr("Font %1(%2) is duplicate of %3").arg(filename).arg(info.faceIndex+1).arg(t.fontPath()));
+		return false;
+	}
+	switch (info.format)
+	{
+		case ScFace::PFA:
+			t = ScFace(new ScFace_pfa(info.family, sty, "", ts, info.psName, filename, info.faceIndex));
+			break;
+		case ScFace::PFB:
+			t = ScFace(new ScFace_pfb(info.family, sty, "", ts, info.psName, filename, info.faceIndex));
+			break;
+		case ScFace::SFNT:
+		case ScFace::TYPE42:
+			t = ScFace(new ScFace_ttf(info.family, sty, "", ts, info.psName, filename, info.faceIndex));
+			break;
+		case ScFace::TTCF:
+			t = ScFace(new ScFace_ttf(info.family, sty, "", ts, info.psName, filename, info.faceIndex));
+			t.m->formatCode = ScFace::TTCF;
+			break;
+		default:
+		/* catching any types not handled above to silence compiler */
+			break;
+	}
+	t.m->typeCode = info.type;
+	t.subset(info.subset);
+	insert(ts,t);
+	t.m->hasNames = info.hasNames;
+	t.embedPs(true);
+	t.usable(true);
+	t.m->status = ScFace::UNKNOWN;
+	t.m->forDocument = DocName;
+	if (showFontInformation)
+		sDebug(QObject::tr("Font %1 loaded from %2(%3)").arg(t.psName()).arg(filename).arg(info.faceIndex+1));
+	return true;
+}
+
+namespace {
+
+/// A FreeType library for each thread which checks font files.
+struct ThreadLibrary
+{
+	FT_Library library;
+	ThreadLibrary() : library(NULL)
+	{
+		if (FT_Init_FreeType( &library ))
+			library = NULL;
+	}
+	~ThreadLibrary()
+	{
+		if (library)
+			FT_Done_FreeType( library );
+	}
+};
+
+QThreadStorage<ThreadLibrary*> threadLibraries;
+
+FT_Library threadLibrary()
+{
+	if (!threadLibraries.hasLocalData())
+		threadLibraries.setLocalData(new ThreadLibrary());
+	return threadLibraries.localData()->library;
+}
+
+QDateTime fontModificationTime(const QString& filename)
 {
-	static bool firstRun;
-	bool Subset = false;
-	char *buf[50];
-	QString glyName = "";
-	ScFace::FontFormat format;
-	ScFace::FontType   type;
-	FT_Face         face = NULL;
-	struct testCache foCache;
 	QFileInfo fic(filename);
 	QDateTime lastMod = fic.lastModified();
 	QTime lastModTime = lastMod.time();
@@ -317,254 +454,86 @@ bool SCFonts::AddScalableFont(QString filename, FT_Library &library, QString Doc
 		lastModTime.setHMS(lastModTime.hour(), lastModTime.minute(), lastModTime.second());
 		lastMod.setTime(lastModTime);
 	}
-	foCache.isOK = false;
-	foCache.isChecked = true;
-	foCache.lastMod = lastMod;
-	if (checkedFonts.count() == 0)
-	{
-		firstRun = true;
-		ScCore->setSplashStatus( QObject::tr("Creating Font Cache") );
-	}
-	bool error = FT_New_Face( library, QFile::encodeName(filename), 0, &face );
+	return lastMod;
+}
+
+} // namespace
+
+// Checks a single font file and reads its faces. Runs in worker threads, so it must not touch SCFonts.
+SCFonts::ScannedFont SCFonts::scanFontFile(const FontCheck& job)
+{
+	bool Subset = false;
+	char *buf[50];
+	QString glyName = "";
+	ScFace::FontFormat format;
+	ScFace::FontType   type;
+	FT_Face         face = NULL;
+	FT_Library      library = threadLibrary();
+	const QString&  filename(job.fileName);
+	ScannedFont result;
+	result.fileName = filename;
+	result.cache.isOK = false;
+	result.cache.isChecked = true;
+	result.cache.lastMod = job.lastMod;
+	bool error = !library || FT_New_Face( library, QFile::encodeName(filename), 0, &face );
 	if (error) 
 	{
 		if (face != NULL)
 			FT_Done_Face( face );
-		checkedFonts.insert(filename, foCache);
-		if (showFontInformation)
+		if (job.showFontInformation)
 			sDebug(QObject::tr("Font %1 is broken, discarding it").arg(filename));
-		return true;
+		return result;
 	}
 	getFontFormat(face, format, type);
 	if (format == ScFace::UNKNOWN_FORMAT) 
 	{
-		if (showFontInformation)
+		if (job.showFontInformation)
 			sDebug(QObject::tr("Failed to load font %1 - font type unknown").arg(filename));
-		checkedFonts.insert(filename, foCache);
-		error = true;
+		FT_Done_Face( face );
+		return result;
 	}
 	bool HasNames = FT_HAS_GLYPH_NAMES(face);
-	if (!error)
+	if (job.checkGlyphs)
 	{
-		if (!checkedFonts.contains(filename))
-		{
-			if (!firstRun)
-				ScCore->setSplashStatus( QObject::tr("New Font found, checking...") );
-			FT_UInt gindex = 0;
-			FT_ULong charcode = FT_Get_First_Char( face, &gindex );
-			while ( gindex != 0 )
-			{
-				error = FT_Load_Glyph( face, gindex, FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP );
-				if (error)
-				{
-					if (showFontInformation)
-						sDebug(QObject::tr("Font %1 has broken glyph %2 (charcode %3)").arg(filename).arg(gindex).arg(charcode));
-					if (face != NULL)
-						FT_Done_Face( face );
-					checkedFonts.insert(filename, foCache);
-					return true;
-				}
-				FT_Get_Glyph_Name(face, gindex, buf, 50);
-				QString newName = QString(reinterpret_cast<char*>(buf));
-				if (newName == glyName)
-				{
-					HasNames = false;
-					Subset = true;
-				}
-				glyName = newName;
-				charcode = FT_Get_Next_Char( face, charcode, &gindex );
-			}
-			foCache.isOK = true;
-			checkedFonts.insert(filename, foCache);
-		}
-		else
+		FT_UInt gindex = 0;
+		FT_ULong charcode = FT_Get_First_Char( face, &gindex );
+		while ( gindex != 0 )
 		{
-			if (!checkedFonts[filename].isOK)
+			error = FT_Load_Glyph( face, gindex, FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP );
+			if (error)
 			{
-				checkedFonts[filename].isChecked = true;
-				return true;
-			}
-			if (checkedFonts[filename].lastMod != foCache.lastMod)
-			{
-				ScCore->setSplashStatus( QObject::tr("Modified Font found, checking...") );
-				FT_UInt gindex = 0;
-				FT_ULong charcode = FT_Get_First_Char( face, &gindex );
-				while ( gindex != 0 )
-				{
-					error = FT_Load_Glyph( face, gindex, FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP );
-					if (error)
-					{
-						if (showFontInformation)
-							sDebug(QObject::tr("Font %1 has broken glyph %2 (charcode %3)").arg(filename).arg(gindex).arg(charcode));
-						if (face != NULL)
-							FT_Done_Face( face );
-						checkedFonts.insert(filename, foCache);
-						return true;
-					}
-					FT_Get_Glyph_Name(face, gindex, buf, 50);
-					QString newName = QString(reinterpret_cast<char*>(buf));
-					if (newName == glyName)
-					{
-						HasNames = false;
-						Subset = true;
-					}
-					glyName = newName;
-					charcode = FT_Get_Next_Char( face, charcode, &gindex );
-				}
-				foCache.isOK = true;
-				checkedFonts[filename] = foCache;
+				if (job.showFontInformation)
+					sDebug(QObject::tr("Font %1 has broken glyph %2 (charcode %3)").arg(filename).arg(gindex).arg(charcode));
+				FT_Done_Face( face );
+				return result;
 			}
-			else
+			FT_Get_Glyph_Name(face, gindex, buf, 50);
+			QString newName = QString(reinterpret_cast<char*>(buf));
+			if (newName == glyName)
 			{
-				checkedFonts[filename].isOK = true;
-				checkedFonts[filename].isChecked = true;
+				HasNames = false;
+				Subset = true;
 			}
+			glyName = newName;
+			charcode = FT_Get_Next_Char( face, charcode, &gindex );
 		}
 	}
+	result.cache.isOK = true;
 	int faceindex=0;
 	while (!error)
 	{
-		QString fam(face->family_name);
-		QString sty(face->style_name);
-		if (sty == "Regular")
-		{
-			switch (face->style_flags)
-			{
-				case 0:
-					break;
-				case 1:
-					sty = "Italic";
-					break;
-				case 2:
-					sty = "Bold";
-					break;
-				case 3:
-					sty = "Bold Italic";
-					break;
-				default:
-					break;
-			}
-		}
-		QString ts(fam + " " + sty);
-		QString alt("");
-		const char* psName = FT_Get_Postscript_Name(face);
-		QString qpsName;
-		if (psName)
-			qpsName = QString(psName);
-		else
-			qpsName = ts;
-		ScFace t;
-		if (contains(ts))
+		CachedFace info;
+		readFace(face, faceindex, format, HasNames, Subset, info);
+		// this is needed since eg. AppleSymbols will happily return a face for *any* face_index
+		bool repeated = false;
+		for (int i = 0; i < result.cache.faces.count() && !repeated; ++i)
 		{
-			t = (*this)[ts];
-			if (t.psName() != qpsName)
-			{
-				alt = " ("+qpsName+")";
-				ts += alt;
-				sty += alt;
-			}
-		}
-		t = (*this)[ts];
-		if (t.isNone())
-		{
-			switch (format) 
-			{
-				case ScFace::PFA:
-					t = ScFace(new ScFace_pfa(fam, sty, "", ts, qpsName, filename, faceindex));
-					t.subset(Subset);
-					break;
-				case ScFace::PFB:
-					t = ScFace(new ScFace_pfb(fam, sty, "", ts, qpsName, filename, faceindex));
-					t.subset(Subset);
-					break;
-				case ScFace::SFNT:
-					t = ScFace(new ScFace_ttf(fam, sty, "", ts, qpsName, filename, faceindex));
-					getSFontType(face, t.m->typeCode);
-					if (t.type() == ScFace::OTF) 
-					{
-						t.subset(true);
-					}
-					else
-						t.subset(Subset);
-					break;
-				case ScFace::TTCF:
-					t = ScFace(new ScFace_ttf(fam, sty, "", ts, qpsName, filename, faceindex));
-					t.m->formatCode = ScFace::TTCF;
-					t.m->typeCode = ScFace::TTF;
-					//getSFontType(face, t.m->typeCode);
-					if (t.type() == ScFace::OTF) 
-					{
-						t.subset(true);
-					}
-					else
-						t.subset(Subset);
-					break;
-				case ScFace::TYPE42:
-					t = ScFace(new ScFace_ttf(fam, sty, "", ts, qpsName, filename, faceindex));
-					getSFontType(face, t.m->typeCode);
-					if (t.type() == ScFace::OTF) 
-					{
-						t.subset(true);
-					}
-					else
-						t.subset(Subset);
-					break;
-				default:
-				/* catching any types not handled above to silence compiler */
-					break;
-			}
-			insert(ts,t);
-			t.m->hasNames = HasNames;
-			t.embedPs(true);
-			t.usable(true);
-			t.m->status = ScFace::UNKNOWN;
-			if (face->num_glyphs > 2048)
-				t.subset(true);
-			t.m->forDocument = DocName;
-			//setBestEncoding(face); //AV
-/*			switch (face->charmap? face->charmap->encoding : -1)
-			{
-				case	 FT_ENCODING_ADOBE_STANDARD: 
-					t->FontEnc = QString("StandardEncoding");
-					break;
-				case	 FT_ENCODING_APPLE_ROMAN: 
-					t->FontEnc = QString("MacRomanEncoding");
-					break;
-				case	 FT_ENCODING_ADOBE_EXPERT: 
-					t->FontEnc = QString("MacExpertEncoding");
-					break;
-				case	 FT_ENCODING_ADOBE_LATIN_1: 
-					t->FontEnc = QString("WinAnsiEncoding");
-					break;
-				case	 FT_ENCODING_UNICODE: 
-					t->FontEnc = QString("Unicode");
-					break;
-				default:
-					t->FontEnc = QString();
-			}
-*/			if (showFontInformation)
-				sDebug(QObject::tr("Font %1 loaded from %2(%3)").arg(t.psName()).arg(filename).arg(faceindex+1));
-
-/*
-//debug
-			QByteArray bb;
-			t->RawData(bb);
-			QFile dump(QString("/tmp/fonts/%1-%2").arg(ts).arg(psName));
-			dump.open(IO_WriteOnly);
-			QDataStream os(&dump);
-			os.writeRawBytes(bb.data(), bb.size());
-			dump.close();
-*/
-		}
-		else 
-		{
-			if (showFontInformation)
-				sDebug(QObject::tr("Font %1(%2) is duplicate of %3").arg(filename).arg(faceindex+1).arg(t.fontPath()));
-			// this is needed since eg. AppleSymbols will happily return a face for *any* face_index
-			if (faceindex > 0) {
-				break;
-			}
+			const CachedFace& other(result.cache.faces[i]);
+			repeated = other.family == info.family && other.style == info.style && other.psName == info.psName;
 		}
+		if (repeated)
+			break;
+		result.cache.faces.append(info);
 		FT_Done_Face(face);
 		face=NULL;
 		++faceindex;
@@ -573,7 +542,124 @@ bool SCFonts::AddScalableFont(QString filename, FT_Library &library, QString Doc
 	
 	if (face != 0)
 		FT_Done_Face( face );
-	return error && faceindex == 0;
+	return result;
+}
+
+QList<SCFonts::ScannedFont> SCFonts::scanFontJob(const FontJob& job)
+{
+	QList<ScannedFont> result;
+	result.append(scanFontFile(job.file));
+	if (!result.last().cache.isOK && !job.resourceFork.fileName.isEmpty())
+		result.append(scanFontFile(job.resourceFork));
+	return result;
+}
+
+bool SCFonts::isCached(const QString& filename, const QDateTime& lastMod) const
+{
+	QMap<QString, testCache>::const_iterator it = checkedFonts.constFind(filename);
+	if (it == checkedFonts.constEnd())
+		return false;
+	return !it.value().isOK || (it.value().lastMod == lastMod && !it.value().faces.isEmpty());
+}
+
+SCFonts::FontCheck SCFonts::fontCheck(const QString& filename) const
+{
+	FontCheck job;
+	job.fileName = filename;
+	job.lastMod = fontModificationTime(filename);
+	QMap<QString, testCache>::const_iterator it = checkedFonts.constFind(filename);
+	// fonts from an old cache without faces were checked already
+	job.checkGlyphs = it == checkedFonts.constEnd() || it.value().lastMod != job.lastMod;
+	job.showFontInformation = showFontInformation;
+	return job;
+}
+
+// Adds the faces of a font file from checkedFonts. Returns true on error.
+bool SCFonts::addCachedFont(const QString& filename, const QString& DocName)
+{
+	if (!checkedFonts.contains(filename))
+		return true;
+	testCache& cached(checkedFonts[filename]);
+	cached.isChecked = true;
+	if (!cached.isOK)
+		return true;
+	for (int i = 0; i < cached.faces.count(); ++i)
+	{
+		// this is needed since eg. AppleSymbols will happily return a face for *any* face_index
+		if (!addFace(filename, cached.faces[i], DocName) && cached.faces[i].faceIndex > 0)
+			break;
+	}
+	return false;
+}
+
+void SCFonts::addFontFiles(const QList<FontFile>& files)
+{
+	if (checkedFonts.count() == 0)
+		ScCore->setSplashStatus( QObject::tr("Creating Font Cache") );
+	// Unchanged fonts are added from the cache without opening them,
+	// FreeType is only asked when the font is used. All others are
+	// checked by a pool of worker threads.
+	QList<FontJob> jobs;
+	QVector<int> jobOfFile(files.count(), -1);
+	QMap<QString, int> scheduled;
+	for (int i = 0; i < files.count(); ++i)
+	{
+		const FontFile& file(files[i]);
+		if (scheduled.contains(file.fileName))
+		{
+			jobOfFile[i] = scheduled[file.fileName];
+			continue;
+		}
+		FontJob job;
+		job.file = fontCheck(file.fileName);
+		bool cached = isCached(job.file.fileName, job.file.lastMod);
+		if (file.tryResourceFork)
+		{
+			job.resourceFork = fontCheck(file.fileName + "/..namedfork/rsrc");
+			if (cached && !checkedFonts[file.fileName].isOK)
+				cached = isCached(job.resourceFork.fileName, job.resourceFork.lastMod);
+		}
+		if (!cached)
+		{
+			scheduled.insert(file.fileName, jobs.count());
+			jobOfFile[i] = jobs.count();
+			jobs.append(job);
+		}
+	}
+
+	QList<QList<ScannedFont> > scanned;
+	if (!jobs.isEmpty())
+	{
+		QFuture<QList<ScannedFont> > future = QtConcurrent::mapped(jobs, &SCFonts::scanFontJob);
+		QEventLoop loop;
+		QTimer timer;
+		QObject::connect(&timer, SIGNAL(timeout()), &loop, SLOT(quit()));
+		timer.start(100);
+		while (!future.isFinished())
+		{
+			ScCore->setSplashStatus( QObject::tr("Checking Fonts (%1 of %2)").arg(future.progressValue()).arg(jobs.count()) );
+			loop.exec();
+		}
+		timer.stop();
+		scanned = future.results();
+	}
+
+	// merge in the order the files were found, so that duplicate names are resolved as before
+	QVector<bool> merged(jobs.count(), false);
+	for (int i = 0; i < files.count(); ++i)
+	{
+		const FontFile& file(files[i]);
+		int job = jobOfFile[i];
+		if (job >= 0 && !merged[job])
+		{
+			merged[job] = true;
+			const QList<ScannedFont>& results(scanned[job]);
+			for (int j = 0; j < results.count(); ++j)
+				checkedFonts.insert(results[j].fileName, results[j].cache);
+		}
+		if (addCachedFont(file.fileName, file.docName) && file.tryResourceFork)
+			addCachedFont(file.fileName + "/..namedfork/rsrc", file.docName);
+	}
 }
 
 void SCFonts::removeFont(QString name)
@@ -640,7 +726,7 @@ void SCFonts::setSubstitutions(const QMap<QString,QString>& substitutes, Scribus
 
 #ifdef HAVE_FONTCONFIG
 // Use Fontconfig to locate and load fonts.
-void SCFonts::AddFontconfigFonts()
+void SCFonts::AddFontconfigFonts(QList<FontFile>& files)
 {
 	// All-in-one library setup. Perhaps this should be in
 	// the SCFonts constructor.
@@ -659,11 +745,7 @@ void SCFonts::AddFontconfigFonts()
 	FcFontSet* fs = FcFontList(0, pat, os);
 	FcObjectSetDestroy(os);
 	FcPatternDestroy(pat);
-	// Create the Freetype library
-	bool error;
-	FT_Library library = NULL;
-	error = FT_Init_FreeType( &library );
-	// Now iterate over the font files and load them
+	// Now iterate over the font files and queue them for loading
 	int i;
 	for (i = 0; i < fs->nfont; i++) 
 	{
@@ -672,13 +754,12 @@ void SCFonts::AddFontconfigFonts()
 		{
 			if (showFontInformation)
 				sDebug(QObject::tr("Loading font %1 (found using fontconfig)").arg(QString((char*)file)));
-			error = AddScalableFont(QString((char*)file), library, "");
+			files.append(FontFile(QString((char*)file), "", false));
 		}
 		else
 			if (showFontInformation)
 				sDebug(QObject::tr("Failed to load a font - freetype2 couldn't find the font file"));
 	}
-	FT_Done_FreeType( library );
 }
 
 #elif defined(Q_WS_X11)
@@ -760,6 +841,9 @@ void SCFonts::AddUserPath(QString )
 		AddPath(extraDirs->get(i, 0));
 }
 
+static const quint32 FontCacheMagic = 0x53434643; // "SCFC"
+static const quint32 FontCacheVersion = 1;
+
 void SCFonts::ReadCacheList(QString pf)
 {
 	QFile fr(pf + "/cfonts.xml");
@@ -767,6 +851,9 @@ void SCFonts::ReadCacheList(QString pf)
 	if (fir.exists())
 		fr.remove();
 	checkedFonts.clear();
+	if (readFontCache(pf + "/fontcache.dat"))
+		return;
+	// fall back to the cache of older versions, which only knows the status of a font
 	struct testCache foCache;
 	QDomDocument docu("fontcacherc");
 	QFile f(pf + "/checkfonts.xml");
@@ -801,32 +888,79 @@ void SCFonts::ReadCacheList(QString pf)
 	}
 }
 
+bool SCFonts::readFontCache(const QString& fileName)
+{
+	QFile f(fileName);
+	if (!f.open(QIODevice::ReadOnly))
+		return false;
+	ScCore->setSplashStatus( QObject::tr("Reading Font Cache") );
+	QDataStream ds(&f);
+	ds.setVersion(QDataStream::Qt_4_6);
+	quint32 magic, version, count;
+	ds >> magic >> version;
+	if (magic != FontCacheMagic || version != FontCacheVersion)
+		return false;
+	ds >> count;
+	for (quint32 i = 0; i < count && ds.status() == QDataStream::Ok; ++i)
+	{
+		QString file;
+		struct testCache foCache;
+		quint32 faceCount;
+		ds >> file >> foCache.isOK >> foCache.lastMod >> faceCount;
+		foCache.isChecked = false;
+		for (quint32 j = 0; j < faceCount && ds.status() == QDataStream::Ok; ++j)
+		{
+			CachedFace face;
+			qint32 faceIndex, format, type;
+			ds >> faceIndex >> face.family >> face.style >> face.psName >> format >> type >> face.hasNames >> face.subset;
+			face.faceIndex = faceIndex;
+			face.format = static_cast<ScFace::FontFormat>(format);
+			face.type = static_cast<ScFace::FontType>(type);
+			foCache.faces.append(face);
+		}
+		if (ds.status() == QDataStream::Ok)
+			checkedFonts.insert(file, foCache);
+	}
+	if (ds.status() != QDataStream::Ok)
+	{
+		// truncated or damaged, check all fonts again
+		checkedFonts.clear();
+		return false;
+	}
+	return true;
+}
+
 void SCFonts::WriteCacheList(QString pf)
 {
-	QDomDocument docu("fontcacherc");
-	QString st="<CachedFonts></CachedFonts>";
-	docu.setContent(st);
-	QDomElement elem = docu.documentElement();
+	ScCore->setSplashStatus( QObject::tr("Writing updated Font Cache") );
 	QMap<QString, testCache>::Iterator it;
+	quint32 count = 0;
 	for (it = checkedFonts.begin(); it != checkedFonts.end(); ++it)
 	{
 		if (it.value().isChecked)
-		{
-			QDomElement fosu = docu.createElement("Font");
-			fosu.setAttribute("File",it.key());
-			fosu.setAttribute("Status",static_cast<int>(it.value().isOK));
-			fosu.setAttribute("Modified",it.value().lastMod.toString(Qt::ISODate));
-			elem.appendChild(fosu);
-		}
+			++count;
 	}
-	ScCore->setSplashStatus( QObject::tr("Writing updated Font Cache") );
-	QFile f(pf + "/checkfonts.xml");
+	QFile f(pf + "/fontcache.dat");
 	if(f.open(QIODevice::WriteOnly))
 	{
-		QTextStream s(&f);
-		s.setCodec("UTF-8");
-		s<<docu.toString();
+		QDataStream ds(&f);
+		ds.setVersion(QDataStream::Qt_4_6);
+		ds << FontCacheMagic << FontCacheVersion << count;
+		for (it = checkedFonts.begin(); it != checkedFonts.end(); ++it)
+		{
+			if (!it.value().isChecked)
+				continue;
+			const QList<CachedFace>& faces(it.value().faces);
+			ds << it.key() << it.value().isOK << it.value().lastMod << static_cast<quint32>(faces.count());
+			for (int i = 0; i < faces.count(); ++i)
+			{
+				ds << static_cast<qint32>(faces[i].faceIndex) << faces[i].family << faces[i].style << faces[i].psName;
+				ds << static_cast<qint32>(faces[i].format) << static_cast<qint32>(faces[i].type);
+				ds << faces[i].hasNames << faces[i].subset;
+			}
+		}
 		f.close();
+		QFile::remove(pf + "/checkfonts.xml");
 	}
 	checkedFonts.clear();
 }
@@ -838,20 +972,21 @@ void SCFonts::GetFonts(QString pf, bool showFontInfo)
 	ReadCacheList(pf);
 	ScCore->setSplashStatus( QObject::tr("Searching for Fonts") );
 	AddUserPath(pf);
+	QList<FontFile> files;
 	// Search the system paths
 	QStringList ftDirs = ScPaths::getSystemFontDirs();
 	for (int i = 0; i < ftDirs.count(); i++)
-		AddScalableFonts( ftDirs[i] );
+		collectFontFiles( ftDirs[i], "", files );
 	// Search Scribus font path
 	if (!ScPaths::instance().fontDir().isEmpty() && QDir(ScPaths::instance().fontDir()).exists())
-		AddScalableFonts( ScPaths::instance().fontDir() );
+		collectFontFiles( ScPaths::instance().fontDir(), "", files );
 // if fontconfig is there, it does all the work
 #if HAVE_FONTCONFIG
 	// Search fontconfig paths
 	QStringList::iterator fpi, fpend = FontPath.end();
 	for(fpi = FontPath.begin() ; fpi != fpend; ++fpi) 
-		AddScalableFonts(*fpi);
-	AddFontconfigFonts();
+		collectFontFiles(*fpi, "", files);
+	AddFontconfigFonts(files);
 #else
 // on X11 look there:
 #ifdef Q_WS_X11
@@ -861,8 +996,9 @@ void SCFonts::GetFonts(QString pf, bool showFontInfo)
 // add user and X11 fonts:
 	QStringList::iterator fpi, fpend = FontPath.end();
 	for(fpi = FontPath.begin() ; fpi != fpend; ++fpi) 
-		AddScalableFonts(*fpi);
+		collectFontFiles(*fpi, "", files);
 #endif
+	addFontFiles(files);
 	updateFontMap();
 	WriteCacheList(pf);
 }
@@ -56,13 +56,75 @@ class SCRIBUS_API SCFonts : public QMap<QString,ScFace>
 		/// maps family name to face variants
 		QMap<QString, QStringList> fontMap;
 	private:
+		/// what checking a font file found out about a face, kept in the font cache
+		struct CachedFace
+		{
+			int faceIndex;
+			QString family;
+			QString style;
+			QString psName;
+			ScFace::FontFormat format;
+			ScFace::FontType type;
+			bool hasNames;
+			bool subset;
+		};
+		struct testCache
+		{
+			bool isOK;
+			bool isChecked;
+			QDateTime lastMod;
+			/// empty if the faces were not read yet
+			QList<CachedFace> faces;
+		};
+		/// a font file found while searching the font paths
+		struct FontFile
+		{
+			QString fileName;
+			QString docName;
+			/// Mac: files without extension may have the font in their resource fork
+			bool tryResourceFork;
+			FontFile(const QString& name, const QString& doc, bool fork) : fileName(name), docName(doc), tryResourceFork(fork) {}
+		};
+		/// what a worker thread needs to know to check a font file
+		struct FontCheck
+		{
+			QString fileName;
+			QDateTime lastMod;
+			bool checkGlyphs;
+			bool showFontInformation;
+		};
+		struct FontJob
+		{
+			FontCheck file;
+			/// only checked if file is broken, fileName is empty if there is no resource fork to try
+			FontCheck resourceFork;
+		};
+		struct ScannedFont
+		{
+			QString fileName;
+			testCache cache;
+		};
 		void ReadCacheList(QString pf);
 		void WriteCacheList(QString pf);
+		/// reads the binary font cache, returns false if there is none or it has the wrong version
+		bool readFontCache(const QString& fileName);
 		void AddPath(QString p);
-		bool AddScalableFont(QString filename, FT_Library &library, QString DocName);
+		/// appends the font files in path (and its subdirectories if DocName is empty) to files
+		void collectFontFiles(const QString& path, const QString& DocName, QList<FontFile>& files);
+		/// adds the faces of files, checking new and modified files in parallel
+		void addFontFiles(const QList<FontFile>& files);
+		FontCheck fontCheck(const QString& filename) const;
+		/// true if the faces of the file can be taken from checkedFonts
+		bool isCached(const QString& filename, const QDateTime& lastMod) const;
+		bool addCachedFont(const QString& filename, const QString& DocName);
+		static QList<ScannedFont> scanFontJob(const FontJob& job);
+		static ScannedFont scanFontFile(const FontCheck& job);
+		static void readFace(FT_Face face, int faceIndex, ScFace::FontFormat format, bool hasNames, bool subset, CachedFace& info);
+		/// adds the face unless a face with the same name is known already. Returns false for such duplicates.
+		bool addFace(const QString& filename, const CachedFace& info, const QString& DocName);
 		void AddUserPath(QString pf);
 #ifdef HAVE_FONTCONFIG
-		void AddFontconfigFonts();
+		void AddFontconfigFonts(QList<FontFile>& files);
 #else
 #ifndef Q_OS_MAC
 		void AddXFontServerPath();
@@ -71,12 +133,6 @@ class SCRIBUS_API SCFonts : public QMap<QString,ScFace>
 #endif
 		QStringList FontPath;
 		QString ExtraPath;
-		struct testCache
-		{
-			bool isOK;
-			bool isChecked;
-			QDateTime lastMod;
-		};
 		QMap<QString, testCache> checkedFonts;
 	protected:
 		bool showFontInformation;
@@ -88,9 +88,47 @@ QImage ScImage::scaled(int h, int w, Qt::AspectRatioMode mode, Qt::Transformatio
 	return QImage::scaled(h, w, mode, transformMode);
 }
 
+QImage* ScImage::mipLevel(int level)
+{
+	if (level <= 0)
+		return this;
+	// any write access to the pixels changes the cache key
+	if (m_mipKey != cacheKey())
+	{
+		m_mipLevels.clear();
+		m_mipKey = cacheKey();
+	}
+	while (m_mipLevels.count() < level)
+	{
+		const QImage& source = m_mipLevels.isEmpty() ? qImage() : m_mipLevels.last();
+		if ((source.width() <= 1) && (source.height() <= 1))
+			break;
+		QImage reduced = source.scaled(qMax(1, (source.width() + 1) / 2), qMax(1, (source.height() + 1) / 2), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+		// smooth scaling premultiplies alpha, ScPainter::drawImage() expects the format of the image
+		m_mipLevels.append(reduced.convertToFormat(format()));
+	}
+	return m_mipLevels.isEmpty() ? this : &m_mipLevels[qMin(level, m_mipLevels.count()) - 1];
+}
+
+int ScImage::mipLevelFor(double scale) const
+{
+	int level = 0;
+	int w = width();
+	int h = height();
+	while ((scale <= 0.5) && ((w > 1) || (h > 1)))
+	{
+		scale *= 2.0;
+		w = (w + 1) / 2;
+		h = (h + 1) / 2;
+		++level;
+	}
+	return level;
+}
+
 
 void ScImage::initialize()
 {
+	m_mipKey = 0;
 	imgInfo.xres = 72;
 	imgInfo.yres = 72;
 	imgInfo.colorspace = ColorSpaceRGB;
@@ -101,6 +101,13 @@ public:
 	// Scale this image in-place
 	void scaleImage(int width, int height);
 
+	// Mipmaps for drawing the image at small scales: level n is the image reduced n times
+	// by half, level 0 is the image itself. Levels are built on first use and rebuilt
+	// after the image changed.
+	QImage* mipLevel(int level);
+	// The highest level which still has at least as many pixels as drawing at scale needs
+	int mipLevelFor(double scale) const;
+
 	// Retrieve an embedded ICC profile from the file path `fn', storing it in `profile'.
 	// TODO: Bad API. Should probably be static member returning an ICCProfile (custom class) or something like that.
 	void getEmbeddedProfile(const QString & fn, QByteArray *profile, int *components, int page = 0);
@@ -134,6 +141,9 @@ private:
 	void applyCurve(const QVector<int>& curveTable, bool cmyk);
 
 	void addProfileToCacheModifiers(ScImageCacheProxy & cache, const QString & prefix, const ScColorProfile & profile) const;
+
+	QList<QImage> m_mipLevels;
+	qint64 m_mipKey;
 };
 
 #endif
@@ -6,6 +6,7 @@ for which a new license (GPL+exception) is in place.
 */
 
 #include "scpainter.h"
+#include "scimage.h"
 #include "util_color.h"
 #include "util.h"
 #include "util_math.h"
@@ -46,6 +47,7 @@ ScPainter::ScPainter( QImage *target, unsigned int w, unsigned int h, double tra
 	layeredMode = true;
 	imageMode = true;
 	svgMode = false;
+	m_showGuides = true;
 	m_image = target;
 	m_matrix = QTransform();
 	cairo_surface_t *img = cairo_image_surface_create_for_data(m_image->bits(), CAIRO_FORMAT_ARGB32, w, h, w*4);
@@ -1609,6 +1611,26 @@ void ScPainter::setClipPath()
 
 void ScPainter::drawImage( QImage *image)
 {
+	drawImageScaled(image, 1.0, 1.0);
+}
+
+void ScPainter::drawImage( ScImage *image)
+{
+	// the number of device pixels per image pixel
+	QTransform matrix = worldMatrix();
+	double scaleX = sqrt(matrix.m11() * matrix.m11() + matrix.m12() * matrix.m12());
+	double scaleY = sqrt(matrix.m21() * matrix.m21() + matrix.m22() * matrix.m22());
+	QImage *level = image->mipLevel(image->mipLevelFor(qMax(scaleX, scaleY)));
+	if ((level->width() <= 0) || (level->height() <= 0))
+		return;
+	drawImageScaled(level, image->width() / static_cast<double>(level->width()), image->height() / static_cast<double>(level->height()));
+}
+
+void ScPainter::drawImageScaled(QImage *image, double scaleX, double scaleY)
+{
+	// reading through a const image keeps its cache key, which ScImage uses for its mipmaps
+	const QImage *source = image;
+	uchar *bits = const_cast<uchar*>(source->bits());
 #if CAIRO_VERSION >= CAIRO_VERSION_ENCODE(1, 2, 6)
 /*
 	cairo_surface_t *image3 = cairo_image_surface_create_for_data ((uchar*)image->bits(), CAIRO_FORMAT_ARGB32, image->width(), image->height(), image->width()*4);
@@ -1621,10 +1643,13 @@ void ScPainter::drawImage( QImage *image)
 	cairo_push_group(m_cr);
 	cairo_set_operator(m_cr, CAIRO_OPERATOR_OVER);
 	cairo_set_fill_rule(m_cr, cairo_get_fill_rule(m_cr));
-	cairo_surface_t *image2  = cairo_image_surface_create_for_data ((uchar*)image->bits(), CAIRO_FORMAT_RGB24, image->width(), image->height(), image->width()*4);
-	cairo_surface_t *image3 = cairo_image_surface_create_for_data ((uchar*)image->bits(), CAIRO_FORMAT_ARGB32, image->width(), image->height(), image->width()*4);
+	cairo_surface_t *image2  = cairo_image_surface_create_for_data (bits, CAIRO_FORMAT_RGB24, image->width(), image->height(), image->width()*4);
+	cairo_surface_t *image3 = cairo_image_surface_create_for_data (bits, CAIRO_FORMAT_ARGB32, image->width(), image->height(), image->width()*4);
+	cairo_save(m_cr);
+	cairo_scale(m_cr, scaleX, scaleY);
 	cairo_set_source_surface (m_cr, image2, 0, 0);
     cairo_mask_surface (m_cr, image3, 0, 0);
+	cairo_restore(m_cr);
 	cairo_surface_destroy (image2);
 	cairo_surface_destroy (image3);
 	cairo_pop_group_to_source (m_cr);
@@ -1647,13 +1672,13 @@ void ScPainter::drawImage( QImage *image)
 	cairo_surface_t *image3;
 	QImage mask;
 	cairo_set_fill_rule(m_cr, cairo_get_fill_rule(m_cr));
-	cairo_surface_t *image2  = cairo_image_surface_create_for_data ((uchar*)image->bits(), CAIRO_FORMAT_RGB24, image->width(), image->height(), image->width()*4);
+	cairo_surface_t *image2  = cairo_image_surface_create_for_data (bits, CAIRO_FORMAT_RGB24, image->width(), image->height(), image->width()*4);
 	if (fill_trans != 1.0)
 	{
 		mask = QImage(image->width(), image->height(), QImage::Format_Mono);
 		for( int yi = 0; yi < image->height(); ++yi )
 		{
-			QRgb * s = (QRgb*)(image->scanLine( yi ));
+			const QRgb * s = (const QRgb*)(source->scanLine( yi ));
 			unsigned char *d = (unsigned char *)(mask.scanLine( yi ));
 			for( int xi=0; xi < image->width(); ++xi )
 			{
@@ -1668,9 +1693,12 @@ void ScPainter::drawImage( QImage *image)
 		image3 = cairo_image_surface_create_for_data ((uchar*)mask.bits(), CAIRO_FORMAT_A8, image->width(), image->height(), image->width() + adj);
 	}
 	else
-		image3 = cairo_image_surface_create_for_data ((uchar*)image->bits(), CAIRO_FORMAT_ARGB32, image->width(), image->height(), image->width()*4);
+		image3 = cairo_image_surface_create_for_data (bits, CAIRO_FORMAT_ARGB32, image->width(), image->height(), image->width()*4);
+	cairo_save(m_cr);
+	cairo_scale(m_cr, scaleX, scaleY);
 	cairo_set_source_surface (m_cr, image2, 0, 0);
 	cairo_mask_surface (m_cr, image3, 0, 0);
+	cairo_restore(m_cr);
 	cairo_surface_destroy (image2);
 	cairo_surface_destroy (image3);
 #endif
@@ -25,6 +25,8 @@ for which a new license (GPL+exception) is in place.
 #include "scpattern.h"
 #include "mesh.h"
 
+class ScImage;
+
 typedef struct _cairo cairo_t;
 typedef struct _cairo_surface cairo_surface_t;
 typedef struct _cairo_pattern cairo_pattern_t;
@@ -38,6 +40,9 @@ public:
 	virtual void beginLayer(double transparency, int blendmode, FPointArray *clipArray = 0);
 	virtual void endLayer();
 	virtual void setAntialiasing(bool enable);
+	/// frame outlines, image placeholders and control characters are only drawn if guides are shown
+	void setShowGuides(bool show) { m_showGuides = show; }
+	bool showGuides() const { return m_showGuides; }
 	virtual void begin();
 	virtual void end();
 	void clear();
@@ -82,6 +87,8 @@ public:
 	virtual void setClipPath();
 
 	virtual void drawImage( QImage *image);
+	/// draws image, or one of its mipmaps if the current matrix shrinks the image
+	virtual void drawImage( ScImage *image);
 	virtual void setupPolygon(FPointArray *points, bool closed = true);
 	virtual void drawPolygon();
 	virtual void drawPolyLine();
@@ -146,6 +153,8 @@ private:
 		bool pushed;
 	};
 	cairo_pattern_t *getMaskPattern();
+	/// draws image enlarged by scaleX and scaleY, the mask and the transparency are not scaled
+	void drawImageScaled(QImage *image, double scaleX, double scaleY);
 	cairo_surface_t *imageMask;
 	QImage imageQ;
 
@@ -224,6 +233,7 @@ private:
 	bool imageMode;
 	bool layeredMode;
 	bool svgMode;
+	bool m_showGuides;
 };
 
 #endif
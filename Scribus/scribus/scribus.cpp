@@ -1323,6 +1323,7 @@ void ScribusMainWindow::keyPressEvent(QKeyEvent *k)
 					{
 						view->Deselect(false);
 						doc->Items->removeAt(currItem->ItemNr);
+						doc->itemListChanged();
 					}
 					else
 						view->Deselect(false);
@@ -1349,6 +1350,7 @@ void ScribusMainWindow::keyPressEvent(QKeyEvent *k)
 					{
 						view->Deselect(false);
 						doc->Items->removeAt(currItem->ItemNr);
+						doc->itemListChanged();
 					}
 					else
 					{
@@ -1367,6 +1369,7 @@ void ScribusMainWindow::keyPressEvent(QKeyEvent *k)
 					{
 						view->Deselect(false);
 						doc->Items->removeAt(currItem->ItemNr);
+						doc->itemListChanged();
 					}
 					break;
 			}
@@ -5089,6 +5092,7 @@ void ScribusMainWindow::slotEditPaste()
 				{
 					doc->Items->takeAt(ac);
 				}
+				doc->itemListChanged();
 				doc->m_Selection->clear();
 				//doc->m_Selection->restoreFromTempList(0, tempList);
 				*doc->m_Selection=tempSelection;
@@ -6356,6 +6360,9 @@ void ScribusMainWindow::setAppMode(int mode)
 		else if (mode == modeEditTable && oldMode != modeEditTable)
 			actionManager->saveActionShortcutsPreEditMode();
 
+		if (oldMode == modeEditTable && currItem != 0)
+			currItem->update();
+
 		if (oldMode == modeEdit)
 		{
 			view->zoomSpinBox->setFocusPolicy(Qt::ClickFocus);
@@ -9985,6 +9992,7 @@ void ScribusMainWindow::PutToPatterns()
 	PageItem* groupItem = doc->Items->takeAt(z);
 	groupItem->setPattern(patternName);
 	doc->Items->replace(d, groupItem);
+	doc->itemListChanged();
 	propertiesPalette->updateColorList();
 	symbolPalette->updateSymbolList();
 	if (outlinePalette->isVisible())
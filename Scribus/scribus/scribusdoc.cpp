@@ -249,7 +249,10 @@ ScribusDoc::ScribusDoc() : UndoObject( tr("Document")), Observable<ScribusDoc>(N
 	m_alignTransaction(NULL),
 	m_currentPage(NULL),
 	m_updateManager(),
-	m_docUpdater(NULL)
+	m_docUpdater(NULL),
+	m_itemIndexList(NULL),
+	m_itemIndexGeneration(0),
+	m_itemListGeneration(0)
 {
 	docUnitRatio=unitGetRatioFromIndex(docPrefsData.docSetupPrefs.docUnitIndex);
 	docPrefsData.docSetupPrefs.pageHeight=0;
@@ -340,7 +343,10 @@ ScribusDoc::ScribusDoc(const QString& docName, int unitindex, const PageSize& pa
 	m_alignTransaction(NULL),
 	m_currentPage(NULL),
 	m_updateManager(),
-	m_docUpdater(NULL)
+	m_docUpdater(NULL),
+	m_itemIndexList(NULL),
+	m_itemIndexGeneration(0),
+	m_itemListGeneration(0)
 {
 	docPrefsData.docSetupPrefs.docUnitIndex=unitindex;
 	docPrefsData.docSetupPrefs.pageHeight=pagesize.height();
@@ -4376,6 +4382,7 @@ int ScribusDoc::itemAdd(const PageItem::ItemType itemType, const PageItem::ItemF
 		return -1;
 	Items->append(newItem);
 	newItem->ItemNr = Items->count()-1;
+	itemListChanged();
 	//Add in item default values based on itemType and frameType
 	itemAddDetails(itemType, frameType, newItem->ItemNr);
 	if (UndoManager::undoEnabled())
@@ -4686,6 +4693,7 @@ void ScribusDoc::updateFrameItems()
 
 void ScribusDoc::renumberItemsInListOrder( )
 {
+	itemListChanged();
 	m_docUpdater->beginUpdate();
 	m_updateManager.setUpdatesEnabled(false);
 	int itemsCount=Items->count();
@@ -4956,6 +4964,48 @@ int ScribusDoc::OnPage(PageItem *currItem)
 }
 
 
+QList<int> ScribusDoc::itemsInArea(const QRectF& area)
+{
+	// the count catches plugins which add or remove items without telling us
+	if ((m_itemIndexList != Items) || (m_itemIndexGeneration != m_itemListGeneration) || (m_itemIndexItems.count() != Items->count()))
+		rebuildItemIndex();
+	foreach (int pos, m_itemIndexDirty)
+	{
+		PageItem* currItem = m_itemIndexItems.at(pos);
+		QRectF bounds(currItem->getBoundingRect());
+		if (currItem->Clip.size() > 0)
+			bounds |= currItem->getTransform().map(QPolygonF(currItem->Clip)).boundingRect();
+		m_itemIndex.insert(pos, bounds);
+	}
+	m_itemIndexDirty.clear();
+	return m_itemIndex.intersecting(area);
+}
+
+
+void ScribusDoc::itemGeometryChanged(PageItem *currItem)
+{
+	QHash<PageItem*, int>::const_iterator it = m_itemIndexPositions.constFind(currItem);
+	if (it != m_itemIndexPositions.constEnd())
+		m_itemIndexDirty.insert(it.value());
+}
+
+
+void ScribusDoc::rebuildItemIndex()
+{
+	m_itemIndex.clear();
+	m_itemIndexList = Items;
+	m_itemIndexItems = *Items;
+	m_itemIndexGeneration = m_itemListGeneration;
+	m_itemIndexPositions.clear();
+	m_itemIndexDirty.clear();
+	for (int i = 0; i < m_itemIndexItems.count(); ++i)
+	{
+		m_itemIndexPositions.insert(m_itemIndexItems.at(i), i);
+		m_itemIndexDirty.insert(i);
+	}
+}
+
+
 void ScribusDoc::GroupOnPage(PageItem* currItem)
 {
 	if (!currItem->isGroup())
@@ -5374,6 +5424,7 @@ PageItem* ScribusDoc::convertItemTo(PageItem *currItem, PageItem::ItemType newTy
 	newItem->ItemNr = oldItemNr;
 	newItem->uniqueNr = oldItem->uniqueNr;
 	Items->replace(oldItemNr, newItem);
+	itemListChanged();
 	//FIXME: shouldn't we delete the oldItem ???
 	//Add new item back to selection if old item was in selection
 	if (removedFromSelection)
@@ -7339,27 +7390,11 @@ void ScribusDoc::itemSelection_SetEffects(int s, Selection* customSelection)
 #ifndef NLS_PROTO
 				if (appMode == modeEdit)
 				{
-					for (int a = 0; a < currItem->itemText.length(); ++a)
-					{
-						if (currItem->itemText.selected(a))
-						{
-							StyleFlag fl = currItem->itemText.item(a)->effects();
-							fl &= static_cast<StyleFlag>(~1919); // 0x11101111111
-							fl |= static_cast<StyleFlag>(s & 1919);
-							currItem->itemText.item(a)->setFeatures(fl.featureList());
-						}
-					}
+					if (currItem->itemText.lengthOfSelection() > 0)
+						currItem->itemText.replaceEffects(currItem->itemText.startOfSelection(), currItem->itemText.lengthOfSelection(), ScStyle_UserStyles, static_cast<StyleFlag>(s));
 				}
 				else
-				{
-					for (int a = 0; a < currItem->itemText.length(); ++a)
-					{
-						StyleFlag fl = currItem->itemText.item(a)->effects();
-						fl &= static_cast<StyleFlag>(~1919); // 1024+512+256+64+32+16+8+4+2+1
-						fl |= static_cast<StyleFlag>(s & 1919);
-						currItem->itemText.item(a)->setFeatures(fl.featureList());
-					}
-				}
+					currItem->itemText.replaceEffects(0, currItem->itemText.length(), ScStyle_UserStyles, static_cast<StyleFlag>(s));
 #endif
 				currItem->update();
 			}
@@ -11360,6 +11395,9 @@ void ScribusDoc::invalidateAll()
 		for (int ii = 0; ii < allItems.count(); ii++)
 		{
 			ite = allItems.at(ii);
+			// document settings may change the layout, don't reuse old lines
+			if (ite->asTextFrame())
+				ite->itemText.invalidateLayout();
 			ite->invalidateLayout();
 		}
 		allItems.clear();
@@ -11374,6 +11412,9 @@ void ScribusDoc::invalidateAll()
 		for (int ii = 0; ii < allItems.count(); ii++)
 		{
 			ite = allItems.at(ii);
+			// document settings may change the layout, don't reuse old lines
+			if (ite->asTextFrame())
+				ite->itemText.invalidateLayout();
 			ite->invalidateLayout();
 		}
 		allItems.clear();
@@ -28,11 +28,13 @@ for which a new license (GPL+exception) is in place.
 // include files for QT
 #include <QColor>
 #include <QFont>
+#include <QHash>
 #include <QList>
 #include <QMap>
 #include <QObject>
 #include <QPixmap>
 #include <QRectF>
+#include <QSet>
 #include <QStringList>
 #include <QTimer>
 
@@ -47,6 +49,7 @@ for which a new license (GPL+exception) is in place.
 #include "prefsstructs.h"
 #include "scguardedptr.h"
 #include "sclayer.h"
+#include "spatialindex.h"
 #include "styles/styleset.h"
 #include "styles/tablestyle.h"
 #include "styles/cellstyle.h"
@@ -834,6 +837,24 @@ public:
 	
 	int OnPage(double x2, double  y2);
 	int OnPage(PageItem *currItem);
+	/**
+	 * @brief Find the items whose bounds intersect an area, without looking at every item
+	 * @param area area in canvas coordinates
+	 * @retval positions in Items in ascending order, i.e. from the bottom to the top item.
+	 * Callers still need to do their exact tests, the result may contain a few items more.
+	 */
+	QList<int> itemsInArea(const QRectF& area);
+	/**
+	 * @brief Tell the item index that the position, size or shape of an item changed
+	 * Called by PageItem, the bounds are recalculated on the next call of itemsInArea().
+	 */
+	void itemGeometryChanged(PageItem *currItem);
+	/**
+	 * @brief Tell the item index that items were added to, removed from or moved in an item list
+	 * Called by itemAdd() and renumberItemsInListOrder(), code changing Items directly without
+	 * renumbering has to call it. The index is rebuilt on the next call of itemsInArea().
+	 */
+	void itemListChanged() { ++m_itemListGeneration; }
 	void GroupOnPage(PageItem *currItem);
 	//void reformPages(double& maxX, double& maxY, bool moveObjects = true);
 	void reformPages(bool moveObjects = true);
@@ -1262,6 +1283,19 @@ private:
 	MassObservable<Page*> m_pagesChanged;
 	MassObservable<QRectF> m_regionsChanged;
 	DocUpdater* m_docUpdater;
+	/// Bounds of the items in m_itemIndexItems, by position. There is one index for all
+	/// layers: Items holds them in one z-order and callers filter by layer anyway.
+	SpatialIndex m_itemIndex;
+	/// The item list the index was built for, a copy of it and the list generation at that time
+	const QList<PageItem*>* m_itemIndexList;
+	QList<PageItem*> m_itemIndexItems;
+	uint m_itemIndexGeneration;
+	/// Bumped whenever items are added to, removed from or moved in an item list
+	uint m_itemListGeneration;
+	QHash<PageItem*, int> m_itemIndexPositions;
+	QSet<int> m_itemIndexDirty;
+
+	void rebuildItemIndex();
 	
 signals:
 	//Lets make our doc talk to our GUI rather than confusing all our normal stuff
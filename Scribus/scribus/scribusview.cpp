@@ -87,6 +87,7 @@ for which a new license (GPL+exception) is in place.
 #include "pageitem_textframe.h"
 #include "pageitem_table.h"
 #include "pageitem_latexframe.h"
+#include "pagerenderer.h"
 #include "prefscontext.h"
 #include "prefsfile.h"
 #include "prefsmanager.h"
@@ -482,6 +483,8 @@ void ScribusView::changed(QRectF re, bool)
 		m_oldCanvasWidth = newCanvasWidth;
 		m_oldCanvasHeight = newCanvasHeight;
 	}
+	// interactive edits of the selection often only report the changed region
+	m_canvas->invalidateItemCache(re);
 	if (!Doc->isLoading() && !m_ScMW->scriptIsRunning())
 	{
 // 		qDebug() << "ScribusView-changed(): changed region:" << re;
@@ -2609,6 +2612,7 @@ void ScribusView::DrawNew()
 		return;
 	m_canvas->m_viewMode.forceRedraw = true;
 	m_canvas->resetRenderMode();
+	m_canvas->clearItemCache();
 	updateContents();
 	setRulerPos(contentsX(), contentsY());
 	setMenTxt(Doc->currentPage()->pageNr());
@@ -2762,213 +2766,20 @@ void ScribusView::hideSymbolPage()
 
 QImage ScribusView::MPageToPixmap(QString name, int maxGr, bool drawFrame)
 {
-	QImage pm;
-	QImage im;
-	ScLayer layer;
-	layer.isViewable = false;
-	int Nr = Doc->MasterNames[name];
-	int clipx = static_cast<int>(Doc->scratch()->Left);
-	int clipy = static_cast<int>(Doc->scratch()->Top);
-	int clipw = qRound(Doc->MasterPages.at(Nr)->width());
-	int cliph = qRound(Doc->MasterPages.at(Nr)->height());
-	if ((clipw > 0) && (cliph > 0))
-	{
-		double sca = m_canvas->scale();
-		bool frs = Doc->guidesPrefs().framesShown;
-		double cx = Doc->minCanvasCoordinate.x();
-		double cy = Doc->minCanvasCoordinate.y();
-		Doc->minCanvasCoordinate = FPoint(0, 0);
-		Page* act = Doc->currentPage();
-		bool mMode = Doc->masterPageMode();
-		Doc->setMasterPageMode(true);
-		Doc->setCurrentPage(Doc->MasterPages.at(Nr));
-		bool ctrls = Doc->guidesPrefs().showControls;
-		Doc->guidesPrefs().showControls = false;
-		Doc->guidesPrefs().framesShown = false;
-		setScale(1.0);
-		m_canvas->m_viewMode.previewMode = true;
-		m_canvas->m_viewMode.forceRedraw = true;
-		pm = QImage(clipw, cliph, QImage::Format_ARGB32_Premultiplied);
-		ScPainter *painter = new ScPainter(&pm, pm.width(), pm.height(), 1.0, 0);
-		painter->clear(Doc->paperColor());
-		painter->translate(-clipx, -clipy);
-		painter->setLineWidth(1);
-		if (drawFrame)
-		{
-			painter->setPen(Qt::black, 1, Qt::SolidLine, Qt::FlatCap, Qt::MiterJoin);
-			painter->setBrush(Doc->paperColor());
-			painter->drawRect(clipx, clipy, clipw, cliph);
-		}
-		painter->beginLayer(1.0, 0);
-		int layerCount = Doc->layerCount();
-		for (int layerLevel = 0; layerLevel < layerCount; ++layerLevel)
-		{
-			Doc->Layers.levelToLayer(layer, layerLevel);
-			m_canvas->DrawPageItems(painter, layer, QRect(clipx, clipy, clipw, cliph));
-		}
-		painter->endLayer();
-		painter->end();
-		double sx = pm.width() / static_cast<double>(maxGr);
-		double sy = pm.height() / static_cast<double>(maxGr);
-		if (sy < sx)
-			im = pm.scaled(static_cast<int>(pm.width() / sx), static_cast<int>(pm.height() / sx), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-		else
-			im = pm.scaled(static_cast<int>(pm.width() / sy), static_cast<int>(pm.height() / sy), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-		delete painter;
-		painter=NULL;
-		m_canvas->m_viewMode.previewMode = false;
-		m_canvas->m_viewMode.forceRedraw = false;
-		Doc->guidesPrefs().framesShown = frs;
-		Doc->guidesPrefs().showControls = ctrls;
-		setScale(sca);
-		Doc->setMasterPageMode(mMode);
-		Doc->setCurrentPage(act);
-		Doc->minCanvasCoordinate = FPoint(cx, cy);
-	}
-	return im;
+	if (!Doc->MasterNames.contains(name))
+		return QImage();
+	PageRenderer renderer(Doc);
+	return renderer.renderToSize(Doc->MasterPages.at(Doc->MasterNames[name]), maxGr, drawFrame);
 }
 
 QImage ScribusView::PageToPixmap(int Nr, int maxGr, bool drawFrame)
 {
-	QImage im;
-	double sx = maxGr / Doc->DocPages.at(Nr)->width();
-	double sy = maxGr / Doc->DocPages.at(Nr)->height();
-	double sc = qMin(sx, sy);
-	int clipx = static_cast<int>(Doc->DocPages.at(Nr)->xOffset() * sc);
-	int clipy = static_cast<int>(Doc->DocPages.at(Nr)->yOffset() * sc);
-	int clipw = qRound(Doc->DocPages.at(Nr)->width() * sc);
-	int cliph = qRound(Doc->DocPages.at(Nr)->height() * sc);
-	if ((clipw > 0) && (cliph > 0))
-	{
-		im = QImage(clipw, cliph, QImage::Format_ARGB32_Premultiplied);
-		if (!im.isNull())
-		{
-			double oldScale = m_canvas->scale();
-			double cx = Doc->minCanvasCoordinate.x();
-			double cy = Doc->minCanvasCoordinate.y();
-			Doc->minCanvasCoordinate = FPoint(0, 0);
-			bool oldFramesShown  = Doc->guidesPrefs().framesShown;
-			bool oldShowControls = Doc->guidesPrefs().showControls;
-			Doc->guidesPrefs().framesShown = false;
-			Doc->guidesPrefs().showControls = false;
-			m_canvas->setScale(sc);
-			m_canvas->m_viewMode.previewMode = true;
-			m_canvas->m_viewMode.forceRedraw = true;
-			Page* act = Doc->currentPage();
-			bool mMode = Doc->masterPageMode();
-			Doc->setMasterPageMode(false);
-			Doc->setLoading(true);
-			Doc->setCurrentPage(Doc->DocPages.at(Nr));
-			ScPainter *painter = new ScPainter(&im, im.width(), im.height(), 1.0, 0);
-			painter->clear(Doc->paperColor());
-			painter->translate(-clipx, -clipy);
-			painter->setFillMode(ScPainter::Solid);
-			if (drawFrame)
-			{
-				painter->setPen(Qt::black, 1, Qt::SolidLine, Qt::FlatCap, Qt::MiterJoin);
-				painter->setBrush(Doc->paperColor());
-				painter->drawRect(clipx, clipy, clipw, cliph);
-			}
-			painter->beginLayer(1.0, 0);
-			painter->setZoomFactor(m_canvas->scale());
-
-			QList<QPair<PageItem*, int> > changedList;
-			Page* page = Doc->DocPages.at(Nr);
-			PageItem* currItem;
-			if (page->FromMaster.count() != 0)
-			{
-				uint pageFromMasterCount = page->FromMaster.count();
-				for (uint a = 0; a < pageFromMasterCount; ++a)
-				{
-					currItem = page->FromMaster.at(a);
-					if (currItem->asImageFrame())
-					{
-						if (currItem->PictureIsAvailable)
-						{
-							if (currItem->pixm.imgInfo.lowResType != 0)
-							{
-								changedList.append(qMakePair(currItem, currItem->pixm.imgInfo.lowResType));
-								currItem->pixm.imgInfo.lowResType = 0;
-								int fho = currItem->imageFlippedH();
-								int fvo = currItem->imageFlippedV();
-								Doc->loadPict(currItem->Pfile, currItem, true);
-								currItem->setImageFlippedH(fho);
-								currItem->setImageFlippedV(fvo);
-							}
-						}
-					}
-				}
-			}
-			if (Doc->Items->count() != 0)
-			{
-				FPoint orig = m_canvas->localToCanvas(QPoint(clipx, clipy));
-				QRectF cullingArea = QRectF(orig.x(), orig.y(), qRound(clipw / sc + 0.5), qRound(cliph / sc + 0.5));
-				for (int it = 0; it < Doc->Items->count(); ++it)
-				{
-					currItem = Doc->Items->at(it);
-					if (cullingArea.intersects(currItem->getBoundingRect().adjusted(0.0, 0.0, 1.0, 1.0)))
-					{
-						if (currItem->asImageFrame())
-						{
-							if (currItem->PictureIsAvailable)
-							{
-								if (currItem->pixm.imgInfo.lowResType != 0)
-								{
-									changedList.append(qMakePair(currItem, currItem->pixm.imgInfo.lowResType));
-									currItem->pixm.imgInfo.lowResType = 0;
-									int fho = currItem->imageFlippedH();
-									int fvo = currItem->imageFlippedV();
-									Doc->loadPict(currItem->Pfile, currItem, true);
-									currItem->setImageFlippedH(fho);
-									currItem->setImageFlippedV(fvo);
-								}
-							}
-						}
-					}
-				}
-			}
-
-			ScLayer layer;
-			layer.isViewable = false;
-			int layerCount = Doc->layerCount();
-			for (int layerLevel = 0; layerLevel < layerCount; ++layerLevel)
-			{
-				Doc->Layers.levelToLayer(layer, layerLevel);
-				m_canvas->DrawMasterItems(painter, Doc->DocPages.at(Nr), layer, QRect(clipx, clipy, clipw, cliph));
-				m_canvas->DrawPageItems(painter, layer, QRect(clipx, clipy, clipw, cliph));
-			}
-			painter->endLayer();
-			painter->end();
-			delete painter;
-			painter=NULL;
-
-			if (changedList.count() != 0)
-			{
-				QPair<PageItem*, int> itemPair;
-				for (int it = 0; it < changedList.count(); it++)
-				{
-					itemPair = changedList.at(it);
-					currItem = itemPair.first;
-					currItem->pixm.imgInfo.lowResType = itemPair.second;
-					int fho = currItem->imageFlippedH();
-					int fvo = currItem->imageFlippedV();
-					Doc->loadPict(currItem->Pfile, currItem, true);
-					currItem->setImageFlippedH(fho);
-					currItem->setImageFlippedV(fvo);
-				}
-			}
-
-			Doc->guidesPrefs().framesShown  = oldFramesShown;
-			Doc->guidesPrefs().showControls = oldShowControls;
-			m_canvas->setScale(oldScale);
-			Doc->setMasterPageMode(mMode);
-			Doc->setCurrentPage(act);
-			Doc->setLoading(false);
-			m_canvas->m_viewMode.previewMode = false;
-			m_canvas->m_viewMode.forceRedraw = false;
-			Doc->minCanvasCoordinate = FPoint(cx, cy);
-		}
-	}
+	Page* page = Doc->DocPages.at(Nr);
+	PageRenderer renderer(Doc);
+	// images are drawn in full resolution, whatever is used on the canvas
+	PageRenderer::ImageResolutions resolutions = renderer.loadFullResolutionImages(page);
+	QImage im = renderer.renderToSize(page, maxGr, drawFrame);
+	renderer.restoreImageResolutions(resolutions);
 	return im;
 }
 #if 0
@@ -0,0 +1,179 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+
+#include <QtAlgorithms>
+#include <cmath>
+
+#include "spatialindex.h"
+
+namespace {
+
+/// Rectangles covering more grid cells than this are not stored in the grid.
+const int MaxCellsPerEntry = 64;
+/// Cell coordinates are clamped to +-CellLimit to stay within int.
+const double CellLimit = 1e6;
+
+int cellCoordinate(double value, double cellSize)
+{
+	double cell = std::floor(value / cellSize);
+	if (!(cell > -CellLimit))
+		return static_cast<int>(-CellLimit);
+	if (!(cell < CellLimit))
+		return static_cast<int>(CellLimit);
+	return static_cast<int>(cell);
+}
+
+} // namespace
+
+SpatialIndex::SpatialIndex(double cellSize) : m_cellSize(cellSize), m_count(0)
+{
+}
+
+void SpatialIndex::clear()
+{
+	m_entries.clear();
+	m_cells.clear();
+	m_large.clear();
+	m_count = 0;
+}
+
+void SpatialIndex::insert(int id, const QRectF& bounds)
+{
+	Q_ASSERT(id >= 0);
+	if (id >= m_entries.count())
+		m_entries.resize(id + 1);
+	if (m_entries[id].used)
+		removeFromCells(id);
+	else
+		++m_count;
+	m_entries[id].bounds = bounds.normalized();
+	m_entries[id].used = true;
+	addToCells(id);
+}
+
+void SpatialIndex::remove(int id)
+{
+	if (!contains(id))
+		return;
+	removeFromCells(id);
+	m_entries[id] = Entry();
+	--m_count;
+}
+
+bool SpatialIndex::contains(int id) const
+{
+	return id >= 0 && id < m_entries.count() && m_entries[id].used;
+}
+
+QRectF SpatialIndex::bounds(int id) const
+{
+	return contains(id) ? m_entries[id].bounds : QRectF();
+}
+
+QList<int> SpatialIndex::intersecting(const QRectF& area) const
+{
+	QRectF rect(area.normalized());
+	QVector<int> candidates;
+	int x1, y1, x2, y2;
+	cellRange(rect, x1, y1, x2, y2);
+	if ((static_cast<double>(x2) - x1 + 1) * (static_cast<double>(y2) - y1 + 1) > m_cells.count())
+	{
+		// looking at every cell of the area would take longer than looking at every rectangle
+		for (int id = 0; id < m_entries.count(); ++id)
+		{
+			if (m_entries[id].used)
+				candidates.append(id);
+		}
+	}
+	else
+	{
+		for (int y = y1; y <= y2; ++y)
+		{
+			for (int x = x1; x <= x2; ++x)
+			{
+				QHash<quint64, QVector<int> >::const_iterator cell = m_cells.constFind(cellKey(x, y));
+				if (cell != m_cells.constEnd())
+					candidates += cell.value();
+			}
+		}
+		candidates += m_large;
+		qSort(candidates);
+	}
+	QList<int> result;
+	int last = -1;
+	for (int i = 0; i < candidates.count(); ++i)
+	{
+		int id = candidates[i];
+		if (id == last)
+			continue;
+		last = id;
+		if (overlaps(m_entries[id].bounds, rect))
+			result.append(id);
+	}
+	return result;
+}
+
+bool SpatialIndex::overlaps(const QRectF& a, const QRectF& b)
+{
+	return qMax(a.left(), b.left()) <= qMin(a.right(), b.right())
+		&& qMax(a.top(), b.top()) <= qMin(a.bottom(), b.bottom());
+}
+
+void SpatialIndex::cellRange(const QRectF& rect, int& x1, int& y1, int& x2, int& y2) const
+{
+	x1 = cellCoordinate(rect.left(), m_cellSize);
+	y1 = cellCoordinate(rect.top(), m_cellSize);
+	x2 = cellCoordinate(rect.right(), m_cellSize);
+	y2 = cellCoordinate(rect.bottom(), m_cellSize);
+}
+
+quint64 SpatialIndex::cellKey(int x, int y)
+{
+	return (static_cast<quint64>(static_cast<quint32>(x)) << 32) | static_cast<quint32>(y);
+}
+
+void SpatialIndex::addToCells(int id)
+{
+	Entry& entry(m_entries[id]);
+	int x1, y1, x2, y2;
+	cellRange(entry.bounds, x1, y1, x2, y2);
+	entry.large = (static_cast<double>(x2) - x1 + 1) * (static_cast<double>(y2) - y1 + 1) > MaxCellsPerEntry;
+	if (entry.large)
+	{
+		m_large.append(id);
+		return;
+	}
+	for (int y = y1; y <= y2; ++y)
+	{
+		for (int x = x1; x <= x2; ++x)
+			m_cells[cellKey(x, y)].append(id);
+	}
+}
+
+void SpatialIndex::removeFromCells(int id)
+{
+	const Entry& entry(m_entries[id]);
+	if (entry.large)
+	{
+		m_large.remove(m_large.indexOf(id));
+		return;
+	}
+	int x1, y1, x2, y2;
+	cellRange(entry.bounds, x1, y1, x2, y2);
+	for (int y = y1; y <= y2; ++y)
+	{
+		for (int x = x1; x <= x2; ++x)
+		{
+			QHash<quint64, QVector<int> >::iterator cell = m_cells.find(cellKey(x, y));
+			if (cell == m_cells.end())
+				continue;
+			cell.value().remove(cell.value().indexOf(id));
+			if (cell.value().isEmpty())
+				m_cells.erase(cell);
+		}
+	}
+}
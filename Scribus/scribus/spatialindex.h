@@ -0,0 +1,72 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QRectF>
+#include <QVector>
+
+/**
+ * The SpatialIndex class finds rectangles intersecting a given area without looking at all of them.
+ *
+ * Each rectangle is stored under a small non-negative id in the cells of a uniform grid it touches.
+ * Rectangles spanning too many cells are kept in a separate list which is checked on every query.
+ * Rectangles and areas are treated as closed, so touching rectangles and rectangles of zero width
+ * or height are found as well.
+ */
+class SpatialIndex
+{
+public:
+	/// Constructs an empty index with grid cells of @a cellSize x @a cellSize.
+	explicit SpatialIndex(double cellSize = 256.0);
+
+	/// Removes all rectangles.
+	void clear();
+	/// Stores @a bounds under @a id, replacing the rectangle stored under @a id before.
+	void insert(int id, const QRectF& bounds);
+	/// Removes the rectangle stored under @a id.
+	void remove(int id);
+
+	/// Returns <code>true</code> if a rectangle is stored under @a id.
+	bool contains(int id) const;
+	/// Returns the rectangle stored under @a id, a null rectangle if there is none.
+	QRectF bounds(int id) const;
+	/// Returns the number of stored rectangles.
+	int count() const { return m_count; }
+
+	/// Returns the ids of all rectangles intersecting @a area in ascending order.
+	QList<int> intersecting(const QRectF& area) const;
+
+	/// Returns <code>true</code> if the closed rectangles @a a and @a b have a point in common.
+	static bool overlaps(const QRectF& a, const QRectF& b);
+
+private:
+	struct Entry
+	{
+		QRectF bounds;
+		bool used;
+		bool large;
+
+		Entry() : used(false), large(false) {}
+	};
+
+	/// Computes the range of grid cells covered by @a rect.
+	void cellRange(const QRectF& rect, int& x1, int& y1, int& x2, int& y2) const;
+	static quint64 cellKey(int x, int y);
+	void addToCells(int id);
+	void removeFromCells(int id);
+
+	double m_cellSize;
+	int m_count;
+	QVector<Entry> m_entries;
+	QHash<quint64, QVector<int> > m_cells;
+	QVector<int> m_large;
+};
+
+#endif // SPATIALINDEX_H
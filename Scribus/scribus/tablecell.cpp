@@ -30,10 +30,6 @@ TableCell::TableCell(int row, int column, PageItem_Table *table) : d(new TableCe
 	// The context for the internal style is the document-wide context.
 	d->style.setContext(&d->table->doc()->cellStyles());
 
-	// Create a text frame for the cell.
-	d->textFrame = new PageItem_TextFrame(d->table->m_Doc,
-		0, 0, 0, 0, 0, CommonStrings::None, CommonStrings::None);
-
 	setValid(true);
 	setRow(row);
 	setColumn(column);
@@ -62,6 +58,9 @@ QRectF TableCell::contentRect() const
 	if (!isValid())
 		return QRectF();
 
+	if (!d->textFrame)
+		return computeContentRect();
+
 	const qreal x = d->textFrame->xPos();
 	const qreal y = d->textFrame->yPos();
 	const qreal width = d->textFrame->width();
@@ -125,6 +124,23 @@ void TableCell::setStyle(const QString& style)
 }
 
 void TableCell::updateContent()
+{
+	// Cells without text frame compute their content rectangle when painted.
+	if (d->textFrame)
+		placeTextFrame();
+}
+
+void TableCell::placeTextFrame() const
+{
+	const QRectF contentRect = computeContentRect();
+
+	d->textFrame->setXYPos(contentRect.x(), contentRect.y(), true);
+	d->textFrame->setWidthHeight(contentRect.width(), contentRect.height(), true);
+	d->textFrame->updateClip();
+	d->textFrame->invalidateLayout();
+}
+
+QRectF TableCell::computeContentRect() const
 {
 	QRectF contentRect = boundingRect();
 	contentRect.setLeft(contentRect.left() + leftPadding() + maxLeftBorderWidth()/2);
@@ -132,10 +148,7 @@ void TableCell::updateContent()
 	contentRect.setWidth(qMax(contentRect.width() - (rightPadding() + maxRightBorderWidth()/2), 1.0));
 	contentRect.setHeight(qMax(contentRect.height() - (bottomPadding() + maxBottomBorderWidth()/2), 1.0));
 
-	d->textFrame->setXYPos(contentRect.x(), contentRect.y(), true);
-	d->textFrame->setWidthHeight(contentRect.width(), contentRect.height(), true);
-	d->textFrame->updateClip();
-	d->textFrame->invalidateLayout();
+	return contentRect;
 }
 
 void TableCell::setText(const QString& text)
@@ -143,10 +156,42 @@ void TableCell::setText(const QString& text)
 	if (!isValid())
 		return;
 
+	if (!d->textFrame)
+	{
+		d->text = text;
+		return;
+	}
+
 	d->textFrame->itemText.clear();
 	d->textFrame->itemText.insertChars(0, text);
 }
 
+QString TableCell::text() const
+{
+	if (!d->textFrame)
+		return d->text;
+
+	return d->textFrame->itemText.text(0, d->textFrame->itemText.length());
+}
+
+PageItem_TextFrame* TableCell::textFrame() const
+{
+	if (d->textFrame || !isValid())
+		return d->textFrame;
+
+	// Create the text frame and move the plain text into it.
+	d->textFrame = new PageItem_TextFrame(d->table->m_Doc,
+		0, 0, 0, 0, 0, CommonStrings::None, CommonStrings::None);
+	if (!d->text.isEmpty())
+	{
+		d->textFrame->itemText.insertChars(0, d->text);
+		d->text.clear();
+	}
+	placeTextFrame();
+
+	return d->textFrame;
+}
+
 QString TableCell::asString() const
 {
 	QString str("cell(");
@@ -46,6 +46,7 @@ public:
 		rowSpan(other.rowSpan),
 		columnSpan(other.columnSpan),
 		textFrame(other.textFrame),
+		text(other.text),
 		style(other.style),
 		table(other.table) {}
 	/// Destroys the cell data.
@@ -66,8 +67,10 @@ public:
 	/// Number of columns the cell spans.
 	int columnSpan;
 
-	/// Text frame of the cell.
+	/// Text frame of the cell, created when first needed.
 	PageItem_TextFrame *textFrame;
+	/// Plain text of the cell while it has no text frame.
+	QString text;
 	/// Style of the cell.
 	CellStyle style;
 	/// Table containing the cell.
@@ -85,6 +88,10 @@ public:
  * higher fidelity control over the cell content, retrieve its associated text frame
  * with <code>textFrame()</code> and work with that.
  * <p>
+ * The text frame is only created when <code>textFrame()</code> is first called, e.g.
+ * when the cell is edited. Until then the cell just keeps its plain text, which keeps
+ * very large tables with mostly plain cells small.
+ * <p>
  * A cell has a bounding rectangle. This is the rectangle on the table grid containing
  * the cell. It may be queried using the <code>boundingRect()</code> function.
  * <p>
@@ -196,8 +203,14 @@ public:
 	/// Sets the text for this cell to @a text.
 	void setText(const QString& text);
 
-	/// Returns the text frame for this cell.
-	PageItem_TextFrame* textFrame() const { return d->textFrame; }
+	/// Returns the text of this cell.
+	QString text() const;
+
+	/// Returns <code>true</code> if the text frame for this cell has been created.
+	bool hasTextFrame() const { return d->textFrame != 0; }
+
+	/// Returns the text frame for this cell, creating it if needed, or 0 if the cell is invalid.
+	PageItem_TextFrame* textFrame() const;
 
 	/// Returns the cell as a string. Useful for debugging. The format is subject to change.
 	QString asString() const;
@@ -221,6 +234,10 @@ private:
 	void setValid(bool isValid) { d->isValid = isValid; }
 	/// Updates the size and position of the cell text frame.
 	void updateContent();
+	/// Moves and resizes the cell text frame to the content rectangle.
+	void placeTextFrame() const;
+	/// Returns the bounding rectangle adjusted for paddings and borders.
+	QRectF computeContentRect() const;
 
 	/// "Move" the cell down by @a numRows. E.g. increase its row by @a numRows.
 	void moveDown(int numRows) { d->row += numRows; }
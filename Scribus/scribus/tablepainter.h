@@ -9,6 +9,8 @@ for which a new license (GPL+exception) is in place.
 #ifndef TABLEPAINTER_H
 #define TABLEPAINTER_H
 
+#include <QRectF>
+
 class PageItem_Table;
 class ScPainter;
 
@@ -25,8 +27,16 @@ public:
 	explicit TablePainter(PageItem_Table *table) : m_table(table) {};
 	virtual ~TablePainter() {};
 
-	/// Paints the table using @a p.
-	virtual void paintTable(ScPainter* p) = 0;
+	/**
+	 * Paints the table using @a p.
+	 *
+	 * Only the rows and columns intersecting @a area, given in item coordinates, are painted.
+	 * If @a area is null, the whole table is painted.
+	 */
+	virtual void paintTable(ScPainter* p, const QRectF& area) = 0;
+
+	/// Drops everything cached about the table. Called whenever cells, styles or borders change.
+	virtual void invalidate() {}
 
 	/// Returns the table this table painter is configured to paint.
 	PageItem_Table* table() const { return m_table; };
@@ -0,0 +1,167 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#include <QtTest/QtTest>
+
+#include "cellareamaptests.h"
+#include "cellareamap.h"
+
+Q_DECLARE_METATYPE(CellArea);
+
+namespace {
+
+/// Size of the table used by the benchmarks.
+const int BenchmarkRows = 2000;
+const int BenchmarkColumns = 20;
+
+/// A 5x5 table with a 2x2 area at 1,1 and a 1x3 area at 4,0.
+CellAreaMap smallTable()
+{
+	CellAreaMap map;
+	map.build(5, 5, QList<CellArea>() << CellArea(1, 1, 2, 2) << CellArea(4, 0, 3, 1));
+	return map;
+}
+
+/// Every other row of the benchmark table has its first columns merged pairwise.
+QList<CellArea> benchmarkAreas()
+{
+	QList<CellArea> areas;
+	for (int row = 0; row < BenchmarkRows; row += 2)
+	{
+		for (int column = 0; column < 10; column += 2)
+			areas.append(CellArea(row, column, 2, 1));
+	}
+	return areas;
+}
+
+/// Finds the area containing @a row, @a column the way PageItem_Table::cellAt() used to.
+CellArea linearSearch(const QList<CellArea>& areas, int row, int column)
+{
+	foreach (const CellArea& area, areas)
+	{
+		if (area.contains(row, column))
+			return area;
+	}
+	return CellArea();
+}
+
+} // namespace
+
+void CellAreaMapTests::testEmpty()
+{
+	CellAreaMap map;
+	QCOMPARE(map.rows(), 0);
+	QCOMPARE(map.columns(), 0);
+	QVERIFY(!map.areaAt(0, 0).isValid());
+
+	// A table without merged cells has no areas anywhere.
+	map.build(3, 4, QList<CellArea>());
+	QCOMPARE(map.rows(), 3);
+	QCOMPARE(map.columns(), 4);
+	QVERIFY(!map.areaAt(2, 3).isValid());
+}
+
+void CellAreaMapTests::testAreaAt()
+{
+	QFETCH(int, row);
+	QFETCH(int, column);
+	QFETCH(CellArea, expected);
+
+	QCOMPARE(smallTable().areaAt(row, column), expected);
+}
+
+void CellAreaMapTests::testAreaAt_data()
+{
+	QTest::addColumn<int>("row");
+	QTest::addColumn<int>("column");
+	QTest::addColumn<CellArea>("expected");
+
+	QTest::newRow("not merged") << 0 << 0 << CellArea();
+	QTest::newRow("spanning cell") << 1 << 1 << CellArea(1, 1, 2, 2);
+	QTest::newRow("covered cell") << 2 << 2 << CellArea(1, 1, 2, 2);
+	QTest::newRow("right of area") << 1 << 3 << CellArea();
+	QTest::newRow("below area") << 3 << 1 << CellArea();
+	QTest::newRow("last row") << 4 << 2 << CellArea(4, 0, 3, 1);
+	QTest::newRow("negative row") << -1 << 1 << CellArea();
+	QTest::newRow("column outside") << 1 << 5 << CellArea();
+	QTest::newRow("row outside") << 5 << 0 << CellArea();
+}
+
+void CellAreaMapTests::testRebuild()
+{
+	CellAreaMap map = smallTable();
+
+	// Rebuilding for a table with an inserted row moves the areas with it.
+	map.build(6, 5, QList<CellArea>() << CellArea(2, 1, 2, 2) << CellArea(5, 0, 3, 1));
+	QVERIFY(!map.areaAt(1, 1).isValid());
+	QCOMPARE(map.areaAt(3, 2), CellArea(2, 1, 2, 2));
+	QCOMPARE(map.areaAt(5, 0), CellArea(5, 0, 3, 1));
+
+	// Parts of areas outside of the table are ignored.
+	map.build(2, 2, QList<CellArea>() << CellArea(1, 1, 2, 2));
+	QCOMPARE(map.areaAt(1, 1), CellArea(1, 1, 2, 2));
+	QVERIFY(!map.areaAt(2, 2).isValid());
+
+	map.clear();
+	QCOMPARE(map.rows(), 0);
+	QVERIFY(!map.areaAt(1, 1).isValid());
+}
+
+void CellAreaMapTests::testMatchesLinearSearch()
+{
+	QList<CellArea> areas;
+	qsrand(42);
+	for (int i = 0; i < 200; ++i)
+	{
+		CellArea area(qrand() % 100, qrand() % 30, qrand() % 4 + 1, qrand() % 4 + 1);
+		bool intersects = false;
+		foreach (const CellArea& other, areas)
+			intersects = intersects || area.intersects(other);
+		if (!intersects)
+			areas.append(area);
+	}
+
+	CellAreaMap map;
+	map.build(100, 30, areas);
+	for (int row = 0; row < 100; ++row)
+	{
+		for (int column = 0; column < 30; ++column)
+			QCOMPARE(map.areaAt(row, column), linearSearch(areas, row, column));
+	}
+}
+
+void CellAreaMapTests::benchmarkLinearSearch()
+{
+	QList<CellArea> areas = benchmarkAreas();
+	int merged = 0;
+	QBENCHMARK
+	{
+		for (int row = 0; row < BenchmarkRows; row += 10)
+		{
+			for (int column = 0; column < BenchmarkColumns; ++column)
+				merged += linearSearch(areas, row, column).isValid() ? 1 : 0;
+		}
+	}
+	QVERIFY(merged > 0);
+}
+
+void CellAreaMapTests::benchmarkAreaAt()
+{
+	CellAreaMap map;
+	map.build(BenchmarkRows, BenchmarkColumns, benchmarkAreas());
+	int merged = 0;
+	QBENCHMARK
+	{
+		for (int row = 0; row < BenchmarkRows; row += 10)
+		{
+			for (int column = 0; column < BenchmarkColumns; ++column)
+				merged += map.areaAt(row, column).isValid() ? 1 : 0;
+		}
+	}
+	QVERIFY(merged > 0);
+}
+
+QTEST_APPLESS_MAIN(CellAreaMapTests)
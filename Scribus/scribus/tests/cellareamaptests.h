@@ -0,0 +1,31 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#ifndef CELLAREAMAPTESTS_H
+#define CELLAREAMAPTESTS_H
+
+#include <QtTest/QtTest>
+
+/**
+ * Unit tests and benchmarks for CellAreaMap.
+ */
+class CellAreaMapTests : public QObject
+{
+	Q_OBJECT
+public:
+	CellAreaMapTests() {}
+
+private slots:
+	void testEmpty();
+	void testAreaAt();
+	void testAreaAt_data();
+	void testRebuild();
+	void testMatchesLinearSearch();
+	void benchmarkLinearSearch();
+	void benchmarkAreaAt();
+};
+
+#endif // CELLAREAMAPTESTS_H
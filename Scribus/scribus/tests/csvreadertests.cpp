@@ -0,0 +1,107 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#include <QtTest/QtTest>
+
+#include "csvreadertests.h"
+#include "csvreader.h"
+
+typedef QList<QStringList> Records;
+Q_DECLARE_METATYPE(Records);
+
+namespace {
+
+/// Reads all records of @a input.
+Records readAll(QString input, const QChar& fieldDelimiter = QChar(','), const QChar& valueDelimiter = QChar('"'))
+{
+	QTextStream stream(&input, QIODevice::ReadOnly);
+	CsvReader reader(&stream, fieldDelimiter, valueDelimiter);
+	return reader.readAll();
+}
+
+} // namespace
+
+void CsvReaderTests::testReadAll()
+{
+	QFETCH(QString, input);
+	QFETCH(QChar, fieldDelimiter);
+	QFETCH(QChar, valueDelimiter);
+	QFETCH(Records, records);
+
+	QCOMPARE(readAll(input, fieldDelimiter, valueDelimiter), records);
+}
+
+void CsvReaderTests::testReadAll_data()
+{
+	QTest::addColumn<QString>("input");
+	QTest::addColumn<QChar>("fieldDelimiter");
+	QTest::addColumn<QChar>("valueDelimiter");
+	QTest::addColumn<Records>("records");
+
+	const QChar comma(',');
+	const QChar quote('"');
+
+	QTest::newRow("empty") << QString() << comma << quote << Records();
+	QTest::newRow("simple") << QString("a,b,c\n1,2,3\n") << comma << quote
+		<< (Records() << (QStringList() << "a" << "b" << "c") << (QStringList() << "1" << "2" << "3"));
+	QTest::newRow("no trailing line break") << QString("a,b\n1,2") << comma << quote
+		<< (Records() << (QStringList() << "a" << "b") << (QStringList() << "1" << "2"));
+	QTest::newRow("crlf") << QString("a,b\r\n1,2\r\n") << comma << quote
+		<< (Records() << (QStringList() << "a" << "b") << (QStringList() << "1" << "2"));
+	QTest::newRow("cr") << QString("a,b\r1,2\r") << comma << quote
+		<< (Records() << (QStringList() << "a" << "b") << (QStringList() << "1" << "2"));
+	QTest::newRow("empty lines") << QString("\na\n\n\nb\n\n") << comma << quote
+		<< (Records() << (QStringList() << "a") << (QStringList() << "b"));
+	QTest::newRow("empty fields") << QString(",a,,\n") << comma << quote
+		<< (Records() << (QStringList() << "" << "a" << "" << ""));
+	QTest::newRow("whitespace kept") << QString(" a , b \n") << comma << quote
+		<< (Records() << (QStringList() << " a " << " b "));
+	QTest::newRow("enclosed delimiter") << QString("\"a,b\",c\n") << comma << quote
+		<< (Records() << (QStringList() << "a,b" << "c"));
+	QTest::newRow("enclosed line break") << QString("\"a\nb\",c\nd\n") << comma << quote
+		<< (Records() << (QStringList() << "a\nb" << "c") << (QStringList() << "d"));
+	QTest::newRow("doubled quotes") << QString("\"say \"\"hi\"\"\",x\n") << comma << quote
+		<< (Records() << (QStringList() << "say \"hi\"" << "x"));
+	QTest::newRow("empty enclosed value") << QString("\"\"\n") << comma << quote
+		<< (Records() << (QStringList() << ""));
+	QTest::newRow("semicolon") << QString("a;\"b;c\"\n") << QChar(';') << quote
+		<< (Records() << (QStringList() << "a" << "b;c"));
+	QTest::newRow("tab") << QString("a\tb,c\n") << QChar('\t') << quote
+		<< (Records() << (QStringList() << "a" << "b,c"));
+	QTest::newRow("single quote") << QString("'a,b','it''s'\n") << comma << QChar('\'')
+		<< (Records() << (QStringList() << "a,b" << "it's"));
+	QTest::newRow("no value delimiter") << QString("\"a,b\"\n") << comma << QChar()
+		<< (Records() << (QStringList() << "\"a" << "b\""));
+}
+
+void CsvReaderTests::testReadRecord()
+{
+	QString input("a,b\n\n1\n");
+	QTextStream stream(&input, QIODevice::ReadOnly);
+	CsvReader reader(&stream);
+	QStringList fields;
+	QVERIFY(reader.readRecord(fields));
+	QCOMPARE(fields, QStringList() << "a" << "b");
+	QVERIFY(reader.readRecord(fields));
+	QCOMPARE(fields, QStringList() << "1");
+	QVERIFY(!reader.readRecord(fields));
+	QVERIFY(fields.isEmpty());
+}
+
+void CsvReaderTests::testLargeInput()
+{
+	// records and enclosed values crossing the blocks the stream is read in
+	QString value(100000, QChar('x'));
+	QString input;
+	for (int i = 0; i < 3; ++i)
+		input += QString("%1,\"%2\r\n%2\"\r\n").arg(i).arg(value);
+	Records records(readAll(input));
+	QCOMPARE(records.count(), 3);
+	for (int i = 0; i < 3; ++i)
+		QCOMPARE(records[i], QStringList() << QString::number(i) << value + "\r\n" + value);
+}
+
+QTEST_APPLESS_MAIN(CsvReaderTests)
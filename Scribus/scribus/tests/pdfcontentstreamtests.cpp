@@ -0,0 +1,55 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#include <QtTest/QtTest>
+
+#include "pdfcontentstreamtests.h"
+#include "pdfcontentstream.h"
+
+void PdfContentStreamTests::testNumber()
+{
+	QFETCH(double, value);
+	QFETCH(QByteArray, expected);
+	QCOMPARE(PdfContentStream::number(value), expected);
+	QCOMPARE(PdfContentStream::numberString(value), QString::fromLatin1(expected));
+}
+
+void PdfContentStreamTests::testNumber_data()
+{
+	QTest::addColumn<double>("value");
+	QTest::addColumn<QByteArray>("expected");
+	QTest::newRow("zero") << 0.0 << QByteArray("0");
+	QTest::newRow("negative zero") << -0.0 << QByteArray("0");
+	QTest::newRow("integer") << 595.0 << QByteArray("595");
+	QTest::newRow("negative integer") << -42.0 << QByteArray("-42");
+	QTest::newRow("trailing zeros") << 12.5 << QByteArray("12.5");
+	QTest::newRow("five decimals") << 0.12345 << QByteArray("0.12345");
+	QTest::newRow("rounded") << 1.999996 << QByteArray("2");
+	QTest::newRow("rounded decimals") << -3.141592 << QByteArray("-3.14159");
+	QTest::newRow("small fraction") << 0.00001 << QByteArray("0.00001");
+	QTest::newRow("negative fraction") << -0.5 << QByteArray("-0.5");
+	QTest::newRow("too small") << 0.0000001 << QByteArray("0");
+	QTest::newRow("large") << 123456789.25 << QByteArray("123456789.25");
+	QTest::newRow("clipped") << 1e20 << QByteArray("1000000000000");
+	QTest::newRow("clipped negative") << -1e20 << QByteArray("-1000000000000");
+}
+
+void PdfContentStreamTests::testOperators()
+{
+	PdfContentStream stream;
+	QVERIFY(stream.isEmpty());
+	stream << 1.0 << " 0 0 " << 1 << " " << -72.25 << " " << QString("100 cm\n") << QByteArray("q\n");
+	QCOMPARE(stream.data(), QByteArray("1 0 0 1 -72.25 100 cm\nq\n"));
+	QCOMPARE(stream.size(), stream.data().size());
+	PdfContentStream group;
+	group << "/Im" << 12u << " Do\n";
+	stream << group << "Q\n";
+	QCOMPARE(stream.data(), QByteArray("1 0 0 1 -72.25 100 cm\nq\n/Im12 Do\nQ\n"));
+	stream.clear();
+	QVERIFY(stream.isEmpty());
+}
+
+QTEST_APPLESS_MAIN(PdfContentStreamTests)
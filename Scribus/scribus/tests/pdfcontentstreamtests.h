@@ -0,0 +1,27 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#ifndef PDFCONTENTSTREAMTESTS_H
+#define PDFCONTENTSTREAMTESTS_H
+
+#include <QtTest/QtTest>
+
+/**
+ * Unit tests for PdfContentStream.
+ */
+class PdfContentStreamTests : public QObject
+{
+	Q_OBJECT
+public:
+	PdfContentStreamTests() {}
+
+private slots:
+	void testNumber();
+	void testNumber_data();
+	void testOperators();
+};
+
+#endif // PDFCONTENTSTREAMTESTS_H
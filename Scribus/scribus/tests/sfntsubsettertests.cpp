@@ -0,0 +1,253 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#include <QtTest/QtTest>
+
+#include "sfntsubsettertests.h"
+#include "fonts/sfntsubsetter.h"
+
+namespace {
+
+uint readU16(const QByteArray& data, int pos)
+{
+	return static_cast<uchar>(data[pos]) << 8 | static_cast<uchar>(data[pos + 1]);
+}
+
+quint32 readU32(const QByteArray& data, int pos)
+{
+	return static_cast<quint32>(readU16(data, pos)) << 16 | readU16(data, pos + 2);
+}
+
+void appendU16(QByteArray& data, uint value)
+{
+	data.append(static_cast<char>(value >> 8));
+	data.append(static_cast<char>(value));
+}
+
+void appendU32(QByteArray& data, quint32 value)
+{
+	appendU16(data, value >> 16);
+	appendU16(data, value & 0xFFFF);
+}
+
+/// A simple glyph with one contour, filled with @a fill after the bounding box.
+QByteArray simpleGlyph(char fill)
+{
+	QByteArray glyph;
+	appendU16(glyph, 1);
+	glyph.append(QByteArray(8, '\0'));
+	glyph.append(QByteArray(6, fill));
+	return glyph;
+}
+
+/// A composite glyph made of @a first, with word arguments, and @a second, with byte arguments.
+QByteArray compositeGlyph(uint first, uint second)
+{
+	QByteArray glyph;
+	appendU16(glyph, 0xFFFF);
+	glyph.append(QByteArray(8, '\0'));
+	appendU16(glyph, 0x0021);
+	appendU16(glyph, first);
+	appendU32(glyph, 0);
+	appendU16(glyph, 0x0000);
+	appendU16(glyph, second);
+	appendU16(glyph, 0);
+	return glyph;
+}
+
+/// Writes a font with the given tables, without checksums.
+QByteArray writeFont(const QList<QPair<QByteArray, QByteArray> >& tables)
+{
+	QByteArray font;
+	appendU32(font, 0x00010000);
+	appendU16(font, tables.count());
+	font.append(QByteArray(6, '\0'));
+	int offset = 12 + 16 * tables.count();
+	for (int i = 0; i < tables.count(); ++i)
+	{
+		font.append(tables[i].first);
+		appendU32(font, 0);
+		appendU32(font, offset);
+		appendU32(font, tables[i].second.size());
+		offset += (tables[i].second.size() + 3) & ~3;
+	}
+	for (int i = 0; i < tables.count(); ++i)
+	{
+		font.append(tables[i].second);
+		while (font.size() % 4 != 0)
+			font.append('\0');
+	}
+	return font;
+}
+
+/// Builds a TrueType font with @a glyphs and a 'GSUB' table, which is not needed for embedding.
+QByteArray makeFont(const QList<QByteArray>& glyphs, bool longLoca)
+{
+	QByteArray head(54, '\0');
+	head[51] = longLoca ? 1 : 0;
+	QByteArray maxp;
+	appendU32(maxp, 0x00005000);
+	appendU16(maxp, glyphs.count());
+	QByteArray glyf;
+	QByteArray loca;
+	foreach (const QByteArray& glyph, glyphs)
+	{
+		if (longLoca)
+			appendU32(loca, glyf.size());
+		else
+			appendU16(loca, glyf.size() / 2);
+		glyf.append(glyph);
+	}
+	if (longLoca)
+		appendU32(loca, glyf.size());
+	else
+		appendU16(loca, glyf.size() / 2);
+
+	QList<QPair<QByteArray, QByteArray> > tables;
+	tables.append(qMakePair(QByteArray("GSUB"), QByteArray(40, 'x')));
+	tables.append(qMakePair(QByteArray("cmap"), QByteArray(20, 'c')));
+	tables.append(qMakePair(QByteArray("glyf"), glyf));
+	tables.append(qMakePair(QByteArray("head"), head));
+	tables.append(qMakePair(QByteArray("loca"), loca));
+	tables.append(qMakePair(QByteArray("maxp"), maxp));
+	return writeFont(tables);
+}
+
+/// The data of the table @a tag in @a font, a null array if there is no such table.
+QByteArray table(const QByteArray& font, const char* tag)
+{
+	int numTables = readU16(font, 4);
+	for (int i = 0; i < numTables; ++i)
+	{
+		int entry = 12 + 16 * i;
+		if (font.mid(entry, 4) == tag)
+			return font.mid(readU32(font, entry + 8), readU32(font, entry + 12));
+	}
+	return QByteArray();
+}
+
+/// The outline data of glyph @a gid in @a font, with padding.
+QByteArray glyph(const QByteArray& font, uint gid)
+{
+	bool longLoca = readU16(table(font, "head"), 50) != 0;
+	QByteArray loca(table(font, "loca"));
+	quint32 start = longLoca ? readU32(loca, 4 * gid) : 2 * readU16(loca, 2 * gid);
+	quint32 end = longLoca ? readU32(loca, 4 * gid + 4) : 2 * readU16(loca, 2 * gid + 2);
+	return table(font, "glyf").mid(start, end - start);
+}
+
+quint32 checkSum(const QByteArray& data)
+{
+	QByteArray padded(data);
+	while (padded.size() % 4 != 0)
+		padded.append('\0');
+	quint32 sum = 0;
+	for (int i = 0; i < padded.size(); i += 4)
+		sum += readU32(padded, i);
+	return sum;
+}
+
+} // namespace
+
+void SfntSubsetterTests::testDropsUnusedGlyphs()
+{
+	QFETCH(bool, longLoca);
+
+	QList<QByteArray> glyphs;
+	glyphs << simpleGlyph('a') << simpleGlyph('b') << QByteArray() << simpleGlyph('d') << simpleGlyph('e');
+	QByteArray font(makeFont(glyphs, longLoca));
+	QVERIFY(SfntSubsetter::canSubset(font));
+
+	QByteArray result(SfntSubsetter::subset(font, QSet<uint>() << 3 << 2));
+	QCOMPARE(readU16(table(result, "maxp"), 4), 5u);
+	QCOMPARE(glyph(result, 0), simpleGlyph('a'));
+	QVERIFY(glyph(result, 1).isEmpty());
+	QVERIFY(glyph(result, 2).isEmpty());
+	QCOMPARE(glyph(result, 3), simpleGlyph('d'));
+	QVERIFY(glyph(result, 4).isEmpty());
+	QCOMPARE(table(result, "glyf").size(), 2 * simpleGlyph('a').size());
+}
+
+void SfntSubsetterTests::testDropsUnusedGlyphs_data()
+{
+	QTest::addColumn<bool>("longLoca");
+	QTest::newRow("short offsets") << false;
+	QTest::newRow("long offsets") << true;
+}
+
+void SfntSubsetterTests::testKeepsComponents()
+{
+	QList<QByteArray> glyphs;
+	glyphs << simpleGlyph('a') << simpleGlyph('b') << simpleGlyph('c') << compositeGlyph(1, 4)
+		<< compositeGlyph(2, 2) << simpleGlyph('f');
+	QByteArray result(SfntSubsetter::subset(makeFont(glyphs, true), QSet<uint>() << 3));
+	QCOMPARE(glyph(result, 1), simpleGlyph('b'));
+	QCOMPARE(glyph(result, 2), simpleGlyph('c'));
+	QCOMPARE(glyph(result, 3), compositeGlyph(1, 4));
+	QCOMPARE(glyph(result, 4), compositeGlyph(2, 2));
+	QVERIFY(glyph(result, 5).isEmpty());
+}
+
+void SfntSubsetterTests::testIgnoresUnknownGlyphs()
+{
+	QList<QByteArray> glyphs;
+	glyphs << simpleGlyph('a') << simpleGlyph('b');
+	QByteArray result(SfntSubsetter::subset(makeFont(glyphs, true), QSet<uint>() << 2 << 1000 << 0x10000));
+	QCOMPARE(glyph(result, 0), simpleGlyph('a'));
+	QVERIFY(glyph(result, 1).isEmpty());
+}
+
+void SfntSubsetterTests::testChecksums()
+{
+	QList<QByteArray> glyphs;
+	glyphs << simpleGlyph('a') << simpleGlyph('b') << compositeGlyph(1, 1);
+	QByteArray result(SfntSubsetter::subset(makeFont(glyphs, false), QSet<uint>() << 1));
+	int numTables = readU16(result, 4);
+	QCOMPARE(readU16(result, 6), 4u * 16);
+	QCOMPARE(readU16(result, 8), 2u);
+	QCOMPARE(readU16(result, 10), numTables * 16 - 4u * 16);
+	for (int i = 0; i < numTables; ++i)
+	{
+		int entry = 12 + 16 * i;
+		QByteArray data(result.mid(readU32(result, entry + 8), readU32(result, entry + 12)));
+		if (result.mid(entry, 4) == "head")
+			data.replace(8, 4, QByteArray(4, '\0'));
+		QCOMPARE(readU32(result, entry + 4), checkSum(data));
+	}
+	QCOMPARE(checkSum(result), 0xB1B0AFBAu);
+}
+
+void SfntSubsetterTests::testDropsUnneededTables()
+{
+	QList<QByteArray> glyphs;
+	glyphs << simpleGlyph('a') << simpleGlyph('b');
+	QByteArray result(SfntSubsetter::subset(makeFont(glyphs, true), QSet<uint>() << 1));
+	QCOMPARE(readU16(result, 4), 5u);
+	QVERIFY(table(result, "GSUB").isNull());
+	QCOMPARE(table(result, "cmap"), QByteArray(20, 'c'));
+}
+
+void SfntSubsetterTests::testUnsupportedFonts()
+{
+	// CFF based fonts have no 'glyf' table
+	QList<QPair<QByteArray, QByteArray> > tables;
+	tables.append(qMakePair(QByteArray("CFF "), QByteArray(40, 'x')));
+	tables.append(qMakePair(QByteArray("head"), QByteArray(54, '\0')));
+	QByteArray cff(writeFont(tables));
+	QVERIFY(!SfntSubsetter::canSubset(cff));
+	QCOMPARE(SfntSubsetter::subset(cff, QSet<uint>() << 1), cff);
+
+	QList<QByteArray> glyphs;
+	glyphs << simpleGlyph('a') << simpleGlyph('b');
+	QByteArray truncated(makeFont(glyphs, true).left(100));
+	QVERIFY(!SfntSubsetter::canSubset(truncated));
+	QCOMPARE(SfntSubsetter::subset(truncated, QSet<uint>() << 1), truncated);
+
+	QByteArray broken(makeFont(glyphs << compositeGlyph(1, 1).left(12), true));
+	QCOMPARE(SfntSubsetter::subset(broken, QSet<uint>() << 2), broken);
+}
+
+QTEST_APPLESS_MAIN(SfntSubsetterTests)
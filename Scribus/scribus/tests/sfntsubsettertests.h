@@ -0,0 +1,31 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#ifndef SFNTSUBSETTERTESTS_H
+#define SFNTSUBSETTERTESTS_H
+
+#include <QtTest/QtTest>
+
+/**
+ * Unit tests for SfntSubsetter.
+ */
+class SfntSubsetterTests : public QObject
+{
+	Q_OBJECT
+public:
+	SfntSubsetterTests() {}
+
+private slots:
+	void testDropsUnusedGlyphs();
+	void testDropsUnusedGlyphs_data();
+	void testKeepsComponents();
+	void testIgnoresUnknownGlyphs();
+	void testChecksums();
+	void testDropsUnneededTables();
+	void testUnsupportedFonts();
+};
+
+#endif // SFNTSUBSETTERTESTS_H
@@ -0,0 +1,133 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#include <QtTest/QtTest>
+
+#include "spatialindextests.h"
+#include "spatialindex.h"
+
+Q_DECLARE_METATYPE(QList<int>)
+
+namespace {
+
+/// Three 10x10 squares in a row and a zero width line far below them, in cells of 100x100.
+SpatialIndex rowOfSquares()
+{
+	SpatialIndex index(100.0);
+	index.insert(0, QRectF(0, 0, 10, 10));
+	index.insert(1, QRectF(95, 0, 10, 10));
+	index.insert(2, QRectF(300, 0, 10, 10));
+	index.insert(3, QRectF(50, 1000, 0, 50));
+	return index;
+}
+
+} // namespace
+
+void SpatialIndexTests::testEmpty()
+{
+	SpatialIndex index;
+	QCOMPARE(index.count(), 0);
+	QVERIFY(!index.contains(0));
+	QVERIFY(index.bounds(0).isNull());
+	QVERIFY(index.intersecting(QRectF(-1e6, -1e6, 2e6, 2e6)).isEmpty());
+}
+
+void SpatialIndexTests::testInsertRemove()
+{
+	SpatialIndex index(100.0);
+	index.insert(5, QRectF(0, 0, 10, 10));
+	QCOMPARE(index.count(), 1);
+	QVERIFY(index.contains(5));
+	QVERIFY(!index.contains(4));
+	QCOMPARE(index.bounds(5), QRectF(0, 0, 10, 10));
+
+	// Inserting under the same id moves the rectangle.
+	index.insert(5, QRectF(500, 500, 10, 10));
+	QCOMPARE(index.count(), 1);
+	QVERIFY(index.intersecting(QRectF(0, 0, 10, 10)).isEmpty());
+	QCOMPARE(index.intersecting(QRectF(505, 505, 1, 1)), QList<int>() << 5);
+
+	// Rectangles with negative sizes are normalized.
+	index.insert(6, QRectF(20, 20, -10, -10));
+	QCOMPARE(index.bounds(6), QRectF(10, 10, 10, 10));
+
+	index.remove(5);
+	index.remove(7);
+	QCOMPARE(index.count(), 1);
+	QVERIFY(index.intersecting(QRectF(505, 505, 1, 1)).isEmpty());
+
+	index.clear();
+	QCOMPARE(index.count(), 0);
+	QVERIFY(!index.contains(6));
+}
+
+void SpatialIndexTests::testIntersecting()
+{
+	QFETCH(QRectF, area);
+	QFETCH(QList<int>, expected);
+
+	QCOMPARE(rowOfSquares().intersecting(area), expected);
+}
+
+void SpatialIndexTests::testIntersecting_data()
+{
+	QTest::addColumn<QRectF>("area");
+	QTest::addColumn<QList<int> >("expected");
+
+	QTest::newRow("nothing") << QRectF(20, 20, 10, 10) << QList<int>();
+	QTest::newRow("one") << QRectF(2, 2, 1, 1) << (QList<int>() << 0);
+	QTest::newRow("across cells") << QRectF(5, 5, 95, 1) << (QList<int>() << 0 << 1);
+	QTest::newRow("touching") << QRectF(10, 10, 85, 5) << (QList<int>() << 0 << 1);
+	QTest::newRow("point") << QRectF(300, 0, 0, 0) << (QList<int>() << 2);
+	QTest::newRow("zero width item") << QRectF(40, 1010, 20, 1) << (QList<int>() << 3);
+	QTest::newRow("everything") << QRectF(-10, -10, 400, 1100) << (QList<int>() << 0 << 1 << 2 << 3);
+	QTest::newRow("negative size") << QRectF(10, 10, -10, -10) << (QList<int>() << 0);
+}
+
+void SpatialIndexTests::testLargeRectangles()
+{
+	SpatialIndex index(10.0);
+	index.insert(0, QRectF(0, 0, 1000, 1000));
+	index.insert(1, QRectF(500, 500, 1, 1));
+	QCOMPARE(index.intersecting(QRectF(500, 500, 1, 1)), QList<int>() << 0 << 1);
+	QCOMPARE(index.intersecting(QRectF(900, 900, 1, 1)), QList<int>() << 0);
+	QVERIFY(index.intersecting(QRectF(1001, 0, 1, 1)).isEmpty());
+
+	index.remove(0);
+	QCOMPARE(index.intersecting(QRectF(0, 0, 1000, 1000)), QList<int>() << 1);
+}
+
+void SpatialIndexTests::testMatchesLinearSearch()
+{
+	SpatialIndex index(50.0);
+	QList<QRectF> rects;
+	qsrand(42);
+	for (int i = 0; i < 500; ++i)
+	{
+		QRectF rect(qrand() % 2000 - 1000, qrand() % 2000 - 1000, qrand() % 300, qrand() % 300);
+		rects.append(rect);
+		index.insert(i, rect);
+	}
+	// move some of them around
+	for (int i = 0; i < 500; i += 7)
+	{
+		rects[i].translate(qrand() % 200 - 100, qrand() % 200 - 100);
+		index.insert(i, rects[i]);
+	}
+	for (int q = 0; q < 100; ++q)
+	{
+		QRectF area(qrand() % 2400 - 1200, qrand() % 2400 - 1200, qrand() % 400, qrand() % 400);
+		QList<int> expected;
+		for (int i = 0; i < rects.count(); ++i)
+		{
+			if (SpatialIndex::overlaps(rects[i], area))
+				expected.append(i);
+		}
+		QCOMPARE(index.intersecting(area), expected);
+	}
+}
+
+QTEST_APPLESS_MAIN(SpatialIndexTests)
@@ -0,0 +1,30 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#ifndef SPATIALINDEXTESTS_H
+#define SPATIALINDEXTESTS_H
+
+#include <QtTest/QtTest>
+
+/**
+ * Unit tests for SpatialIndex.
+ */
+class SpatialIndexTests : public QObject
+{
+	Q_OBJECT
+public:
+	SpatialIndexTests() {}
+
+private slots:
+	void testEmpty();
+	void testInsertRemove();
+	void testIntersecting();
+	void testIntersecting_data();
+	void testLargeRectangles();
+	void testMatchesLinearSearch();
+};
+
+#endif // SPATIALINDEXTESTS_H
@@ -127,3 +127,91 @@ void TestStoryText::removeCharStyle()
 	QCOMPARE(story.startOfRun(2), 5  + 26 + 1);
 	QCOMPARE(story.endOfRun(2), 11 + 26);
 }
+
+void TestStoryText::longStoryParagraphs()
+{
+	// 10000 paragraphs of 100 chars each
+	QString paragraph = QString(99, QChar('x')) + SpecialChars::PARSEP;
+	QString txt;
+	txt.reserve(100 * 10000);
+	for (int i = 0; i < 10000; ++i)
+		txt += paragraph;
+	StoryText story;
+	story.insertChars(0, txt);
+	QCOMPARE(story.length(), 1000000);
+	QCOMPARE(story.nrOfParagraphs(), 10000u);
+
+	QTime timer;
+	timer.start();
+	for (int i = 0; i < 100000; ++i)
+	{
+		int pos = (i * 7919) % story.length();
+		uint par = story.nrOfParagraph(pos);
+		QCOMPARE(par, uint(pos / 100));
+		QCOMPARE(story.startOfParagraph(par), int(par * 100));
+		QCOMPARE(story.endOfParagraph(par), int(par * 100 + 99));
+		story.paragraphStyle(pos);
+	}
+	// a linear scan per query would take minutes here
+	QVERIFY(timer.elapsed() < 5000);
+
+	// edits in the middle keep the index up to date
+	story.insertChars(500050, QString("abc") + SpecialChars::PARSEP);
+	QCOMPARE(story.nrOfParagraphs(), 10001u);
+	QCOMPARE(story.nrOfParagraph(500055), 5001u);
+	QCOMPARE(story.startOfParagraph(5001), 500054);
+	QCOMPARE(story.endOfParagraph(5001), 500103);
+	story.removeChars(500099, 10);
+	QCOMPARE(story.nrOfParagraphs(), 10000u);
+	QCOMPARE(story.endOfParagraph(5001), 500193);
+	QCOMPARE(story.nextParagraph(0), 99);
+	QCOMPARE(story.prevParagraph(250), 199);
+
+	// splitting and joining paragraphs does not rebuild the index
+	timer.restart();
+	for (int i = 0; i < 2000; ++i)
+		story.insertChars(300000, QString("x") + SpecialChars::PARSEP);
+	QCOMPARE(story.nrOfParagraphs(), 12000u);
+	QCOMPARE(story.startOfParagraph(3001), 300002);
+	for (int i = 0; i < 2000; ++i)
+		story.removeChars(300000, 2);
+	QCOMPARE(story.nrOfParagraphs(), 10000u);
+	QCOMPARE(story.startOfParagraph(3001), 300100);
+	QVERIFY(timer.elapsed() < 5000);
+}
+
+void TestStoryText::bulkEdits()
+{
+	QString paragraph = QString(99, QChar('x')) + SpecialChars::PARSEP;
+	QString txt;
+	for (int i = 0; i < 1000; ++i)
+		txt += paragraph;
+	StoryText story;
+	story.insertChars(0, txt);
+	ParagraphStyle ps;
+	ps.setLineSpacing(42);
+	story.applyStyle(0, ps);
+
+	QTime timer;
+	timer.start();
+	// paste 100 paragraphs into the middle, 100 times
+	QString block = QString(100, QChar('y')) + SpecialChars::PARSEP;
+	block = block.repeated(100);
+	for (int i = 0; i < 100; ++i)
+		story.insertChars(50, block);
+	QCOMPARE(story.length(), 100000 + 100 * block.length());
+	QCOMPARE(story.nrOfParagraphs(), 1000u + 100 * 100);
+	QCOMPARE(story.text(50, 101), QString(100, QChar('y')) + SpecialChars::PARSEP);
+	// the new paragraphs take the style of the one they were pasted into
+	QCOMPARE(story.paragraphStyle(0).lineSpacing(), 42.0);
+	QCOMPARE(story.paragraphStyle(50 + 100 * block.length() - 1).lineSpacing(), 42.0);
+	for (int i = 0; i < 100; ++i)
+		story.removeChars(50, block.length());
+	// each edit used to move the tail of the story once per char
+	QVERIFY(timer.elapsed() < 10000);
+	QCOMPARE(story.text(0, story.length()), txt);
+	QCOMPARE(story.nrOfParagraphs(), 1000u);
+	QCOMPARE(story.endOfParagraph(500), 500 * 100 + 99);
+	QCOMPARE(story.paragraphStyle(0).lineSpacing(), 42.0);
+	QVERIFY(story.paragraphStyle(100).lineSpacing() != 42.0);
+}
@@ -0,0 +1,204 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#include <QtTest/QtTest>
+
+#include "textwrapshapetests.h"
+#include "textwrapshape.h"
+
+namespace {
+
+QList<QPolygonF> rect(double x, double y, double w, double h)
+{
+	return QList<QPolygonF>() << QPolygonF(QRectF(x, y, w, h));
+}
+
+QList<QPolygonF> triangle(const QPointF& a, const QPointF& b, const QPointF& c)
+{
+	return QList<QPolygonF>() << (QPolygonF() << a << b << c);
+}
+
+/// A 100x100 frame with a 20x20 obstacle in its middle.
+TextWrapShape frameWithHole()
+{
+	TextWrapShape shape;
+	shape.setFrame(rect(0, 0, 100, 100));
+	shape.addObstacle(rect(40, 40, 20, 20));
+	return shape;
+}
+
+} // namespace
+
+void TextWrapShapeTests::testEmpty()
+{
+	TextWrapShape shape;
+	QVERIFY(shape.isEmpty());
+	QVERIFY(!shape.contains(QPointF(0, 0)));
+	QVERIFY(shape.spansAt(0).isEmpty());
+
+	shape.setFrame(rect(0, 0, 10, 10));
+	QVERIFY(!shape.isEmpty());
+
+	// Obstacles outside of the frame are dropped.
+	shape.addObstacle(rect(20, 20, 10, 10));
+	QCOMPARE(shape.obstacleCount(), 0);
+
+	shape.clear();
+	QVERIFY(shape.isEmpty());
+}
+
+void TextWrapShapeTests::testComparison()
+{
+	QVERIFY(frameWithHole() == frameWithHole());
+
+	TextWrapShape other;
+	other.setFrame(rect(0, 0, 100, 100));
+	QVERIFY(frameWithHole() != other);
+	other.addObstacle(rect(40, 40, 20, 21));
+	QVERIFY(frameWithHole() != other);
+}
+
+void TextWrapShapeTests::testContainsPoint_data()
+{
+	QTest::addColumn<QPointF>("point");
+	QTest::addColumn<bool>("contains");
+
+	QTest::newRow("inside") << QPointF(10, 10) << true;
+	QTest::newRow("left of hole") << QPointF(39.5, 50) << true;
+	QTest::newRow("in hole") << QPointF(50, 50) << false;
+	QTest::newRow("right of hole") << QPointF(60.5, 50) << true;
+	QTest::newRow("above hole") << QPointF(50, 39.5) << true;
+	QTest::newRow("outside frame") << QPointF(150, 50) << false;
+	QTest::newRow("above frame") << QPointF(50, -1) << false;
+}
+
+void TextWrapShapeTests::testContainsPoint()
+{
+	QFETCH(QPointF, point);
+	QFETCH(bool, contains);
+
+	TextWrapShape shape = frameWithHole();
+	QCOMPARE(shape.contains(point), contains);
+	// Second query is answered from the cache.
+	QCOMPARE(shape.contains(point), contains);
+}
+
+void TextWrapShapeTests::testSpansAt()
+{
+	TextWrapShape shape = frameWithHole();
+
+	WrapSpans spans = shape.spansAt(50);
+	QCOMPARE(spans.count(), 2);
+	QCOMPARE(spans[0], WrapSpan(0, 40));
+	QCOMPARE(spans[1], WrapSpan(60, 100));
+
+	spans = shape.spansAt(10);
+	QCOMPARE(spans.count(), 1);
+	QCOMPARE(spans[0], WrapSpan(0, 100));
+
+	// Sloped edges are not rounded to whole points.
+	TextWrapShape slope;
+	slope.setFrame(triangle(QPointF(0, 0), QPointF(100, 0), QPointF(0, 100)));
+	spans = slope.spansAt(25);
+	QCOMPARE(spans.count(), 1);
+	QCOMPARE(spans[0], WrapSpan(0, 75));
+	spans = slope.spansAt(25.5);
+	QCOMPARE(spans[0], WrapSpan(0, 74.5));
+}
+
+void TextWrapShapeTests::testSpans()
+{
+	TextWrapShape shape = frameWithHole();
+
+	// Band touching the hole.
+	WrapSpans spans = shape.spans(30, 45);
+	QCOMPARE(spans.count(), 2);
+	QCOMPARE(spans[0], WrapSpan(0, 40));
+	QCOMPARE(spans[1], WrapSpan(60, 100));
+
+	// Band above the hole.
+	spans = shape.spans(10, 30);
+	QCOMPARE(spans.count(), 1);
+	QCOMPARE(spans[0], WrapSpan(0, 100));
+
+	// A sloped frame edge reduces the span to the narrowest part of the band.
+	TextWrapShape slope;
+	slope.setFrame(triangle(QPointF(0, 0), QPointF(100, 0), QPointF(0, 100)));
+	spans = slope.spans(20, 30);
+	QCOMPARE(spans.count(), 1);
+	QCOMPARE(spans[0], WrapSpan(0, 70));
+
+	// A small obstacle between top and bottom blocks the band.
+	TextWrapShape dot;
+	dot.setFrame(rect(0, 0, 100, 100));
+	dot.addObstacle(rect(50, 52, 1, 1));
+	QCOMPARE(dot.spansAt(50).count(), 1);
+	spans = dot.spans(50, 55);
+	QCOMPARE(spans.count(), 2);
+	QCOMPARE(spans[0], WrapSpan(0, 50));
+	QCOMPARE(spans[1], WrapSpan(51, 100));
+}
+
+void TextWrapShapeTests::testClippedObstacle()
+{
+	TextWrapShape shape;
+	shape.setFrame(rect(0, 0, 100, 100));
+	// only the part of the obstacle inside of the clip blocks text
+	shape.addObstacle(rect(20, 20, 60, 60), rect(50, 0, 100, 100));
+	QVERIFY(shape.contains(QPointF(30, 50)));
+	QVERIFY(!shape.contains(QPointF(60, 50)));
+
+	WrapSpans spans = shape.spansAt(50);
+	QCOMPARE(spans.count(), 2);
+	QCOMPARE(spans[0], WrapSpan(0, 50));
+	QCOMPARE(spans[1], WrapSpan(80, 100));
+}
+
+void TextWrapShapeTests::testFreeUntil()
+{
+	TextWrapShape shape = frameWithHole();
+
+	// The whole i-beam is free until the hole.
+	QCOMPARE(shape.freeUntil(10, 45, 50), 40.0);
+	// Only the lower end hits the hole.
+	QCOMPARE(shape.freeUntil(10, 30, 50), 40.0);
+	// Neither end hits the hole, but the part in between does.
+	QCOMPARE(shape.freeUntil(10, 30, 70), 40.0);
+	// Starting in the hole.
+	QCOMPARE(shape.freeUntil(50, 45, 50), 50.0);
+	// Starting behind the hole.
+	QCOMPARE(shape.freeUntil(70, 45, 50), 100.0);
+}
+
+void TextWrapShapeTests::testFits()
+{
+	TextWrapShape shape = frameWithHole();
+
+	QVERIFY(shape.fits(10, 30, 70));
+	QVERIFY(!shape.fits(50, 30, 70));
+	QVERIFY(shape.fits(50, 10, 30));
+	QVERIFY(!shape.fits(10, -5, 10));
+
+	QCOMPARE(shape.nextFit(10, 30, 70), 10.0);
+	QCOMPARE(shape.nextFit(45, 30, 70), 60.0);
+	// Nothing fits behind the frame.
+	QCOMPARE(shape.nextFit(45, 90, 110), 100.0);
+}
+
+void TextWrapShapeTests::testFrameUnion()
+{
+	// Overlapping parts of the frame don't cancel out.
+	TextWrapShape shape;
+	shape.setFrame(rect(0, 0, 60, 100) + rect(40, 0, 60, 100));
+	QVERIFY(shape.contains(QPointF(50, 50)));
+	WrapSpans spans = shape.spansAt(50);
+	QCOMPARE(spans.count(), 1);
+	QCOMPARE(spans[0].left, 0.0);
+	QCOMPARE(spans[0].right, 100.0);
+	QVERIFY(shape.fits(50, 20, 80));
+}
+
+QTEST_APPLESS_MAIN(TextWrapShapeTests)
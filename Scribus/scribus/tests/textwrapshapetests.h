@@ -0,0 +1,34 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#ifndef TEXTWRAPSHAPETESTS_H
+#define TEXTWRAPSHAPETESTS_H
+
+#include <QtTest/QtTest>
+
+/**
+ * Unit tests for TextWrapShape.
+ */
+class TextWrapShapeTests : public QObject
+{
+	Q_OBJECT
+public:
+	TextWrapShapeTests() {}
+
+private slots:
+	void testEmpty();
+	void testComparison();
+	void testContainsPoint();
+	void testContainsPoint_data();
+	void testSpansAt();
+	void testSpans();
+	void testClippedObstacle();
+	void testFreeUntil();
+	void testFits();
+	void testFrameUnion();
+};
+
+#endif // TEXTWRAPSHAPETESTS_H
@@ -0,0 +1,351 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <cassert>
+
+#include "paragraphindex.h"
+
+
+ParagraphIndex::ParagraphIndex() : m_root(-1), m_length(0), m_seed(2463534242u)
+{
+	clear();
+}
+
+
+void ParagraphIndex::clear()
+{
+	m_nodes.clear();
+	m_freeNodes.clear();
+	m_root = newNode(0);
+	m_length = 0;
+}
+
+
+void ParagraphIndex::reset(const QVector<int>& separatorPositions, int length)
+{
+	QVector<int> lengths;
+	lengths.reserve(separatorPositions.count() + 1);
+	int start = 0;
+	for (int i = 0; i < separatorPositions.count(); ++i)
+	{
+		assert(separatorPositions[i] >= start);
+		lengths.append(separatorPositions[i] + 1 - start);
+		start = separatorPositions[i] + 1;
+	}
+	assert(length >= start);
+	lengths.append(length - start);
+	m_nodes.clear();
+	m_freeNodes.clear();
+	m_root = build(lengths);
+	m_length = length;
+}
+
+
+int ParagraphIndex::trailingLength() const
+{
+	int node = m_root;
+	while (m_nodes[node].right >= 0)
+		node = m_nodes[node].right;
+	return m_nodes[node].length;
+}
+
+
+int ParagraphIndex::separatorsBefore(int pos) const
+{
+	return qMin(segmentsUpTo(pos), separators());
+}
+
+
+int ParagraphIndex::startOfSegment(int index) const
+{
+	if (index <= 0)
+		return 0;
+	if (index > separators())
+		return m_length;
+	return prefix(index);
+}
+
+
+int ParagraphIndex::nextSeparator(int pos) const
+{
+	int index = separatorsBefore(pos);
+	return index < separators() ? separatorPos(index) : -1;
+}
+
+
+void ParagraphIndex::insertChars(int pos, int count)
+{
+	int segment = separatorsBefore(pos);
+	m_length += count;
+	add(segment, count);
+}
+
+
+void ParagraphIndex::removeChars(int pos, int count)
+{
+	int segment = separatorsBefore(pos);
+	assert(segmentLength(segment) - count >= (segment < separators() ? 1 : 0));
+	m_length -= count;
+	add(segment, -count);
+}
+
+
+void ParagraphIndex::insertSeparator(int pos)
+{
+	int segment = separatorsBefore(pos);
+	int head = pos - prefix(segment);
+	int tail = segmentLength(segment) - head;
+	add(segment, head + 1 - segmentLength(segment));
+	int left, right;
+	split(m_root, segment + 1, left, right);
+	m_root = merge(merge(left, newNode(tail)), right);
+	++m_length;
+}
+
+
+void ParagraphIndex::removeSeparator(int pos)
+{
+	int segment = separatorsBefore(pos);
+	assert(segment < separators());
+	assert(separatorPos(segment) == pos);
+	add(segment, segmentLength(segment + 1) - 1);
+	int left, middle, right;
+	split(m_root, segment + 1, left, right);
+	split(right, 1, middle, right);
+	freeTree(middle);
+	m_root = merge(left, right);
+	--m_length;
+}
+
+
+void ParagraphIndex::replace(int pos, int removed, int inserted, const QVector<int>& separatorOffsets)
+{
+	// the segments touched by the removed chars are replaced by new ones,
+	// the first and the last keep the chars in front of and behind the block
+	int first = separatorsBefore(pos);
+	int last = separatorsBefore(pos + removed);
+	int head = pos - prefix(first);
+	int tail = prefix(last + 1) - pos - removed;
+	QVector<int> lengths;
+	lengths.reserve(separatorOffsets.count() + 1);
+	int start = -head;
+	for (int i = 0; i < separatorOffsets.count(); ++i)
+	{
+		assert(separatorOffsets[i] >= qMax(start, 0) && separatorOffsets[i] < inserted);
+		lengths.append(separatorOffsets[i] + 1 - start);
+		start = separatorOffsets[i] + 1;
+	}
+	lengths.append(inserted - start + tail);
+	int left, middle, right;
+	split(m_root, first, left, right);
+	split(right, last - first + 1, middle, right);
+	freeTree(middle);
+	m_root = merge(merge(left, build(lengths)), right);
+	m_length += inserted - removed;
+}
+
+
+int ParagraphIndex::prefix(int count) const
+{
+	int result = 0;
+	int node = m_root;
+	while (node >= 0 && count > 0)
+	{
+		const Node& n(m_nodes[node]);
+		int leftCount = this->count(n.left);
+		if (count <= leftCount)
+			node = n.left;
+		else
+		{
+			result += sum(n.left) + n.length;
+			count -= leftCount + 1;
+			node = n.right;
+		}
+	}
+	return result;
+}
+
+
+int ParagraphIndex::segmentsUpTo(int pos) const
+{
+	int result = 0;
+	int node = m_root;
+	while (node >= 0)
+	{
+		const Node& n(m_nodes[node]);
+		int leftSum = sum(n.left);
+		if (pos < leftSum)
+			node = n.left;
+		else if (pos < leftSum + n.length)
+			return result + count(n.left);
+		else
+		{
+			pos -= leftSum + n.length;
+			result += count(n.left) + 1;
+			node = n.right;
+		}
+	}
+	return result;
+}
+
+
+int ParagraphIndex::segmentLength(int segment) const
+{
+	int node = m_root;
+	while (node >= 0)
+	{
+		const Node& n(m_nodes[node]);
+		int leftCount = count(n.left);
+		if (segment < leftCount)
+			node = n.left;
+		else if (segment == leftCount)
+			return n.length;
+		else
+		{
+			segment -= leftCount + 1;
+			node = n.right;
+		}
+	}
+	return 0;
+}
+
+
+void ParagraphIndex::add(int segment, int delta)
+{
+	int node = m_root;
+	while (node >= 0)
+	{
+		Node& n(m_nodes[node]);
+		n.sum += delta;
+		int leftCount = count(n.left);
+		if (segment < leftCount)
+			node = n.left;
+		else if (segment == leftCount)
+		{
+			n.length += delta;
+			return;
+		}
+		else
+		{
+			segment -= leftCount + 1;
+			node = n.right;
+		}
+	}
+}
+
+
+int ParagraphIndex::newNode(int length)
+{
+	// xorshift, the priorities only have to look random
+	m_seed ^= m_seed << 13;
+	m_seed ^= m_seed >> 17;
+	m_seed ^= m_seed << 5;
+	Node n;
+	n.length = n.sum = length;
+	n.count = 1;
+	n.left = n.right = -1;
+	n.priority = m_seed;
+	if (!m_freeNodes.isEmpty())
+	{
+		int node = m_freeNodes.last();
+		m_freeNodes.pop_back();
+		m_nodes[node] = n;
+		return node;
+	}
+	m_nodes.append(n);
+	return m_nodes.count() - 1;
+}
+
+
+void ParagraphIndex::freeTree(int node)
+{
+	if (node < 0)
+		return;
+	freeTree(m_nodes[node].left);
+	freeTree(m_nodes[node].right);
+	m_freeNodes.append(node);
+}
+
+
+void ParagraphIndex::update(int node)
+{
+	Node& n(m_nodes[node]);
+	n.sum = sum(n.left) + n.length + sum(n.right);
+	n.count = count(n.left) + 1 + count(n.right);
+}
+
+
+void ParagraphIndex::split(int node, int count, int& left, int& right)
+{
+	if (node < 0)
+	{
+		left = right = -1;
+		return;
+	}
+	int leftCount = this->count(m_nodes[node].left);
+	if (count <= leftCount)
+	{
+		int l;
+		split(m_nodes[node].left, count, left, l);
+		m_nodes[node].left = l;
+		right = node;
+	}
+	else
+	{
+		int r;
+		split(m_nodes[node].right, count - leftCount - 1, r, right);
+		m_nodes[node].right = r;
+		left = node;
+	}
+	update(node);
+}
+
+
+int ParagraphIndex::merge(int left, int right)
+{
+	if (left < 0)
+		return right;
+	if (right < 0)
+		return left;
+	if (m_nodes[left].priority > m_nodes[right].priority)
+	{
+		int r = merge(m_nodes[left].right, right);
+		m_nodes[left].right = r;
+		update(left);
+		return left;
+	}
+	int l = merge(left, m_nodes[right].left);
+	m_nodes[right].left = l;
+	update(right);
+	return right;
+}
+
+
+int ParagraphIndex::build(const QVector<int>& lengths)
+{
+	// the stack holds the right spine of the tree built so far, nodes
+	// popped from it are complete
+	QVector<int> spine;
+	for (int i = 0; i < lengths.count(); ++i)
+	{
+		int node = newNode(lengths[i]);
+		int last = -1;
+		while (!spine.isEmpty() && m_nodes[spine.last()].priority < m_nodes[node].priority)
+		{
+			last = spine.last();
+			spine.pop_back();
+			update(last);
+		}
+		m_nodes[node].left = last;
+		if (!spine.isEmpty())
+			m_nodes[spine.last()].right = node;
+		spine.append(node);
+	}
+	for (int i = spine.count() - 1; i >= 0; --i)
+		update(spine[i]);
+	return spine.isEmpty() ? -1 : spine.first();
+}
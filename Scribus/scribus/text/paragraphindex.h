@@ -0,0 +1,103 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#ifndef PARAGRAPHINDEX_H
+#define PARAGRAPHINDEX_H
+
+#include <QVector>
+
+#include "scribusapi.h"
+
+/**
+   Keeps track of the paragraph separators in a story.
+
+   The text is split into segments, each ending with a separator, plus a
+   trailing segment which may be empty. The segments are kept in a treap
+   ordered by their position in the text, each node holding the length and
+   the number of segments of its subtree. Finding a paragraph from a char
+   position and vice versa, inserting or removing chars and inserting or
+   removing a separator are O(log n) where n is the number of paragraphs.
+   replace() splices a block with k separators in O(k + log n).
+ */
+class SCRIBUS_API ParagraphIndex
+{
+public:
+	ParagraphIndex();
+
+	/// empty text, no separators
+	void clear();
+	/// rebuilds the index from the separator positions (ascending) and the text length
+	void reset(const QVector<int>& separatorPositions, int length);
+
+	/// number of paragraph separators
+	int separators() const { return count(m_root) - 1; }
+	/// length of the indexed text
+	int length() const { return m_length; }
+	/// number of chars behind the last separator
+	int trailingLength() const;
+
+	/// number of separators in [0, pos)
+	int separatorsBefore(int pos) const;
+	/// position of the first char behind separator number index-1, 0 for index == 0
+	int startOfSegment(int index) const;
+	/// position of separator number index, index < separators()
+	int separatorPos(int index) const { return startOfSegment(index + 1) - 1; }
+	/// position of the first separator at or behind pos, -1 if there is none
+	int nextSeparator(int pos) const;
+
+	/// count ordinary chars were inserted at pos
+	void insertChars(int pos, int count);
+	/// count ordinary chars were removed at pos. They must not span a separator.
+	void removeChars(int pos, int count);
+	/// a separator was inserted at pos
+	void insertSeparator(int pos);
+	/// the separator at pos was removed
+	void removeSeparator(int pos);
+	/**
+	   The chars [pos, pos+removed), separators or not, were replaced by
+	   inserted chars with separators at the given offsets from pos (ascending).
+	 */
+	void replace(int pos, int removed, int inserted, const QVector<int>& separatorOffsets);
+
+private:
+	struct Node
+	{
+		int  length;
+		/// total length and number of segments of the subtree
+		int  sum;
+		int  count;
+		int  left;
+		int  right;
+		uint priority;
+	};
+
+	int count(int node) const { return node < 0 ? 0 : m_nodes[node].count; }
+	int sum(int node) const { return node < 0 ? 0 : m_nodes[node].sum; }
+	/// sum of the lengths of the first count segments
+	int prefix(int count) const;
+	/// largest count with prefix(count) <= pos
+	int segmentsUpTo(int pos) const;
+	int segmentLength(int segment) const;
+	void add(int segment, int delta);
+
+	int  newNode(int length);
+	void freeTree(int node);
+	void update(int node);
+	/// splits node into the subtrees of the first count segments and of the rest
+	void split(int node, int count, int& left, int& right);
+	int  merge(int left, int right);
+	/// builds a treap from the segment lengths in O(n)
+	int  build(const QVector<int>& lengths);
+
+	QVector<Node> m_nodes;
+	QVector<int> m_freeNodes;
+	int  m_root;
+	int  m_length;
+	uint m_seed;
+};
+
+#endif /*PARAGRAPHINDEX_H*/
@@ -19,7 +19,8 @@ for which a new license (GPL+exception) is in place.
 ScText_Shared::ScText_Shared(const StyleContext* pstyles) : QList<ScText*>(), 
 	defaultStyle(), 
 	pstyleContext(NULL),
-	refs(1), len(0), cursorPosition(0), trailingStyle()
+	refs(1), len(0), cursorPosition(0), trailingStyle(),
+	revision(1), journalStart(1)
 {
 	pstyleContext.setDefaultStyle( & defaultStyle );
 	defaultStyle.setContext( pstyles );
@@ -33,7 +34,8 @@ ScText_Shared::ScText_Shared(const ScText_Shared& other) : QList<ScText*>(),
 	defaultStyle(other.defaultStyle), 
 	pstyleContext(other.pstyleContext),
 	refs(1), len(0), cursorPosition(other.cursorPosition),
-	trailingStyle(other.trailingStyle)
+	trailingStyle(other.trailingStyle),
+	revision(1), journalStart(1)
 {
 	pstyleContext.setDefaultStyle( &defaultStyle );
 	trailingStyle.setContext( &pstyleContext );
@@ -50,6 +52,7 @@ ScText_Shared::ScText_Shared(const ScText_Shared& other) : QList<ScText*>(),
 		}
 	}
 	len = count();
+	rebuildParagraphIndex();
 	replaceCharStyleContextInParagraph(len,  trailingStyle.charStyleContext() );
 //		qDebug() << QString("ScText_Shared(%2) %1").arg(reinterpret_cast<uint>(this)).arg(reinterpret_cast<uint>(&other));
 }
@@ -59,6 +62,7 @@ void ScText_Shared::clear()
 	while(!this->isEmpty())
 		delete this->takeFirst(); 
 	QList<ScText*>::clear();
+	paragraphs.clear();
 	cursorPosition = 0;
 }
 
@@ -89,7 +93,9 @@ ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other)
 			}
 		}
 		len = count();
+		rebuildParagraphIndex();
 		cursorPosition = other.cursorPosition;
+		recordFullChange();
 		pstyleContext.invalidate();
 //			qDebug() << QString("StoryText::copy: %1 align=%2 %3").arg(trailingStyle.parentStyle()->name())
 //				   .arg(trailingStyle.alignment()).arg((uint)trailingStyle.context());
@@ -99,6 +105,59 @@ ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other)
 	return *this;
 }
 
+void ScText_Shared::insertItems(int pos, const QList<ScText*>& items)
+{
+	assert(pos >= 0 && pos <= count());
+	if (pos == count())
+	{
+		append(items);
+		return;
+	}
+	QList<ScText*> tail(mid(pos));
+	erase(begin() + pos, end());
+	append(items);
+	append(tail);
+}
+
+void ScText_Shared::removeItems(int pos, int count)
+{
+	assert(pos >= 0 && pos + count <= size());
+	for (int i = pos; i < pos + count; ++i)
+		delete at(i);
+	erase(begin() + pos, begin() + pos + count);
+}
+
+static const int MAX_JOURNAL_LENGTH = 256;
+
+void ScText_Shared::recordChange(int pos, int removed, int inserted)
+{
+	ScTextChange change;
+	change.revision = ++revision;
+	change.pos      = pos;
+	change.removed  = removed;
+	change.inserted = inserted;
+	journal.append(change);
+	if (journal.count() > MAX_JOURNAL_LENGTH)
+		journalStart = journal.takeFirst().revision;
+}
+
+void ScText_Shared::recordFullChange()
+{
+	journal.clear();
+	journalStart = ++revision;
+}
+
+void ScText_Shared::rebuildParagraphIndex()
+{
+	QVector<int> separators;
+	for (int i = 0; i < count(); ++i)
+	{
+		if (at(i)->ch == SpecialChars::PARSEP)
+			separators.append(i);
+	}
+	paragraphs.reset(separators, count());
+}
+
 ScText_Shared::~ScText_Shared() 
 {
 //		qDebug() << QString("~ScText_Shared() %1").arg(reinterpret_cast<uint>(this));
@@ -126,11 +185,16 @@ void ScText_Shared::replaceCharStyleContextInParagraph(int pos, const StyleConte
 	}
 #ifndef NDEBUG // skip assertions if we aren't debugging
 	// we are done here but will do a sanity check:
-	// assert that all chars point to the following parstyle
-	QListIterator<ScText*> it( *this );
+	// assert that all chars of this paragraph point to the following parstyle.
+	// Checking the whole story here made building long stories quadratic.
+	int first = qMin(pos, size());
+	while (first > 0 && at(first-1)->ch != SpecialChars::PARSEP)
+		--first;
 	const StyleContext* lastContext = NULL;
-	while ( it.hasNext() ) {
-		ScText* elem = it.next();
+	bool atEnd = true;
+	for (int i = first; i < size(); ++i)
+	{
+		ScText* elem = at(i);
 		assert( elem );
 		if ( elem->ch.isNull() ) 
 		{
@@ -143,7 +207,8 @@ void ScText_Shared::replaceCharStyleContextInParagraph(int pos, const StyleConte
 			{
 				assert( lastContext == elem->parstyle->charStyleContext() );
 			}
-			lastContext = NULL;
+			atEnd = false;
+			break;
 		}
 		else if (lastContext == NULL)
 		{
@@ -154,7 +219,7 @@ void ScText_Shared::replaceCharStyleContextInParagraph(int pos, const StyleConte
 			assert( lastContext == elem->context() );
 		}
 	}
-	if ( lastContext )
+	if ( atEnd && lastContext )
 		assert( lastContext == trailingStyle.charStyleContext() );
 #endif
 }
@@ -8,12 +8,27 @@
 
 //#include "text/paragraphlayout.h"
 #include "text/frect.h"
+#include "text/paragraphindex.h"
 #include "style.h"
 #include "styles/charstyle.h"
 #include "styles/paragraphstyle.h"
 #include "styles/stylecontextproxy.h"
 
 
+/**
+   An entry in the edit journal of a story: the chars [pos, pos+removed)
+   were replaced by 'inserted' new chars. Style changes are recorded with
+   removed == inserted.
+ */
+struct ScTextChange
+{
+	uint revision;
+	int  pos;
+	int  removed;
+	int  inserted;
+};
+
+
 class SCRIBUS_API ScText_Shared : public QList<ScText*>
 {
 public:
@@ -23,6 +38,13 @@ public:
 	uint len;
 	uint cursorPosition;
 	ParagraphStyle trailingStyle;
+	/// incremented for each change of text or styles
+	uint revision;
+	/// the journal holds all changes after this revision
+	uint journalStart;
+	QList<ScTextChange> journal;
+	/// positions of the paragraph separators
+	ParagraphIndex paragraphs;
 	ScText_Shared(const StyleContext* pstyles);	
 
 	ScText_Shared(const ScText_Shared& other);
@@ -32,6 +54,11 @@ public:
 	~ScText_Shared();
 
 	void clear();
+
+	/// inserts items at pos, moving the following items only once
+	void insertItems(int pos, const QList<ScText*>& items);
+	/// deletes count items at pos
+	void removeItems(int pos, int count);
 	
 	/**
 	   A char's stylecontext is the containing paragraph's style, 
@@ -39,6 +66,14 @@ public:
 	   in the parstyle first.
 	 */
 	void replaceCharStyleContextInParagraph(int pos, const StyleContext* newContext);
+
+	/// adds an entry to the edit journal, dropping the oldest one if it gets too long
+	void recordChange(int pos, int removed, int inserted);
+	/// records a change which can't be described by a char range, eg. a new default style
+	void recordFullChange();
+
+	/// scans the whole text for paragraph separators
+	void rebuildParagraphIndex();
 };
 
 #endif /*SCTEXT_SHARED_H*/
@@ -55,6 +55,7 @@ StoryText::StoryText(ScribusDoc * doc_) : doc(doc_)
 	lastFrameItem = -1;
 	m_magicX = 0.0;
 	m_lastMagicPos = -1;
+	m_layoutRevision = 0;
 	
 	d->len = 0;
 	invalidateAll();
@@ -71,6 +72,7 @@ StoryText::StoryText() : doc(NULL)
 	lastFrameItem = -1;
 	m_magicX = 0.0;
 	m_lastMagicPos = -1;
+	m_layoutRevision = 0;
 }
 
 StoryText::StoryText(const StoryText & other) : QObject(), SaxIO(), doc(other.doc)
@@ -90,6 +92,7 @@ StoryText::StoryText(const StoryText & other) : QObject(), SaxIO(), doc(other.do
 	lastFrameItem = -1;
 	m_magicX = 0.0;
 	m_lastMagicPos = -1;
+	m_layoutRevision = 0;
 
 	invalidateLayout();
 }
@@ -269,16 +272,17 @@ void StoryText::insert(int pos, const StoryText& other, bool onlySelection)
 
 
 /**
-    Make sure that the paragraph CharStyle's point to the new ParagraphStyle
+    Make sure that the paragraph CharStyle's point to the new ParagraphStyle.
+    atEnd tells if the separator was appended to the text.
  */
-void StoryText::insertParSep(int pos)
+void StoryText::insertParSep(int pos, bool atEnd)
 {
 	ScText* it = item_p(pos);
 	if(!it->parstyle) {
 		it->parstyle = new ParagraphStyle(paragraphStyle(pos+1));
 		it->parstyle->setContext( & d->pstyleContext);
 		// #7432 : when inserting a paragraph separator, apply/erase the trailing Style
-		if (pos >= signed(d->len - 1))
+		if (atEnd)
 		{
 			applyStyle(pos, d->trailingStyle);
 			d->trailingStyle.erase();
@@ -309,6 +313,37 @@ void StoryText::removeParSep(int pos)
 	d->replaceCharStyleContextInParagraph(pos, paragraphStyle(pos+1).charStyleContext());	
 }
 
+/**
+    Updates the paragraph index for count chars which were just inserted at
+    pos, and sets up the new paragraph separators in parSeps with the styles
+    single inserts would give them.
+ */
+void StoryText::spliceParSeps(int pos, int count, const QList<int>& parSeps, bool atEnd)
+{
+	d->len = d->count();
+	QVector<int> offsets;
+	offsets.reserve(parSeps.count());
+	for (int i = 0; i < parSeps.count(); ++i)
+		offsets.append(parSeps[i] - pos);
+	d->paragraphs.replace(pos, 0, count, offsets);
+	if (parSeps.isEmpty())
+		return;
+	// the index already knows all new separators, so set them up back to
+	// front: each one copies the style of the paragraph behind it. Only the
+	// first one takes the trailing style, the others get the erased one.
+	ParagraphStyle trailing;
+	if (atEnd)
+	{
+		trailing = d->trailingStyle;
+		d->trailingStyle.erase();
+	}
+	for (int i = parSeps.count() - 1; i > 0; --i)
+		insertParSep(parSeps[i], false);
+	if (atEnd)
+		d->trailingStyle = trailing;
+	insertParSep(parSeps[0], atEnd);
+}
+
 void StoryText::removeChars(int pos, uint len)
 {
 	if (pos < 0)
@@ -323,22 +358,29 @@ void StoryText::removeChars(int pos, uint len)
 	if (pos + static_cast<int>(len) > length())
 		len = length() - pos;
 
+	// first demote the paragraph separators like removeParSep() does, then
+	// let the chars in front of them join the following paragraph and
+	// remove all chars at once
+	bool removesParSep = false;
 	for ( int i=pos + static_cast<int>(len) - 1; i >= pos; --i )
 	{
 		ScText *it = d->at(i);
 		if ((it->ch == SpecialChars::PARSEP)) {
-			removeParSep(i);
+			delete it->parstyle;
+			it->parstyle = 0;
+			it->ch = 0;
+			removesParSep = true;
 		}
-//		qDebug("remove char %d at %d", (int) it->ch.unicode(), i);
-		d->takeAt(i);
-		d->len--;
-		delete it;
 		// #9592 : adjust selFirst and selLast, those values have to be
 		// consistent in functions such as select()
 		if (i <= selLast) --selLast;
 		if (i < selFirst) --selFirst;
 		if ((i + 1 ) <= d->cursorPosition && d->cursorPosition > 0) d->cursorPosition -= 1;
 	}
+	if (removesParSep)
+		d->replaceCharStyleContextInParagraph(pos + len, paragraphStyle(pos + len).charStyleContext());
+	d->removeItems(pos, len);
+	d->paragraphs.replace(pos, len, 0, QVector<int>());
 
 	d->len = d->count();
 	d->cursorPosition = qMin(d->cursorPosition, d->len);
@@ -347,6 +389,7 @@ void StoryText::removeChars(int pos, uint len)
 		selFirst =  0;
 		selLast  = -1;
 	}
+	d->recordChange(pos, len, 0);
 	invalidate(pos, length());
 }
 
@@ -376,22 +419,26 @@ void StoryText::insertChars(int pos, QString txt, bool applyNeighbourStyle) //,
 		clone.setEffects(ScStyle_Default);
 	}
 
+	bool atEnd = pos == length();
+	QList<ScText*> items;
+	QList<int> parSeps;
 	for (int i = 0; i < txt.length(); ++i) {
 		ScText * item = new ScText(clone);
 		item->ch= txt.at(i);
 		item->setContext(cStyleContext);
-		d->insert(pos + i, item);
-		d->len++;
-		if (item->ch == SpecialChars::PARSEP) {
-//			qDebug() << QString("new PARSEP %2 at %1").arg(pos).arg(paragraphStyle(pos).name());
-			insertParSep(pos + i);
-		}
-		if (d->cursorPosition >= (pos + i)) {
-			d->cursorPosition += 1;
-		}
+		items.append(item);
+		if (item->ch == SpecialChars::PARSEP)
+			parSeps.append(pos + i);
+	}
+	d->insertItems(pos, items);
+	spliceParSeps(pos, txt.length(), parSeps, atEnd);
+
+	if (d->cursorPosition >= pos) {
+		d->cursorPosition += txt.length();
 	}
 
 	d->len = d->count();
+	d->recordChange(pos, 0, txt.length());
 	invalidate(pos, pos + txt.length());
 }
 
@@ -416,6 +463,9 @@ void StoryText::insertCharsWithSoftHyphens(int pos, QString txt, bool applyNeigh
 		clone.setEffects(ScStyle_Default);
 	}
 
+	bool atEnd = pos == length();
+	QList<ScText*> items;
+	QList<int> parSeps;
 	int inserted = 0;
 	for (int i = 0; i < txt.length(); ++i) 
 	{
@@ -423,7 +473,7 @@ void StoryText::insertCharsWithSoftHyphens(int pos, QString txt, bool applyNeigh
 		int  index  = pos + inserted;
 		bool insert = true; 
 		if (ch == SpecialChars::SHYPHEN && index > 0) {
-			ScText* lastItem = this->item(index - 1);
+			ScText* lastItem = inserted > 0 ? items.last() : this->item(index - 1);
 			// qreal SHY means user provided SHY, single SHY is automatic one
 			if (lastItem->effects() & ScStyle_HyphenationPossible)
 				lastItem->setEffects(lastItem->effects() & ~ScStyle_HyphenationPossible);
@@ -438,19 +488,23 @@ void StoryText::insertCharsWithSoftHyphens(int pos, QString txt, bool applyNeigh
 			ScText * item = new ScText(clone);
 			item->ch = ch;
 			item->setContext(cStyleContext);
-			d->insert(index, item);
-			d->len++;
-			if (item->ch == SpecialChars::PARSEP) {
-				insertParSep(index);
-			}
-			if (d->cursorPosition >= index) {
-				d->cursorPosition += 1;
-			}
+			items.append(item);
+			if (item->ch == SpecialChars::PARSEP)
+				parSeps.append(index);
 			++inserted;
 		}
 	}
+	d->insertItems(pos, items);
+	spliceParSeps(pos, inserted, parSeps, atEnd);
+
+	if (d->cursorPosition >= pos) {
+		d->cursorPosition += inserted;
+	}
 
 	d->len = d->count();
+	// a soft hyphen at the start may have changed the previous char
+	int first = qMax(0, pos - 1);
+	d->recordChange(first, pos - first, pos - first + inserted);
 	invalidate(pos, pos + inserted);
 }
 
@@ -466,14 +520,14 @@ void StoryText::replaceChar(int pos, QChar ch)
 	if (item->ch == ch)
 		return;
 	
-	if (d->at(pos)->ch == SpecialChars::PARSEP) {
+	if (item->ch == SpecialChars::PARSEP)
 		removeParSep(pos);
-	}
 	item->ch = ch;
-	if (d->at(pos)->ch == SpecialChars::PARSEP) {
-		insertParSep(pos);
-	}
+	d->paragraphs.replace(pos, 1, 1, ch == SpecialChars::PARSEP ? QVector<int>(1, 0) : QVector<int>());
+	if (ch == SpecialChars::PARSEP)
+		insertParSep(pos, pos >= signed(d->len - 1));
 	
+	d->recordChange(pos, 1, 1);
 	invalidate(pos, pos + 1);
 }
 
@@ -495,6 +549,23 @@ void StoryText::hyphenateWord(int pos, uint len, char* hyphens)
 		}
 	}
 //	qDebug() << QString("st: %1").arg(dump);
+	d->recordChange(pos, len, len);
+	invalidate(pos, pos + len);
+}
+
+void StoryText::replaceEffects(int pos, uint len, StyleFlag mask, StyleFlag effects)
+{
+	assert(pos >= 0);
+	assert(pos + signed(len) <= length());
+
+	for (int i=pos; i < pos+signed(len); ++i)
+	{
+		StyleFlag fl = d->at(i)->effects();
+		fl &= ~mask;
+		fl |= effects & mask;
+		d->at(i)->setFeatures(fl.featureList());
+	}
+	d->recordChange(pos, len, len);
 	invalidate(pos, pos + len);
 }
 
@@ -648,10 +719,8 @@ const ParagraphStyle & StoryText::paragraphStyle(int pos) const
 //	assert( that->at(pos)->cab < doc->docParagraphStyles.count() );
 //	return doc->docParagraphStyles[that->at(pos)->cab];
 	
-	while (pos < length() && that->d->at(pos)->ch != SpecialChars::PARSEP) {
-		++pos;
-	}
-	if (pos >= length()) {
+	pos = d->paragraphs.nextSeparator(pos);
+	if (pos < 0) {
 		return that->d->trailingStyle;
 	}
 	else if ( !that->d->at(pos)->parstyle ) {
@@ -735,6 +804,7 @@ void StoryText::applyCharStyle(int pos, uint len, const CharStyle& style )
 		d->trailingStyle.charStyle().applyCharStyle(style);
 	}*/
 	
+	d->recordChange(pos, len, len);
 	invalidate(pos, pos + len);
 }
 
@@ -765,6 +835,7 @@ void StoryText::eraseCharStyle(int pos, uint len, const CharStyle& style )
 		d->trailingStyle.charStyle().eraseCharStyle(style);
 	}*/
 	
+	d->recordChange(pos, len, len);
 	invalidate(pos, pos + len);
 }
 
@@ -776,10 +847,9 @@ void StoryText::applyStyle(int pos, const ParagraphStyle& style, bool rmDirectFo
 	assert(pos >= 0);
 	assert(pos <= length());
 
-	int i = pos;
-	while (i < length() && d->at(i)->ch != SpecialChars::PARSEP) {
-		++i;
-	}
+	int i = d->paragraphs.nextSeparator(pos);
+	if (i < 0)
+		i = length();
 	if (i < length()) {
 		if (!d->at(i)->parstyle) {
 			qDebug("PARSEP without style at pos %i", i);
@@ -797,6 +867,8 @@ void StoryText::applyStyle(int pos, const ParagraphStyle& style, bool rmDirectFo
 //		qDebug() << QString("applying parstyle %1 as defaultstyle for %2").arg(paragraphStyle(pos).name()).arg(pos);
 		d->trailingStyle.applyStyle(style);
 	}
+	int parLen = qMin(i + 1, length()) - pos;
+	d->recordChange(pos, parLen, parLen);
 	if (rmDirectFormatting)
 	{
 		--i;
@@ -817,10 +889,9 @@ void StoryText::eraseStyle(int pos, const ParagraphStyle& style)
 	assert(pos >= 0);
 	assert(pos <= length());
 		
-	int i = pos;
-	while (i < length() && d->at(i)->ch != SpecialChars::PARSEP) {
-		++i;
-	}
+	int i = d->paragraphs.nextSeparator(pos);
+	if (i < 0)
+		i = length();
 	if (i < length()) {
 		if (!d->at(i)->parstyle) {
 			qDebug("PARSEP without style at pos %i", i);
@@ -838,6 +909,8 @@ void StoryText::eraseStyle(int pos, const ParagraphStyle& style)
 		//		qDebug() << QString("applying parstyle %1 as defaultstyle for %2").arg(paragraphStyle(pos).name()).arg(pos);
 		d->trailingStyle.eraseStyle(style);
 	}
+	int parLen = qMin(i + 1, length()) - pos;
+	d->recordChange(pos, parLen, parLen);
 	invalidate(pos, qMin(i, length()));
 }
 
@@ -870,6 +943,7 @@ void StoryText::setCharStyle(int pos, uint len, const CharStyle& style)
 		itText->setStyle(style);
 	}
 	
+	d->recordChange(pos, len, len);
 	invalidate(pos, pos + len);
 }
 
@@ -918,6 +992,7 @@ void StoryText::replaceNamedResources(ResourceCollection& newNames)
 			itText->replaceNamedResources(newNames);
 	}
 	
+	d->recordFullChange();
 	invalidate(0, len);	
 }
 
@@ -936,31 +1011,14 @@ uint StoryText::nrOfParagraph() const
 
 uint StoryText::nrOfParagraph(int pos) const
 {
-	uint result = 0;
-	StoryText* that = const_cast<StoryText *>(this);
-	bool lastWasPARSEP = true;
-	pos = qMin(pos, that->length());
-	for (int i=0; i < pos; ++i)
-	{
-		lastWasPARSEP = that->d->at(i)->ch == SpecialChars::PARSEP;
-		if (lastWasPARSEP)
-			++result;
-	}
-	return result;
+	pos = qMin(pos, length());
+	return d->paragraphs.separatorsBefore(qMax(pos, 0));
 }
 
 uint StoryText::nrOfParagraphs() const
 {
-	uint result = 0;
-	StoryText* that = const_cast<StoryText *>(this);
-	bool lastWasPARSEP = true;
-	for (int i=0; i < length(); ++i)
-	{
-		lastWasPARSEP = that->d->at(i)->ch == SpecialChars::PARSEP;
-		if (lastWasPARSEP)
-			++result;
-	}
-	return lastWasPARSEP ? result : result + 1;
+	uint result = d->paragraphs.separators();
+	return d->paragraphs.trailingLength() > 0 ? result + 1 : result;
 }
 
 int StoryText::startOfParagraph() const
@@ -970,16 +1028,7 @@ int StoryText::startOfParagraph() const
 
 int StoryText::startOfParagraph(uint index) const
 {
-	if (index == 0)
-		return 0;
-
-	StoryText* that = const_cast<StoryText *>(this);
-	for (int i=0; i < length(); ++i)
-	{
-		if (that->d->at(i)->ch == SpecialChars::PARSEP && ! --index)
-			return i + 1;
-	}
-	return length();
+	return d->paragraphs.startOfSegment(index);
 }
 
 int StoryText::endOfParagraph() const
@@ -989,13 +1038,8 @@ int StoryText::endOfParagraph() const
 
 int StoryText::endOfParagraph(uint index) const
 {
-	++index;
-	StoryText* that = const_cast<StoryText *>(this);
-	for (int i=0; i < length(); ++i)
-	{
-		if (that->d->at(i)->ch == SpecialChars::PARSEP && ! --index)
-			return i;
-	}
+	if (index < uint(d->paragraphs.separators()))
+		return d->paragraphs.separatorPos(index);
 	return length();
 }
 
@@ -1067,17 +1111,14 @@ int StoryText::prevSentence(int pos)
 int StoryText::nextParagraph(int pos)
 {
 	int len = length();
-	pos = qMin(len, pos+1);
-	while (pos < len && text(pos) != SpecialChars::PARSEP)
-		++pos;
-	return pos;
+	pos = d->paragraphs.nextSeparator(qMin(len, pos+1));
+	return pos < 0 ? len : pos;
 }
 int StoryText::prevParagraph(int pos)
 {
 	pos = qMax(0, pos-1);
-	while (pos > 0 && text(pos) != SpecialChars::PARSEP)
-		--pos;
-	return pos;
+	int index = d->paragraphs.separatorsBefore(pos + 1);
+	return index > 0 ? d->paragraphs.separatorPos(index - 1) : 0;
 }
 
 QString StoryText::wordAt(int pos) const
@@ -1387,10 +1428,54 @@ void StoryText::invalidateObject(const PageItem * embedded)
 
 void StoryText::invalidateLayout()
 {
+	m_layoutRevision = 0;
+}
+
+LayoutDamage StoryText::layoutDamage() const
+{
+	LayoutDamage damage;
+	damage.full    = m_layoutRevision == 0 || m_layoutRevision < d->journalStart;
+	damage.changed = damage.full;
+	damage.first   = 0;
+	damage.end     = length();
+	damage.delta   = 0;
+	if (damage.full)
+		return damage;
+	for (int i = 0; i < d->journal.count(); ++i)
+	{
+		const ScTextChange& change(d->journal.at(i));
+		if (change.revision <= m_layoutRevision)
+			continue;
+		int changeEnd = change.pos + change.inserted;
+		if (!damage.changed)
+		{
+			damage.changed = true;
+			damage.first = change.pos;
+			damage.end   = changeEnd;
+		}
+		else
+		{
+			// move the damaged range along with the text behind the change
+			if (damage.end >= change.pos + change.removed)
+				damage.end += change.inserted - change.removed;
+			else if (damage.end > change.pos)
+				damage.end = changeEnd;
+			damage.first = qMin(damage.first, change.pos);
+			damage.end   = qMax(damage.end, changeEnd);
+		}
+		damage.delta += change.inserted - change.removed;
+	}
+	return damage;
+}
+
+void StoryText::markLayoutValid()
+{
+	m_layoutRevision = d->revision;
 }
 
 void StoryText::invalidateAll()
 {
+	d->recordFullChange();
 	d->pstyleContext.invalidate();
 	invalidate(0, nrOfItems());
 }
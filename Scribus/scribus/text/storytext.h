@@ -69,6 +69,20 @@ struct LineSpec
 	qreal naturalWidth;
 };
 
+/**
+ * Describes which part of a story was changed since its lines were
+ * computed. Positions refer to the current text, delta is the change
+ * in length. If full is set, nothing is known about the changes.
+ */
+struct LayoutDamage
+{
+	bool full;
+	bool changed;
+	int  first;
+	int  end;
+	int  delta;
+};
+
 /**
  * This class holds the text of a Scribus textframe and pointers to its
  * styles and embedded objects.
@@ -128,6 +142,8 @@ class SCRIBUS_API StoryText : public QObject, public SaxIO
  	void replaceChar(int pos, QChar ch);
 
 	void hyphenateWord(int pos, uint len, char* hyphens);
+	/// replaces the effects selected by mask of the chars [pos, pos+len) with those in effects
+	void replaceEffects(int pos, uint len, StyleFlag mask, StyleFlag effects);
 	
  	int length() const;
 	// Get char at current cursor position
@@ -224,6 +240,10 @@ class SCRIBUS_API StoryText : public QObject, public SaxIO
  	void invalidateObject(const PageItem* embedded);
  	/// call this if the shape of the paragraph changes (redos layout)
  	void invalidateLayout();
+	/// returns the changes since the last call to markLayoutValid()
+	LayoutDamage layoutDamage() const;
+	/// call this when the lines reflect the current text
+	void markLayoutValid();
 
 public slots:
 	/// call this if some logical style changes (redos shaping and layout)
@@ -289,6 +309,21 @@ public:
 		lastFrameItem = -1; 
 	}
 	
+	/// moves all lines by delta chars, used after text was inserted or removed before them
+	void shiftLines(int delta)
+	{
+		for (int i = 0; i < m_lines.count(); ++i)
+		{
+			m_lines[i].firstItem += delta;
+			m_lines[i].lastItem += delta;
+		}
+		if (firstFrameItem <= lastFrameItem)
+		{
+			firstFrameItem += delta;
+			lastFrameItem += delta;
+		}
+	}
+	
 	int firstInFrame() { return firstFrameItem; }
 	int lastInFrame() { return lastFrameItem; }
 
@@ -298,6 +333,8 @@ private:
 	int firstFrameItem, lastFrameItem;
 	QList<LineSpec> m_lines;
 	bool m_validLayout;
+	/// revision of the shared text when the lines were computed, 0 if unknown
+	uint m_layoutRevision;
 	qreal m_magicX;
 	int m_lastMagicPos;
 
@@ -307,7 +344,8 @@ private:
  	/// mark these runs as invalid, ie. need itemize and shaping
  	void invalidate(int firstRun, int lastRun);
  	void removeParSep(int pos);
- 	void insertParSep(int pos);
+ 	void insertParSep(int pos, bool atEnd);
+	void spliceParSeps(int pos, int count, const QList<int>& parSeps, bool atEnd);
 
 	// 	int splitRun(int pos);
  	
@@ -0,0 +1,323 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+
+#include <QPainterPath>
+#include <QtAlgorithms>
+
+#include "textwrapshape.h"
+
+namespace {
+
+/// Maximum number of lines kept in the span cache before it is flushed.
+const int MaxCachedLines = 4096;
+
+bool spanLessThan(const WrapSpan& a, const WrapSpan& b)
+{
+	return a.left < b.left;
+}
+
+QRectF boundsOf(const QList<QPolygonF>& polygons)
+{
+	QRectF result;
+	foreach (const QPolygonF& polygon, polygons)
+		result |= polygon.boundingRect();
+	return result;
+}
+
+} // namespace
+
+TextWrapShape::TextWrapShape()
+{
+}
+
+void TextWrapShape::clear()
+{
+	m_frame.clear();
+	m_frameBounds = QRectF();
+	m_obstacles.clear();
+	m_lineCache.clear();
+	m_bandCache.clear();
+}
+
+void TextWrapShape::setFrame(const QPolygonF& frame)
+{
+	setFrame(QList<QPolygonF>() << frame);
+}
+
+void TextWrapShape::setFrame(const QList<QPolygonF>& frame)
+{
+	if (frame.count() > 1)
+	{
+		// overlapping subpaths would cancel out with the odd-even rule
+		QPainterPath area;
+		foreach (const QPolygonF& polygon, frame)
+		{
+			QPainterPath subpath;
+			subpath.addPolygon(polygon);
+			subpath.closeSubpath();
+			area = area.united(subpath);
+		}
+		m_frame = area.toSubpathPolygons();
+	}
+	else
+		m_frame = frame;
+	m_frameBounds = boundsOf(m_frame);
+	m_lineCache.clear();
+	m_bandCache.clear();
+}
+
+void TextWrapShape::addObstacle(const QList<QPolygonF>& shape, const QList<QPolygonF>& clip)
+{
+	Obstacle obstacle;
+	obstacle.shape = shape;
+	obstacle.clip = clip;
+	obstacle.bounds = boundsOf(shape);
+	if (!clip.isEmpty())
+		obstacle.bounds &= boundsOf(clip);
+	// obstacles outside of the frame can never block anything
+	if (!obstacle.bounds.intersects(m_frameBounds))
+		return;
+	m_obstacles.append(obstacle);
+	m_lineCache.clear();
+	m_bandCache.clear();
+}
+
+bool TextWrapShape::operator==(const TextWrapShape& other) const
+{
+	if (m_frame != other.m_frame || m_obstacles.count() != other.m_obstacles.count())
+		return false;
+	for (int i = 0; i < m_obstacles.count(); ++i)
+	{
+		if (m_obstacles[i].shape != other.m_obstacles[i].shape || m_obstacles[i].clip != other.m_obstacles[i].clip)
+			return false;
+	}
+	return true;
+}
+
+bool TextWrapShape::contains(const QPointF& point) const
+{
+	if (!m_frameBounds.contains(point))
+		return false;
+	return spanAt(spansAt(point.y()), point.x()) != 0;
+}
+
+const WrapSpans& TextWrapShape::spansAt(double y) const
+{
+	QMap<double, WrapSpans>::const_iterator cached = m_lineCache.constFind(y);
+	if (cached != m_lineCache.constEnd())
+		return cached.value();
+	if (m_lineCache.count() >= MaxCachedLines)
+		m_lineCache.clear();
+
+	WrapSpans result;
+	scanLine(m_frame, y, result);
+	for (int i = 0; i < m_obstacles.count() && !result.isEmpty(); ++i)
+	{
+		const Obstacle& obstacle(m_obstacles[i]);
+		if (y < obstacle.bounds.top() || y > obstacle.bounds.bottom())
+			continue;
+		WrapSpans blocked;
+		scanLine(obstacle.shape, y, blocked);
+		if (!obstacle.clip.isEmpty())
+		{
+			WrapSpans clip;
+			scanLine(obstacle.clip, y, clip);
+			blocked = intersected(blocked, clip);
+		}
+		result = subtracted(result, blocked);
+	}
+	return m_lineCache.insert(y, result).value();
+}
+
+const WrapSpans& TextWrapShape::spans(double top, double bottom) const
+{
+	if (top > bottom)
+		qSwap(top, bottom);
+	QPair<double, double> band(top, bottom);
+	QMap<QPair<double, double>, WrapSpans>::const_iterator cached = m_bandCache.constFind(band);
+	if (cached != m_bandCache.constEnd())
+		return cached.value();
+	if (m_bandCache.count() >= MaxCachedLines)
+		m_bandCache.clear();
+
+	// Where no edge crosses the band, being inside or outside of a polygon
+	// does not change between top and bottom. So the frame minus its edges
+	// and each obstacle plus its edges give the free ranges for the whole band.
+	WrapSpans result;
+	scanLine(m_frame, top, result);
+	WrapSpans edges;
+	edgeRanges(m_frame, top, bottom, edges);
+	normalize(edges);
+	result = subtracted(result, edges);
+	for (int i = 0; i < m_obstacles.count() && !result.isEmpty(); ++i)
+	{
+		const Obstacle& obstacle(m_obstacles[i]);
+		if (bottom < obstacle.bounds.top() || top > obstacle.bounds.bottom())
+			continue;
+		WrapSpans blocked;
+		scanLine(obstacle.shape, top, blocked);
+		edgeRanges(obstacle.shape, top, bottom, blocked);
+		normalize(blocked);
+		if (!obstacle.clip.isEmpty())
+		{
+			WrapSpans clip;
+			scanLine(obstacle.clip, top, clip);
+			edgeRanges(obstacle.clip, top, bottom, clip);
+			normalize(clip);
+			blocked = intersected(blocked, clip);
+		}
+		result = subtracted(result, blocked);
+	}
+	return m_bandCache.insert(band, result).value();
+}
+
+bool TextWrapShape::fits(double x, double top, double bottom) const
+{
+	return spanAt(spans(top, bottom), x) != 0;
+}
+
+double TextWrapShape::nextFit(double x, double top, double bottom) const
+{
+	const WrapSpans& available(spans(top, bottom));
+	for (int i = 0; i < available.count(); ++i)
+	{
+		if (x < available[i].right)
+			return qMax(x, available[i].left);
+	}
+	return qMax(x, m_frameBounds.right());
+}
+
+double TextWrapShape::freeUntil(double x, double top, double bottom) const
+{
+	const WrapSpan* span = spanAt(spans(top, bottom), x);
+	return span ? span->right : x;
+}
+
+void TextWrapShape::scanLine(const QList<QPolygonF>& polygons, double y, WrapSpans& result)
+{
+	QVector<double> crossings;
+	foreach (const QPolygonF& polygon, polygons)
+	{
+		int count = polygon.count();
+		for (int i = 0; i < count; ++i)
+		{
+			const QPointF& p1(polygon.at(i));
+			const QPointF& p2(polygon.at((i + 1) % count));
+			// half open in y, so that a vertex shared by two edges is counted once
+			if ((p1.y() <= y && y < p2.y()) || (p2.y() <= y && y < p1.y()))
+				crossings.append(p1.x() + (y - p1.y()) * (p2.x() - p1.x()) / (p2.y() - p1.y()));
+		}
+	}
+	qSort(crossings);
+	for (int i = 0; i + 1 < crossings.count(); i += 2)
+	{
+		if (crossings[i] < crossings[i + 1])
+			result.append(WrapSpan(crossings[i], crossings[i + 1]));
+	}
+}
+
+void TextWrapShape::edgeRanges(const QList<QPolygonF>& polygons, double top, double bottom, WrapSpans& result)
+{
+	foreach (const QPolygonF& polygon, polygons)
+	{
+		int count = polygon.count();
+		for (int i = 0; i < count; ++i)
+		{
+			QPointF p1(polygon.at(i));
+			QPointF p2(polygon.at((i + 1) % count));
+			if (p1.y() > p2.y())
+				qSwap(p1, p2);
+			if (p2.y() < top || p1.y() > bottom)
+				continue;
+			double x1 = p1.x();
+			double x2 = p2.x();
+			if (p1.y() < p2.y())
+			{
+				double slope = (p2.x() - p1.x()) / (p2.y() - p1.y());
+				if (p1.y() < top)
+					x1 = p1.x() + (top - p1.y()) * slope;
+				if (p2.y() > bottom)
+					x2 = p1.x() + (bottom - p1.y()) * slope;
+			}
+			result.append(WrapSpan(qMin(x1, x2), qMax(x1, x2)));
+		}
+	}
+}
+
+void TextWrapShape::normalize(WrapSpans& spans)
+{
+	if (spans.isEmpty())
+		return;
+	qSort(spans.begin(), spans.end(), spanLessThan);
+	int last = 0;
+	for (int i = 1; i < spans.count(); ++i)
+	{
+		if (spans[i].left <= spans[last].right)
+			spans[last].right = qMax(spans[last].right, spans[i].right);
+		else
+			spans[++last] = spans[i];
+	}
+	spans.resize(last + 1);
+}
+
+WrapSpans TextWrapShape::intersected(const WrapSpans& a, const WrapSpans& b)
+{
+	WrapSpans result;
+	int i = 0, j = 0;
+	while (i < a.count() && j < b.count())
+	{
+		double left = qMax(a[i].left, b[j].left);
+		double right = qMin(a[i].right, b[j].right);
+		if (left <= right)
+			result.append(WrapSpan(left, right));
+		if (a[i].right < b[j].right)
+			++i;
+		else
+			++j;
+	}
+	return result;
+}
+
+WrapSpans TextWrapShape::subtracted(const WrapSpans& a, const WrapSpans& b)
+{
+	// b is treated as closed: a blocked range of zero width still splits a span
+	WrapSpans result;
+	int j = 0;
+	for (int i = 0; i < a.count(); ++i)
+	{
+		double left = a[i].left;
+		double right = a[i].right;
+		while (j < b.count() && b[j].right < left)
+			++j;
+		for (int k = j; k < b.count() && b[k].left < right; ++k)
+		{
+			if (b[k].left > left)
+				result.append(WrapSpan(left, b[k].left));
+			left = qMax(left, b[k].right);
+		}
+		if (left < right)
+			result.append(WrapSpan(left, right));
+	}
+	return result;
+}
+
+const WrapSpan* TextWrapShape::spanAt(const WrapSpans& spans, double x)
+{
+	// spans are sorted and disjoint, find the last one starting at or before x
+	int low = 0, high = spans.count();
+	while (low < high)
+	{
+		int mid = (low + high) / 2;
+		if (spans[mid].left <= x)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	if (low == 0 || x >= spans[low - 1].right)
+		return 0;
+	return &spans[low - 1];
+}
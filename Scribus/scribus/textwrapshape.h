@@ -0,0 +1,111 @@
+/*
+ * For general Scribus (>=1.3.2) copyright and licensing information please refer
+ * to the COPYING file provided with the program. Following this notice may exist
+ * a copyright and/or license notice that predates the release of Scribus 1.3.2
+ * for which a new license (GPL+exception) is in place.
+ */
+#ifndef TEXTWRAPSHAPE_H
+#define TEXTWRAPSHAPE_H
+
+#include <QList>
+#include <QMap>
+#include <QPair>
+#include <QPointF>
+#include <QPolygonF>
+#include <QRectF>
+#include <QVector>
+
+/// A horizontal range [left, right) of free space.
+struct WrapSpan
+{
+	double left;
+	double right;
+
+	WrapSpan() : left(0), right(0) {}
+	WrapSpan(double l, double r) : left(l), right(r) {}
+	bool operator==(const WrapSpan& other) const { return left == other.left && right == other.right; }
+};
+
+typedef QVector<WrapSpan> WrapSpans;
+
+/**
+ * The TextWrapShape class describes where text may be placed in a text frame.
+ *
+ * It consists of the frame area and a list of obstacles the text has to flow around,
+ * all given as polygons in frame coordinates. The frame is the union of its polygons,
+ * obstacles are filled with the odd-even rule. Unlike QRegion it is not rounded to whole
+ * points, and queries for horizontal spans are answered from the polygon edges directly.
+ * The spans of each queried line and band are cached, so a shape should be kept as long
+ * as the frame and the obstacles don't change.
+ */
+class TextWrapShape
+{
+public:
+	/// Constructs an empty shape.
+	TextWrapShape();
+
+	/// Removes the frame area and all obstacles.
+	void clear();
+
+	/// Sets the area text may flow into to @a frame.
+	void setFrame(const QPolygonF& frame);
+	/// Sets the area text may flow into to the union of the @a frame subpaths.
+	void setFrame(const QList<QPolygonF>& frame);
+	/// Adds an area the text has to flow around. If @a clip is not empty, only the part inside @a clip counts.
+	void addObstacle(const QList<QPolygonF>& shape, const QList<QPolygonF>& clip = QList<QPolygonF>());
+
+	/// Returns <code>true</code> if there is no frame area at all.
+	bool isEmpty() const { return m_frameBounds.isEmpty(); }
+	/// Returns the number of obstacles.
+	int obstacleCount() const { return m_obstacles.count(); }
+
+	/// Returns <code>true</code> if this shape and @a other have the same frame and obstacles.
+	bool operator==(const TextWrapShape& other) const;
+	bool operator!=(const TextWrapShape& other) const { return !(*this == other); }
+
+	/// Returns <code>true</code> if @a point is inside the frame and outside of all obstacles.
+	bool contains(const QPointF& point) const;
+
+	/// Returns the free spans on the horizontal line at @a y, sorted from left to right.
+	const WrapSpans& spansAt(double y) const;
+	/// Returns the x ranges where the whole vertical segment from @a top to @a bottom is free.
+	const WrapSpans& spans(double top, double bottom) const;
+	/// Returns <code>true</code> if the whole vertical segment from @a top to @a bottom at @a x is free.
+	bool fits(double x, double top, double bottom) const;
+	/**
+	 * Returns the first x' >= @a x where the vertical segment from @a top to @a bottom is free,
+	 * the right edge of the frame if there is none.
+	 */
+	double nextFit(double x, double top, double bottom) const;
+	/**
+	 * Returns the end of the free range of the vertical segment from @a top to @a bottom
+	 * starting at @a x, @a x itself if the segment at @a x is not free.
+	 */
+	double freeUntil(double x, double top, double bottom) const;
+
+private:
+	struct Obstacle
+	{
+		QList<QPolygonF> shape;
+		QList<QPolygonF> clip;
+		QRectF bounds;
+	};
+
+	/// Computes the odd-even spans of @a polygons on the line at @a y.
+	static void scanLine(const QList<QPolygonF>& polygons, double y, WrapSpans& result);
+	/// Adds the x ranges of all edges of @a polygons between @a top and @a bottom to @a result.
+	static void edgeRanges(const QList<QPolygonF>& polygons, double top, double bottom, WrapSpans& result);
+	/// Sorts @a spans and merges overlapping ones.
+	static void normalize(WrapSpans& spans);
+	static WrapSpans intersected(const WrapSpans& a, const WrapSpans& b);
+	static WrapSpans subtracted(const WrapSpans& a, const WrapSpans& b);
+	static const WrapSpan* spanAt(const WrapSpans& spans, double x);
+
+	QList<QPolygonF> m_frame;
+	QRectF m_frameBounds;
+	QList<Obstacle> m_obstacles;
+	mutable QMap<double, WrapSpans> m_lineCache;
+	mutable QMap<QPair<double, double>, WrapSpans> m_bandCache;
+};
+
+#endif // TEXTWRAPSHAPE_H
@@ -1337,6 +1337,7 @@ void PaintManagerDialog::loadVectors(QString data)
 		{
 			pat.items.append(m_doc->Items->takeAt(ac));
 		}
+		m_doc->itemListChanged();
 		if (!dialogPatterns.contains(patNam))
 		{
 			dialogPatterns.insert(patNam, pat);
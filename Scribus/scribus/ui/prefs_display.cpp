@@ -55,6 +55,7 @@ void Prefs_Display::languageChange()
 	showLayerIndicatorsCheckBox->setToolTip( "<qt>" + tr("Turns the display of layer indicators on or off") + "</qt>");
 	showImagesCheckBox->setToolTip( "<qt>" + tr("Turns the display of images on or off") + "</qt>");
 	showPageShadowCheckBox->setToolTip( "<qt>" + tr("Turns the page shadow on or off") + "</qt>");
+	itemCacheSizeSpinBox->setToolTip( "<qt>" + tr("Memory used to keep rendered items, so that they are drawn faster when scrolling or selecting. Set to None to always draw all items anew") + "</qt>");
 	scratchSpaceLeftSpinBox->setToolTip( "<qt>" + tr( "Defines amount of space left of the document canvas available as a pasteboard for creating and modifying elements and dragging them onto the active page" ) + "</qt>" );
 	scratchSpaceRightSpinBox->setToolTip( "<qt>" + tr( "Defines amount of space right of the document canvas available as a pasteboard for creating and modifying elements and dragging them onto the active page" ) + "</qt>" );
 	scratchSpaceTopSpinBox->setToolTip( "<qt>" + tr( "Defines amount of space above the document canvas available as a pasteboard for creating and modifying elements and dragging them onto the active page" ) + "</qt>" );
@@ -80,6 +81,7 @@ void Prefs_Display::restoreDefaults(struct ApplicationPrefs *prefsData)
 	showBleedAreaCheckBox->setChecked(prefsData->guidesPrefs.showBleed);
 	showPageShadowCheckBox->setChecked(prefsData->displayPrefs.showPageShadow);
 	showVerifierWarningsOnCanvasCheckBox->setChecked(prefsData->displayPrefs.showVerifierWarningsOnCanvas);
+	itemCacheSizeSpinBox->setValue(prefsData->displayPrefs.itemCacheSize);
 
 	scratchSpaceLeftSpinBox->setMaximum(1000);
 	scratchSpaceRightSpinBox->setMaximum(1000);
@@ -385,6 +387,7 @@ void Prefs_Display::saveGuiToPrefs(struct ApplicationPrefs *prefsData) const
 	prefsData->guidesPrefs.showBleed=showBleedAreaCheckBox->isChecked();
 	prefsData->displayPrefs.showPageShadow=showPageShadowCheckBox->isChecked();
 	prefsData->displayPrefs.showVerifierWarningsOnCanvas=showVerifierWarningsOnCanvasCheckBox->isChecked();
+	prefsData->displayPrefs.itemCacheSize=itemCacheSizeSpinBox->value();
 	double unitRatio = unitGetRatioFromIndex(docUnitIndex);
 	prefsData->displayPrefs.scratch.Left=scratchSpaceLeftSpinBox->value()/unitRatio;
 	prefsData->displayPrefs.scratch.Right=scratchSpaceRightSpinBox->value()/unitRatio;
@@ -694,7 +694,9 @@ void SearchReplace::slotDoReplace()
 					StyleFlag fl = Item->itemText.item(a)->effects();
 					fl &= static_cast<StyleFlag>(~1919);
 					fl |= static_cast<StyleFlag>(s);
-					Item->itemText.item(a)->setFeatures(fl.featureList());
+					CharStyle newFeatures;
+					newFeatures.setFeatures(fl.featureList());
+					Item->itemText.applyCharStyle(a, 1, newFeatures);
 				}
 			}
 #endif